@@ -40,6 +40,7 @@ namespace Fd1d
     : mixture_(),
       domain_(),
       fileMaster_(),
+      logFilePtr_(0),
       fieldIo_(),
       homogeneous_(),
       interactionPtr_(0),
@@ -65,7 +66,12 @@ namespace Fd1d
       iteratorFactoryPtr_ = new IteratorFactory(*this); 
       sweepFactoryPtr_ = new SweepFactory(*this);
 
-      BracketPolicy::set(BracketPolicy::Optional);
+      // Set the process-wide bracket policy once, in a thread-safe
+      // static initialization, so that systems constructed in 
+      // concurrent threads do not write it while others read it.
+      static const bool hasBracketPolicy 
+                 = (BracketPolicy::set(BracketPolicy::Optional), true);
+      (void) hasBracketPolicy;
    }
 
    /*
@@ -130,7 +136,7 @@ namespace Fd1d
             oArg  = optarg;
             break;
          case '?':
-           Log::file() << "Unknown option -" << optopt << std::endl;
+           logFile() << "Unknown option -" << optopt << std::endl;
            UTIL_THROW("Invalid command line option");
          }
       }
@@ -252,7 +258,7 @@ namespace Fd1d
       int nMonomer = mixture().nMonomer();
       wFields_.allocate(nMonomer);
       cFields_.allocate(nMonomer);
-      int nx = domain().nx();
+      int nx = domain().nGrid();
       for (int i = 0; i < nMonomer; ++i) {
          wField(i).allocate(nx);
          cField(i).allocate(nx);
@@ -281,11 +287,11 @@ namespace Fd1d
          if (inBuffer.eof()) {
             break;
          } else {
-            Log::file() << command;
+            logFile() << command;
          }
 
          if (command == "FINISH") {
-            Log::file() << std::endl;
+            logFile() << std::endl;
             readNext = false;
          } else
          if (command == "READ_W") {
@@ -294,7 +300,7 @@ namespace Fd1d
          } else
          if (command == "COMPUTE") {
             // Solve the modified diffusion equation, without iteration
-            Log::file() << std::endl;
+            logFile() << std::endl;
             compute();
          } else
          if (command == "ITERATE") {
@@ -313,12 +319,12 @@ namespace Fd1d
          if (command == "COMPARE_HOMOGENEOUS") {
             int mode;
             inBuffer >> mode;
-            Log::file() << std::endl;
-            Log::file() << "mode       = " << mode << std::endl;
+            logFile() << std::endl;
+            logFile() << "mode       = " << mode << std::endl;
 
             HomogeneousComparison comparison(*this);
             comparison.compute(mode);
-            comparison.output(mode, Log::file());
+            comparison.output(mode, logFile());
          } else 
          if (command == "WRITE_W") {
             readEcho(inBuffer, filename);
@@ -349,37 +355,37 @@ namespace Fd1d
          if (command == "WRITE_VERTEX_Q") {
             int polymerId, vertexId;
             inBuffer >> polymerId;
-            Log::file() << std::endl;
-            Log::file() << "polymerId = " 
-                        << Int(polymerId, 5) << std::endl;
+            logFile() << std::endl;
+            logFile() << "polymerId = " 
+                      << Int(polymerId, 5) << std::endl;
             inBuffer >> vertexId;
-            Log::file() << "vertexId  = " 
-                        << Int(vertexId, 5) << std::endl;
+            logFile() << "vertexId  = " 
+                      << Int(vertexId, 5) << std::endl;
             inBuffer >> filename;
-            Log::file() << "outfile   = " 
-                        << Str(filename, 20) << std::endl;
+            logFile() << "outfile   = " 
+                      << Str(filename, 20) << std::endl;
             fieldIo_.writeVertexQ(mixture_, polymerId, vertexId, filename);  
          } else
          if (command == "REMESH_W") {
             int nx;
             inBuffer >> nx;
-            Log::file() << std::endl;
-            Log::file() << "nx      = " << Int(nx, 20) << std::endl;
+            logFile() << std::endl;
+            logFile() << "nx      = " << Int(nx, 20) << std::endl;
             inBuffer >> filename;
-            Log::file() << "outfile = " << Str(filename, 20) << std::endl;
+            logFile() << "outfile = " << Str(filename, 20) << std::endl;
             fieldIo_.remesh(wFields(), nx, filename);
          } else
          if (command == "EXTEND_W") {
             int m;
             inBuffer >> m;
-            Log::file() << std::endl;
-            Log::file() << "m       = " << Int(m, 20) << std::endl;
+            logFile() << std::endl;
+            logFile() << "m       = " << Int(m, 20) << std::endl;
             inBuffer >> filename;
-            Log::file() << "outfile = " << Str(filename, 20) << std::endl;
+            logFile() << "outfile = " << Str(filename, 20) << std::endl;
             fieldIo_.extend(wFields(), m, filename);
          } else {
-            Log::file() << "  Error: Unknown command  " 
-                        << command << std::endl;
+            logFile() << "  Error: Unknown command  " 
+                      << command << std::endl;
             readNext = false;
          }
 
@@ -403,7 +409,7 @@ namespace Fd1d
    void System::readEcho(std::istream& in, std::string& string) const
    {
       in >> string;
-      Log::file() << "  " << Str(string, 20) << std::endl;
+      logFile() << "  " << Str(string, 20) << std::endl;
    }
 
    // Primary SCFT Computations
@@ -429,7 +435,7 @@ namespace Fd1d
       // UTIL_CHECK(hasWFields_);
       // hasCFields_ = false;
 
-      Log::file() << std::endl;
+      logFile() << std::endl;
 
       // Call iterator (return 0 for convergence, 1 for failure)
       int error = iterator().solve(isContinuation);
@@ -439,7 +445,7 @@ namespace Fd1d
       // If converged, compute related properties
       if (!error) {   
          computeFreeEnergy();
-         writeThermo(Log::file());
+         writeThermo(logFile());
       }
       return error;
    }
@@ -451,8 +457,8 @@ namespace Fd1d
    {
       //UTIL_CHECK(hasWFields_);
       UTIL_CHECK(sweepPtr_);
-      Log::file() << std::endl;
-      Log::file() << std::endl;
+      logFile() << std::endl;
+      logFile() << std::endl;
 
       sweepPtr_->sweep();
    }
@@ -509,7 +515,7 @@ namespace Fd1d
       }
 
       // Add average interaction free energy density per monomer
-      int nx = domain().nx();
+      int nx = domain().nGrid();
       if (!f_.isAllocated()) f_.allocate(nx);
       if (!c_.isAllocated()) c_.allocate(nm);
       int j;
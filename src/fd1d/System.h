@@ -14,6 +14,7 @@
 #include <fd1d/domain/Domain.h>            // member
 #include <pscf/homogeneous/Mixture.h>      // member
 #include <util/misc/FileMaster.h>          // member
+#include <util/misc/Log.h>                 // default log stream
 #include <util/containers/DArray.h>        // member template
 #include <util/containers/Array.h>         // function parameter
 
@@ -330,6 +331,27 @@ namespace Fd1d
       */
       FileMaster& fileMaster();
 
+      /**
+      * Set the stream to which this System writes log output.
+      *
+      * By default, log output is written to the global Log::file(). 
+      * Systems that run concurrently in separate threads should each
+      * be given their own log stream. The stream must outlive this 
+      * System, or be replaced before it is destroyed.
+      *
+      * Util::Memory allocation counters, parameter echo (-e option) and
+      * some warnings still use process-wide state, as described for 
+      * Pspc::System::setLogFile.
+      *
+      * \param out  output stream for log output
+      */
+      void setLogFile(std::ostream& out);
+
+      /**
+      * Get the stream to which this System writes log output.
+      */
+      std::ostream& logFile() const;
+
       ///@}
 
    private:
@@ -349,6 +371,11 @@ namespace Fd1d
       */
       FileMaster fileMaster_;
 
+      /**
+      * Pointer to log stream (null if Log::file() is used).
+      */
+      std::ostream* logFilePtr_;
+
       /**
       * FieldIo (field input-output operations).
       */
@@ -520,6 +547,18 @@ namespace Fd1d
    inline FileMaster& System::fileMaster()
    {  return fileMaster_; }
 
+   /*
+   * Set the log stream.
+   */
+   inline void System::setLogFile(std::ostream& out)
+   {  logFilePtr_ = &out; }
+
+   /*
+   * Get the log stream.
+   */
+   inline std::ostream& System::logFile() const
+   {  return logFilePtr_ ? *logFilePtr_ : Log::file(); }
+
    /*
    * Get an array of all monomer excess chemical potential fields.
    */
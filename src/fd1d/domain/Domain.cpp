@@ -18,6 +18,10 @@ namespace Fd1d
       dx_(0.0),
       volume_(0.0),
       nx_(0),
+      yMin_(0.0),
+      yMax_(0.0),
+      dy_(0.0),
+      ny_(1),
       mode_(Planar),
       isShell_(false)
    {  setClassName("Domain"); }
@@ -42,6 +46,21 @@ namespace Fd1d
       read(in, "xMax", xMax_);
       read(in, "nx", nx_);
       dx_ = (xMax_ - xMin_)/double(nx_ - 1);
+
+      // Optional second (planar) coordinate y
+      yMin_ = 0.0;
+      ny_ = 1;
+      readOptional(in, "yMin", yMin_);
+      bool is2D = readOptional(in, "yMax", yMax_).isActive();
+      if (is2D) {
+         read(in, "ny", ny_);
+         UTIL_CHECK(ny_ > 1);
+         UTIL_CHECK(yMax_ > yMin_);
+         if (mode_ == Spherical) {
+            UTIL_THROW("A 2D domain must be planar or cylindrical");
+         }
+         dy_ = (yMax_ - yMin_)/double(ny_ - 1);
+      }
       computeVolume();
    }
 
@@ -52,6 +71,7 @@ namespace Fd1d
       xMin_ = xMin;
       xMax_ = xMax;
       nx_ = nx;
+      ny_ = 1;
       dx_ = (xMax_ - xMin_)/double(nx_ - 1);
       computeVolume();
    }
@@ -64,6 +84,7 @@ namespace Fd1d
       xMin_ = xMin;
       xMax_ = xMax;
       nx_ = nx;
+      ny_ = 1;
       dx_ = (xMax_ - xMin_)/double(nx_ - 1);
       computeVolume();
    }
@@ -75,6 +96,7 @@ namespace Fd1d
       xMin_ = 0.0;
       xMax_ = xMax;
       nx_ = nx;
+      ny_ = 1;
       dx_ = xMax_/double(nx_ - 1);
       computeVolume();
    }
@@ -86,10 +108,25 @@ namespace Fd1d
       xMin_ = 0.0;
       xMax_ = xMax;
       nx_ = nx;
+      ny_ = 1;
       dx_ = xMax_/double(nx_ - 1);
       computeVolume();
    }
 
+   void Domain::setYParameters(double yMin, double yMax, int ny)
+   {
+      UTIL_CHECK(ny > 1);
+      UTIL_CHECK(yMax > yMin);
+      if (mode_ == Spherical) {
+         UTIL_THROW("A 2D domain must be planar or cylindrical");
+      }
+      yMin_ = yMin;
+      yMax_ = yMax;
+      ny_ = ny;
+      dy_ = (yMax_ - yMin_)/double(ny_ - 1);
+      computeVolume();
+   }
+
    void Domain::computeVolume()
    {
       if (mode_ == Planar) {
@@ -111,6 +148,38 @@ namespace Fd1d
       } else {
          UTIL_THROW("Invalid geometry mode");
       }
+      if (ny_ > 1) {
+         volume_ *= yMax_ - yMin_;
+      }
+   }
+
+   /*
+   * Integration weight for grid point i along x, used for 2D domains.
+   *
+   * Weights are those used for 1D spatial averages below: trapezoidal
+   * for planar coordinates, and trapezoidal with a factor of r/dx for
+   * cylindrical coordinates (with weight 1/8 for the point at r = 0).
+   */
+   double Domain::xWeight(int i) const
+   {
+      double weight = 1.0;
+      if (mode_ == Planar) {
+         if (i == 0 || i == nx_ - 1) weight = 0.5;
+      } else
+      if (mode_ == Cylindrical) {
+         double x = xMin_/dx_ + double(i);
+         if (i == 0 && !isShell_) {
+            weight = 1.0/8.0;
+         } else
+         if (i == 0 || i == nx_ - 1) {
+            weight = 0.5*x;
+         } else {
+            weight = x;
+         }
+      } else {
+         UTIL_THROW("Invalid geometry mode for 2D domain");
+      }
+      return weight;
    }
 
    /*
@@ -121,10 +190,26 @@ namespace Fd1d
       UTIL_CHECK(nx_ > 1);
       UTIL_CHECK(dx_ > 0.0);
       UTIL_CHECK(xMax_ - xMin_ >=  dx_);
-      UTIL_CHECK(nx_ == f.capacity());
+      UTIL_CHECK(nx_*ny_ == f.capacity());
 
       double sum = 0.0;
       double norm = 0.0;
+      if (ny_ > 1) {
+
+         // Two-dimensional domain: product of 1D trapezoidal weights
+         double wx, wy, weight;
+         int i, j;
+         for (j = 0; j < ny_; ++j) {
+            wy = (j == 0 || j == ny_ - 1) ? 0.5 : 1.0;
+            for (i = 0; i < nx_; ++i) {
+               wx = xWeight(i);
+               weight = wx*wy;
+               sum += weight*f[i + nx_*j];
+               norm += weight;
+            }
+         }
+
+      } else
       if (mode_ == Planar) {
 
          sum += 0.5*f[0];
@@ -202,16 +287,17 @@ namespace Fd1d
    {
       // Preconditions
       UTIL_CHECK(nx_ > 1);
-      UTIL_CHECK(nx_ == f.capacity());
-      UTIL_CHECK(nx_ == g.capacity());
+      int nGrid = nx_*ny_;
+      UTIL_CHECK(nGrid == f.capacity());
+      UTIL_CHECK(nGrid == g.capacity());
       if (!work_.isAllocated()) {
-         work_.allocate(nx_);
+         work_.allocate(nGrid);
       } else {
-         UTIL_ASSERT(nx_ == work_.capacity());
+         UTIL_ASSERT(nGrid == work_.capacity());
       } 
 
       // Compute average of f(x)*g(x)
-      for (int i = 0; i < nx_; ++i) {
+      for (int i = 0; i < nGrid; ++i) {
          work_[i] = f[i]*g[i];
       }
       return spatialAverage(work_);
@@ -18,7 +18,17 @@ namespace Fd1d {
    using namespace Util;
 
    /**
-   * One-dimensional spatial domain and discretization grid.
+   * One- or two-dimensional spatial domain and discretization grid.
+   *
+   * By default the domain is one-dimensional, with a coordinate x that
+   * may be planar, cylindrical or spherical. If the optional parameters 
+   * yMax and ny are present, the domain is a two-dimensional region
+   * with a second, planar coordinate y: a rectangle (x,y) if the mode 
+   * is planar, or an axisymmetric region (r,z) with r = x and z = y if 
+   * the mode is cylindrical. Fields on a 2D grid are stored in arrays 
+   * of nGrid() = nx()*ny() elements, in which the element for grid 
+   * point (i, j) has index i + nx()*j. 
+   *
    *
    * \ref fd1d_Domain_page "Parameter File Format"
    * \ingroup Fd1d_Domain_Module
@@ -88,6 +98,20 @@ namespace Fd1d {
       */
       void setSphereParameters(double xMax, int nx);
 
+      /**
+      * Add a second, planar coordinate y to a planar or cylindrical domain.
+      *
+      * This should be called after the parameters of the x coordinate
+      * are set. The resulting domain is a rectangle if the mode is planar,
+      * or a finite axisymmetric cylinder or annulus (r,z) if the mode is 
+      * cylindrical. 
+      *
+      * \param yMin  minimum y coordinate value
+      * \param yMax  maximum y coordinate value
+      * \param ny  number of grid points in y, including endpoints
+      */
+      void setYParameters(double yMin, double yMax, int ny);
+
       ///@}
       /// \name Accessors
       ///@{
@@ -116,10 +140,42 @@ namespace Fd1d {
       double dx() const;
 
       /**
-      * Get number of spatial grid points, including both endpoints.
+      * Get number of spatial grid points in x, including both endpoints.
       */
       int nx() const;
 
+      /**
+      * Get minimum y coordinate (2D domains only).
+      */
+      double yMin() const;
+
+      /**
+      * Get maximum y coordinate (2D domains only).
+      */
+      double yMax() const;
+
+      /**
+      * Get grid step size in y (2D domains only).
+      */
+      double dy() const;
+
+      /**
+      * Get number of grid points in y (equal to 1 for 1D domains).
+      */
+      int ny() const;
+
+      /**
+      * Get total number of grid points, nx()*ny().
+      *
+      * This is the number of elements in each field.
+      */
+      int nGrid() const;
+
+      /**
+      * Is this a two-dimensional domain?
+      */
+      bool is2D() const;
+
       /**
       * Get coordinate system flag (Planar, Cylindrical or Spherical).
       */
@@ -186,6 +242,26 @@ namespace Fd1d {
       */
       int nx_;
 
+      /**
+      * Lower bound of y coordinate (2D only).
+      */
+      double yMin_;
+
+      /**
+      * Upper bound of y coordinate (2D only).
+      */
+      double yMax_;
+
+      /**
+      * Grid step in y (2D only).
+      */
+      double dy_;
+
+      /**
+      * Number of grid points in y (= 1 for 1D domains).
+      */
+      int ny_;
+
       /**
       * Coordinate system flag (=Planar, Cylindrical, or Spherical).
       */
@@ -206,6 +282,14 @@ namespace Fd1d {
       */
       void computeVolume();
 
+      /**
+      * Trapezoidal integration weight for grid point i along x.
+      *
+      * Includes the radial factor for cylindrical coordinates, in
+      * units of dx. Used for 2D domains.
+      */
+      double xWeight(int i) const;
+
    };
 
    // Inline member functions
@@ -222,6 +306,24 @@ namespace Fd1d {
    inline double Domain::xMax() const
    {  return xMax_; }
 
+   inline double Domain::yMin() const
+   {  return yMin_; }
+
+   inline double Domain::yMax() const
+   {  return yMax_; }
+
+   inline double Domain::dy() const
+   {  return dy_; }
+
+   inline int Domain::ny() const
+   {  return ny_; }
+
+   inline int Domain::nGrid() const
+   {  return nx_*ny_; }
+
+   inline bool Domain::is2D() const
+   {  return (ny_ > 1); }
+
    inline double Domain::volume() const
    {  return volume_; }
 
@@ -135,7 +135,7 @@ namespace Fd1d{
    int AmIterator::nElements()
    {
       const int nm = system().mixture().nMonomer(); // # of monomers
-      const int nx = domain().nx();                 // # of grid points
+      const int nx = domain().nGrid();                 // # of grid points
       return nm*nx;
    }
 
@@ -143,7 +143,7 @@ namespace Fd1d{
    void AmIterator::getCurrent(DArray<double>& curr)
    {
       const int nm = system().mixture().nMonomer();  // # of monomers
-      const int nx =  domain().nx();                 // # of grid points
+      const int nx =  domain().nGrid();                 // # of grid points
       const DArray< DArray<double> > * currSys = &system().wFields();
 
       // Straighten out fields into linear arrays
@@ -196,7 +196,7 @@ namespace Fd1d{
    void AmIterator::getResidual(DArray<double>& resid)
    {
       const int nm = system().mixture().nMonomer();
-      const int nx = domain().nx();
+      const int nx = domain().nGrid();
       const int nr = nm*nx;
 
        // Initialize residuals
@@ -227,7 +227,7 @@ namespace Fd1d{
    void AmIterator::update(DArray<double>& newGuess)
    {
       const int nm = mixture().nMonomer();  // # of monomers
-      const int nx = domain().nx();         // # of grid points
+      const int nx = domain().nGrid();         // # of grid points
 
       // Set current w fields in system
       // If canonical, shift to as to set last element to zero
@@ -250,5 +250,11 @@ namespace Fd1d{
    void AmIterator::outputToLog()
    {}
 
+   /*
+   * Get the log stream of the parent system.
+   */
+   std::ostream& AmIterator::logFile() const
+   {  return system().logFile(); }
+
 }
 }
@@ -66,6 +66,11 @@ namespace Fd1d
       */
       void setup(bool isContinuation);
 
+      /**
+      * Get the log stream of the parent system.
+      */
+      std::ostream& logFile() const;
+
    private:
 
       // Local copy of interaction, adapted for use AMBD residual definition
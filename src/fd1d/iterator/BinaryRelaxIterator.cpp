@@ -35,7 +35,7 @@ namespace Fd1d
    // Read parameter file block and allocate memory
    void BinaryRelaxIterator::readParameters(std::istream& in)
    {
-      UTIL_CHECK(domain().nx() > 0);
+      UTIL_CHECK(domain().nGrid() > 0);
       read(in, "epsilon", epsilon_);
       read(in, "maxIter", maxItr_);
       read(in, "lambdaPlus", lambdaPlus_);
@@ -50,7 +50,7 @@ namespace Fd1d
       if (isAllocated_) return;
       int nm = mixture().nMonomer();  // number of monomer types
       UTIL_CHECK(nm == 2);
-      int nx = domain().nx();         // number of grid points
+      int nx = domain().nGrid();         // number of grid points
       UTIL_CHECK(nx > 0);
       cArray_.allocate(nm);
       wArray_.allocate(nm);
@@ -77,7 +77,7 @@ namespace Fd1d
       double dWmNorm = 0.0;
       double dWpNorm = 0.0;
       double chi = system().interaction().chi(0,1);
-      int nx = domain().nx();        // number of grid points
+      int nx = domain().nGrid();        // number of grid points
       //For AB diblok
       for (int i = 0; i < nx; ++i) {
          c0 = cFields[0][i];
@@ -104,7 +104,7 @@ namespace Fd1d
    {
       int nm = mixture().nMonomer();  // number of monomer types
       UTIL_CHECK(nm == 2);
-      int nx = domain().nx();        // number of grid points
+      int nx = domain().nGrid();        // number of grid points
       int i;                         // monomer index
       int j;                         // grid point index
       double w0, w1;
@@ -137,7 +137,7 @@ namespace Fd1d
       int nm = mixture().nMonomer();  // number of monomer types
       UTIL_CHECK(nm == 2);
       int np = mixture().nPolymer();  // number of polymer species
-      int nx = domain().nx();         // number of grid points
+      int nx = domain().nGrid();         // number of grid points
       
       // Start overall timer 
       timerTotal.start();
@@ -174,7 +174,7 @@ namespace Fd1d
       // Iterative loop
       int i, j, k;
       for (i = 0; i < maxItr_; ++i) {
-         Log::file() << "iteration " << i
+         system().logFile() << "iteration " << i
          << " , error = " << dWNorm_
          << std::endl;
         
@@ -182,17 +182,17 @@ namespace Fd1d
             // Stop timers
             timerTotal.stop();
             
-            Log::file() << "The epsilon is " << epsilon_<< std::endl;
-            Log::file() << "Converged" << std::endl;
+            system().logFile() << "The epsilon is " << epsilon_<< std::endl;
+            system().logFile() << "Converged" << std::endl;
             system().computeFreeEnergy();
             // Success
-            Log::file() << "\n\n";
+            system().logFile() << "\n\n";
             // Output timing resultsl;
-            Log::file() << "Total time:                             "  
-                        << timerTotal.time()   << " s  "  << std::endl;
-            Log::file() << "Average time cost of each iteration:    "  
-                        << timerTotal.time()/i  << " s  " << std::endl;
-            Log::file() << "\n\n";
+            system().logFile() << "Total time:                             "  
+                               << timerTotal.time()   << " s  "  << std::endl;
+            system().logFile() << "Average time cost of each iteration:    "  
+                               << timerTotal.time()/i  << " s  " << std::endl;
+            system().logFile() << "\n\n";
             return 0;
          }
 
@@ -205,15 +205,15 @@ namespace Fd1d
          j = 0;
          while (dWNormNew_ > dWNorm_ && j < 3) {
             //double dWNormDecrease_;
-            Log::file() << "      error = " 
-                        << dWNormNew_ << ", decreasing increment" << std::endl;
+            system().logFile() << "      error = " << dWNormNew_ 
+                               << ", decreasing increment" << std::endl;
             lambdaPlus_ *= 0.5;
             lambdaMinus_ *= 0.5;
             //Print lambdaPlus_ and lambdaMinus_ 
-            Log::file() << "      lambdaPlus = " 
-                        << lambdaPlus_ << std::endl;
-            Log::file() << "      lambdaMinus = " 
-                        << lambdaMinus_<< std::endl;                        
+            system().logFile() << "      lambdaPlus = " 
+                               << lambdaPlus_ << std::endl;
+            system().logFile() << "      lambdaMinus = " 
+                               << lambdaMinus_<< std::endl;                        
             computeDW(system().wFields(),system().cFields(), dWNew_, 
                       dWNormNew_);
             updateWFields(system().wFields(), dWNew_, wFieldsNew_);
@@ -233,7 +233,7 @@ namespace Fd1d
             dWNorm_ = dWNormNew_;
             }
         } else {
-            Log::file() << "Iteration failed, norm = "
+            system().logFile() << "Iteration failed, norm = "
             << dWNormNew_ << std::endl;
             break;
           }
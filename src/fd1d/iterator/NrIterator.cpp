@@ -52,7 +52,7 @@ namespace Fd1d
    void NrIterator::setup()
    {
       int nm = system().mixture().nMonomer();   // number of monomer types
-      int nx = domain().nx(); // number of grid points
+      int nx = domain().nGrid(); // number of grid points
       UTIL_CHECK(nm > 0);
       UTIL_CHECK(nx > 0);
       int nr = nm*nx;                  // number of residual components
@@ -82,7 +82,7 @@ namespace Fd1d
                                     Array<double>& residual)
    {
       int nm = system().mixture().nMonomer();  // number of monomer types
-      int nx = domain().nx();         // number of grid points
+      int nx = domain().nGrid();         // number of grid points
       int i;                          // grid point index
       int j;                          // monomer indices
       int ir;                         // residual index
@@ -139,7 +139,7 @@ namespace Fd1d
    void NrIterator::computeJacobian()
    {
       int nm = system().mixture().nMonomer();   // number of monomer types
-      int nx = domain().nx();          // number of grid points
+      int nx = domain().nGrid();          // number of grid points
       int i;                           // monomer index
       int j;                           // grid point index
 
@@ -171,8 +171,8 @@ namespace Fd1d
          }
       }
 
-      // Decompose Jacobian matrix
-      solver_.computeLU(jacobian_);
+      // Decompose Jacobian matrix in place (jacobian_ is overwritten)
+      solver_.computeLUInPlace(jacobian_);
 
    }
 
@@ -181,7 +181,7 @@ namespace Fd1d
                                      Array<WField> & wNew)
    {
       int nm = system().mixture().nMonomer(); // number of monomers types
-      int nx = domain().nx();        // number of grid points
+      int nx = domain().nGrid();        // number of grid points
       int i;                         // monomer index
       int j;                         // grid point index
       int k = 0;                     // residual element index
@@ -209,7 +209,7 @@ namespace Fd1d
    double NrIterator::residualNorm(Array<double> const & residual) const
    {
       int nm = system().mixture().nMonomer();  // number of monomer types
-      int nx = domain().nx();         // number of grid points
+      int nx = domain().nGrid();         // number of grid points
       int nr = nm*nx;                 // number of residual components
       double value, norm;
       norm = 0.0;
@@ -226,7 +226,7 @@ namespace Fd1d
    {
       int nm = system().mixture().nMonomer();  // number of monomer types
       int np = system().mixture().nPolymer();  // number of polymer species
-      int nx = domain().nx();         // number of grid points
+      int nx = domain().nGrid();         // number of grid points
       int nr = nm*nx;                 // number of residual elements
 
       // Determine if isCanonical (iff all species ensembles are closed)
@@ -269,19 +269,19 @@ namespace Fd1d
       double normNew;
       int i, j, k;
       for (i = 0; i < maxItr_; ++i) {
-         Log::file() << "iteration " << i
-                     << " , error = " << norm
-                     << std::endl;
+         system().logFile() << "iteration " << i
+                            << " , error = " << norm
+                            << std::endl;
 
          if (norm < epsilon_) {
-            Log::file() << "Converged" << std::endl;
+            system().logFile() << "Converged" << std::endl;
             system().computeFreeEnergy();
             // Success
             return 0;
          }
 
          if (needsJacobian_) {
-            Log::file() << "Computing jacobian" << std::endl;;
+            system().logFile() << "Computing jacobian" << std::endl;;
             computeJacobian();
             newJacobian_ = true;
             needsJacobian_ = false;
@@ -299,8 +299,8 @@ namespace Fd1d
          // Decrease increment if necessary
          j = 0;
          while (normNew > norm && j < 3) {
-            Log::file() << "      decreasing increment,  error = "
-                        << normNew << std::endl;
+            system().logFile() << "      decreasing increment,  error = "
+                               << normNew << std::endl;
             needsJacobian_ = true;
             for (k = 0; k < nr; ++k) {
                dOmega_[k] *= 0.66666666;
@@ -314,8 +314,8 @@ namespace Fd1d
 
          // If necessary, try reversing direction
          if (normNew > norm) {
-            Log::file() << "      reversing increment,  norm = "
-                        << normNew << std::endl;
+            system().logFile() << "      reversing increment,  norm = "
+                               << normNew << std::endl;
             needsJacobian_ = true;
             for (k = 0; k < nr; ++k) {
                dOmega_[k] *= -1.000;
@@ -347,13 +347,13 @@ namespace Fd1d
             }
             norm = normNew;
          } else {
-            Log::file() << "Iteration failed, norm = "
+            system().logFile() << "Iteration failed, norm = "
                       << normNew << std::endl;
             if (newJacobian_) {
                return 1;
-               Log::file() << "Unrecoverable failure " << std::endl;
+               system().logFile() << "Unrecoverable failure " << std::endl;
             } else {
-               Log::file() << "Try rebuilding Jacobian" << std::endl;
+               system().logFile() << "Try rebuilding Jacobian" << std::endl;
                needsJacobian_ = true;
             }
          }
@@ -68,10 +68,17 @@ namespace Fd1d
       UTIL_CHECK(nx > 0);
       UTIL_CHECK(nx == domain().nx());
       in >> label;
+      int ny = 1;
+      if (label == "ny") {
+         in >> ny;
+         in >> label;
+      }
+      UTIL_CHECK(ny == domain().ny());
       UTIL_CHECK (label == "nm");
       int nm;
       in >> nm;
       UTIL_CHECK(nm > 0);
+      nx = nx*ny;
 
       // Check dimensions of fields array
       UTIL_CHECK(nm == fields.capacity());
@@ -104,13 +111,16 @@ namespace Fd1d
       int nm = fields.capacity();
       UTIL_CHECK(nm > 0);
       int nx = fields[0].capacity();
-      UTIL_CHECK(nx == domain().nx());
+      UTIL_CHECK(nx == domain().nGrid());
       if (nm > 1) {
          for (int i = 0; i < nm; ++i) {
             UTIL_CHECK(nx == fields[i].capacity());
          }
       }
-      out << "nx     "  <<  nx              << std::endl;
+      out << "nx     "  <<  domain().nx()   << std::endl;
+      if (domain().is2D()) {
+         out << "ny     "  <<  domain().ny()   << std::endl;
+      }
       out << "nm     "  <<  nm              << std::endl;
 
       // Write fields
@@ -138,12 +148,15 @@ namespace Fd1d
    */
    void FieldIo::writeBlockCFields(Mixture const & mixture, std::ostream& out)
    {
-      int nx = domain().nx();         // number grid points
+      int nx = domain().nGrid();      // number grid points
       int np = mixture.nPolymer();    // number of polymer species
       int nb_tot = mixture.nBlock();  // number of blocks in all polymers
       int ns = mixture.nSolvent();    // number of solvents
 
-      out << "nx          "  <<  nx       << std::endl;
+      out << "nx          "  <<  domain().nx() << std::endl;
+      if (domain().is2D()) {
+         out << "ny          "  <<  domain().ny() << std::endl;
+      }
       out << "n_block     "  <<  nb_tot   << std::endl;
       out << "n_solvent   "  <<  ns       << std::endl;
 
@@ -194,7 +207,7 @@ namespace Fd1d
       UTIL_CHECK(vertexId <= polymer.nBlock());
       Vertex const & vertex = polymer.vertex(vertexId);
       int nb = vertex.size();   // number of attached blocks
-      int nx = domain().nx();   // number grid points
+      int nx = domain().nGrid();   // number grid points
 
       Pair<int> pId;
       int bId;
@@ -239,6 +252,7 @@ namespace Fd1d
    FieldIo::remesh(DArray<Field> const & fields, int nx, std::ostream& out)
    {
       // Query and check dimensions of fields array
+      UTIL_CHECK(!domain().is2D());
       int nm = fields.capacity();
       UTIL_CHECK(nm > 0);
       for (int i = 0; i < nm; ++i) {
@@ -312,6 +326,7 @@ namespace Fd1d
    FieldIo::extend(DArray<Field> const & fields, int m, std::ostream& out)
    {
       // Query and check dimensions of fields array
+      UTIL_CHECK(!domain().is2D());
       int nm = fields.capacity();
       UTIL_CHECK(nm > 0);
       int nx = fields[0].capacity();
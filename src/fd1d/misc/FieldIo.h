@@ -53,6 +53,9 @@ namespace Fd1d {
       /**
       * Read a set of fields, one per monomer type.
       *
+      * The file header contains the number of grid points nx and, for
+      * a 2D domain, ny. Grid points are listed with index i + nx*j.
+      *
       * \pre File in must be open for reading.
       *
       * \param fields  array of fields to read, indexed by monomer id
@@ -143,6 +146,8 @@ namespace Fd1d {
       /**
       * Interpolate an array of fields onto a new mesh.
       *
+      * Only valid for 1D domains.
+      *
       * \param fields  field to be remeshed
       * \param nx  number of grid points in new mesh
       * \param out  output stream for remeshed field
@@ -162,6 +167,8 @@ namespace Fd1d {
       /**
       * Add points to the end of mesh
       *
+      * Only valid for 1D domains.
+      *
       * \param fields  array of fields to be extended
       * \param m  number of added grid points
       * \param out  output stream for extended field
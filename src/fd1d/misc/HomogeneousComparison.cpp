@@ -81,7 +81,7 @@ namespace Fd1d
          }
          int ix; // Grid index from which we obtain guess of composition
          if (mode == 1) {
-            ix = domain().nx() - 1;
+            ix = domain().nGrid() - 1;
          } else 
          if (mode == 2) {
             ix = 0;
@@ -52,17 +52,42 @@ namespace Fd1d
 
       // Allocate all required memory
       int nx = domain.nx();
-      dA_.allocate(nx);
-      dB_.allocate(nx);
-      uA_.allocate(nx - 1);
-      uB_.allocate(nx - 1);
-      lA_.allocate(nx - 1);
-      lB_.allocate(nx - 1);
-      v_.allocate(nx);
-      solver_.allocate(nx);
-      propagator(0).allocate(ns_, nx);
-      propagator(1).allocate(ns_, nx);
-      cField().allocate(nx);
+      int nGrid = domain.nGrid();
+      if (domain.is2D()) {
+         int ny = domain.ny();
+         dAx_.allocate(nGrid);
+         dAy_.allocate(nGrid);
+         uAx_.allocate(nx - 1);
+         lAx_.allocate(nx - 1);
+         uAy_.allocate(ny - 1);
+         lAy_.allocate(ny - 1);
+         dLx_.allocate(nx);
+         vx_.allocate(nx);
+         qx_.allocate(nx);
+         vy_.allocate(ny);
+         qy_.allocate(ny);
+         qStar_.allocate(nGrid);
+         solverX_.allocate(ny);
+         for (int j = 0; j < ny; ++j) {
+            solverX_[j].allocate(nx);
+         }
+         solverY_.allocate(nx);
+         for (int i = 0; i < nx; ++i) {
+            solverY_[i].allocate(ny);
+         }
+      } else {
+         dA_.allocate(nx);
+         dB_.allocate(nx);
+         uA_.allocate(nx - 1);
+         uB_.allocate(nx - 1);
+         lA_.allocate(nx - 1);
+         lB_.allocate(nx - 1);
+         v_.allocate(nx);
+         solver_.allocate(nx);
+      }
+      propagator(0).allocate(ns_, nGrid);
+      propagator(1).allocate(ns_, nGrid);
+      cField().allocate(nGrid);
    }
 
    void Block::setLength(double newLength)
@@ -121,6 +146,13 @@ namespace Fd1d
    {
       // Preconditions
       UTIL_CHECK(domainPtr_);
+      UTIL_CHECK(ns_ > 0);
+      UTIL_CHECK(propagator(0).isAllocated());
+      UTIL_CHECK(propagator(1).isAllocated());
+      if (domain().is2D()) {
+         setupSolver2D(w);
+         return;
+      }
       int nx = domain().nx();
       UTIL_CHECK(nx > 0);
       UTIL_CHECK(dA_.capacity() == nx);
@@ -129,9 +161,6 @@ namespace Fd1d
       UTIL_CHECK(dB_.capacity() == nx);
       UTIL_CHECK(uB_.capacity() == nx - 1);
       UTIL_CHECK(lB_.capacity() == nx - 1);
-      UTIL_CHECK(ns_ > 0);
-      UTIL_CHECK(propagator(0).isAllocated());
-      UTIL_CHECK(propagator(1).isAllocated());
 
       // Set step size (in case block length has changed)
       ds_ = length()/double(ns_ - 1);
@@ -146,22 +175,141 @@ namespace Fd1d
       double dx = domain().dx();
       double db = kuhn()/dx;
       double c1 = halfDs*db*db/6.0;
+      addLaplacian(domain().mode(), c1, dA_, uA_, lA_);
+
+      // Construct matrix B - 1
+      for (int i = 0; i < nx; ++i) {
+         dB_[i] = -dA_[i];
+      }
+      for (int i = 0; i < nx - 1; ++i) {
+         uB_[i] = -uA_[i];
+      }
+      for (int i = 0; i < nx - 1; ++i) {
+         lB_[i] = -lA_[i];
+      }
+
+      // Add diagonal identity terms to matrices A and B
+      for (int i = 0; i < nx; ++i) {
+         dA_[i] += 1.0;
+         dB_[i] += 1.0;
+      }
+
+      // Compute the LU decomposition of matrix A 
+      solver_.computeLU(dA_, uA_, lA_);
+   }
+
+   /*
+   * Setup the alternating direction implicit (ADI) algorithm for a 2D
+   * domain.
+   *
+   * The operator H = -(b^2/6)nabla^2 + w is split as H = Hx + Hy, with
+   * Hx = -(b^2/6)d^2/dx^2 + w/2 and Hy = -(b^2/6)d^2/dy^2 + w/2, where 
+   * d^2/dx^2 is replaced by the radial part of the Laplacian in an 
+   * axisymmetric (r,z) domain. Each step is a Peaceman-Rachford pair
+   * of half steps:
+   *
+   *     (1 + 0.5*ds_*Hx) q* = (1 - 0.5*ds_*Hy) q(i)
+   *     (1 + 0.5*ds_*Hy) q(i+1) = (1 - 0.5*ds_*Hx) q*
+   *
+   * which is second order accurate in ds_, like the Crank-Nicholson
+   * algorithm used in 1D, and requires only the solution of tridiagonal
+   * systems along lines of constant y (first half step) or constant x 
+   * (second half step). 
+   *
+   * Matrices Ax = 1 + 0.5*ds_*Hx and Ay = 1 + 0.5*ds_*Hy are stored as 
+   * diagonals dAx_ and dAy_ with one element per grid point, and as
+   * off-diagonal arrays that are shared by all lines. The corresponding
+   * explicit operators are applied as 1 - 0.5*ds_*Hx = 2 - Ax, etc.
+   * Each line has its own TridiagonalSolver, because the diagonal of
+   * each matrix depends on w along that line.
+   */
+   void Block::setupSolver2D(DArray<double> const& w)
+   {
+      int nx = domain().nx();
+      int ny = domain().ny();
+      UTIL_CHECK(dAx_.capacity() == nx*ny);
+      UTIL_CHECK(dAy_.capacity() == nx*ny);
+      UTIL_CHECK(solverX_.capacity() == ny);
+      UTIL_CHECK(solverY_.capacity() == nx);
+
+      // Set step size (in case block length has changed)
+      ds_ = length()/double(ns_ - 1);
+      double halfDs = 0.5*ds_;
+      double b2 = kuhn()*kuhn()/6.0;
+      int i, j, k;
+
+      // Second derivative terms along x, common to all lines
+      double cx = halfDs*b2/(domain().dx()*domain().dx());
+      for (i = 0; i < nx; ++i) {
+         dLx_[i] = 0.0;
+      }
+      addLaplacian(domain().mode(), cx, dLx_, uAx_, lAx_);
+
+      // Second derivative terms along y (always planar)
+      double cy = halfDs*b2/(domain().dy()*domain().dy());
+      for (j = 0; j < ny; ++j) {
+         vy_[j] = 0.0;
+      }
+      addLaplacian(Planar, cy, vy_, uAy_, lAy_);
+
+      // Diagonal elements of Ax and Ay, with half of w in each
+      double quarterDs = 0.5*halfDs;
+      for (j = 0; j < ny; ++j) {
+         for (i = 0; i < nx; ++i) {
+            k = i + nx*j;
+            dAx_[k] = 1.0 + quarterDs*w[k] + dLx_[i];
+            dAy_[k] = 1.0 + quarterDs*w[k] + vy_[j];
+         }
+      }
+
+      // LU decompositions of Ax along each line of constant y
+      for (j = 0; j < ny; ++j) {
+         for (i = 0; i < nx; ++i) {
+            vx_[i] = dAx_[i + nx*j];
+         }
+         solverX_[j].computeLU(vx_, uAx_, lAx_);
+      }
+
+      // LU decompositions of Ay along each line of constant x
+      for (i = 0; i < nx; ++i) {
+         for (j = 0; j < ny; ++j) {
+            vy_[j] = dAy_[i + nx*j];
+         }
+         solverY_[i].computeLU(vy_, uAy_, lAy_);
+      }
+   }
+
+   /*
+   * Add finite difference second derivative terms along x to the 
+   * diagonal d and set off-diagonals u and l of a tridiagonal matrix.
+   *
+   * Terms are multiplied by c1 = 0.5*ds*(b/dx)^2/6, and include radial
+   * factors for cylindrical and spherical coordinates. Neumann (zero
+   * slope) boundary conditions are imposed at both ends.
+   */
+   void Block::addLaplacian(GeometryMode mode, double c1,
+                            DArray<double>& d, DArray<double>& u, 
+                            DArray<double>& l) const
+   {
+      int nx = d.capacity();
+      UTIL_CHECK(u.capacity() == nx - 1);
+      UTIL_CHECK(l.capacity() == nx - 1);
       double c2 = 2.0*c1;
-      GeometryMode mode = domain().mode();
       if (mode == Planar) {
 
-         dA_[0] += c2;
-         uA_[0] = -c2;
+         d[0] += c2;
+         u[0] = -c2;
          for (int i = 1; i < nx - 1; ++i) {
-            dA_[i] += c2;
-            uA_[i] = -c1;
-            lA_[i-1] = -c1;
+            d[i] += c2;
+            u[i] = -c1;
+            l[i-1] = -c1;
          }
-         dA_[nx - 1] += c2;
-         lA_[nx - 2] = -c2;
+         d[nx - 1] += c2;
+         l[nx - 2] = -c2;
 
       } else {
 
+         double dx = domain().dx();
          double xMin = domain().xMin();
          double xMax = domain().xMax();
          double halfDx = 0.5*dx;
@@ -185,8 +333,8 @@ namespace Fd1d
             }
          }
          rp *= c1;
-         dA_[0] += 2.0*rp;
-         uA_[0] = -2.0*rp;
+         d[0] += 2.0*rp;
+         u[0] = -2.0*rp;
 
          // Interior rows
          for (int i = 1; i < nx - 1; ++i) {
@@ -199,9 +347,9 @@ namespace Fd1d
             }
             rm *= c1;
             rp *= c1;
-            dA_[i] += rm + rp;
-            uA_[i] = -rp;
-            lA_[i-1] = -rm;
+            d[i] += rm + rp;
+            u[i] = -rp;
+            l[i-1] = -rm;
          }
 
          // Last row: x = xMax
@@ -210,29 +358,9 @@ namespace Fd1d
             rm *= rm;
          }
          rm *= c1;
-         dA_[nx-1] += 2.0*rm;
-         lA_[nx-2] = -2.0*rm;
-      }
-
-      // Construct matrix B - 1
-      for (int i = 0; i < nx; ++i) {
-         dB_[i] = -dA_[i];
-      }
-      for (int i = 0; i < nx - 1; ++i) {
-         uB_[i] = -uA_[i];
-      }
-      for (int i = 0; i < nx - 1; ++i) {
-         lB_[i] = -lA_[i];
+         d[nx-1] += 2.0*rm;
+         l[nx-2] = -2.0*rm;
       }
-
-      // Add diagonal identity terms to matrices A and B
-      for (int i = 0; i < nx; ++i) {
-         dA_[i] += 1.0;
-         dB_[i] += 1.0;
-      }
-
-      // Compute the LU decomposition of matrix A 
-      solver_.computeLU(dA_, uA_, lA_);
    }
 
    /*
@@ -241,20 +369,16 @@ namespace Fd1d
    void Block::computeConcentration(double prefactor)
    {
       // Preconditions
-      UTIL_CHECK(domain().nx() > 0);
+      UTIL_CHECK(domain().nGrid() > 0);
       UTIL_CHECK(ns_ > 0);
       UTIL_CHECK(ds_ > 0);
-      UTIL_CHECK(dA_.capacity() == domain().nx());
-      UTIL_CHECK(dB_.capacity() == domain().nx());
-      UTIL_CHECK(uA_.capacity() == domain().nx() -1);
-      UTIL_CHECK(uB_.capacity() == domain().nx() -1);
       UTIL_CHECK(propagator(0).isAllocated());
       UTIL_CHECK(propagator(1).isAllocated());
-      UTIL_CHECK(cField().capacity() == domain().nx()) 
+      UTIL_CHECK(cField().capacity() == domain().nGrid()) 
 
       // Initialize cField to zero at all points
       int i;
-      int nx = domain().nx();
+      int nx = domain().nGrid();
       for (i = 0; i < nx; ++i) {
          cField()[i] = 0.0;
       }
@@ -293,6 +417,10 @@ namespace Fd1d
    */
    void Block::step(DArray<double> const & q, DArray<double>& qNew)
    {
+      if (domain().is2D()) {
+         step2D(q, qNew);
+         return;
+      }
       int nx = domain().nx();
       v_[0] = dB_[0]*q[0] + uB_[0]*q[1];
       for (int i = 1; i < nx - 1; ++i) {
@@ -302,5 +430,52 @@ namespace Fd1d
       solver_.solve(v_, qNew);
    }
 
+   /*
+   * Propagate solution by one step on a 2D grid, using the ADI algorithm
+   * described in the documentation of setupSolver2D().
+   */
+   void Block::step2D(DArray<double> const & q, DArray<double>& qNew)
+   {
+      int nx = domain().nx();
+      int ny = domain().ny();
+      int i, j, k;
+
+      // First half step: implicit in x, explicit in y
+      for (j = 0; j < ny; ++j) {
+         for (i = 0; i < nx; ++i) {
+            k = i + nx*j;
+            vx_[i] = (2.0 - dAy_[k])*q[k];
+            if (j > 0) {
+               vx_[i] -= lAy_[j-1]*q[k - nx];
+            }
+            if (j < ny - 1) {
+               vx_[i] -= uAy_[j]*q[k + nx];
+            }
+         }
+         solverX_[j].solve(vx_, qx_);
+         for (i = 0; i < nx; ++i) {
+            qStar_[i + nx*j] = qx_[i];
+         }
+      }
+
+      // Second half step: implicit in y, explicit in x
+      for (i = 0; i < nx; ++i) {
+         for (j = 0; j < ny; ++j) {
+            k = i + nx*j;
+            vy_[j] = (2.0 - dAx_[k])*qStar_[k];
+            if (i > 0) {
+               vy_[j] -= lAx_[i-1]*qStar_[k - 1];
+            }
+            if (i < nx - 1) {
+               vy_[j] -= uAx_[i]*qStar_[k + 1];
+            }
+         }
+         solverY_[i].solve(vy_, qy_);
+         for (j = 0; j < ny; ++j) {
+            qNew[i + nx*j] = qy_[j];
+         }
+      }
+   }
+
 }
 }
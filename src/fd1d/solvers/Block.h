@@ -26,6 +26,10 @@ namespace Fd1d
    * Derived from BlockTmpl<Propagator>. A BlockTmpl<Propagator> has two 
    * Propagator members and is derived from BlockDescriptor.
    *
+   * The modified diffusion equation is solved by the Crank-Nicholson 
+   * algorithm in a 1D domain, and by a Peaceman-Rachford alternating
+   * direction implicit (ADI) algorithm in a 2D domain.
+   *
    * \ingroup Fd1d_Solver_Module
    */
    class Block : public BlockTmpl<Propagator>
@@ -128,6 +132,47 @@ namespace Fd1d
       /// Work vector
       DArray<double> v_;
 
+      // Members used only for 2D domains (ADI algorithm). Arrays dAx_ 
+      // and dAy_ contain diagonal elements of the matrices 
+      // Ax = 1 + 0.5*ds*Hx and Ay = 1 + 0.5*ds*Hy at every grid point. 
+      // Off-diagonal elements are the same for all lines.
+
+      /// Diagonal elements of matrix Ax (nGrid elements)
+      DArray<double> dAx_;
+
+      /// Diagonal elements of matrix Ay (nGrid elements)
+      DArray<double> dAy_;
+
+      /// Off-diagonal upper elements of matrix Ax
+      DArray<double> uAx_;
+
+      /// Off-diagonal lower elements of matrix Ax
+      DArray<double> lAx_;
+
+      /// Off-diagonal upper elements of matrix Ay
+      DArray<double> uAy_;
+
+      /// Off-diagonal lower elements of matrix Ay
+      DArray<double> lAy_;
+
+      /// Second derivative contribution to diagonal of Ax (nx elements)
+      DArray<double> dLx_;
+
+      /// Work vectors along x (nx elements)
+      DArray<double> vx_, qx_;
+
+      /// Work vectors along y (ny elements)
+      DArray<double> vy_, qy_;
+
+      /// Intermediate solution after first half step (nGrid elements)
+      DArray<double> qStar_;
+
+      /// Solvers for lines of constant y (ny solvers of size nx)
+      DArray<TridiagonalSolver> solverX_;
+
+      /// Solvers for lines of constant x (nx solvers of size ny)
+      DArray<TridiagonalSolver> solverY_;
+
       /// Pointer to associated Domain object.
       Domain const * domainPtr_;
 
@@ -140,6 +185,33 @@ namespace Fd1d
       /// Number of contour length steps = # grid points - 1.
       int ns_;
 
+      /**
+      * Set up ADI solver for a 2D domain.
+      *
+      * \param w  Chemical potential field (input)
+      */
+      void setupSolver2D(DArray<double> const & w);
+
+      /**
+      * Take one ADI step on a 2D domain.
+      *
+      * \param q  input slice of propagator
+      * \param qNew  output slice of propagator
+      */
+      void step2D(DArray<double> const & q, DArray<double>& qNew);
+
+      /**
+      * Add finite difference second derivative terms along x.
+      *
+      * \param mode  geometry mode (Planar for the y direction)
+      * \param c1  prefactor 0.5*ds*(b/dx)^2/6 
+      * \param d  diagonal elements (incremented)
+      * \param u  upper off-diagonal elements (set)
+      * \param l  lower off-diagonal elements (set)
+      */
+      void addLaplacian(GeometryMode mode, double c1, DArray<double>& d,
+                        DArray<double>& u, DArray<double>& l) const;
+
    };
 
    // Inline member functions
@@ -86,13 +86,13 @@ namespace Fd1d
                          DArray<Mixture::CField>& cFields)
    {
       UTIL_CHECK(domainPtr_);
-      UTIL_CHECK(domain().nx() > 0);
+      UTIL_CHECK(domain().nGrid() > 0);
       UTIL_CHECK(nMonomer() > 0);
       UTIL_CHECK(nPolymer() + nSolvent() > 0);
       UTIL_CHECK(wFields.capacity() == nMonomer());
       UTIL_CHECK(cFields.capacity() == nMonomer());
 
-      int nx = domain().nx();
+      int nx = domain().nGrid();
       int nm = nMonomer();
       int i, j, k;
 
@@ -37,6 +37,10 @@ namespace Fd1d
    void Polymer::compute(DArray<Block::WField> const & wFields)
    {
 
+      if (hasMergedArms()) {
+         UTIL_THROW("Option mergeArms is not supported by this program");
+      }
+
       // Setup solvers for all blocks
       int monomerId;
       for (int j = 0; j < nBlock(); ++j) {
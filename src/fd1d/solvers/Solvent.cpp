@@ -27,7 +27,7 @@ namespace Fd1d {
    void Solvent::setDiscretization(Domain const & domain)
    {
       domainPtr_ = &domain;
-      int nx = domain.nx();
+      int nx = domain.nGrid();
       if (nx > 0) {
          cField_.allocate(nx);
       }
@@ -41,7 +41,7 @@ namespace Fd1d {
       UTIL_CHECK(cField_.isAllocated());
 
       // Evaluate unnormalized concentration, Boltzmann weight
-      int nx = domain().nx();
+      int nx = domain().nGrid();
       double s = size();
       for (int i = 0; i < nx; ++i) {
           cField_[i] = exp(-s*wField[i]);
@@ -50,6 +50,9 @@ namespace Fd1d
    void Sweep::readParameters(std::istream& in)
    {
       Base::readParameters(in);
+      if (looseEpsilon_ > 0.0) {
+         UTIL_THROW("Parameter looseEpsilon is not supported by this sweep");
+      }
       homogeneousMode_ = -1; // default value
       readOptional<int>(in, "homogeneousMode", homogeneousMode_);
    }
@@ -60,7 +63,7 @@ namespace Fd1d
    void Sweep::checkAllocation(Sweep::State& state) 
    {
       int nm = mixture().nMonomer();
-      int nx = domain().nx();
+      int nx = domain().nGrid();
       UTIL_CHECK(nm > 0);
       UTIL_CHECK(nx > 0);
 
@@ -92,7 +95,7 @@ namespace Fd1d
       // Open log summary file
       std::string fileName = baseFileName_;
       fileName += "log";
-      fileMaster().openOutputFile(fileName, logFile_);
+      fileMaster().openOutputFile(fileName, sweepLog_);
 
    };
 
@@ -112,7 +115,7 @@ namespace Fd1d
    void Sweep::extrapolate(double sNew) 
    {
       int nm = mixture().nMonomer();
-      int nx = domain().nx();
+      int nx = domain().nGrid();
       UTIL_CHECK(nm > 0);
       UTIL_CHECK(nx > 0);
 
@@ -180,7 +183,7 @@ namespace Fd1d
       outputSolution(fileName);
 
       // Output brief summary to log file
-      outputSummary(logFile_);
+      outputSummary(sweepLog_);
    };
 
    void Sweep::outputSolution(std::string const & fileName)
@@ -237,14 +240,20 @@ namespace Fd1d
    }
 
    void Sweep::cleanup()
-   {  logFile_.close(); }
+   {  sweepLog_.close(); }
+
+   /*
+   * Get the log stream of the parent system.
+   */
+   std::ostream& Sweep::logFile() const
+   {  return system().logFile(); }
 
    void Sweep::assignFields(DArray<System::Field>& lhs,
                             DArray<System::Field> const & rhs) const
    {
 
       int nm = mixture().nMonomer();
-      int nx = domain().nx();
+      int nx = domain().nGrid();
 
       UTIL_CHECK(lhs.capacity() == nm);
       UTIL_CHECK(rhs.capacity() == nm);
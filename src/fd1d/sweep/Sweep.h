@@ -130,6 +130,11 @@ namespace Fd1d
       */
       virtual void cleanup();
 
+      /**
+      * Get the log stream of the parent system.
+      */
+      virtual std::ostream& logFile() const;
+
    private:
 
       /// Algorithm for comparing to a homogeneous system
@@ -138,8 +143,8 @@ namespace Fd1d
       /// FieldIo object for writing output files
       FieldIo fieldIo_;
 
-      /// Summary log file
-      std::ofstream logFile_;
+      /// Sweep summary file (sweep.log), distinct from logFile()
+      std::ofstream sweepLog_;
 
       /// Assign state rhs = lhs
       void assignFields(State& lhs, State const & rhs) const;
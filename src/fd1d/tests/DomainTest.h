@@ -219,6 +219,42 @@ public:
       TEST_ASSERT(std::abs(computed - predicted) < 1.0E-4);
    }
 
+   void testPlanar2DAverageLinear()
+   {
+      printMethod(TEST_FUNC);
+
+      // Create and initialize Domain
+      int nx = 41;
+      int ny = 21;
+      double xMax = 1.7;
+      double yMax = 0.9;
+      double dx = xMax/double(nx-1);
+      double dy = yMax/double(ny-1);
+
+      Domain domain;
+      domain.setPlanarParameters(0.0, xMax, nx);
+      domain.setYParameters(0.0, yMax, ny);
+      TEST_ASSERT(domain.nGrid() == nx*ny);
+      TEST_ASSERT(eq(domain.volume(), xMax*yMax));
+
+      DArray<double> f;
+      f.allocate(nx*ny);
+      double A = 0.3;
+      double B = 0.7;
+      for (int j=0; j < ny; ++j) {
+         for (int i=0; i < nx; ++i) {
+            f[i + nx*j] = A*dx*double(i) + B*dy*double(j);
+         }
+      }
+      double computed  = domain.spatialAverage(f);
+      double predicted = 0.5*(A*xMax + B*yMax);
+      if (verbose() > 0) {
+         std::cout << "\n computed   = " << computed;
+         std::cout << "\n predicted  = " << predicted;
+      }
+      TEST_ASSERT(eq(computed, predicted));
+   }
+
 };
 
 TEST_BEGIN(DomainTest)
@@ -232,6 +268,7 @@ TEST_ADD(DomainTest, testCylindricalAverageUniform)
 TEST_ADD(DomainTest, testSphericalAverageUniform)
 TEST_ADD(DomainTest, testCylindricalAverageLinear)
 TEST_ADD(DomainTest, testSphericalAverageLinear)
+TEST_ADD(DomainTest, testPlanar2DAverageLinear)
 TEST_END(DomainTest)
 
 #endif
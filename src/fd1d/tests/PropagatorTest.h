@@ -360,6 +360,125 @@ public:
       TEST_ASSERT(eq(sum0, sum1));
    }
 
+   /*
+   * Test 2D ADI solver for a homogeneous field, separable sinusoidal 
+   * initial condition in a rectangle.
+   */
+   void testPlanar2DSolve()
+   {
+      printMethod(TEST_FUNC);
+
+      // Setup Domain
+      double xMax = 1.0;
+      double yMax = 2.0;
+      int nx = 33;
+      int ny = 17;
+      Domain domain;
+      domain.setPlanarParameters(0.0, xMax, nx);
+      domain.setYParameters(0.0, yMax, ny);
+      TEST_ASSERT(domain.is2D());
+      TEST_ASSERT(domain.nGrid() == nx*ny);
+      TEST_ASSERT(eq(domain.volume(), xMax*yMax));
+
+      Block b;
+      double length = 0.5;
+      double ds = 0.00005;
+      double step = 1.0;
+      b.setId(0);
+      b.setMonomerId(1);
+      b.setLength(length);
+      b.setKuhn(step);
+      b.setDiscretization(domain, ds);
+
+      int nGrid = domain.nGrid();
+      DArray<double> q, w;
+      q.allocate(nGrid);
+      w.allocate(nGrid);
+      double wc = 0.5;
+      int i, j;
+      for (j = 0; j < ny; ++j) {
+         for (i = 0; i < nx; ++i) {
+            q[i + nx*j] = cos(2.0*Constants::Pi*double(i)/double(nx-1))
+                        * cos(Constants::Pi*double(j)/double(ny-1));
+            w[i + nx*j] = wc;
+         }
+      }
+
+      b.setupSolver(w);
+      b.propagator(0).solve(q);
+
+      double dx = xMax/double(nx - 1);
+      double dy = yMax/double(ny - 1);
+      double kx = 2.0*sin(Constants::Pi/double(nx-1))/dx;
+      double ky = 2.0*sin(0.5*Constants::Pi/double(ny-1))/dy;
+      double f = (kx*kx + ky*ky)*step*step/6.0 + wc;
+      double expected = exp(-f*length);
+
+      double head, tail, ratio;
+      for (i = 0; i < nGrid; ++i) {
+         head = b.propagator(0).head()[i];
+         if (abs(head) > 1.0E-6) {
+            tail = b.propagator(0).tail()[i];
+            ratio = tail/head;
+            TEST_ASSERT( abs(ratio - expected) < 1.0E-5 );
+         }
+      }
+   }
+
+   /*
+   * Test 2D ADI solver in an axisymmetric (r,z) domain, by checking 
+   * that the partition function is independent of contour position.
+   */
+   void testCylinder2DSolve()
+   {
+      printMethod(TEST_FUNC);
+
+      // Setup Domain
+      double xMax = 1.0;
+      double yMax = 1.5;
+      int nx = 33;
+      int ny = 25;
+      Domain domain;
+      domain.setCylinderParameters(xMax, nx);
+      domain.setYParameters(0.0, yMax, ny);
+      double volume = Constants::Pi*xMax*xMax*yMax;
+      TEST_ASSERT(eq(domain.volume(), volume));
+
+      Block b;
+      double length = 0.5;
+      double ds = 0.0005;
+      double step = 1.0;
+      b.setId(0);
+      b.setMonomerId(1);
+      b.setLength(length);
+      b.setKuhn(step);
+      b.setDiscretization(domain, ds);
+      int ns = b.ns();
+
+      int nGrid = domain.nGrid();
+      DArray<double> q, w;
+      q.allocate(nGrid);
+      w.allocate(nGrid);
+      double wc = 0.5;
+      int i, j;
+      for (j = 0; j < ny; ++j) {
+         for (i = 0; i < nx; ++i) {
+            q[i + nx*j] = 1.0;
+            w[i + nx*j] = wc*cos(2.0*Constants::Pi*double(i)/double(nx-1))
+                            *cos(Constants::Pi*double(j)/double(ny-1));
+         }
+      }
+
+      b.setupSolver(w);
+      b.propagator(0).solve(q);
+
+      int m = ns/2;
+      double sum0 = domain.spatialAverage( b.propagator(0).tail() );
+      double sum1 = domain.innerProduct( b.propagator(0).q(m),
+                                         b.propagator(0).q(ns-1-m) );
+      TEST_ASSERT(std::abs(sum0 - sum1) < 1.0E-6);
+   }
+
 };
 
 TEST_BEGIN(PropagatorTest)
@@ -370,6 +489,8 @@ TEST_ADD(PropagatorTest, testCylinderSolve1)
 TEST_ADD(PropagatorTest, testCylinderSolve2)
 TEST_ADD(PropagatorTest, testSphereSolve1)
 TEST_ADD(PropagatorTest, testSphereSolve2)
+TEST_ADD(PropagatorTest, testPlanar2DSolve)
+TEST_ADD(PropagatorTest, testCylinder2DSolve)
 TEST_END(PropagatorTest)
 
 #endif
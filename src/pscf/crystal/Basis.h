@@ -604,6 +604,14 @@ namespace Pscf {
                      UnitCell<D> const & unitCell, 
                      std::string groupName);
 
+      /**
+      * Destroy the basis, returning to the uninitialized state.
+      *
+      * After this call, makeBasis may be called again, e.g., with a
+      * mesh of different dimensions.
+      */
+      void clear();
+
       /**
       * Print a list of all waves to an output stream.
       *
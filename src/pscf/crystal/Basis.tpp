@@ -96,6 +96,25 @@ namespace Pscf {
       isInitialized_ = true;
    }
 
+   /*
+   * Destroy basis, return to uninitialized state.
+   */
+   template <int D>
+   void Basis<D>::clear()
+   {
+      if (waves_.isAllocated()) waves_.deallocate();
+      if (waveIds_.isAllocated()) waveIds_.deallocate();
+      if (starIds_.isAllocated()) starIds_.deallocate();
+      stars_.clear();
+      nWave_ = 0;
+      nBasisWave_ = 0;
+      nStar_ = 0;
+      nBasis_ = 0;
+      meshPtr_ = 0;
+      unitCellPtr_ = 0;
+      isInitialized_ = false;
+   }
+
    /*
    * Construct ordered list of waves.
    * 
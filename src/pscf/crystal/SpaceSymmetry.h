@@ -248,17 +248,6 @@ namespace Pscf {
       */
       Translation t_;
 
-      // Static member variables
-
-      /// Identity element (static member stored for reference)
-      static SpaceSymmetry<D> identity_;
-
-      /// Has the static identity_ been constructed?
-      static bool hasIdentity_;
-
-      /// Construct static identity_ object.
-      static void makeIdentity();
-
    // friends:
 
       friend 
@@ -357,8 +346,9 @@ namespace Pscf {
    inline 
    const SpaceSymmetry<D>& SpaceSymmetry<D>::identity()
    {
-      if (!hasIdentity_) makeIdentity();
-      return identity_;
+      // Local static is initialized once, in a thread safe manner
+      static const SpaceSymmetry<D> element;
+      return element;
    }
 
    // Friend function template definitions
@@ -489,14 +479,6 @@ namespace Pscf {
       return in;
    }
 
-   // Define static members
-   template<int D> 
-   SpaceSymmetry<D> SpaceSymmetry<D>::identity_ = SpaceSymmetry<D>();
-
-   template<int D> 
-   bool SpaceSymmetry<D>::hasIdentity_ = false;
-
-
    #ifndef PSCF_SPACE_SYMMETRY_TPP
    // Suppress implicit instantiation
    extern template class SpaceSymmetry<1>;
@@ -98,25 +98,6 @@ namespace Pscf
       }
    }
 
-   /*
-   * Make identity (private static method).
-   */
-   template <int D>
-   void SpaceSymmetry<D>::makeIdentity()
-   {
-      int i, j;
-      for (i = 0; i < D; ++i) {
-         identity_.t_[i] = 0;
-         for (j = 0; j < D; ++j) {
-            if (i == j) {
-               identity_.R_(i, j) = 1;
-            } else {
-               identity_.R_(i, j) = 0;
-            }
-         }
-      }
-   }
-
    /*
    * Return inverse of this SpaceSymmetry<D>.
    */
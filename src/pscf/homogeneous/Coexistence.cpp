@@ -0,0 +1,576 @@
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Coexistence.h"
+#include "Mixture.h"
+#include <pscf/inter/Interaction.h>
+#include <pscf/math/LuSolver.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace Pscf {
+namespace Homogeneous {
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   Coexistence::Coexistence()
+    : phases_(),
+      fractions_(),
+      fPhases_(),
+      x_(),
+      f_(),
+      phiWork_(),
+      nGrid_(100),
+      nPoint_(0),
+      nDim_(0),
+      nPhase_(0),
+      mixturePtr_(0),
+      interactionPtr_(0)
+   {}
+
+   /*
+   * Destructor.
+   */
+   Coexistence::~Coexistence()
+   {}
+
+   /*
+   * Set number of grid intervals per axis.
+   */
+   void Coexistence::setNGrid(int nGrid)
+   {
+      UTIL_CHECK(nGrid >= 4);
+      UTIL_CHECK(nPoint_ == 0);
+      nGrid_ = nGrid;
+   }
+
+   /*
+   * Compute coexisting phases.
+   */
+   int Coexistence::compute(Mixture& mixture,
+                            Interaction const & interaction,
+                            DArray<double> const & phi)
+   {
+      const int nMolecule = mixture.nMolecule();
+      UTIL_CHECK(nMolecule > 1);
+      UTIL_CHECK(phi.capacity() == nMolecule);
+      UTIL_CHECK(interaction.nMonomer() == mixture.nMonomer());
+      mixturePtr_ = &mixture;
+      interactionPtr_ = &interaction;
+
+      // Allocate on first use
+      if (nDim_ == 0) {
+         nDim_ = nMolecule - 1;
+         phiWork_.allocate(nMolecule);
+         phases_.allocate(nMolecule);
+         for (int p = 0; p < nMolecule; ++p) {
+            phases_[p].allocate(nMolecule);
+         }
+         fractions_.allocate(nMolecule);
+         fPhases_.allocate(nMolecule);
+      }
+      UTIL_CHECK(nDim_ == nMolecule - 1);
+      const int d = nDim_;
+
+      // Evaluate free energy on composition grid
+      makeGrid();
+
+      // Find supporting facet of lower convex hull
+      DArray<double> x0, weight, y;
+      DArray<int> vertex;
+      x0.allocate(d);
+      weight.allocate(d + 1);
+      y.allocate(d + 1);
+      vertex.allocate(d + 1);
+      int i, k, m, p;
+      for (m = 0; m < d; ++m) {
+         x0[m] = phi[m];
+      }
+      findFacet(x0, vertex, weight, y);
+
+      // Merge vertices within a few grid spacings into phases
+      const double range = 2.5/double(nGrid_);
+      DArray<int> rep;
+      rep.allocate(d + 1);
+      DMatrix<double> xp;
+      xp.allocate(d + 1, d);
+      nPhase_ = 0;
+      bool found;
+      for (k = 0; k <= d; ++k) {
+         if (weight[k] <= 1.0E-12) continue;
+         i = vertex[k];
+         found = false;
+         for (p = 0; p < nPhase_ && !found; ++p) {
+            found = true;
+            for (m = 0; m < d; ++m) {
+               if (std::abs(x_(i, m) - x_(rep[p], m)) > range) {
+                  found = false;
+               }
+            }
+            if (found) {
+               for (m = 0; m < d; ++m) {
+                  xp(p, m) += weight[k]*x_(i, m);
+               }
+               fractions_[p] += weight[k];
+            }
+         }
+         if (!found) {
+            rep[nPhase_] = i;
+            for (m = 0; m < d; ++m) {
+               xp(nPhase_, m) = weight[k]*x_(i, m);
+            }
+            fractions_[nPhase_] = weight[k];
+            ++nPhase_;
+         }
+      }
+      UTIL_CHECK(nPhase_ > 0);
+      for (p = 0; p < nPhase_; ++p) {
+         for (m = 0; m < d; ++m) {
+            xp(p, m) /= fractions_[p];
+         }
+      }
+
+      // Refine tie-line, or accept overall composition as single phase
+      if (nPhase_ == 1) {
+         for (m = 0; m < d; ++m) {
+            xp(0, m) = x0[m];
+         }
+         fractions_[0] = 1.0;
+      } else {
+         refine(x0, xp, y);
+      }
+
+      // Store phase compositions and free energies
+      DArray<double> g;
+      g.allocate(d);
+      for (p = 0; p < nPhase_; ++p) {
+         fPhases_[p] = freeEnergy(&xp(p, 0), g);
+         for (m = 0; m < nMolecule; ++m) {
+            phases_[p][m] = phiWork_[m];
+         }
+      }
+
+      return nPhase_;
+   }
+
+   /*
+   * Evaluate free energy on a regular grid in the composition simplex.
+   *
+   * Grid points are offset slightly from the boundaries of the simplex,
+   * at which the ideal mixing free energy is singular.
+   */
+   void Coexistence::makeGrid()
+   {
+      const int d = nDim_;
+      const int n = nGrid_;
+      const double delta = 0.05;
+      const double norm = double(n) + double(d + 1)*delta;
+
+      // Count grid points
+      DArray<int> a;
+      a.allocate(d);
+      int m, sum, count;
+      for (m = 0; m < d; ++m) {
+         a[m] = 0;
+      }
+      count = 0;
+      m = d - 1;
+      while (m >= 0) {
+         ++count;
+         m = d - 1;
+         ++a[m];
+         sum = 0;
+         for (int j = 0; j < d; ++j) sum += a[j];
+         while (sum > n) {
+            sum -= a[m];
+            a[m] = 0;
+            --m;
+            if (m < 0) break;
+            ++a[m];
+            ++sum;
+         }
+      }
+
+      // Allocate on first use
+      if (nPoint_ == 0) {
+         nPoint_ = count;
+         x_.allocate(nPoint_, d);
+         f_.allocate(nPoint_);
+      }
+      UTIL_CHECK(nPoint_ == count);
+
+      // Evaluate free energy at each grid point
+      DArray<double> g;
+      g.allocate(d);
+      for (m = 0; m < d; ++m) {
+         a[m] = 0;
+      }
+      int i = 0;
+      m = d - 1;
+      while (m >= 0) {
+         for (int j = 0; j < d; ++j) {
+            x_(i, j) = (double(a[j]) + delta)/norm;
+         }
+         f_[i] = freeEnergy(&x_(i, 0), g);
+         ++i;
+         m = d - 1;
+         ++a[m];
+         sum = 0;
+         for (int j = 0; j < d; ++j) sum += a[j];
+         while (sum > n) {
+            sum -= a[m];
+            a[m] = 0;
+            --m;
+            if (m < 0) break;
+            ++a[m];
+            ++sum;
+         }
+      }
+      UTIL_CHECK(i == nPoint_);
+   }
+
+   /*
+   * Find the facet of the lower convex hull above x0.
+   *
+   * Solves the linear program: minimize sum_i w_i f_i subject to
+   * sum_i w_i = 1, sum_i w_i x_i = x0 and w_i >= 0, by the revised
+   * simplex method. The d + 1 rows of the constraint matrix are small,
+   * so each basis is factorized directly. The optimal dual variables
+   * define the common tangent plane.
+   */
+   void Coexistence::findFacet(DArray<double> const & x0,
+                               DArray<int>& vertex,
+                               DArray<double>& weight,
+                               DArray<double>& y)
+   {
+      const int d = nDim_;
+      const int nRow = d + 1;
+      const double tolerance = 1.0E-12;
+
+      // Initial basis: grid points nearest the corners of the simplex
+      int i, k, m;
+      vertex[d] = 0;
+      for (m = 0; m < d; ++m) {
+         vertex[m] = 0;
+      }
+      for (i = 0; i < nPoint_; ++i) {
+         for (m = 0; m < d; ++m) {
+            if (x_(i, m) > x_(vertex[m], m)) vertex[m] = i;
+         }
+      }
+
+      DMatrix<double> basis, basisT;
+      basis.allocate(nRow, nRow);
+      basisT.allocate(nRow, nRow);
+      DArray<double> b, fB, column, u;
+      b.allocate(nRow);
+      fB.allocate(nRow);
+      column.allocate(nRow);
+      u.allocate(nRow);
+      LuSolver solver, solverT;
+      solver.allocate(nRow);
+      solverT.allocate(nRow);
+
+      int enter, leave, r;
+      double cost, minCost, ratio, minRatio;
+      for (int iter = 0; iter < nPoint_; ++iter) {
+
+         // Factorize basis matrix and its transpose
+         for (k = 0; k < nRow; ++k) {
+            i = vertex[k];
+            basis(0, k) = 1.0;
+            for (r = 1; r < nRow; ++r) {
+               basis(r, k) = x_(i, r-1);
+            }
+            fB[k] = f_[i];
+         }
+         for (r = 0; r < nRow; ++r) {
+            for (k = 0; k < nRow; ++k) {
+               basisT(k, r) = basis(r, k);
+            }
+         }
+         solver.computeLU(basis);
+         solverT.computeLU(basisT);
+
+         // Primal weights and dual (tangent plane) variables
+         b[0] = 1.0;
+         for (r = 1; r < nRow; ++r) {
+            b[r] = x0[r-1];
+         }
+         solver.solve(b, weight);
+         solverT.solve(fB, y);
+         if (iter == 0) {
+            for (k = 0; k < nRow; ++k) {
+               if (weight[k] < -tolerance) {
+                  UTIL_THROW("Composition lies outside the grid");
+               }
+            }
+         }
+
+         // Choose entering point: most negative reduced cost
+         enter = -1;
+         minCost = -tolerance;
+         for (i = 0; i < nPoint_; ++i) {
+            cost = f_[i] - y[0];
+            for (m = 0; m < d; ++m) {
+               cost -= y[m+1]*x_(i, m);
+            }
+            if (cost < minCost) {
+               minCost = cost;
+               enter = i;
+            }
+         }
+         if (enter < 0) return;
+
+         // Ratio test: choose leaving vertex
+         column[0] = 1.0;
+         for (r = 1; r < nRow; ++r) {
+            column[r] = x_(enter, r-1);
+         }
+         solver.solve(column, u);
+         leave = -1;
+         minRatio = 0.0;
+         for (k = 0; k < nRow; ++k) {
+            if (u[k] > tolerance) {
+               ratio = weight[k]/u[k];
+               if (leave < 0 || ratio < minRatio) {
+                  minRatio = ratio;
+                  leave = k;
+               }
+            }
+         }
+         UTIL_CHECK(leave >= 0);
+         vertex[leave] = enter;
+      }
+      UTIL_THROW("Convex hull search failed to converge");
+   }
+
+   /*
+   * Refine coexisting phases by Newton's method.
+   *
+   * Unknowns are the independent volume fractions of each phase, the
+   * slopes and intercept of the common tangent plane, and the phase
+   * fractions. Equations require that each phase lie on the tangent
+   * plane with the same slope, and that phase fractions satisfy mass
+   * balance with the overall composition.
+   */
+   void Coexistence::refine(DArray<double> const & x0,
+                            DMatrix<double>& xp,
+                            DArray<double>& y)
+   {
+      const int d = nDim_;
+      const int P = nPhase_;
+      const int n = P*d + d + 1 + P;
+      const int yCol = P*d;      // first slope
+      const int y0Col = P*d + d; // intercept
+      const int lCol = P*d + d + 1; // first phase fraction
+      const double epsilon = 1.0E-10;
+      const double h = 1.0E-6;
+
+      DMatrix<double> jacobian, hessian, grad, xOld;
+      jacobian.allocate(n, n);
+      hessian.allocate(d, d);
+      grad.allocate(P, d);
+      xOld.allocate(P, d);
+      DArray<double> residual, dX, fp, g, gPlus, gMinus, xWork;
+      residual.allocate(n);
+      dX.allocate(n);
+      fp.allocate(P);
+      g.allocate(d);
+      gPlus.allocate(d);
+      gMinus.allocate(d);
+      xWork.allocate(d);
+      LuSolver solver;
+      solver.allocate(n);
+
+      int p, q, m, k, r, it, j;
+      double error, sum;
+      for (it = 0; it < 100; ++it) {
+
+         // Free energy and gradient of each phase
+         for (p = 0; p < P; ++p) {
+            fp[p] = freeEnergy(&xp(p, 0), g);
+            for (m = 0; m < d; ++m) {
+               grad(p, m) = g[m];
+            }
+         }
+
+         // Residuals
+         for (p = 0; p < P; ++p) {
+            sum = y[0];
+            for (m = 0; m < d; ++m) {
+               residual[p*d + m] = grad(p, m) - y[m+1];
+               sum += y[m+1]*xp(p, m);
+            }
+            residual[P*d + p] = fp[p] - sum;
+         }
+         for (m = 0; m < d; ++m) {
+            sum = -x0[m];
+            for (p = 0; p < P; ++p) {
+               sum += fractions_[p]*xp(p, m);
+            }
+            residual[P*d + P + m] = sum;
+         }
+         sum = -1.0;
+         for (p = 0; p < P; ++p) {
+            sum += fractions_[p];
+         }
+         residual[n-1] = sum;
+
+         error = 0.0;
+         for (r = 0; r < n; ++r) {
+            if (std::abs(residual[r]) > error) error = std::abs(residual[r]);
+         }
+         if (error < epsilon) break;
+
+         // Jacobian
+         for (r = 0; r < n; ++r) {
+            for (k = 0; k < n; ++k) {
+               jacobian(r, k) = 0.0;
+            }
+         }
+         for (p = 0; p < P; ++p) {
+
+            // Hessian of free energy by central differences of gradient
+            for (k = 0; k < d; ++k) {
+               for (m = 0; m < d; ++m) {
+                  xWork[m] = xp(p, m);
+               }
+               xWork[k] += h;
+               freeEnergy(&xWork[0], gPlus);
+               xWork[k] -= 2.0*h;
+               freeEnergy(&xWork[0], gMinus);
+               for (m = 0; m < d; ++m) {
+                  hessian(m, k) = (gPlus[m] - gMinus[m])/(2.0*h);
+               }
+            }
+
+            for (m = 0; m < d; ++m) {
+               r = p*d + m;
+               for (k = 0; k < d; ++k) {
+                  jacobian(r, p*d + k) = hessian(m, k);
+               }
+               jacobian(r, yCol + m) = -1.0;
+            }
+            r = P*d + p;
+            for (k = 0; k < d; ++k) {
+               jacobian(r, p*d + k) = grad(p, k) - y[k+1];
+               jacobian(r, yCol + k) = -xp(p, k);
+            }
+            jacobian(r, y0Col) = -1.0;
+            for (m = 0; m < d; ++m) {
+               r = P*d + P + m;
+               jacobian(r, p*d + m) = fractions_[p];
+               jacobian(r, lCol + p) = xp(p, m);
+            }
+            jacobian(n-1, lCol + p) = 1.0;
+         }
+
+         // Newton step, halved until all phases remain in the simplex
+         solver.computeLU(jacobian);
+         solver.solve(residual, dX);
+         for (p = 0; p < P; ++p) {
+            for (m = 0; m < d; ++m) {
+               xOld(p, m) = xp(p, m);
+            }
+         }
+         bool inRange = false;
+         for (j = 0; j < 10 && !inRange; ++j) {
+            inRange = true;
+            for (p = 0; p < P; ++p) {
+               sum = 0.0;
+               for (m = 0; m < d; ++m) {
+                  xp(p, m) = xOld(p, m) - dX[p*d + m];
+                  if (xp(p, m) <= 0.0) inRange = false;
+                  sum += xp(p, m);
+               }
+               if (sum >= 1.0) inRange = false;
+            }
+            if (!inRange) {
+               for (r = 0; r < n; ++r) {
+                  dX[r] *= 0.5;
+               }
+            }
+         }
+         if (!inRange) {
+            UTIL_THROW("Phase compositions remain out of range");
+         }
+         for (m = 0; m < d; ++m) {
+            y[m+1] -= dX[yCol + m];
+         }
+         y[0] -= dX[y0Col];
+         for (p = 0; p < P; ++p) {
+            fractions_[p] -= dX[lCol + p];
+         }
+      }
+      if (error >= epsilon) {
+         UTIL_THROW("Failed to converge");
+      }
+
+      // Check that distinct phases have not merged
+      const double range = 0.5/double(nGrid_);
+      bool distinct;
+      for (p = 0; p < P; ++p) {
+         for (q = p + 1; q < P; ++q) {
+            distinct = false;
+            for (m = 0; m < d; ++m) {
+               if (std::abs(xp(p, m) - xp(q, m)) > range) distinct = true;
+            }
+            if (!distinct) {
+               UTIL_THROW("Coexisting phases merged during refinement");
+            }
+         }
+      }
+   }
+
+   /*
+   * Set mixture composition from independent volume fractions.
+   */
+   bool Coexistence::setComposition(double const * x)
+   {
+      const int d = nDim_;
+      double sum = 0.0;
+      for (int m = 0; m < d; ++m) {
+         if (x[m] <= 0.0) return false;
+         phiWork_[m] = x[m];
+         sum += x[m];
+      }
+      if (sum >= 1.0) return false;
+      phiWork_[d] = 1.0 - sum;
+      mixturePtr_->setComposition(phiWork_);
+      return true;
+   }
+
+   /*
+   * Free energy per monomer and its gradient.
+   *
+   * With xi = 0, mu_i/v_i is the derivative of the free energy per
+   * monomer with respect to phi_i, treating all phi_i as independent.
+   * The last volume fraction is eliminated by incompressibility.
+   */
+   double Coexistence::freeEnergy(double const * x, DArray<double>& g)
+   {
+      if (!setComposition(x)) {
+         UTIL_THROW("Composition outside of simplex");
+      }
+      Mixture& mixture = *mixturePtr_;
+      mixture.computeMu(*interactionPtr_, 0.0);
+      mixture.computeFreeEnergy(*interactionPtr_);
+      const int d = nDim_;
+      double muLast = mixture.mu(d)/mixture.molecule(d).size();
+      for (int m = 0; m < d; ++m) {
+         g[m] = mixture.mu(m)/mixture.molecule(m).size() - muLast;
+      }
+      return mixture.fHelmholtz();
+   }
+
+} // namespace Homogeneous
+} // namespace Pscf
@@ -0,0 +1,215 @@
+#ifndef PSCF_HOMOGENEOUS_COEXISTENCE_H
+#define PSCF_HOMOGENEOUS_COEXISTENCE_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>       // Member template
+#include <util/containers/DMatrix.h>      // Member template
+
+namespace Pscf {
+   class Interaction;
+}
+
+namespace Pscf {
+namespace Homogeneous {
+
+   class Mixture;
+
+   using namespace Util;
+
+   /**
+   * Coexisting phases of a homogeneous mixture.
+   *
+   * Computes the compositions and amounts of the homogeneous phases
+   * that coexist at equilibrium in a mixture of specified overall
+   * composition, with any number of molecular species. The calculation
+   * has two stages:
+   *
+   *   - The free energy per monomer is evaluated on a regular grid in
+   *     the space of independent molecular volume fractions. The lower
+   *     convex hull of these values at the overall composition is then
+   *     found by solving a small linear program by the simplex method.
+   *     The vertices of the supporting facet of the hull give the
+   *     approximate compositions of the coexisting phases, and the
+   *     barycentric weights give the phase fractions (lever rule).
+   *
+   *   - Vertices within a few grid spacings of one another are merged
+   *     into one phase, and the resulting tie-line (or tie-simplex) is
+   *     refined by Newton's method, by requiring a common tangent plane
+   *     and mass balance.
+   *
+   * The convex hull stage requires no initial guess and finds every
+   * coexisting phase resolved by the grid, including three-phase
+   * regions of ternary blends.
+   *
+   * \ingroup Pscf_Homogeneous_Module
+   */
+   class Coexistence
+   {
+   public:
+
+      /**
+      * Constructor.
+      */
+      Coexistence();
+
+      /**
+      * Destructor.
+      */
+      ~Coexistence();
+
+      /**
+      * Set the number of grid intervals per volume fraction axis.
+      *
+      * The default value is 100. The number of grid points grows as
+      * nGrid^(nMolecule-1).
+      *
+      * \param nGrid number of grid intervals (>= 4)
+      */
+      void setNGrid(int nGrid);
+
+      /**
+      * Compute coexisting phases for an overall composition.
+      *
+      * On return, the state of the mixture is that of the last phase.
+      * Throws an Exception if the Newton refinement fails to converge.
+      *
+      * \param mixture  homogeneous mixture (molecules must be defined)
+      * \param interaction  excess free energy model
+      * \param phi  overall molecular volume fractions (nMolecule)
+      * \return number of coexisting phases
+      */
+      int compute(Mixture& mixture, Interaction const & interaction,
+                  DArray<double> const & phi);
+
+      /**
+      * Number of coexisting phases found by the last call to compute.
+      */
+      int nPhase() const;
+
+      /**
+      * Molecular volume fractions in one phase.
+      *
+      * \param p phase index, 0 <= p < nPhase()
+      */
+      DArray<double> const & phi(int p) const;
+
+      /**
+      * Fraction of total volume occupied by one phase.
+      *
+      * \param p phase index, 0 <= p < nPhase()
+      */
+      double fraction(int p) const;
+
+      /**
+      * Free energy per monomer of one phase.
+      *
+      * \param p phase index, 0 <= p < nPhase()
+      */
+      double fHelmholtz(int p) const;
+
+   private:
+
+      /// Compositions of coexisting phases (nMolecule fractions each).
+      DArray< DArray<double> > phases_;
+
+      /// Volume fractions of coexisting phases.
+      DArray<double> fractions_;
+
+      /// Free energies per monomer of coexisting phases.
+      DArray<double> fPhases_;
+
+      /// Independent volume fractions of grid points.
+      DMatrix<double> x_;
+
+      /// Free energy per monomer at grid points.
+      DArray<double> f_;
+
+      /// Work array of molecular volume fractions.
+      DArray<double> phiWork_;
+
+      /// Number of grid intervals per axis.
+      int nGrid_;
+
+      /// Number of grid points.
+      int nPoint_;
+
+      /// Number of independent volume fractions (nMolecule - 1).
+      int nDim_;
+
+      /// Number of coexisting phases.
+      int nPhase_;
+
+      /// Pointer to current mixture.
+      Mixture* mixturePtr_;
+
+      /// Pointer to current interaction.
+      Interaction const * interactionPtr_;
+
+      /**
+      * Evaluate free energy on grid of compositions.
+      */
+      void makeGrid();
+
+      /**
+      * Find supporting facet of lower convex hull by the simplex method.
+      *
+      * \param x0  independent overall volume fractions
+      * \param vertex  indices of grid points in facet (output)
+      * \param weight  barycentric weights of vertices (output)
+      * \param y  common tangent plane: intercept, then slopes (output)
+      */
+      void findFacet(DArray<double> const & x0, DArray<int>& vertex,
+                     DArray<double>& weight, DArray<double>& y);
+
+      /**
+      * Refine phase compositions and fractions by Newton's method.
+      *
+      * \param x0  independent overall volume fractions
+      * \param xp  independent volume fractions of phases (in/out)
+      * \param y  common tangent plane (in/out)
+      */
+      void refine(DArray<double> const & x0, DMatrix<double>& xp,
+                  DArray<double>& y);
+
+      /**
+      * Set the mixture composition from independent fractions.
+      *
+      * \param x  independent volume fractions (nMolecule - 1)
+      * \return false if x lies outside the open composition simplex
+      */
+      bool setComposition(double const * x);
+
+      /**
+      * Compute free energy and its gradient at a composition.
+      *
+      * \param x  independent volume fractions
+      * \param g  gradient w.r.t. independent volume fractions (output)
+      * \return free energy per monomer
+      */
+      double freeEnergy(double const * x, DArray<double>& g);
+
+   };
+
+   // Inline member functions
+
+   inline int Coexistence::nPhase() const
+   {  return nPhase_; }
+
+   inline DArray<double> const & Coexistence::phi(int p) const
+   {  return phases_[p]; }
+
+   inline double Coexistence::fraction(int p) const
+   {  return fractions_[p]; }
+
+   inline double Coexistence::fHelmholtz(int p) const
+   {  return fPhases_[p]; }
+
+} // namespace Homogeneous
+} // namespace Pscf
+#endif
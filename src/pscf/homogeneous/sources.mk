@@ -1,7 +1,8 @@
 pscf_homogeneous_= \
   pscf/homogeneous/Clump.cpp \
   pscf/homogeneous/Molecule.cpp \
-  pscf/homogeneous/Mixture.cpp 
+  pscf/homogeneous/Mixture.cpp \
+  pscf/homogeneous/Coexistence.cpp 
 
 pscf_homogeneous_SRCS=\
      $(addprefix $(SRC_DIR)/, $(pscf_homogeneous_))
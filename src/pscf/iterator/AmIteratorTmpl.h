@@ -11,6 +11,7 @@
 #include <util/containers/DArray.h>     // member template
 #include <util/containers/DMatrix.h>    // member template
 #include <util/containers/RingBuffer.h> // member template
+#include <pscf/math/LuSolver.h>          // member
 
 namespace Pscf {
 
@@ -33,6 +34,29 @@ namespace Pscf {
    * The template type parameter T is the type of the data structure used 
    * to store both field and residual vectors. 
    *
+   * If the optional parameter "adaptive" is true, the iterator also
+   * monitors progress: It discards old basis vectors when the matrix 
+   * U of residual basis dot products becomes ill-conditioned, damps 
+   * the mixing parameter lambda when the error jumps, restarts from 
+   * the best state found so far if the error stagnates, and switches 
+   * to a more conservative mixing mode before declaring failure.
+   *
+   * The iterator also maintains an a-posteriori estimate of the error 
+   * in the free energy, which is returned by fError(). Because the free
+   * energy is stationary at the solution, this error is second order in
+   * the residual. The error for the state obtained after each Anderson 
+   * step is estimated as half the magnitude of the product of the 
+   * residual and the step, as computed by estimateFError, and is scaled
+   * by the square of the ratio of the norms of the new and previous 
+   * residual vectors to estimate the error in the new state. This is
+   * a heuristic, not a bound: The product estimate is exact to second
+   * order only for a Newton step, and an Anderson mixing step is not a
+   * Newton step, so the estimate may be too small by a factor of order
+   * the ratio of the mixing step to the Newton step. Callers that only
+   * need the free energy to limited accuracy (e.g., sweeps with a loose
+   * tolerance) may use it to decide whether to converge a solution more
+   * tightly, but should choose tolerances with this in mind.
+   *
    * \ingroup Pscf_Iterator_Module
    */
    template <typename Iterator, typename T>
@@ -65,6 +89,49 @@ namespace Pscf {
       */
       int solve(bool isContinuation = false);
 
+      /**
+      * Get the error tolerance used to test for convergence.
+      */
+      double epsilon() const;
+
+      /**
+      * Set the error tolerance used to test for convergence.
+      *
+      * \param epsilon  new error tolerance (> 0)
+      */
+      void setEpsilon(double epsilon);
+
+      /**
+      * Estimated error in the free energy of the current state.
+      *
+      * Returns the estimate computed in the last iteration of the most
+      * recent call to solve, or a negative value if no estimate was
+      * available (e.g., if the initial state was already converged). 
+      * This is a heuristic estimate rather than a bound (see the class
+      * documentation).
+      */
+      double fError() const;
+
+      /**
+      * Number of iterations in the most recent call to solve.
+      */
+      int nItr() const;
+
+      /**
+      * Number of restarts in the most recent solve (adaptive mode).
+      */
+      int nRestart() const;
+
+      /**
+      * Number of basis truncations in the most recent solve (adaptive).
+      */
+      int nTruncate() const;
+
+      /**
+      * Did the most recent solve escalate to safe mode (adaptive mode)?
+      */
+      bool isSafeMode() const;
+
    protected:
 
       /// Type of error criterion used to test convergence 
@@ -142,6 +209,15 @@ namespace Pscf {
       */
       void allocateAM();
 
+      /**
+      * Reallocate after a change in the number of elements.
+      *
+      * Discards all histories and basis vectors and reallocates all 
+      * arrays of nElements() elements, e.g., after a change of mesh.
+      * Does nothing if allocateAM has not been called.
+      */
+      void reallocateAM();
+
       /**
       * Clear information about history.
       *
@@ -158,6 +234,25 @@ namespace Pscf {
       * if isAllocatedAM() is false, and otherwise calls clear() if 
       * isContinuation is false.
       *
+      * If isContinuation is true (e.g., within a sweep) and the optional
+      * parameter retainBasis is true, the basis 
+      * vectors, which are differences between successive field and 
+      * residual vectors, are retained, but the field and residual 
+      * histories are discarded. A change in parameters shifts all 
+      * residuals near a solution by nearly the same vector (the 
+      * derivative of the residual with respect to the sweep parameter, 
+      * times the change), which cancels to first order in differences. 
+      * The retained basis is thus valid at the new parameters, and is 
+      * used to compute an Anderson mixing step on the first iteration. 
+      * No basis vector is formed from the difference between a field 
+      * for the old parameters and one for the new parameters. The 
+      * histories are cleared after any failure to converge, so that 
+      * a continuation after a failure starts from scratch.
+      *
+      * If retainBasis is false, as it is by default, a continuation
+      * instead keeps all histories, and the first iteration takes a 
+      * simple relaxation step, as in earlier versions.
+      *
       * \param isContinuation true iff continuation within a sweep
       */ 
       virtual void setup(bool isContinuation);
@@ -170,6 +265,54 @@ namespace Pscf {
       */
       virtual double computeError(int verbose);
 
+      /**
+      * Estimate the free energy error from a residual and a step.
+      *
+      * Returns an estimate of the magnitude of the difference between 
+      * the free energy of the state with field vector field and that of
+      * the solution, given the residual resid of this state and the 
+      * field fieldNew obtained by the Anderson step. The default 
+      * implementation returns half the absolute value of the dot product 
+      * of resid with (fieldNew - field), which is exact to second order 
+      * if the residual is the gradient of the free energy, and if the 
+      * step is a Newton step. Subclasses should override this if the 
+      * residual is related to the gradient by a different metric.
+      *
+      * \param resid  residual vector of current state
+      * \param field  field vector of current state
+      * \param fieldNew  field vector after Anderson mixing step
+      */
+      virtual double estimateFError(T const & resid, T const & field,
+                                    T const & fieldNew);
+
+      /**
+      * Refine the discretization of the underlying model, if needed.
+      *
+      * This function is called on each iteration after the scalar 
+      * error is computed, before the test for convergence. Subclasses
+      * that begin iteration with a coarse discretization (e.g., a 
+      * large contour step) may refine the discretization here and 
+      * return true, but must then return true whenever the error is 
+      * less than epsilon until the final discretization is reached. 
+      * After a refinement, the iterator re-evaluates the current 
+      * field, retains the basis vectors, and discards the field and 
+      * residual histories, as for a continuation. The default 
+      * implementation does nothing and returns false.
+      *
+      * \param error  scalar error for the current state
+      * \return true iff the discretization was changed
+      */
+      virtual bool refine(double error);
+
+      /**
+      * Get the stream to which log output is written.
+      *
+      * The default implementation returns Log::file(). Subclasses that
+      * are owned by a system with its own log stream should override 
+      * this to return that stream.
+      */
+      virtual std::ostream& logFile() const;
+
       /**
       * Return the current residual vector by const reference.
       */
@@ -224,6 +367,54 @@ namespace Pscf {
       /// Has the allocateAM function been called.
       bool isAllocatedAM_;
 
+      /// Use adaptive control of history and mixing parameter?
+      bool adaptive_;
+
+      /// Maximum estimated condition number of U_ (adaptive mode).
+      double maxCond_;
+
+      /// Number of iterations without improvement before a restart.
+      int nStagnant_;
+
+      /// Retain only the basis (not histories) on a continuation?
+      bool retainBasis_;
+
+      /// Damping factor by which lambda_ is multiplied (adaptive mode).
+      double lambdaScale_;
+
+      /// Maximum value of lambdaScale_ (reduced in safe mode).
+      double lambdaMax_;
+
+      /// Error at previous iteration (adaptive mode).
+      double prevError_;
+
+      /// Lowest error in this solve (adaptive mode).
+      double bestError_;
+
+      /// Maximum number of basis vectors used (adaptive mode).
+      int histCap_;
+
+      /// Iteration at which bestError_ was reached (-1 if none).
+      int itrBest_;
+
+      /// Number of restarts in this solve.
+      int nRestart_;
+
+      /// Number of basis truncations in this solve.
+      int nTruncate_;
+
+      /// Has the iterator escalated to the safe mixing mode?
+      bool isSafeMode_;
+
+      /// Estimated error in free energy of the current state.
+      double fError_;
+
+      /// Estimated free energy error of the state before the last step.
+      double fErrorStep_;
+
+      /// Norm of the residual vector at the previous iteration.
+      double resNormPrev_;
+
       /// History of previous field vectors.
       RingBuffer<T> fieldHists_;
 
@@ -245,6 +436,15 @@ namespace Pscf {
       /// Dot products of current residual with residual basis vectors.
       DArray<double> v_;
 
+      /// Cholesky factor of the normalized U_ matrix (adaptive mode).
+      DMatrix<double> L_;
+
+      /// Square roots of diagonal elements of U_ (adaptive mode).
+      DArray<double> norms_;
+
+      /// Solver for mixing coefficients, of dimension maxHist_.
+      LuSolver luSolver_;
+
       /// New trial field (big W in Arora et al. 2017)
       T fieldTrial_;
 
@@ -254,6 +454,9 @@ namespace Pscf {
       /// Workspace for calculations
       T temp_;
 
+      /// Field with lowest error (adaptive mode).
+      T bestField_;
+
       // --- Non-virtual private functions (implemented here) ---- //
 
       /**
@@ -272,6 +475,38 @@ namespace Pscf {
       */
       void updateGuess();
 
+      /**
+      * Reduce nBasis_ if the U matrix is ill-conditioned (adaptive mode).
+      *
+      * Retains the largest number of newest basis vectors for which the
+      * condition number of the corresponding block of U_, normalized to
+      * unit diagonal and estimated from a Cholesky decomposition, does 
+      * not exceed maxCond_.
+      */
+      void truncateBasis();
+
+      /**
+      * Adaptive control applied after each unconverged iteration.
+      *
+      * Records the best state, damps lambda_ if the error more than
+      * doubled, and calls restart if the error has not decreased below 
+      * the best value within nStagnant_ iterations.
+      *
+      * \param error  scalar error for the current state
+      * \return 0 to continue, 1 after a restart, 2 to give up
+      */
+      int adapt(double error);
+
+      /**
+      * Restart from the best state with empty histories.
+      *
+      * The second restart in a solve also switches to a safe mode, with
+      * at most 5 basis vectors and a damping factor no greater than 0.5.
+      * Returns false, so that the iterator gives up, if no best state
+      * has been recorded or the iterator is already in safe mode.
+      */
+      bool restart();
+
       // --- Private virtual functions with default implementations --- //
 
       /**
@@ -411,6 +646,48 @@ namespace Pscf {
 
    };
   
+   /*
+   * Get the error tolerance.
+   */
+   template <typename Iterator, typename T>
+   inline double AmIteratorTmpl<Iterator,T>::epsilon() const
+   {  return epsilon_; }
+
+   /*
+   * Get the estimated error in the free energy.
+   */
+   template <typename Iterator, typename T>
+   inline double AmIteratorTmpl<Iterator,T>::fError() const
+   {  return fError_; }
+
+   /*
+   * Get the number of iterations in the most recent solve.
+   */
+   template <typename Iterator, typename T>
+   inline int AmIteratorTmpl<Iterator,T>::nItr() const
+   {  return itr_; }
+
+   /*
+   * Get the number of restarts in the most recent solve.
+   */
+   template <typename Iterator, typename T>
+   inline int AmIteratorTmpl<Iterator,T>::nRestart() const
+   {  return nRestart_; }
+
+   /*
+   * Get the number of basis truncations in the most recent solve.
+   */
+   template <typename Iterator, typename T>
+   inline int AmIteratorTmpl<Iterator,T>::nTruncate() const
+   {  return nTruncate_; }
+
+   /*
+   * Did the most recent solve escalate to safe mode?
+   */
+   template <typename Iterator, typename T>
+   inline bool AmIteratorTmpl<Iterator,T>::isSafeMode() const
+   {  return isSafeMode_; }
+
    /*
    * Return the current residual vector by const reference.
    */
@@ -9,11 +9,11 @@
 */
 
 #include <pscf/inter/Interaction.h>
-#include <pscf/math/LuSolver.h>
 #include "NanException.h"
 #include <util/containers/FArray.h>
 #include <util/format/Dbl.h>
 #include <util/format/Int.h>
+#include <util/misc/Log.h>
 #include <util/misc/Timer.h>
 #include <cmath>
 
@@ -39,7 +39,23 @@ namespace Pscf
       nElem_(0),
       verbose_(0),
       outputTime_(false),
-      isAllocatedAM_(false)
+      isAllocatedAM_(false),
+      adaptive_(false),
+      maxCond_(1.0E+10),
+      nStagnant_(20),
+      retainBasis_(false),
+      lambdaScale_(1.0),
+      lambdaMax_(1.0),
+      prevError_(0.0),
+      bestError_(0.0),
+      histCap_(0),
+      itrBest_(-1),
+      nRestart_(0),
+      nTruncate_(0),
+      isSafeMode_(false),
+      fError_(-1.0),
+      fErrorStep_(-1.0),
+      resNormPrev_(0.0)
    {  setClassName("AmIteratorTmpl"); }
 
    /*
@@ -76,6 +92,20 @@ namespace Pscf
       // Flag to output timing results (true) or skip (false)
       // Initialized to false by default in constructor
       readOptional(in, "outputTime", outputTime_);
+
+      // Flag to enable adaptive control of mixing (optional)
+      // Initialized to false by default in constructor
+      readOptional(in, "adaptive", adaptive_);
+      if (adaptive_) {
+         readOptional(in, "maxCond", maxCond_);
+         readOptional(in, "nStagnant", nStagnant_);
+         UTIL_CHECK(maxCond_ > 1.0);
+         UTIL_CHECK(nStagnant_ > 0);
+      }
+
+      // Flag to retain only the basis of differences on a continuation
+      // (optional). Initialized to true by default in constructor
+      readOptional(in, "retainBasis", retainBasis_);
    }
 
    /*
@@ -110,7 +140,18 @@ namespace Pscf
       timerMDE.stop();
 
       // Iterative loop
+      fError_ = -1.0;
+      fErrorStep_ = -1.0;
       nBasis_ = fieldBasis_.size();
+      if (adaptive_) {
+         histCap_ = nBasis_;
+         lambdaScale_ = 1.0;
+         lambdaMax_ = 1.0;
+         itrBest_ = -1;
+         nRestart_ = 0;
+         nTruncate_ = 0;
+         isSafeMode_ = false;
+      }
       for (itr_ = 0; itr_ < maxItr_; ++itr_) {
 
          // Append current field to fieldHists_ ringbuffer
@@ -120,9 +161,9 @@ namespace Pscf
          timerAM.start();
 
          if (verbose_ > 1) {
-            Log::file() << "------------------------------- \n";
+            logFile() << "------------------------------- \n";
          }
-         Log::file() << " Iteration " << Int(itr_,5);
+         logFile() << " Iteration " << Int(itr_,5);
 
 
          if (nBasis_ < maxHist_) {
@@ -145,17 +186,50 @@ namespace Pscf
          try {
             error = computeError(verbose_);
          } catch (const NanException&) {
-            Log::file() << ",  error  =             NaN" << std::endl;
+            logFile() << ",  error  =             NaN" << std::endl;
+            if (adaptive_) {
+               timerError.stop();
+               timerAM.stop();
+               timerMDE.start();
+               bool restarted = restart();
+               timerMDE.stop();
+               if (restarted) continue;
+            }
             break; // Exit loop if a NanException is caught
          }
          if (verbose_ < 2) {
-             Log::file() << ",  error  = " << Dbl(error, 15) << std::endl;
+             logFile() << ",  error  = " << Dbl(error, 15) << std::endl;
+         }
+
+         // Scale free energy error estimate for the state before the
+         // last step by the square of the ratio of residual norms
+         double resNorm = norm(resHists_[0]);
+         if (fErrorStep_ >= 0.0 && resNormPrev_ > 0.0) {
+            double ratio = resNorm/resNormPrev_;
+            fError_ = fErrorStep_*ratio*ratio;
+         } else {
+            fError_ = -1.0;
          }
+         resNormPrev_ = resNorm;
          timerError.stop();
 
          // Output additional details of this iteration to the log file
          outputToLog();
 
+         // Refine discretization, if requested by a subclass. Retain
+         // the basis, but discard histories for the old discretization
+         if (refine(error)) {
+            timerAM.stop();
+            resHists_.clear();
+            fieldHists_.clear();
+            fErrorStep_ = -1.0;
+            itrBest_ = -1;
+            timerMDE.start();
+            evaluate();
+            timerMDE.stop();
+            continue;
+         }
+
          // Check for convergence
          if (error < epsilon_) {
 
@@ -164,47 +238,63 @@ namespace Pscf
             timerTotal.stop();
 
             if (verbose_ > 1) {
-               Log::file() << "-------------------------------\n";
+               logFile() << "-------------------------------\n";
+            }
+            logFile() << " Converged\n";
+            if (verbose_ > 0 && fError_ >= 0.0) {
+               logFile() << " Estimated error in free energy = " 
+                         << Dbl(fError_, 15) << "\n";
             }
-            Log::file() << " Converged\n";
 
             // Output error report if not done previously
             if (verbose_ == 1) {
-               Log::file() << "\n";
+               logFile() << "\n";
                computeError(2); 
             }
 
             // Output timing results, if requested.
             if (outputTime_) {
                double total = timerTotal.time();
-               Log::file() << "\n";
-               Log::file() << "Iterator times contributions:\n";
-               Log::file() << "\n";
-               Log::file() << "MDE solution:         "
-                           << timerMDE.time()  << " s,  "
-                           << timerMDE.time()/total << "\n";
-               Log::file() << "residual computation: "
-                           << timerResid.time()  << " s,  "
-                           << timerResid.time()/total << "\n";
-               Log::file() << "mixing coefficients:  "
-                           << timerCoeff.time()  << " s,  "
-                           << timerCoeff.time()/total << "\n";
-               Log::file() << "checking convergence: "
-                           << timerError.time()  << " s,  "
-                           << timerError.time()/total << "\n";
-               Log::file() << "updating guess:       "
-                           << timerOmega.time()  << " s,  "
-                           << timerOmega.time()/total << "\n";
-               Log::file() << "total time:           "
-                           << total << " s  \n";
+               logFile() << "\n";
+               logFile() << "Iterator times contributions:\n";
+               logFile() << "\n";
+               logFile() << "MDE solution:         "
+                         << timerMDE.time()  << " s,  "
+                         << timerMDE.time()/total << "\n";
+               logFile() << "residual computation: "
+                         << timerResid.time()  << " s,  "
+                         << timerResid.time()/total << "\n";
+               logFile() << "mixing coefficients:  "
+                         << timerCoeff.time()  << " s,  "
+                         << timerCoeff.time()/total << "\n";
+               logFile() << "checking convergence: "
+                         << timerError.time()  << " s,  "
+                         << timerError.time()/total << "\n";
+               logFile() << "updating guess:       "
+                         << timerOmega.time()  << " s,  "
+                         << timerOmega.time()/total << "\n";
+               logFile() << "total time:           "
+                         << total << " s  \n";
             }
-            Log::file() << "\n";
+            logFile() << "\n";
 
             // Successful completion (i.e., converged within tolerance)
             return 0;
 
          } else {
 
+            // Adaptive control: Damp lambda, or restart if stagnant
+            if (adaptive_) {
+               int action = adapt(error);
+               if (action == 1) {
+                  timerAM.stop();
+                  continue;
+               } else 
+               if (action == 2) {
+                  break;
+               }
+            }
+
             // Compute optimal coefficients for basis vectors
             timerCoeff.start();
             computeResidCoeff();
@@ -213,6 +303,8 @@ namespace Pscf
             // Compute the trial updated field and update the system
             timerOmega.start();
             updateGuess();
+            fErrorStep_ = estimateFError(resHists_[0], fieldHists_[0], 
+                                         fieldTrial_);
             timerOmega.stop();
 
             timerAM.stop();
@@ -230,7 +322,11 @@ namespace Pscf
       // Failure: iteration counter itr reached maxItr without converging
       timerTotal.stop();
 
-      Log::file() << "Iterator failed to converge.\n";
+      logFile() << "Iterator failed to converge.\n";
+
+      // Discard histories, which should not be reused by a continuation
+      clear();
+
       return 1;
 
    }
@@ -251,6 +347,16 @@ namespace Pscf
    void AmIteratorTmpl<Iterator,T>::setMaxHist(int maxHist)
    {  maxHist_ = maxHist; }
 
+   /*
+   * Set the error tolerance.
+   */
+   template <typename Iterator, typename T>
+   void AmIteratorTmpl<Iterator,T>::setEpsilon(double epsilon)
+   {
+      UTIL_CHECK(epsilon > 0.0);
+      epsilon_ = epsilon; 
+   }
+
    /*
    * Set and validate value of error type string.
    */
@@ -333,17 +439,77 @@ namespace Pscf
       U_.allocate(maxHist_, maxHist_);
       v_.allocate(maxHist_);
       coeffs_.allocate(maxHist_);
+      luSolver_.allocate(maxHist_);
+
+      // Allocate work space used to check conditioning of U_
+      if (adaptive_) {
+         L_.allocate(maxHist_, maxHist_);
+         norms_.allocate(maxHist_);
+      }
+
+      // Allocate storage for best state, used for adaptive restarts
+      if (adaptive_) {
+         bestField_.allocate(nElem_);
+      }
 
       isAllocatedAM_ = true;
    }
 
+   /*
+   * Reallocate after a change in the number of elements.
+   * (protected, non-virtual)
+   */
+   template <typename Iterator, typename T>
+   void AmIteratorTmpl<Iterator,T>::reallocateAM()
+   {
+      if (!isAllocatedAM_) return;
+
+      // Release elements of all ring buffers. Elements are accessible
+      // only below size(), so fill each buffer before releasing.
+      RingBuffer<T>* buffers[4] 
+                   = {&fieldHists_, &resHists_, &fieldBasis_, &resBasis_};
+      int i, j;
+      for (i = 0; i < 4; ++i) {
+         RingBuffer<T>& buffer = *buffers[i];
+         while (buffer.size() < buffer.capacity()) {
+            buffer.append(temp_);
+         }
+         for (j = 0; j < buffer.size(); ++j) {
+            buffer[j].deallocate();
+         }
+         buffer.clear();
+      }
+      nBasis_ = 0;
+
+      // Reallocate arrays of nElements() elements
+      nElem_ = nElements();
+      fieldTrial_.deallocate();
+      resTrial_.deallocate();
+      temp_.deallocate();
+      fieldTrial_.allocate(nElem_);
+      resTrial_.allocate(nElem_);
+      temp_.allocate(nElem_);
+      if (adaptive_) {
+         bestField_.deallocate();
+         bestField_.allocate(nElem_);
+      }
+      itrBest_ = -1;
+   }
+
+   /*
+   * Get the log output stream (default implementation).
+   */
+   template <typename Iterator, typename T>
+   std::ostream& AmIteratorTmpl<Iterator,T>::logFile() const
+   {  return Log::file(); }
+
    template <typename Iterator, typename T>
    void AmIteratorTmpl<Iterator,T>::clear()
    {
       if (!isAllocatedAM_) return;
 
       // Clear histories and bases (ring buffers)
-      Log::file() << "Clearing ring buffers\n";
+      logFile() << "Clearing ring buffers\n";
       resHists_.clear();
       fieldHists_.clear();
       resBasis_.clear();
@@ -373,66 +539,202 @@ namespace Pscf
          }
       }
 
-      // Do nothing else on first iteration
-      if (itr_ == 0) return;
+      // Without retainBasis, do nothing else on the first iteration
+      if (!retainBasis_ && itr_ == 0) return;
 
-      // Update basis spanning differences of past field vectors
-      updateBasis(fieldBasis_, fieldHists_);
+      if (fieldHists_.size() == 1) {
 
-      // Update basis spanning differences of past residual vectors
-      updateBasis(resBasis_, resHists_);
+         // Do nothing else on first iteration (or after a restart),
+         // unless basis vectors were retained from a previous solve
+         if (nBasis_ == 0) return;
 
-      // Update nBasis_
-      nBasis_ = fieldBasis_.size();
-      UTIL_CHECK(fieldBasis_.size() == nBasis_);
+         // Recompute the entire U matrix for the retained basis
+         int m, n;
+         double dotprod;
+         for (m = 0; m < nBasis_; ++m) {
+            for (n = 0; n <= m; ++n) {
+               dotprod = dotProduct(resBasis_[m], resBasis_[n]);
+               U_(m, n) = dotprod;
+               U_(n, m) = dotprod;
+            }
+         }
+         updateV(v_, resHists_[0], resBasis_, nBasis_);
+
+      } else {
 
-      // Update the U matrix and v vector.
-      updateU(U_, resBasis_, nBasis_);
-      updateV(v_, resHists_[0], resBasis_, nBasis_);
-      // Note: resHists_[0] is the current residual vector
+         // Update basis spanning differences of past field vectors
+         updateBasis(fieldBasis_, fieldHists_);
+
+         // Update basis spanning differences of past residual vectors
+         updateBasis(resBasis_, resHists_);
+
+         // Update nBasis_
+         nBasis_ = fieldBasis_.size();
+         UTIL_CHECK(fieldBasis_.size() == nBasis_);
+
+         // In adaptive mode, use only the histCap_ newest basis vectors,
+         // and add at most one basis vector per iteration. This keeps 
+         // the leading nBasis_ x nBasis_ block of U_ up to date.
+         if (adaptive_) {
+            int maxBasis = maxHist_;
+            if (isSafeMode_ && maxBasis > 5) maxBasis = 5;
+            if (histCap_ < maxBasis) ++histCap_;
+            if (nBasis_ > histCap_) nBasis_ = histCap_;
+         }
+
+         // Update the U matrix and v vector.
+         updateU(U_, resBasis_, nBasis_);
+         updateV(v_, resHists_[0], resBasis_, nBasis_);
+         // Note: resHists_[0] is the current residual vector
+
+      }
+
+      // Discard old basis vectors if U_ is ill-conditioned
+      if (adaptive_) {
+         truncateBasis();
+         if (nBasis_ == 0) return;
+      }
 
       // Solve matrix equation problem to compute coefficients
       // that minmize the L2 norm of the residual vector.
       if (nBasis_ == 1) {
          // Solve explicitly for coefficient
          coeffs_[0] = v_[0] / U_(0,0);
-      } else
-      if (nBasis_ < maxHist_) {
-
-         // Create temporary smaller version of U_, v_, coeffs_ .
-         // This is done to avoid reallocating U_ with each iteration.
-         DMatrix<double> tempU;
-         DArray<double> tempv,tempcoeffs;
-         tempU.allocate(nBasis_,nBasis_);
-         tempv.allocate(nBasis_);
-         tempcoeffs.allocate(nBasis_);
-         for (int i = 0; i < nBasis_; ++i) {
-            tempv[i] = v_[i];
-            for (int j = 0; j < nBasis_; ++j) {
-               tempU(i,j) = U_(i,j);
+      } else {
+
+         // Factor only the leading nBasis_ x nBasis_ block of U_, and
+         // solve for the first nBasis_ elements of coeffs_.
+         luSolver_.computeLU(U_, nBasis_);
+         luSolver_.solve(v_, coeffs_);
+
+      }
+
+      return;
+   }
+
+   /*
+   * Truncate the basis if the U matrix is ill-conditioned.
+   */
+   template <typename Iterator, typename T>
+   void AmIteratorTmpl<Iterator,T>::truncateBasis()
+   {
+      // Cholesky decomposition C = L L^T of the leading block of the 
+      // normalized matrix C(i,j) = U(i,j)/sqrt(U(i,i)U(j,j)). Basis 
+      // vectors are ordered from newest to oldest, and the factor of 
+      // each leading block of C is the leading block of L. L(j,j)^2 is 
+      // the squared sine of the angle between residual basis vector j 
+      // and the span of vectors 0,...,j-1, and its inverse is used as 
+      // an estimate of the condition number.
+      double minSq = 1.0/maxCond_;
+      double sum, d;
+      int i, j, k;
+      int n = nBasis_;
+      for (j = 0; j < nBasis_; ++j) {
+         norms_[j] = sqrt(U_(j, j));
+         if (!(norms_[j] > 0.0)) {
+            n = j;
+            break;
+         }
+      }
+      for (j = 0; j < n; ++j) {
+         sum = 1.0;
+         for (k = 0; k < j; ++k) {
+            sum -= L_(j, k)*L_(j, k);
+         }
+         if (!(sum > minSq)) {
+            n = j;
+            break;
+         }
+         d = sqrt(sum);
+         L_(j, j) = d;
+         for (i = j + 1; i < n; ++i) {
+            sum = U_(i, j)/(norms_[i]*norms_[j]);
+            for (k = 0; k < j; ++k) {
+               sum -= L_(i, k)*L_(j, k);
             }
+            L_(i, j) = sum/d;
          }
+      }
 
-         // Solve matrix equation
-         LuSolver solver;
-         solver.allocate(nBasis_);
-         solver.computeLU(tempU);
-         solver.solve(tempv,tempcoeffs);
+      if (n < nBasis_) {
+         if (verbose_ > 1) {
+            logFile() << "Truncating basis from " << nBasis_ 
+                      << " to " << n << " vectors\n";
+         }
+         nBasis_ = n;
+         histCap_ = n;
+         ++nTruncate_;
+      }
+   }
+
+   /*
+   * Record best state, adjust lambda, and detect stagnation.
+   */
+   template <typename Iterator, typename T>
+   int AmIteratorTmpl<Iterator,T>::adapt(double error)
+   {
+      // Record best state, or restart if no improvement is recent
+      if (itrBest_ < 0 || error < bestError_) {
+         bestError_ = error;
+         itrBest_ = itr_;
+         setEqual(bestField_, fieldHists_[0]);
+      } else 
+      if (itr_ - itrBest_ >= nStagnant_) {
+         logFile() << "Iterator stagnated.\n";
+         if (restart()) {
+            return 1;
+         } else {
+            return 2;
+         }
+      }
 
-         // Transfer solution to full-sized member variable
-         for (int i = 0; i < nBasis_; ++i) {
-            coeffs_[i] = tempcoeffs[i];
+      // Damp lambda if the error more than doubled, else relax damping
+      if (fieldHists_.size() > 1) {
+         if (error > 2.0*prevError_) {
+            lambdaScale_ *= 0.5;
+            if (lambdaScale_ < 0.1) lambdaScale_ = 0.1;
+         } else {
+            lambdaScale_ *= 1.25;
+            if (lambdaScale_ > lambdaMax_) lambdaScale_ = lambdaMax_;
          }
+      }
+      prevError_ = error;
+      lambda_ *= lambdaScale_;
 
-      } else
-      if (nBasis_ == maxHist_) {
-         LuSolver solver;
-         solver.allocate(maxHist_);
-         solver.computeLU(U_);
-         solver.solve(v_, coeffs_);
+      return 0;
+   }
+
+   /*
+   * Restart from the best state, or escalate to safe mode.
+   */
+   template <typename Iterator, typename T>
+   bool AmIteratorTmpl<Iterator,T>::restart()
+   {
+      // Give up if there is no saved state or safe mode also failed
+      if (itrBest_ < 0 || isSafeMode_) return false;
+
+      // After the first restart, escalate to a safer mixing mode
+      if (nRestart_ > 0) {
+         isSafeMode_ = true;
+         lambdaMax_ = 0.5;
+         logFile() << "Switching to safe mixing mode\n";
       }
+      ++nRestart_;
 
-      return;
+      logFile() << "Restarting from best state, error  = " 
+                << Dbl(bestError_, 15) << "\n";
+      setEqual(fieldTrial_, bestField_);
+      update(fieldTrial_);
+      evaluate();
+
+      clear();
+      nBasis_ = 0;
+      histCap_ = 0;
+      fErrorStep_ = -1.0;
+      lambdaScale_ = lambdaMax_;
+      itrBest_ = itr_ + 1;
+
+      return true;
    }
 
    template <typename Iterator, typename T>
@@ -473,12 +775,40 @@ namespace Pscf
       if (!isAllocatedAM()) {
          allocateAM();
       } else {
-         if (!isContinuation) {
+         if (isContinuation) {
+            // Retain basis vectors, but discard field and residual
+            // histories, which were computed for other parameters.
+            // Without retainBasis, keep all histories.
+            if (retainBasis_) {
+               resHists_.clear();
+               fieldHists_.clear();
+            }
+         } else {
             clear();
          }
       }
    }
 
+   /*
+   * Estimate free energy error from residual and Anderson step.
+   */
+   template <typename Iterator, typename T>
+   double 
+   AmIteratorTmpl<Iterator,T>::estimateFError(T const & resid, 
+                                              T const & field,
+                                              T const & fieldNew)
+   {
+      double dot = dotProduct(resid, fieldNew) - dotProduct(resid, field);
+      return 0.5*std::abs(dot);
+   }
+
+   /*
+   * Refine discretization (default implementation does nothing).
+   */
+   template <typename Iterator, typename T>
+   bool AmIteratorTmpl<Iterator,T>::refine(double error)
+   {  return false; }
+
    /*
    * Compute L2 norm of a vector.
    */
@@ -531,24 +861,24 @@ namespace Pscf
 
       if (verbose > 1) {
 
-         Log::file() << "\n";
+         logFile() << "\n";
 
          // Find max residual vector element
          double maxRes  = maxAbs(resHists_[0]);
-         Log::file() << "Max Residual  = " << Dbl(maxRes,15) << "\n";
+         logFile() << "Max Residual  = " << Dbl(maxRes,15) << "\n";
    
          // Find norm of residual vector
          double normRes = norm(resHists_[0]);
-         Log::file() << "Residual Norm = " << Dbl(normRes,15) << "\n";
+         logFile() << "Residual Norm = " << Dbl(normRes,15) << "\n";
    
          // Find root-mean-squared residual element value
          double rmsRes = normRes/sqrt(nElem_);
-         Log::file() << "RMS Residual  = " << Dbl(rmsRes,15) << "\n";
+         logFile() << "RMS Residual  = " << Dbl(rmsRes,15) << "\n";
 
          // Find norm of residual vector relative to field
          double normField = norm(fieldHists_[0]);
          double relNormRes = normRes/normField;
-         Log::file() << "Relative Norm = " << Dbl(relNormRes,15) << std::endl;
+         logFile() << "Relative Norm = " << Dbl(relNormRes,15) << std::endl;
    
          // Check if calculation has diverged (normRes will be NaN)
          UTIL_CHECK(!std::isnan(normRes));
@@ -582,7 +912,7 @@ namespace Pscf
          } else {
             UTIL_THROW("Invalid iterator error type in parameter file.");
          }
-         //Log::file() << ",  error  = " << Dbl(error, 15) << "\n";
+         //logFile() << ",  error  = " << Dbl(error, 15) << "\n";
 
       }
 
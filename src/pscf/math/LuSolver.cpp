@@ -7,37 +7,63 @@
 
 #include "LuSolver.h"
 #include <gsl/gsl_linalg.h>
+#include <cmath>
+#include <limits>
+
+#ifdef PSCF_LAPACK
+extern "C" {
+   void dgetrf_(int* m, int* n, double* a, int* lda, int* ipiv, int* info);
+   void dgetrs_(char* trans, int* n, int* nrhs, double* a, int* lda,
+                int* ipiv, double* b, int* ldb, int* info);
+   void dgetri_(int* n, double* a, int* lda, int* ipiv, double* work,
+                int* lwork, int* info);
+}
+#endif
 
 namespace Pscf
 {
-  
+
    LuSolver::LuSolver()
-    : luPtr_(0),
+    : lu_(),
+      perm_(),
+      work_(),
       permPtr_(0),
-      n_(0)
+      luData_(0),
+      signum_(0),
+      n_(0),
+      m_(0),
+      #ifdef PSCF_LAPACK
+      backend_(Lapack)
+      #else
+      backend_(Blocked)
+      #endif
    {
-      // Initialize gs_vector b_ 
+      // Initialize gs_vector b_
       b_.size = 0;
       b_.stride = 1;
       b_.data = 0;
       b_.block = 0;
       b_.owner = 0;
 
-      // Initialize gsl_vector x_ 
+      // Initialize gsl_vector x_
       x_.size = 0;
       x_.stride = 1;
       x_.data = 0;
       x_.block = 0;
       x_.owner = 0;
+
+      // Initialize gsl_matrix lu_gsl_
+      lu_gsl_.size1 = 0;
+      lu_gsl_.size2 = 0;
+      lu_gsl_.tda = 0;
+      lu_gsl_.data = 0;
+      lu_gsl_.block = 0;
+      lu_gsl_.owner = 0;
    }
 
    LuSolver::~LuSolver()
    {
-      if (n_ > 0)  {
-         if (luPtr_) gsl_matrix_free(luPtr_);
-         if (gMatInverse_) gsl_matrix_free(gMatInverse_);
-         if (permPtr_) gsl_permutation_free(permPtr_);
-      }
+      if (permPtr_) gsl_permutation_free(permPtr_);
    }
 
    /*
@@ -47,18 +73,74 @@ namespace Pscf
    {
       UTIL_CHECK(n > 0);
       UTIL_CHECK(n_ == 0);
-      UTIL_CHECK(luPtr_ == 0);
       UTIL_CHECK(permPtr_ == 0);
-      luPtr_ = gsl_matrix_alloc(n, n);
-      gMatInverse_ = gsl_matrix_alloc(n, n);
+      lu_.allocate(n*n);
+      perm_.allocate(n);
+      work_.allocate(n);
+      unit_.allocate(n);
+      column_.allocate(n);
       permPtr_ = gsl_permutation_alloc(n);
       b_.size = n;
       x_.size = n;
+      lu_gsl_.size1 = n;
+      lu_gsl_.size2 = n;
+      lu_gsl_.tda = n;
       n_ = n;
+      m_ = n;
+   }
+
+   /*
+   * Release memory and reset n.
+   */
+   void LuSolver::deallocate()
+   {
+      if (n_ == 0) return;
+      lu_.deallocate();
+      perm_.deallocate();
+      work_.deallocate();
+      unit_.deallocate();
+      column_.deallocate();
+      if (permPtr_) {
+         gsl_permutation_free(permPtr_);
+         permPtr_ = 0;
+      }
+      b_.size = 0;
+      x_.size = 0;
+      lu_gsl_.size1 = 0;
+      lu_gsl_.size2 = 0;
+      lu_gsl_.tda = 0;
+      lu_gsl_.data = 0;
+      luData_ = 0;
+      n_ = 0;
+      m_ = 0;
+   }
+
+   /*
+   * Choose backend.
+   */
+   void LuSolver::setBackend(Backend backend)
+   {
+      if (backend == Lapack && !hasLapack()) {
+         UTIL_THROW("LAPACK backend requested but PSCF_LAPACK not defined");
+      }
+      backend_ = backend;
+      luData_ = 0;
+   }
+
+   /*
+   * Is the LAPACK backend available?
+   */
+   bool LuSolver::hasLapack()
+   {
+      #ifdef PSCF_LAPACK
+      return true;
+      #else
+      return false;
+      #endif
    }
 
    /*
-   * Compute the LU decomposition for later use.
+   * Compute the LU decomposition of a copy of A.
    */
    void LuSolver::computeLU(const Matrix<double>& A)
    {
@@ -70,11 +152,198 @@ namespace Pscf
       int k = 0;
       for (i = 0; i < n_;  ++i) {
          for (j = 0; j < n_; ++j) {
-            luPtr_->data[k] = A(i,j);
+            lu_[k] = A(i,j);
+            ++k;
+         }
+      }
+      luData_ = lu_.cArray();
+      m_ = n_;
+      factorize();
+   }
+
+   /*
+   * Compute the LU decomposition of a copy of the leading block of A.
+   */
+   void LuSolver::computeLU(const Matrix<double>& A, int m)
+   {
+      UTIL_CHECK(n_ > 0);
+      UTIL_CHECK(m > 0);
+      UTIL_CHECK(m <= n_);
+      UTIL_CHECK(A.capacity1() >= m);
+      UTIL_CHECK(A.capacity2() >= m);
+
+      // Copy leading block, stored contiguously with row length m
+      int i, j;
+      int k = 0;
+      for (i = 0; i < m;  ++i) {
+         for (j = 0; j < m; ++j) {
+            lu_[k] = A(i,j);
             ++k;
          }
       }
-      gsl_linalg_LU_decomp(luPtr_, permPtr_, &signum_);
+      luData_ = lu_.cArray();
+      m_ = m;
+      factorize();
+   }
+
+   /*
+   * Compute the LU decomposition in the memory of A.
+   */
+   void LuSolver::computeLUInPlace(Matrix<double>& A)
+   {
+      UTIL_CHECK(n_ > 0);
+      UTIL_CHECK(A.capacity1() == n_);
+      UTIL_CHECK(A.capacity2() == n_);
+      luData_ = A.cArray();
+      m_ = n_;
+      factorize();
+   }
+
+   /*
+   * Factorize matrix at luData_ using the current backend.
+   */
+   void LuSolver::factorize()
+   {
+      switch (backend_) {
+      case Blocked:
+         factorizeBlocked();
+         break;
+      case Lapack:
+         {
+            #ifdef PSCF_LAPACK
+            // Row major storage of A is column major storage of A^T.
+            // A positive info denotes an exact zero pivot, for which
+            // the factorization is completed (see class doc).
+            int info;
+            dgetrf_(&m_, &m_, luData_, &m_, perm_.cArray(), &info);
+            UTIL_CHECK(info >= 0);
+            #endif
+         }
+         break;
+      case Gsl:
+         {
+            lu_gsl_.size1 = m_;
+            lu_gsl_.size2 = m_;
+            lu_gsl_.tda = m_;
+            lu_gsl_.data = luData_;
+            gsl_permutation* perm = permPtr_;
+            gsl_permutation view;
+            if (m_ < n_) {
+               // GSL requires a permutation of matching size
+               view.size = m_;
+               view.data = permPtr_->data;
+               perm = &view;
+            }
+            gsl_linalg_LU_decomp(&lu_gsl_, perm, &signum_);
+         }
+         break;
+      }
+   }
+
+   /*
+   * Right-looking blocked LU decomposition with partial pivoting.
+   *
+   * The matrix is stored in row major order. Each panel of nb columns
+   * is factored with rows swapped across the full matrix, after which
+   * the block row of U to the right of the panel is computed and the
+   * trailing submatrix is updated. The update is tiled over columns,
+   * so that a tile of the block row of U remains in cache while it is
+   * applied to all rows below the panel.
+   */
+   void LuSolver::factorizeBlocked()
+   {
+      const int n = m_;
+      const int nb = 32;   // Panel width
+      const int jb = 256;  // Column tile width for trailing update
+      double* a = luData_;
+      double* ri;
+      double const * rk;
+      double pivot, l, t, aMax;
+      int i, j, k, p, k0, k1, j0, j1;
+
+      for (i = 0; i < n; ++i) {
+         perm_[i] = i;
+      }
+      signum_ = 1;
+
+      for (k0 = 0; k0 < n; k0 += nb) {
+         k1 = (k0 + nb < n) ? k0 + nb : n;
+
+         // Factor panel, columns [k0, k1)
+         for (k = k0; k < k1; ++k) {
+
+            // Choose pivot row
+            p = k;
+            aMax = std::abs(a[k*n + k]);
+            for (i = k + 1; i < n; ++i) {
+               t = std::abs(a[i*n + k]);
+               if (t > aMax) {
+                  aMax = t;
+                  p = i;
+               }
+            }
+            // Exact zero pivot: All multipliers are zero, so leave the
+            // column as is. A later solve divides by zero (see class doc)
+            if (aMax == 0.0) {
+               continue;
+            }
+
+            // Swap full rows k and p
+            if (p != k) {
+               ri = a + p*n;
+               double* rkw = a + k*n;
+               for (j = 0; j < n; ++j) {
+                  t = rkw[j];
+                  rkw[j] = ri[j];
+                  ri[j] = t;
+               }
+               j = perm_[k];
+               perm_[k] = perm_[p];
+               perm_[p] = j;
+               signum_ = -signum_;
+            }
+
+            // Compute multipliers and update remainder of panel
+            rk = a + k*n;
+            pivot = rk[k];
+            for (i = k + 1; i < n; ++i) {
+               ri = a + i*n;
+               l = ri[k]/pivot;
+               ri[k] = l;
+               for (j = k + 1; j < k1; ++j) {
+                  ri[j] -= l*rk[j];
+               }
+            }
+         }
+         if (k1 == n) break;
+
+         // Block row of U: solve L11 U12 = A12 (unit lower L11)
+         for (k = k0; k < k1; ++k) {
+            rk = a + k*n;
+            for (i = k + 1; i < k1; ++i) {
+               ri = a + i*n;
+               l = ri[k];
+               for (j = k1; j < n; ++j) {
+                  ri[j] -= l*rk[j];
+               }
+            }
+         }
+
+         // Trailing update: A22 -= L21 U12, tiled over columns
+         for (j0 = k1; j0 < n; j0 += jb) {
+            j1 = (j0 + jb < n) ? j0 + jb : n;
+            for (i = k1; i < n; ++i) {
+               ri = a + i*n;
+               for (k = k0; k < k1; ++k) {
+                  l = ri[k];
+                  rk = a + k*n;
+                  for (j = j0; j < j1; ++j) {
+                     ri[j] -= l*rk[j];
+                  }
+               }
+            }
+         }
+      }
    }
 
    /*
@@ -83,31 +352,147 @@ namespace Pscf
    void LuSolver::solve(Array<double>& b, Array<double>& x)
    {
       UTIL_CHECK(n_ > 0);
-      UTIL_CHECK(b.capacity() == n_);
-      UTIL_CHECK(x.capacity() == n_);
+      UTIL_CHECK(luData_);
+      UTIL_CHECK(b.capacity() >= m_);
+      UTIL_CHECK(x.capacity() >= m_);
 
-      // Associate gsl_vectors b_ and x_ with Arrays b and x
-      b_.data = b.cArray();
-      x_.data = x.cArray();
+      switch (backend_) {
+      case Blocked:
+         {
+            const int n = m_;
+            double const * a = luData_;
+            double const * ri;
+            double sum;
+            int i, j;
 
-      // Solve system of equations
-      gsl_linalg_LU_solve(luPtr_, permPtr_, &b_, &x_);
+            // Forward substitution, L y = P b (unit diagonal)
+            for (i = 0; i < n; ++i) {
+               ri = a + i*n;
+               sum = b[perm_[i]];
+               for (j = 0; j < i; ++j) {
+                  sum -= ri[j]*work_[j];
+               }
+               work_[i] = sum;
+            }
 
-      // Destroy temporary associations
-      b_.data = 0;
-      x_.data = 0;
+            // Back substitution, U x = y
+            for (i = n - 1; i >= 0; --i) {
+               ri = a + i*n;
+               sum = work_[i];
+               for (j = i + 1; j < n; ++j) {
+                  sum -= ri[j]*x[j];
+               }
+               x[i] = sum/ri[i];
+            }
+         }
+         break;
+      case Lapack:
+         {
+            #ifdef PSCF_LAPACK
+            for (int i = 0; i < m_; ++i) {
+               x[i] = b[i];
+            }
+            char trans = 'T';
+            int nrhs = 1;
+            int info;
+            dgetrs_(&trans, &m_, &nrhs, luData_, &m_, perm_.cArray(),
+                    x.cArray(), &m_, &info);
+            UTIL_CHECK(info == 0);
+            #endif
+         }
+         break;
+      case Gsl:
+         {
+            // Associate gsl_vectors b_ and x_ with Arrays b and x
+            b_.size = m_;
+            x_.size = m_;
+            b_.data = b.cArray();
+            x_.data = x.cArray();
+            lu_gsl_.data = luData_;
+            gsl_permutation* perm = permPtr_;
+            gsl_permutation view;
+            if (m_ < n_) {
+               view.size = m_;
+               view.data = permPtr_->data;
+               perm = &view;
+            }
+
+            // Solve system of equations
+            gsl_linalg_LU_solve(&lu_gsl_, perm, &b_, &x_);
+
+            // Destroy temporary associations
+            b_.data = 0;
+            x_.data = 0;
+         }
+         break;
+      }
    }
 
-   /*  
-   * Find inverse 
-   */  
+   /*
+   * Find inverse
+   */
    void LuSolver::inverse(Matrix<double>& inv)
-   {   
-      UTIL_CHECK(n_ > 0); 
+   {
+      UTIL_CHECK(n_ > 0);
+      UTIL_CHECK(luData_);
+      UTIL_CHECK(m_ == n_);
+      UTIL_CHECK(inv.capacity1() == n_);
+      UTIL_CHECK(inv.capacity2() == n_);
 
-      gMatInverse_->data = inv.cArray();
-      gsl_linalg_LU_invert(luPtr_, permPtr_, gMatInverse_);
+      switch (backend_) {
+      case Blocked:
+         {
+            int i, j;
+            for (j = 0; j < n_; ++j) {
+               for (i = 0; i < n_; ++i) {
+                  unit_[i] = 0.0;
+               }
+               unit_[j] = 1.0;
+               solve(unit_, column_);
+               for (i = 0; i < n_; ++i) {
+                  inv(i, j) = column_[i];
+               }
+            }
+         }
+         break;
+      case Lapack:
+         {
+            #ifdef PSCF_LAPACK
+            // Invert a copy of the factors, which dgetri overwrites
+            double* data = inv.cArray();
+            int nn = n_*n_;
+            for (int i = 0; i < nn; ++i) {
+               data[i] = luData_[i];
+            }
+            int info;
+            dgetri_(&n_, data, &n_, perm_.cArray(), work_.cArray(),
+                    &n_, &info);
+            UTIL_CHECK(info >= 0);
 
-   } 
+            // Singular matrix: dgetri does not compute an inverse
+            if (info > 0) {
+               double nan = std::numeric_limits<double>::quiet_NaN();
+               for (int i = 0; i < nn; ++i) {
+                  data[i] = nan;
+               }
+            }
+            #endif
+         }
+         break;
+      case Gsl:
+         {
+            gsl_matrix invGsl;
+            invGsl.size1 = n_;
+            invGsl.size2 = n_;
+            invGsl.tda = n_;
+            invGsl.data = inv.cArray();
+            invGsl.block = 0;
+            invGsl.owner = 0;
+            lu_gsl_.data = luData_;
+            gsl_linalg_LU_invert(&lu_gsl_, permPtr_, &invGsl);
+         }
+         break;
+      }
+   }
 
 }
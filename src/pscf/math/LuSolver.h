@@ -10,11 +10,12 @@
 
 #include <util/containers/Array.h>
 #include <util/containers/Matrix.h>
+#include <util/containers/DArray.h>
 #include <gsl/gsl_matrix.h>
 #include <gsl/gsl_vector.h>
 #include <gsl/gsl_permutation.h>
 
-namespace Pscf 
+namespace Pscf
 {
 
    using namespace Util;
@@ -22,15 +23,43 @@ namespace Pscf
    /**
    * Solve Ax=b by LU decomposition of A.
    *
-   * This class is a simple wrapper for the functions provided by
-   * the Gnu Scientific Library (GSL).
+   * The decomposition may be computed by any of several backends:
+   *
+   *   - Blocked: A right-looking blocked LU decomposition with partial
+   *     pivoting, in which the trailing submatrix is updated in cache
+   *     sized tiles. This is implemented here, with no dependencies.
+   *
+   *   - Lapack: The LAPACK functions dgetrf, dgetrs and dgetri. This is
+   *     available only if the code was compiled with the preprocessor
+   *     macro PSCF_LAPACK defined and linked to a LAPACK library (e.g.,
+   *     a threaded BLAS such as OpenBLAS or MKL).
+   *
+   *   - Gsl: The Gnu Scientific Library (GSL) functions used by earlier
+   *     versions of this class.
+   *
+   * The default backend is Lapack if available, or Blocked otherwise.
+   *
+   * A matrix with an exact zero pivot does not cause an Exception to
+   * be thrown by any backend. The decomposition is completed, and a 
+   * subsequent call to solve or inverse yields non-finite (Inf or NaN)
+   * values, as in earlier GSL-based versions of this class. Callers
+   * such as AmIteratorTmpl detect these values in the resulting 
+   * fields and recover (e.g., by restarting).
+   * All backends operate in place on an internal copy of the matrix, or
+   * directly on the matrix passed to computeLUInPlace, with no further
+   * copies.
    *
    * \ingroup Pscf_Math_Module
-   */  
+   */
    class LuSolver
    {
    public:
 
+      /**
+      * Algorithm used to compute and apply the decomposition.
+      */
+      enum Backend {Blocked, Lapack, Gsl};
+
       /**
       * Constructor.
       */
@@ -48,51 +77,148 @@ namespace Pscf
       */
       void allocate(int n);
 
+      /**
+      * Release memory, so that allocate may be called again.
+      */
+      void deallocate();
+
+      /**
+      * Choose the backend.
+      *
+      * Must be called before computeLU. Throws an Exception if the
+      * Lapack backend is requested but unavailable.
+      *
+      * \param backend  algorithm used for subsequent decompositions
+      */
+      void setBackend(Backend backend);
+
       /**
       * Compute the LU decomposition for later use.
       *
+      * Does not throw if A has an exact zero pivot (see class doc).
+      *
+      * Matrix A is copied into memory owned by this object, and is
+      * not modified.
+      *
       * \param A the square matrix A in problem Ax=b.
       */
       void computeLU(const Matrix<double>& A);
 
+      /**
+      * Compute the LU decomposition of the leading m x m block of A.
+      *
+      * The leading m x m block of matrix A is copied into memory owned
+      * by this object, and only that block is factored, so the cost
+      * scales as m^3 rather than n^3. Subsequent calls to solve use
+      * and set only the first m elements of b and x, until the next
+      * call to computeLU or computeLUInPlace. This allows a solver
+      * allocated once with a maximum dimension n to be used for a
+      * system whose size varies (e.g., in AmIteratorTmpl).
+      *
+      * \param A  matrix whose leading block is the matrix in Ax=b
+      * \param m  dimension of leading block (0 < m <= n)
+      */
+      void computeLU(const Matrix<double>& A, int m);
+
+      /**
+      * Compute the LU decomposition in the memory of matrix A.
+      *
+      * On return, A contains the LU factors rather than the original
+      * matrix. Matrix A must not be modified or destroyed until after
+      * the last call to solve or inverse that uses this decomposition.
+      * This avoids a copy of a large matrix (e.g., a Jacobian) that is
+      * not needed after it is factored.
+      *
+      * \param A the square matrix A in problem Ax=b (overwritten).
+      */
+      void computeLUInPlace(Matrix<double>& A);
+
       /**
       * Solve Ax = b for known b to compute x.
       *
+      * If the decomposition was computed for a leading block of
+      * dimension m < n, only the first m elements of b and x are
+      * used, and the remaining elements of x are not modified.
+      *
       * \param b the RHS vector
       * \param x the solution vector
       */
       void solve(Array<double>& b, Array<double>& x);
 
-      /** 
+      /**
       * Compute inverse of matrix A.
       *
+      * Requires a decomposition of the full n x n matrix.
+      *
       * \param inv inverse of matrix A (output)
-      */  
-      void inverse (Matrix<double>& inv); 
- 
+      */
+      void inverse (Matrix<double>& inv);
+
+      /**
+      * Get the current backend.
+      */
+      Backend backend() const
+      {  return backend_; }
+
+      /**
+      * Was the code compiled with support for the Lapack backend?
+      */
+      static bool hasLapack();
+
    private:
 
+      /// Storage for LU factors, if not computed in place.
+      DArray<double> lu_;
+
+      /// Row permutation (Blocked) or pivot indices (Lapack).
+      DArray<int> perm_;
+
+      /// Work space for solve (Blocked) and inverse (Lapack).
+      DArray<double> work_;
+
+      /// Unit vector used by inverse (Blocked).
+      DArray<double> unit_;
+
+      /// Column of inverse computed by inverse (Blocked).
+      DArray<double> column_;
+
       /// RHS vector of Ax=b.
       gsl_vector b_;
 
       /// Solution vector of Ax=b.
       gsl_vector x_;
 
-      /// Pointer to LU decomposition matrix.
-      gsl_matrix* luPtr_;
-
-      /// Pointer to inverse matrix.
-      gsl_matrix* gMatInverse_;
+      /// GSL view of LU decomposition matrix.
+      gsl_matrix lu_gsl_;
 
-      /// Pointer to permutation in LU decomposition.
+      /// Pointer to permutation in GSL LU decomposition.
       gsl_permutation* permPtr_;
 
+      /// Pointer to first element of LU factors (row major).
+      double* luData_;
+
       /// Sign of permutation in LU decomposition.
       int signum_;
 
-      /// Number of rows and columns in matrix.
+      /// Number of rows and columns in matrix (allocated dimension).
       int n_;
 
+      /// Dimension of the matrix in the current decomposition (m_ <= n_).
+      int m_;
+
+      /// Current backend.
+      Backend backend_;
+
+      /**
+      * Factorize the m_ x m_ matrix stored at luData_ in place.
+      */
+      void factorize();
+
+      /**
+      * Blocked LU decomposition with partial pivoting.
+      */
+      void factorizeBlocked();
+
    };
 
 }
@@ -0,0 +1,66 @@
+#ifndef PSCF_MATRIX_PRODUCT_H
+#define PSCF_MATRIX_PRODUCT_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/Array.h>
+#include <util/containers/Matrix.h>
+
+namespace Pscf 
+{
+
+   using namespace Util;
+
+   /**
+   * Compute y_i += sum_j A(i,j) x_j for a set of arrays.
+   *
+   * Here, A is an m x n matrix, x_0, ..., x_{n-1} are arrays and 
+   * y_0, ..., y_{m-1} are arrays, each with length elements. This is 
+   * the matrix product Y += A X, in which row j of X is the array x_j 
+   * and row i of Y is y_i. Rows are passed as pointers, and so need 
+   * not be stored contiguously (e.g., they may be separate monomer 
+   * fields, or segments of one long residual vector). 
+   *
+   * The computation is blocked over elements, so that all rows of X 
+   * and Y are read and written once per block while the block remains 
+   * in cache, rather than once per element of A.
+   *
+   * \param A  m x n coefficient matrix
+   * \param x  array of n pointers to rows of X (input)
+   * \param y  array of m pointers to rows of Y (updated)
+   * \param length  number of elements in each row
+   *
+   * \ingroup Pscf_Math_Module
+   */
+   void addMatrixProduct(Matrix<double> const & A, 
+                         Array<double const *> const & x,
+                         Array<double*> const & y,
+                         int length);
+
+   /**
+   * Compute sum_k sum_{i,j} A(i,j) x_i[k] y_j[k] for a set of arrays.
+   *
+   * Here, A is an m x n matrix, x_0, ..., x_{m-1} and y_0, ..., 
+   * y_{n-1} are arrays with length elements. This is the trace of 
+   * X^T A Y, computed in blocks over elements as for addMatrixProduct. 
+   * Terms for which A(i,j) == 0 are skipped.
+   *
+   * \param A  m x n coefficient matrix
+   * \param x  array of m pointers to rows of X
+   * \param y  array of n pointers to rows of Y
+   * \param length  number of elements in each row
+   *
+   * \ingroup Pscf_Math_Module
+   */
+   double bilinearForm(Matrix<double> const & A, 
+                       Array<double const *> const & x,
+                       Array<double const *> const & y,
+                       int length);
+
+}
+#endif
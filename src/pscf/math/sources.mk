@@ -1,5 +1,6 @@
 pscf_math_= \
   pscf/math/LuSolver.cpp \
+  pscf/math/MatrixProduct.cpp \
   pscf/math/TridiagonalSolver.cpp \
   pscf/math/IntVec.cpp \
   pscf/math/Field.cpp
@@ -21,6 +21,9 @@ LIBS=$(PSCF_LIBS)
 INCLUDES+=$(GSL_INC)
 LIBS+=$(GSL_LIB) 
 
+# Add optional LAPACK library (empty unless PSCF_LAPACK is used)
+LIBS+=$(LAPACK_LIB)
+
 # Preprocessor macro definitions needed in src/pscf
 DEFINES=$(PSCF_DEFS) $(UTIL_DEFS)
 
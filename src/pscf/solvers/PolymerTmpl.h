@@ -19,6 +19,9 @@
 #include <util/containers/DMatrix.h>
 
 #include <cmath>
+#include <map>
+#include <vector>
+#include <algorithm>
 
 namespace Pscf
 { 
@@ -35,6 +38,20 @@ namespace Pscf
    * equation (MDE) for the entire molecule and computes monomer
    * concentration fields for all blocks.
    *
+   * If the optional parameter mergeArms is true, identical subtrees
+   * (e.g., the arms of a star) that are attached to the same vertex
+   * are represented by a single subtree, with a multiplicity equal to
+   * the number of copies. Identical subtrees attached to different
+   * vertices, such as single side chains grafted at different junctions
+   * of a bottlebrush backbone, are not merged. The blocks of the 
+   * remaining copies are assigned a multiplicity of 0, and their 
+   * propagators and concentrations are never computed. The 
+   * concentration field of each block with multiplicity m > 1 is the 
+   * sum of the concentrations of all m equivalent blocks, and the
+   * representative() function maps each block to the block whose
+   * concentration includes its own. Subclasses use the multiplicity() 
+   * function to avoid allocating memory for blocks with multiplicity 0.
+   *
    * \ingroup Pscf_Solver_Module
    */
    template <class Block>
@@ -186,6 +203,35 @@ namespace Pscf
       */
       double length() const;
 
+      /**
+      * Number of equivalent blocks represented by a block.
+      *
+      * Returns 1 for all blocks unless mergeArms is enabled. If so,
+      * returns the number of equivalent copies represented by each 
+      * block that is explicitly computed, and 0 for each block whose 
+      * propagators and concentration are not computed.
+      *
+      * \param blockId  block index, 0 <= blockId < nBlock
+      */
+      int multiplicity(int blockId) const;
+
+      /**
+      * Index of the block whose concentration includes this block.
+      *
+      * Returns blockId for each block with nonzero multiplicity. For
+      * a block of a merged copy, returns the equivalent block of the
+      * representative subtree. The m blocks that map to a block with 
+      * multiplicity m contribute equally to its concentration.
+      *
+      * \param blockId  block index, 0 <= blockId < nBlock
+      */
+      int representative(int blockId) const;
+
+      /**
+      * Were any identical subtrees merged? 
+      */
+      bool hasMergedArms() const;
+
       //@}
 
    protected:
@@ -199,9 +245,27 @@ namespace Pscf
       * works for any acyclic branched block copolymer. This function
       * is called in the default implementation of readParameters, 
       * and must be called the readParameters method of any subclass.
+      *
+      * Propagators are added to the plan from a queue, starting from
+      * the chain ends. Each vertex keeps a count of the propagators 
+      * that arrive at it, and enqueues its outgoing propagators when
+      * they become ready, so the cost is linear in nBlock.
       */
       virtual void makePlan();
 
+      /**
+      * Identify identical subtrees and assign block multiplicities.
+      *
+      * Must be called after makePlan. On return, twins(b, d) holds 
+      * the block and direction index of the propagator that will be 
+      * used in place of propagator (b, d) as a source for other 
+      * propagators, and multiplicity_ and representative_ are set for
+      * all blocks.
+      *
+      * \param twins  replacement source propagator ids (output)
+      */
+      void mergeSubtrees(DArray< Pair<int> >& twins);
+
    private:
 
       /// Array of Block objects in this polymer.
@@ -213,6 +277,12 @@ namespace Pscf
       /// Propagator ids, indexed in order of computation.
       DArray< Pair<int> > propagatorIds_;
 
+      /// Number of equivalent blocks represented by each block.
+      DArray<int> multiplicity_;
+
+      /// Block whose concentration includes that of each block.
+      DArray<int> representative_;
+
       /// Number of blocks in this polymer
       int nBlock_;
 
@@ -225,6 +295,12 @@ namespace Pscf
       /// Polymer type (Branched or Linear)
       PolymerType::Enum type_;
 
+      /// Should identical subtrees be merged? (parameter)
+      bool mergeArms_;
+
+      /// Were identical subtrees merged?
+      bool hasMergedArms_;
+
    };
 
    /*
@@ -261,6 +337,27 @@ namespace Pscf
       return value;
    }
 
+   /*
+   * Number of equivalent blocks represented by a block.
+   */
+   template <class Block>
+   inline int PolymerTmpl<Block>::multiplicity(int blockId) const
+   {  return multiplicity_[blockId]; }
+
+   /*
+   * Index of the block whose concentration includes this block.
+   */
+   template <class Block>
+   inline int PolymerTmpl<Block>::representative(int blockId) const
+   {  return representative_[blockId]; }
+
+   /*
+   * Were any identical subtrees merged?
+   */
+   template <class Block>
+   inline bool PolymerTmpl<Block>::hasMergedArms() const
+   {  return hasMergedArms_; }
+
    /*
    * Get a specified Vertex.
    */
@@ -335,9 +432,13 @@ namespace Pscf
       blocks_(),
       vertices_(),
       propagatorIds_(),
+      multiplicity_(),
+      representative_(),
       nBlock_(0),
       nVertex_(0),
-      nPropagator_(0)
+      nPropagator_(0),
+      mergeArms_(false),
+      hasMergedArms_(false)
    {  setClassName("PolymerTmpl"); }
 
    /*
@@ -363,6 +464,8 @@ namespace Pscf
       blocks_.allocate(nBlock_);
       vertices_.allocate(nVertex_);
       propagatorIds_.allocate(2*nBlock_);
+      multiplicity_.allocate(nBlock_);
+      representative_.allocate(nBlock_);
 
       // Set block id and polymerType for all blocks
       for (int blockId = 0; blockId < nBlock_; ++blockId) {
@@ -435,6 +538,24 @@ namespace Pscf
          read(in, "mu", mu_);
       }
 
+      // Optionally merge identical subtrees
+      mergeArms_ = false;
+      readOptional(in, "mergeArms", mergeArms_);
+      DArray< Pair<int> > twins;
+      twins.allocate(2*nBlock_);
+      if (mergeArms_) {
+         mergeSubtrees(twins);
+      } else {
+         for (int blockId = 0; blockId < nBlock_; ++blockId) {
+            multiplicity_[blockId] = 1;
+            representative_[blockId] = blockId;
+            for (int directionId = 0; directionId < 2; ++directionId) {
+               twins[2*blockId + directionId][0] = blockId;
+               twins[2*blockId + directionId][1] = directionId;
+            }
+         }
+      }
+
       // Set sources for all propagators
       Vertex const * vertexPtr = 0;
       Propagator const * sourcePtr = 0;
@@ -452,6 +573,8 @@ namespace Pscf
                if (propagatorId[0] == blockId) {
                   UTIL_CHECK(propagatorId[1] != directionId);
                } else {
+                  propagatorId = 
+                     twins[2*propagatorId[0] + propagatorId[1]];
                   sourcePtr = 
                      &block(propagatorId[0]).propagator(propagatorId[1]);
                   propagatorPtr->addSource(*sourcePtr);
@@ -473,44 +596,300 @@ namespace Pscf
          UTIL_THROW("nPropagator !=0 on entry");
       }
 
-      // Allocate and initialize isFinished matrix
+      // Number of propagators that have arrived at each vertex
+      DArray<int> nArrived;
+      nArrived.allocate(nVertex_);
+      for (int iVertex = 0; iVertex < nVertex_; ++iVertex) {
+         nArrived[iVertex] = 0;
+      }
+
+      // Allocate and initialize isQueued and isFinished matrices
+      DMatrix<bool> isQueued;
       DMatrix<bool> isFinished;
+      isQueued.allocate(nBlock_, 2);
       isFinished.allocate(nBlock_, 2);
       for (int iBlock = 0; iBlock < nBlock_; ++iBlock) {
          for (int iDirection = 0; iDirection < 2; ++iDirection) {
+            isQueued(iBlock, iDirection) = false;
             isFinished(iBlock, iDirection) = false;
          }
       }
 
+      // Propagators are appended to propagatorIds_, which is used as
+      // a queue: Elements [0, nPropagator_) have been processed, and
+      // elements [nPropagator_, nQueued) are waiting to be processed.
+      int nQueued = 0;
+
+      // Initialize queue with propagators that start at chain ends
       Pair<int> propagatorId;
-      Vertex* inVertexPtr = 0;
-      int inVertexId = -1;
-      bool isReady;
-      while (nPropagator_ < nBlock_*2) {
-         for (int iBlock = 0; iBlock < nBlock_; ++iBlock) {
-            for (int iDirection = 0; iDirection < 2; ++iDirection) {
-               if (isFinished(iBlock, iDirection) == false) {
-                  inVertexId = blocks_[iBlock].vertexId(iDirection);
-                  inVertexPtr = &vertices_[inVertexId];
-                  isReady = true;
-                  for (int j = 0; j < inVertexPtr->size(); ++j) {
-                     propagatorId = inVertexPtr->inPropagatorId(j);
-                     if (propagatorId[0] != iBlock) {
-                        if (!isFinished(propagatorId[0], propagatorId[1])) {
-                           isReady = false;
-                           break;
-                        }
+      for (int iVertex = 0; iVertex < nVertex_; ++iVertex) {
+         if (vertices_[iVertex].size() == 1) {
+            propagatorId = vertices_[iVertex].outPropagatorId(0);
+            propagatorIds_[nQueued] = propagatorId;
+            isQueued(propagatorId[0], propagatorId[1]) = true;
+            ++nQueued;
+         }
+      }
+
+      Vertex* vertexPtr = 0;
+      int iBlock, iDirection, vertexId, size, j;
+      while (nPropagator_ < nQueued) {
+
+         // Process next propagator in queue
+         iBlock = propagatorIds_[nPropagator_][0];
+         iDirection = propagatorIds_[nPropagator_][1];
+         isFinished(iBlock, iDirection) = true;
+         ++nPropagator_;
+
+         // Vertex at which this propagator arrives
+         vertexId = blocks_[iBlock].vertexId(1 - iDirection);
+         vertexPtr = &vertices_[vertexId];
+         size = vertexPtr->size();
+         ++nArrived[vertexId];
+
+         // If all incoming propagators but one have arrived, the 
+         // outgoing propagator of the remaining block is ready. If all
+         // incoming propagators have arrived, all outgoing propagators
+         // are ready. Each of these cases occurs once per vertex.
+         if (nArrived[vertexId] >= size - 1) {
+            for (j = 0; j < size; ++j) {
+               if (nArrived[vertexId] == size - 1) {
+                  propagatorId = vertexPtr->inPropagatorId(j);
+                  if (isFinished(propagatorId[0], propagatorId[1])) {
+                     continue;
+                  }
+               }
+               propagatorId = vertexPtr->outPropagatorId(j);
+               if (!isQueued(propagatorId[0], propagatorId[1])) {
+                  UTIL_CHECK(nQueued < nBlock_*2);
+                  propagatorIds_[nQueued] = propagatorId;
+                  isQueued(propagatorId[0], propagatorId[1]) = true;
+                  ++nQueued;
+               }
+            }
+         }
+
+      }
+
+      if (nPropagator_ != nBlock_*2) {
+         UTIL_THROW("Polymer is not a connected acyclic graph");
+      }
+
+   }
+
+   /*
+   * Identify identical subtrees and assign block multiplicities.
+   */
+   template <class Block>
+   void PolymerTmpl<Block>::mergeSubtrees(DArray< Pair<int> >& twins)
+   {
+      UTIL_CHECK(nPropagator_ == nBlock_*2);
+      UTIL_CHECK(twins.capacity() == nBlock_*2);
+
+      int iBlock, iDirection, iVertex, i, j, k;
+      Pair<int> propagatorId;
+
+      // Index of each propagator in the plan
+      DArray<int> rank;
+      rank.allocate(2*nBlock_);
+      for (i = 0; i < nPropagator_; ++i) {
+         propagatorId = propagatorIds_[i];
+         rank[2*propagatorId[0] + propagatorId[1]] = i;
+      }
+
+      // Assign integer signatures to all propagators, in plan order.
+      // Two propagators have equal signatures if and only if they 
+      // propagate through identical subtrees, and so are identical 
+      // functions for any set of w fields. 
+      typedef std::pair< std::pair<int, double>, std::vector<int> > Key;
+      std::map<Key, int> signatures;
+      typename std::map<Key, int>::iterator iter;
+      DArray<int> signature;
+      signature.allocate(2*nBlock_);
+      Vertex const * vertexPtr = 0;
+      Key key;
+      for (i = 0; i < nPropagator_; ++i) {
+         iBlock = propagatorIds_[i][0];
+         iDirection = propagatorIds_[i][1];
+         key.first.first = blocks_[iBlock].monomerId();
+         key.first.second = blocks_[iBlock].length();
+         key.second.clear();
+         vertexPtr = &vertices_[blocks_[iBlock].vertexId(iDirection)];
+         for (j = 0; j < vertexPtr->size(); ++j) {
+            propagatorId = vertexPtr->inPropagatorId(j);
+            if (propagatorId[0] != iBlock) {
+               k = 2*propagatorId[0] + propagatorId[1];
+               key.second.push_back(signature[k]);
+            }
+         }
+         std::sort(key.second.begin(), key.second.end());
+         iter = signatures.find(key);
+         if (iter == signatures.end()) {
+            k = (int) signatures.size();
+            signatures.insert(std::make_pair(key, k));
+         } else {
+            k = iter->second;
+         }
+         signature[2*iBlock + iDirection] = k;
+      }
+
+      // Initialize multiplicities and twins 
+      for (iBlock = 0; iBlock < nBlock_; ++iBlock) {
+         multiplicity_[iBlock] = 1;
+         representative_[iBlock] = iBlock;
+         for (iDirection = 0; iDirection < 2; ++iDirection) {
+            twins[2*iBlock + iDirection][0] = iBlock;
+            twins[2*iBlock + iDirection][1] = iDirection;
+         }
+      }
+
+      // Work space: incoming propagators at one vertex, and a stack 
+      // of (vertex, block) pairs for traversal of subtrees 
+      std::vector< std::pair<int, int> > incoming;
+      std::vector< std::pair<int, int> > stack;
+      std::vector< std::pair<int, int> > sources[2];
+      int rep, repIndex, size, factor, vertexId, blockId, prevId;
+      int repId, copyId, n;
+      bool skip;
+
+      for (iVertex = 0; iVertex < nVertex_; ++iVertex) {
+         vertexPtr = &vertices_[iVertex];
+         size = vertexPtr->size();
+         if (size < 2) continue;
+
+         // Skip vertices in or adjacent to a subtree already removed
+         skip = false;
+         for (j = 0; j < size; ++j) {
+            if (multiplicity_[vertexPtr->inPropagatorId(j)[0]] == 0) {
+               skip = true;
+            }
+         }
+         if (skip) continue;
+
+         // Sort incoming propagators by signature, then by plan rank
+         incoming.clear();
+         for (j = 0; j < size; ++j) {
+            propagatorId = vertexPtr->inPropagatorId(j);
+            k = 2*propagatorId[0] + propagatorId[1];
+            incoming.push_back(std::make_pair(signature[k], rank[k]));
+         }
+         std::sort(incoming.begin(), incoming.end());
+
+         // Process groups of incoming propagators with equal signature
+         i = 0;
+         while (i < size) {
+            j = i + 1;
+            while (j < size && incoming[j].first == incoming[i].first) {
+               ++j;
+            }
+            factor = j - i;
+            if (factor > 1) {
+               hasMergedArms_ = true;
+
+               // Representative is the first propagator in the plan,
+               // and so is computed before all others in the group
+               repIndex = incoming[i].second;
+               rep = propagatorIds_[repIndex][0];
+
+               // Traverse the subtree attached through the representative,
+               // multiplying multiplicities by the number of copies
+               propagatorId = propagatorIds_[repIndex];
+               stack.clear();
+               stack.push_back(std::make_pair(
+                       blocks_[rep].vertexId(propagatorId[1]), rep));
+               while (!stack.empty()) {
+                  vertexId = stack.back().first;
+                  prevId = stack.back().second;
+                  stack.pop_back();
+                  multiplicity_[prevId] *= factor;
+                  Vertex const & u = vertices_[vertexId];
+                  for (int m = 0; m < u.size(); ++m) {
+                     propagatorId = u.outPropagatorId(m);
+                     if (propagatorId[0] != prevId) {
+                        stack.push_back(std::make_pair(
+                          blocks_[propagatorId[0]].vertexId(
+                                             1 - propagatorId[1]),
+                          propagatorId[0]));
                      }
                   }
-                  if (isReady) {
-                     propagatorIds_[nPropagator_][0] = iBlock;
-                     propagatorIds_[nPropagator_][1] = iDirection;
-                     isFinished(iBlock, iDirection) = true;
-                     ++nPropagator_;
+               }
+
+               // Traverse the subtree of each other copy in parallel 
+               // with that of the representative, matching source 
+               // propagators by signature. Zero the multiplicity of 
+               // each block of the copy, and record the equivalent 
+               // block of the representative.
+               for (k = i + 1; k < j; ++k) {
+                  propagatorId = propagatorIds_[incoming[k].second];
+                  twins[2*propagatorId[0] + propagatorId[1]] 
+                                              = propagatorIds_[repIndex];
+                  stack.clear();
+                  stack.push_back(std::make_pair(
+                     2*rep + propagatorIds_[repIndex][1],
+                     2*propagatorId[0] + propagatorId[1]));
+                  while (!stack.empty()) {
+                     repId = stack.back().first;
+                     copyId = stack.back().second;
+                     stack.pop_back();
+                     multiplicity_[copyId/2] = 0;
+                     representative_[copyId/2] = repId/2;
+                     for (int c = 0; c < 2; ++c) {
+                        blockId = (c == 0) ? repId/2 : copyId/2;
+                        vertexId = blocks_[blockId].vertexId(
+                                       (c == 0) ? repId%2 : copyId%2);
+                        Vertex const & u = vertices_[vertexId];
+                        sources[c].clear();
+                        for (int m = 0; m < u.size(); ++m) {
+                           propagatorId = u.inPropagatorId(m);
+                           if (propagatorId[0] != blockId) {
+                              n = 2*propagatorId[0] + propagatorId[1];
+                              sources[c].push_back(
+                                         std::make_pair(signature[n], n));
+                           }
+                        }
+                        std::sort(sources[c].begin(), sources[c].end());
+                     }
+                     UTIL_CHECK(sources[0].size() == sources[1].size());
+                     for (n = 0; n < (int) sources[0].size(); ++n) {
+                        UTIL_CHECK(sources[0][n].first 
+                                   == sources[1][n].first);
+                        stack.push_back(std::make_pair(
+                               sources[0][n].second, 
+                               sources[1][n].second));
+                     }
                   }
                }
+               UTIL_CHECK(multiplicity_[rep] > 0);
             }
+            i = j;
+         }
+      }
+
+      // A copy may have been mapped to a block that was itself merged 
+      // later, at a vertex of the representative subtree. Follow such
+      // chains to a block with nonzero multiplicity.
+      for (iBlock = 0; iBlock < nBlock_; ++iBlock) {
+         k = representative_[iBlock];
+         n = 0;
+         while (multiplicity_[k] == 0) {
+            k = representative_[k];
+            ++n;
+            UTIL_CHECK(n < nBlock_);
          }
+         representative_[iBlock] = k;
+      }
+
+      // Check that each block with multiplicity m represents m blocks
+      DArray<int> count;
+      count.allocate(nBlock_);
+      for (iBlock = 0; iBlock < nBlock_; ++iBlock) {
+         count[iBlock] = 0;
+      }
+      for (iBlock = 0; iBlock < nBlock_; ++iBlock) {
+         ++count[representative_[iBlock]];
+      }
+      for (iBlock = 0; iBlock < nBlock_; ++iBlock) {
+         UTIL_CHECK(count[iBlock] == multiplicity_[iBlock]);
       }
 
    }
@@ -528,14 +907,19 @@ namespace Pscf
       }
 
       // Solve modified diffusion equation for all propagators in
-      // the order specified by function makePlan.
+      // the order specified by function makePlan, skipping blocks
+      // that are represented by an identical block.
+      int firstBlockId = -1;
       for (int j = 0; j < nPropagator(); ++j) {
+         if (multiplicity_[propagatorId(j)[0]] == 0) continue;
+         if (firstBlockId < 0) firstBlockId = propagatorId(j)[0];
          UTIL_CHECK(propagator(j).isReady());
          propagator(j).solve();
       }
+      UTIL_CHECK(firstBlockId >= 0);
 
       // Compute molecular partition function q_
-      q_ = block(0).propagator(0).computeQ(); 
+      q_ = block(firstBlockId).propagator(0).computeQ(); 
   
       // The Propagator::computeQ function returns a spatial average.
       // Correct for partial occupation of the unit cell.k
@@ -552,7 +936,9 @@ namespace Pscf
       // Compute block concentration fields
       double prefactor = phi_ / ( q_ * length() );
       for (int i = 0; i < nBlock(); ++i) {
-         block(i).computeConcentration(prefactor);
+         if (multiplicity_[i] > 0) {
+            block(i).computeConcentration(prefactor*multiplicity_[i]);
+         }
       }
 
    }
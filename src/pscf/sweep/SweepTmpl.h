@@ -52,6 +52,12 @@ namespace Pscf {
       /// Base name for output files
       std::string baseFileName_;
 
+      /// Error tolerance for intermediate states (disabled if <= 0).
+      double looseEpsilon_;
+
+      /// Tolerance for estimated free energy error (disabled if <= 0).
+      double fTolerance_;
+
       /**
       * Constructor (protected).
       *
@@ -146,6 +152,18 @@ namespace Pscf {
       int nAccept() const
       {  return nAccept_; }
 
+      /**
+      * Was the most recent solution converged only to looseEpsilon?
+      *
+      * This is true only if looseEpsilon is positive and iteration for
+      * the most recent solution was stopped at that tolerance rather
+      * than continued to the normal iterator tolerance. The value is 
+      * set before accept() is called, and so may be used within the 
+      * implementation of getSolution() to label output.
+      */
+      bool isLoose() const
+      {  return isLoose_; }
+
       /**
       * Initialize variables that track history of solutions.
       *
@@ -256,6 +274,38 @@ namespace Pscf {
       */
       virtual void cleanup();
 
+      /**
+      * Get the error tolerance of the iterator.
+      *
+      * This and the following two functions are used only if the
+      * optional parameter looseEpsilon is positive. The default 
+      * implementations throw an Exception.
+      */
+      virtual double iteratorEpsilon() const;
+
+      /**
+      * Set the error tolerance of the iterator.
+      *
+      * \param epsilon  new error tolerance
+      */
+      virtual void setIteratorEpsilon(double epsilon);
+
+      /**
+      * Get the estimated error in the free energy after the last solve.
+      *
+      * Should return a negative value if no estimate is available.
+      */
+      virtual double iteratorFError() const;
+
+      /**
+      * Get the stream to which log output is written.
+      *
+      * The default implementation returns Log::file(). Subclasses
+      * should override this to return the log stream of the parent
+      * system, if it has one.
+      */
+      virtual std::ostream& logFile() const;
+
    private:
 
       /// Array of State objects, not sequential (work space)
@@ -282,6 +332,9 @@ namespace Pscf {
       /// Should the state of the iterator be re-used during continuation.
       bool reuseState_;
 
+      /// Was the most recent solution converged only to looseEpsilon_?
+      bool isLoose_;
+
       /**
       * Accept a new solution, and update history.
       *
@@ -294,6 +347,24 @@ namespace Pscf {
       */
       void accept(double s);
 
+      /**
+      * Solve for one state, using a loose tolerance if allowed.
+      *
+      * If looseEpsilon_ is positive and isFinal is false, the state is
+      * first converged to the tolerance looseEpsilon_. If fTolerance_ 
+      * is also positive, iteration is then continued to the normal 
+      * iterator tolerance only if the estimated error in the free 
+      * energy exceeds fTolerance_ or is unavailable. Otherwise, this
+      * simply calls solve(isContinuation). Sets isLoose_ to indicate
+      * whether the resulting solution is converged only to the loose
+      * tolerance.
+      *
+      * \param isContinuation true iff continuation within a sweep
+      * \param isFinal  true iff this is the last state of the sweep
+      * \return 0 for sucessful solution, 1 on failure to converge.
+      */
+      int solveStep(bool isContinuation, bool isFinal);
+
       /**
       * Default constructor (private, not implemented to prevent use).
       */
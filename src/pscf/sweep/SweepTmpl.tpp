@@ -22,10 +22,13 @@ namespace Pscf {
    SweepTmpl<State>::SweepTmpl(int historyCapacity)
     : ns_(0),
       baseFileName_(),
+      looseEpsilon_(0.0),
+      fTolerance_(0.0),
       historyCapacity_(historyCapacity),
       historySize_(0),
       nAccept_(0),
-      reuseState_(true)
+      reuseState_(true),
+      isLoose_(false)
    {  setClassName("SweepTmpl"); }
 
    /*
@@ -49,6 +52,8 @@ namespace Pscf {
       readOptional<std::string>(in, "baseFileName", baseFileName_);
       readOptional<int>(in, "historyCapacity", historyCapacity_);
       readOptional<bool>(in, "reuseState", reuseState_);
+      readOptional<double>(in, "looseEpsilon", looseEpsilon_);
+      readOptional<double>(in, "fTolerance", fTolerance_);
 
       // Allocate required arrays
       UTIL_CHECK(historyCapacity_ > 0);
@@ -65,21 +70,22 @@ namespace Pscf {
       // Compute and output ds
       double ds = 1.0/double(ns_);
       double ds0 = ds;
-      Log::file() << std::endl;
-      Log::file() << "ns = " << ns_ << std::endl;
-      Log::file() << "ds = " << ds  << std::endl;
+      logFile() << std::endl;
+      logFile() << "ns = " << ns_ << std::endl;
+      logFile() << "ds = " << ds  << std::endl;
 
       // Initial setup, before a sweep
       setup();
 
       // Solve for initial state of sweep
       double sNew = 0.0;
-      Log::file() << std::endl;
-      Log::file() << "===========================================\n";
-      Log::file() << "Attempt s = " << sNew << std::endl;
+      logFile() << std::endl;
+      logFile() << "===========================================\n";
+      logFile() << "Attempt s = " << sNew << std::endl;
 
       int error;
       bool isContinuation = false; // False on first step
+      isLoose_ = false;
       error = solve(isContinuation);
       
       if (error) {
@@ -98,9 +104,9 @@ namespace Pscf {
 
             // Set a new contour variable value sNew
             sNew = s(0) + ds; 
-            Log::file() << std::endl;
-            Log::file() << "===========================================\n";
-            Log::file() << "Attempt s = " << sNew << std::endl;
+            logFile() << std::endl;
+            logFile() << "===========================================\n";
+            logFile() << "Attempt s = " << sNew << std::endl;
 
             // Set non-adjustable system parameters to new values
             setParameters(sNew);
@@ -110,14 +116,15 @@ namespace Pscf {
             // set initial guess values in the parent system.
             extrapolate(sNew);
 
-            // Attempt iterative SCFT solution
+            // Attempt iterative SCFT solution. Intermediate states 
+            // may use a loose tolerance, but the final state may not.
             isContinuation = reuseState_;
-            error = solve(isContinuation);
+            error = solveStep(isContinuation, sNew + ds > 1.0000001);
 
             // Process success or failure
             if (error) {
-               Log::file() << "Backtrack and halve sweep step size:" 
-                           << std::endl;
+               logFile() << "Backtrack and halve sweep step size:" 
+                         << std::endl;
 
                // Upon failure, reset state to last converged solution
                reset();
@@ -139,13 +146,46 @@ namespace Pscf {
             finished = true;
          }
       }
-      Log::file() << "===========================================\n";
+      logFile() << "===========================================\n";
 
       // Clean up after end of the entire sweep
       cleanup();
 
    }
 
+   /*
+   * Solve for one state, using a loose tolerance if allowed.
+   */
+   template <class State>
+   int SweepTmpl<State>::solveStep(bool isContinuation, bool isFinal)
+   {
+      isLoose_ = false;
+      if (looseEpsilon_ <= 0.0 || isFinal) {
+         return solve(isContinuation);
+      }
+
+      // Converge to the loose tolerance
+      double epsilon = iteratorEpsilon();
+      setIteratorEpsilon(looseEpsilon_);
+      int error = solve(isContinuation);
+      setIteratorEpsilon(epsilon);
+      if (error) {
+         return error;
+      }
+
+      // Tighten the tolerance only if the free energy may be inaccurate
+      double fError = iteratorFError();
+      if (fTolerance_ > 0.0 && (fError < 0.0 || fError > fTolerance_)) {
+         logFile() << "Free energy error estimate exceeds fTolerance,"
+                   << " continue to full tolerance" << std::endl;
+         return solve(true);
+      }
+
+      isLoose_ = true;
+      logFile() << "Accept state converged to looseEpsilon" << std::endl;
+      return 0;
+   }
+
    /*
    * Initialize history variables (must be called by setup function).
    */
@@ -241,5 +281,36 @@ namespace Pscf {
    void SweepTmpl<State>::cleanup()
    {}
 
+   /*
+   * Get the iterator error tolerance (default implementation).
+   */
+   template <class State>
+   double SweepTmpl<State>::iteratorEpsilon() const
+   {
+      UTIL_THROW("Parameter looseEpsilon is not supported by this sweep");
+      return 0.0;
+   }
+
+   /*
+   * Set the iterator error tolerance (default implementation).
+   */
+   template <class State>
+   void SweepTmpl<State>::setIteratorEpsilon(double epsilon)
+   {  UTIL_THROW("Parameter looseEpsilon is not supported by this sweep"); }
+
+   /*
+   * Get the estimated free energy error (default implementation).
+   */
+   template <class State>
+   double SweepTmpl<State>::iteratorFError() const
+   {  return -1.0; }
+
+   /*
+   * Get the log output stream (default implementation).
+   */
+   template <class State>
+   std::ostream& SweepTmpl<State>::logFile() const
+   {  return Log::file(); }
+
 } // namespace Pscf
 #endif
@@ -0,0 +1,98 @@
+#ifndef PSCF_HOMOGENEOUS_COEXISTENCE_TEST_H
+#define PSCF_HOMOGENEOUS_COEXISTENCE_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <pscf/homogeneous/Coexistence.h>
+#include <pscf/homogeneous/Mixture.h>
+#include <pscf/inter/Interaction.h>
+#include <util/containers/DArray.h>
+#include <util/misc/Log.h>
+
+#include <fstream>
+#include <cmath>
+
+using namespace Pscf;
+using namespace Util;
+
+class CoexistenceTest : public UnitTest 
+{
+
+public:
+
+   void setUp()
+   {
+      //setVerbose(1);
+   }
+
+   void tearDown()
+   {}
+
+   void testConstructor()
+   {
+      printMethod(TEST_FUNC);
+      Homogeneous::Coexistence coexistence;
+   } 
+
+   void testSymmetricBlend() 
+   {
+      printMethod(TEST_FUNC);
+
+      Homogeneous::Mixture mixture;
+      std::ifstream in;
+      openInputFile("in/Blend", in);
+      mixture.readParam(in);
+      in.close();
+
+      Interaction interaction;
+      interaction.setNMonomer(mixture.nMonomer());
+      openInputFile("in/InteractionBlend", in);
+      interaction.readParam(in);
+      in.close();
+
+      DArray<double> phi;
+      phi.allocate(2);
+      phi[0] = 0.4;
+      phi[1] = 0.6;
+
+      Homogeneous::Coexistence coexistence;
+      int nPhase = coexistence.compute(mixture, interaction, phi);
+      TEST_ASSERT(nPhase == 2);
+
+      // Symmetric binodal: ln(phi/(1-phi)) = chi N (2 phi - 1)
+      double chiN = 3.0;
+      double p0 = coexistence.phi(0)[0];
+      double p1 = coexistence.phi(1)[0];
+      TEST_ASSERT(std::abs(p0 + p1 - 1.0) < 1.0E-8);
+      TEST_ASSERT(std::abs(log(p0/(1.0-p0)) - chiN*(2.0*p0-1.0)) < 1.0E-7);
+
+      // Lever rule
+      double f0 = coexistence.fraction(0);
+      double f1 = coexistence.fraction(1);
+      TEST_ASSERT(std::abs(f0 + f1 - 1.0) < 1.0E-10);
+      TEST_ASSERT(std::abs(f0*p0 + f1*p1 - phi[0]) < 1.0E-10);
+
+      if (verbose() > 0) {
+         printEndl();
+         Log::file() << "phi = " << p0 << "  " << p1 << "\n";
+         Log::file() << "fraction = " << f0 << "  " << f1 << "\n";
+      }
+
+      // Single phase outside the miscibility gap
+      phi[0] = 0.98;
+      phi[1] = 0.02;
+      nPhase = coexistence.compute(mixture, interaction, phi);
+      TEST_ASSERT(nPhase == 1);
+      TEST_ASSERT(std::abs(coexistence.phi(0)[0] - 0.98) < 1.0E-10);
+      TEST_ASSERT(std::abs(coexistence.fraction(0) - 1.0) < 1.0E-10);
+   }
+
+};
+
+TEST_BEGIN(CoexistenceTest)
+TEST_ADD(CoexistenceTest, testConstructor)
+TEST_ADD(CoexistenceTest, testSymmetricBlend)
+TEST_END(CoexistenceTest)
+
+#endif
@@ -6,11 +6,13 @@
 #include "ClumpTest.h"
 #include "MoleculeTest.h"
 #include "MixtureTest.h"
+#include "CoexistenceTest.h"
 
 TEST_COMPOSITE_BEGIN(HomogeneousTestComposite)
 TEST_COMPOSITE_ADD_UNIT(ClumpTest);
 TEST_COMPOSITE_ADD_UNIT(MoleculeTest);
 TEST_COMPOSITE_ADD_UNIT(MixtureTest);
+TEST_COMPOSITE_ADD_UNIT(CoexistenceTest);
 TEST_COMPOSITE_END
 
 #endif
@@ -6,8 +6,12 @@
 
 #include <pscf/math/LuSolver.h>
 #include <util/containers/DMatrix.h>
+#include <util/containers/DArray.h>
+#include <util/misc/Timer.h>
 
 #include <fstream>
+#include <cmath>
+#include <cstdlib>
 
 using namespace Util;
 using namespace Pscf;
@@ -95,12 +99,196 @@ public:
       TEST_ASSERT(eq(b[1], y[1]));
       TEST_ASSERT(eq(b[2], y[2]));
    }
+   /*
+   * Fill a diagonally dominant n x n matrix with pseudo-random values.
+   */
+   void makeMatrix(DMatrix<double>& a, int n)
+   {
+      a.allocate(n, n);
+      srand(17);
+      int i, j;
+      for (i = 0; i < n; ++i) {
+         for (j = 0; j < n; ++j) {
+            a(i, j) = double(rand())/double(RAND_MAX) - 0.5;
+         }
+         a(i, i) += 0.5*double(n);
+      }
+   }
+
+   /*
+   * Max norm of residual Ax - b.
+   */
+   double residual(DMatrix<double> const & a, DArray<double> const & x,
+                   DArray<double> const & b)
+   {
+      int n = b.capacity();
+      double r, error = 0.0;
+      for (int i = 0; i < n; ++i) {
+         r = -b[i];
+         for (int j = 0; j < n; ++j) {
+            r += a(i,j)*x[j];
+         }
+         if (std::abs(r) > error) error = std::abs(r);
+      }
+      return error;
+   }
+
+   void testBackends()
+   {
+      printMethod(TEST_FUNC);
+
+      // Size chosen to span several panels of the blocked algorithm
+      const int n = 150;
+      DMatrix<double> a, lu, inv;
+      makeMatrix(a, n);
+      inv.allocate(n, n);
+      DArray<double> b, x;
+      b.allocate(n);
+      x.allocate(n);
+      for (int i = 0; i < n; ++i) {
+         b[i] = double(i % 7) - 3.0;
+      }
+
+      LuSolver::Backend backends[3] = {LuSolver::Blocked, LuSolver::Gsl,
+                                       LuSolver::Lapack};
+      int nBackend = LuSolver::hasLapack() ? 3 : 2;
+      int i, j, k, m;
+      double error;
+      for (k = 0; k < nBackend; ++k) {
+         LuSolver solver;
+         solver.allocate(n);
+         solver.setBackend(backends[k]);
+
+         // Solve using a copy of the matrix
+         solver.computeLU(a);
+         solver.solve(b, x);
+         TEST_ASSERT(residual(a, x, b) < 1.0E-10);
+
+         // Inverse
+         solver.inverse(inv);
+         error = 0.0;
+         for (i = 0; i < n; ++i) {
+            for (j = 0; j < n; ++j) {
+               double sum = (i == j) ? -1.0 : 0.0;
+               for (m = 0; m < n; ++m) {
+                  sum += a(i, m)*inv(m, j);
+               }
+               if (std::abs(sum) > error) error = std::abs(sum);
+            }
+         }
+         TEST_ASSERT(error < 1.0E-10);
+
+         // Solve in place, overwriting lu
+         lu = a;
+         solver.computeLUInPlace(lu);
+         solver.solve(b, x);
+         TEST_ASSERT(residual(a, x, b) < 1.0E-10);
+
+         // Solve using only the leading block, without reallocation
+         const int nBlock = 40;
+         DMatrix<double> aBlock;
+         DArray<double> bBlock, xBlock;
+         aBlock.allocate(nBlock, nBlock);
+         bBlock.allocate(nBlock);
+         xBlock.allocate(nBlock);
+         for (i = 0; i < nBlock; ++i) {
+            for (j = 0; j < nBlock; ++j) {
+               aBlock(i, j) = a(i, j);
+            }
+            bBlock[i] = b[i];
+            x[i] = 0.0;
+         }
+         x[nBlock] = 7.0;
+         solver.computeLU(a, nBlock);
+         solver.solve(b, x);
+         for (i = 0; i < nBlock; ++i) {
+            xBlock[i] = x[i];
+         }
+         TEST_ASSERT(residual(aBlock, xBlock, bBlock) < 1.0E-10);
+         TEST_ASSERT(x[nBlock] == 7.0);
+      }
+   }
+
+   /*
+   * A matrix with an exact zero pivot must not cause a throw, and must 
+   * yield non-finite solution values (Blocked and Lapack backends).
+   */
+   void testSingular()
+   {
+      printMethod(TEST_FUNC);
+
+      const int n = 3;
+      DMatrix<double> a;
+      a.allocate(n, n);
+      DArray<double> b, x;
+      b.allocate(n);
+      x.allocate(n);
+      int i;
+      for (i = 0; i < n; ++i) {
+         a(i, 0) = double(2*i + 1);
+         a(i, 1) = 0.0;
+         a(i, 2) = double(2*i + 2);
+         b[i] = 1.0;
+      }
+
+      LuSolver::Backend backends[2] = {LuSolver::Blocked, 
+                                       LuSolver::Lapack};
+      int nBackend = LuSolver::hasLapack() ? 2 : 1;
+      for (int k = 0; k < nBackend; ++k) {
+         LuSolver solver;
+         solver.allocate(n);
+         solver.setBackend(backends[k]);
+         solver.computeLU(a);
+         solver.solve(b, x);
+         bool isFinite = true;
+         for (i = 0; i < n; ++i) {
+            if (!std::isfinite(x[i])) isFinite = false;
+         }
+         TEST_ASSERT(!isFinite);
+      }
+   }
+
+   /*
+   * Compare decomposition times of all available backends.
+   *
+   * Times are only reported in verbose mode.
+   */
+   void testBenchmark()
+   {
+      printMethod(TEST_FUNC);
+
+      const int n = 600;
+      DMatrix<double> a;
+      makeMatrix(a, n);
+
+      LuSolver::Backend backends[3] = {LuSolver::Blocked, LuSolver::Gsl,
+                                       LuSolver::Lapack};
+      const char* names[3] = {"Blocked", "Gsl", "Lapack"};
+      int nBackend = LuSolver::hasLapack() ? 3 : 2;
+      for (int k = 0; k < nBackend; ++k) {
+         LuSolver solver;
+         solver.allocate(n);
+         solver.setBackend(backends[k]);
+         Timer timer;
+         timer.start();
+         solver.computeLU(a);
+         timer.stop();
+         if (verbose() > 0) {
+            std::cout << "\n" << names[k] << " LU, n = " << n << ": "
+                      << timer.time() << " s";
+         }
+      }
+   }
+
 };
 
 TEST_BEGIN(LuSolverTest)
 TEST_ADD(LuSolverTest, testConstructor)
 TEST_ADD(LuSolverTest, testDecompose)
 TEST_ADD(LuSolverTest, testSolve)
+TEST_ADD(LuSolverTest, testBackends)
+TEST_ADD(LuSolverTest, testSingular)
+TEST_ADD(LuSolverTest, testBenchmark)
 TEST_END(LuSolverTest)
 
 #endif
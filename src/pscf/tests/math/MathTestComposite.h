@@ -7,12 +7,14 @@
 #include "RealVecTest.h"
 #include "TridiagonalSolverTest.h"
 #include "LuSolverTest.h"
+#include "MatrixProductTest.h"
 
 TEST_COMPOSITE_BEGIN(MathTestComposite)
 TEST_COMPOSITE_ADD_UNIT(IntVecTest);
 TEST_COMPOSITE_ADD_UNIT(RealVecTest);
 TEST_COMPOSITE_ADD_UNIT(TridiagonalSolverTest);
 TEST_COMPOSITE_ADD_UNIT(LuSolverTest);
+TEST_COMPOSITE_ADD_UNIT(MatrixProductTest);
 TEST_COMPOSITE_END
 
 #endif
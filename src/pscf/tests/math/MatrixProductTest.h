@@ -0,0 +1,139 @@
+#ifndef PSCF_MATRIX_PRODUCT_TEST_H
+#define PSCF_MATRIX_PRODUCT_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <pscf/math/MatrixProduct.h>
+#include <util/containers/DMatrix.h>
+#include <util/containers/DArray.h>
+
+#include <cmath>
+
+using namespace Util;
+using namespace Pscf;
+
+class MatrixProductTest : public UnitTest 
+{
+
+public:
+
+   void setUp()
+   {}
+
+   void tearDown()
+   {}
+
+   /*
+   * Fill m x length array of rows with arbitrary values.
+   */
+   void setRows(DArray< DArray<double> >& rows, int m, int length, 
+                double seed)
+   {
+      rows.allocate(m);
+      for (int i = 0; i < m; ++i) {
+         rows[i].allocate(length);
+         for (int k = 0; k < length; ++k) {
+            rows[i][k] = sin(seed + 0.37*i + 0.011*k*(i+1));
+         }
+      }
+   }
+
+   void testAddMatrixProduct()
+   {
+      printMethod(TEST_FUNC);
+
+      // Length is not a multiple of the internal block size
+      const int m = 4;
+      const int n = 7;
+      const int length = 601;
+
+      DMatrix<double> A;
+      A.allocate(m, n);
+      for (int i = 0; i < m; ++i) {
+         for (int j = 0; j < n; ++j) {
+            A(i, j) = ((i + j) % 3 == 0) ? 0.0 : cos(1.0 + i - 0.5*j);
+         }
+      }
+
+      DArray< DArray<double> > X, Y;
+      setRows(X, n, length, 0.3);
+      setRows(Y, m, length, 1.7);
+
+      DArray<double const *> x;
+      DArray<double*> y;
+      x.allocate(n);
+      y.allocate(m);
+      for (int j = 0; j < n; ++j) {
+         x[j] = X[j].cArray();
+      }
+      for (int i = 0; i < m; ++i) {
+         y[i] = Y[i].cArray();
+      }
+
+      // Expected result, computed element by element
+      DArray< DArray<double> > Z;
+      setRows(Z, m, length, 1.7);
+      for (int i = 0; i < m; ++i) {
+         for (int j = 0; j < n; ++j) {
+            for (int k = 0; k < length; ++k) {
+               Z[i][k] += A(i, j)*X[j][k];
+            }
+         }
+      }
+
+      addMatrixProduct(A, x, y, length);
+
+      double error = 0.0;
+      for (int i = 0; i < m; ++i) {
+         for (int k = 0; k < length; ++k) {
+            error = std::max(error, std::abs(Y[i][k] - Z[i][k]));
+         }
+      }
+      TEST_ASSERT(error < 1.0E-12);
+   }
+
+   void testBilinearForm()
+   {
+      printMethod(TEST_FUNC);
+
+      const int m = 5;
+      const int length = 300;
+
+      DMatrix<double> A;
+      A.allocate(m, m);
+      for (int i = 0; i < m; ++i) {
+         for (int j = 0; j < m; ++j) {
+            A(i, j) = (j > i) ? 1.0 + 0.1*i*j : 0.0;
+         }
+      }
+
+      DArray< DArray<double> > X;
+      setRows(X, m, length, 0.9);
+      DArray<double const *> x;
+      x.allocate(m);
+      for (int i = 0; i < m; ++i) {
+         x[i] = X[i].cArray();
+      }
+
+      double expected = 0.0;
+      for (int i = 0; i < m; ++i) {
+         for (int j = i + 1; j < m; ++j) {
+            for (int k = 0; k < length; ++k) {
+               expected += A(i, j)*X[i][k]*X[j][k];
+            }
+         }
+      }
+
+      double result = bilinearForm(A, x, x, length);
+      TEST_ASSERT(std::abs(result - expected) < 1.0E-10);
+   }
+
+};
+
+TEST_BEGIN(MatrixProductTest)
+TEST_ADD(MatrixProductTest, testAddMatrixProduct)
+TEST_ADD(MatrixProductTest, testBilinearForm)
+TEST_END(MatrixProductTest)
+
+#endif
@@ -159,12 +159,72 @@ public:
  
    }
 
+   void testReadBrushParam() 
+   {
+      printMethod(TEST_FUNC);
+
+      std::ifstream in;
+      openInputFile("in/Polymer3", in);
+
+      PolymerStub p;
+      p.readParam(in);
+
+      if (verbose() > 0) {
+         std::cout << std::endl;
+         p.writeParam(std::cout);
+      }
+
+      // Each pair of side chains is represented by one side chain
+      TEST_ASSERT(p.hasMergedArms());
+      int nZero = 0;
+      int sum = 0;
+      for (int i = 0; i < p.nBlock(); ++i) {
+         if (verbose() > 0) {
+            std::cout << i << "  " << p.multiplicity(i) << "\n";
+         }
+         if (p.multiplicity(i) == 0) ++nZero;
+         sum += p.multiplicity(i);
+      }
+      TEST_ASSERT(nZero == 2);
+      TEST_ASSERT(sum == p.nBlock());
+      for (int i = 0; i < 3; ++i) {
+         TEST_ASSERT(p.multiplicity(i) == 1);
+      }
+      TEST_ASSERT(p.multiplicity(3) + p.multiplicity(4) == 2);
+      TEST_ASSERT(p.multiplicity(5) + p.multiplicity(6) == 2);
+
+      // Each merged side chain maps to the one that represents it
+      int r;
+      for (int i = 0; i < p.nBlock(); ++i) {
+         r = p.representative(i);
+         if (p.multiplicity(i) > 0) {
+            TEST_ASSERT(r == i);
+         } else {
+            TEST_ASSERT(p.multiplicity(r) == 2);
+            TEST_ASSERT(r == 3 || r == 4 || r == 5 || r == 6);
+            TEST_ASSERT((r < 5) == (i < 5));
+         }
+      }
+
+      // Check computation plan, skipping merged blocks
+      for (int i = 0; i < p.nPropagator(); ++i) {
+         p.propagator(i).setIsSolved(false);
+      }
+      for (int i = 0; i < p.nPropagator(); ++i) {
+         if (p.multiplicity(p.propagatorId(i)[0]) == 0) continue;
+         TEST_ASSERT(p.propagator(i).isReady());
+         p.propagator(i).setIsSolved(true);
+      }
+ 
+   }
+
 };
 
 TEST_BEGIN(PolymerStubTest)
 TEST_ADD(PolymerStubTest, testConstructor)
 TEST_ADD(PolymerStubTest, testReadParam)
 TEST_ADD(PolymerStubTest, testReadStarParam)
+TEST_ADD(PolymerStubTest, testReadBrushParam)
 TEST_END(PolymerStubTest)
 
 #endif
@@ -19,11 +19,14 @@
 #include <pspc/field/Mask.h>               // member
 #include <pspc/field/RField.h>             // member
 #include <pspc/field/RFieldDft.h>          // member
+#include <pspc/analyzer/AnalyzerManager.h> // member
 
 #include <pscf/homogeneous/Mixture.h>      // member
 
 #include <util/misc/FileMaster.h>          // member
+#include <util/misc/Log.h>                 // default log stream
 #include <util/containers/DArray.h>        // member template
+#include <util/containers/DMatrix.h>       // member template
 #include <util/containers/FSArray.h>       // member template
 
 namespace Pscf {
@@ -175,6 +178,8 @@ namespace Pspc
       * be known whether the r-grid field exhibits the declared space
       * group symmetry.  On exit, w().rgrid() is reset and w().hasData() 
       * is true, while w().isSymmetric() and hasCFields() are false.
+      * This function does not construct a basis, so that calculations
+      * that use only r-grid fields never pay the cost of doing so.
       *
       * \param filename  name of input w-field basis file
       */
@@ -186,7 +191,9 @@ namespace Pspc
       * This function sets values for w fields in both symmetry adapted 
       * and r-grid format.  On exit, values of both w().basis() and 
       * w().rgrid() are reset, w().hasData() and w().isSymmetric() are 
-      * true, and hasCFields() is false. 
+      * true, and hasCFields() is false. The unit cell must be set on 
+      * entry. The basis is constructed and basis fields are allocated
+      * if this was not done previously.
       *
       * \param fields  array of new w (chemical potential) fields
       */
@@ -255,6 +262,38 @@ namespace Pspc
       */
       void setUnitCell(FSArray<double, 6> const & parameters);
 
+      //@}
+      /// \name Mesh Modifier
+      //@{
+
+      /**
+      * Change the dimensions of the spatial mesh.
+      *
+      * Reconstructs the FFT and basis for the new mesh and reallocates
+      * all fields and propagators. The w fields, and any symmetric h 
+      * and mask fields, are transferred by spectral interpolation, i.e.,
+      * by retaining all basis function coefficients for wavevectors 
+      * that exist on both meshes. The w fields of any previous states 
+      * in a sweep are transferred in the same way. The iterator is 
+      * then notified by calling Iterator::resetMesh. The c fields and
+      * free energy must be recomputed after this call.
+      *
+      * The w fields must be symmetric (i.e., known in basis format).
+      *
+      * \param dimensions  new mesh dimensions
+      */
+      void setMesh(IntVec<D> const & dimensions);
+
+      /**
+      * Construct the symmetry-adapted basis, if not done previously.
+      *
+      * Also allocates all fields in basis format. The unit cell must
+      * be initialized on entry. Reading or setting fields in basis 
+      * format constructs the basis automatically, so this is needed
+      * only before other uses of the basis, e.g., in r-grid workflows.
+      */
+      void makeBasis();
+
       //@}
       /// \name Primary SCFT Computations
       //@{
@@ -603,6 +642,45 @@ namespace Pspc
       void basisToKGrid(const std::string & inFileName,
                         const std::string & outFileName);
 
+      /**
+      * Convert many field files, concurrently if OpenMP is enabled.
+      *
+      * The list file contains one pair of input and output file names
+      * per line. The conversion parameter is the name of one of the
+      * single-file conversion commands (e.g., BASIS_TO_RGRID). The basis
+      * and FFT plans are constructed once, and files are converted by a
+      * FieldConverter, using one work space per thread.
+      *
+      * \param conversion  name of conversion, e.g., "BASIS_TO_RGRID"
+      * \param listFileName  name of file containing file name pairs
+      * \return number of files that could not be converted
+      */
+      int convertFields(const std::string & conversion,
+                        const std::string & listFileName);
+
+      /**
+      * Compute and tabulate free energies for many sets of w fields.
+      *
+      * The list file contains one w field file name per line. Files
+      * with names ending in ".rf" are read in r-grid format and then
+      * converted to the symmetry-adapted basis, and all others are read
+      * in basis format. All fields must use the same mesh and space 
+      * group as this system. For each file, the fields are read, the 
+      * MDE is solved by compute(), and the free energy is computed, 
+      * reusing the mesh, basis, FFT plans and solver work space. One 
+      * line per file is written to the output file, containing the 
+      * file index, fHelmholtz, pressure and file name. If a file cannot
+      * be read, if r-grid fields lack the space group symmetry, or if 
+      * the computation fails, the string ERROR is written in place of
+      * fHelmholtz and pressure, and processing continues.
+      *
+      * \param listFileName  name of file containing w field file names
+      * \param outFileName  name of output table file
+      * \return number of sets of fields successfully evaluated
+      */
+      int batchCompute(const std::string & listFileName,
+                       const std::string & outFileName);
+
       /**
       * Compare two field files in symmetrized basis format.
       *
@@ -692,6 +770,10 @@ namespace Pspc
 
       /**
       * Get associated Basis object by reference.
+      *
+      * The basis is constructed by makeBasis() or by functions that 
+      * read or set fields in basis format (e.g., readWBasis or 
+      * setWBasis), and is uninitialized until then.
       */
       Basis<D> const & basis() const;
 
@@ -720,6 +802,11 @@ namespace Pspc
       */
       Iterator<D> const & iterator() const;
 
+      /**
+      * Get the manager for in-situ analyzers by reference.
+      */
+      AnalyzerManager<D>& analyzerManager();
+
       /**
       * Get homogeneous mixture (for reference calculations).
       */
@@ -740,6 +827,37 @@ namespace Pspc
       */
       FileMaster const & fileMaster() const;
 
+      /**
+      * Set the stream to which this System writes log output.
+      *
+      * By default, log output is written to the global Log::file(). 
+      * Each of several systems that are run concurrently in separate 
+      * threads should be given its own log stream, so that their 
+      * output is neither interleaved nor written to one stream from 
+      * several threads. The stream must outlive this System, or be 
+      * replaced by another before it is destroyed.
+      *
+      * Warnings and errors from the associated FieldIo (including file
+      * conversions by FieldConverter) are also written to this stream.
+      *
+      * Some state in the util library remains shared by all systems:
+      * Allocation statistics kept by Util::Memory are updated without 
+      * synchronization whenever a container is allocated or freed, so
+      * systems that allocate memory concurrently race on these counters
+      * (this affects only the statistics). Parameter echo (the -e 
+      * command line option) and some error and warning messages are
+      * written to the global Log::file(), so echo should not be enabled
+      * while parameter files are read in several threads.
+      *
+      * \param out  output stream for log output
+      */
+      void setLogFile(std::ostream& out);
+
+      /**
+      * Get the stream to which this System writes log output.
+      */
+      std::ostream& logFile() const;
+
       /**
       * Get the group name string.
       */
@@ -792,6 +910,11 @@ namespace Pspc
       */
       FileMaster fileMaster_;
 
+      /**
+      * Pointer to log stream (null if Log::file() is used).
+      */
+      std::ostream* logFilePtr_;
+
       /**
       * Homogeneous mixture, for reference.
       */
@@ -822,6 +945,11 @@ namespace Pspc
       */
       SweepFactory<D>* sweepFactoryPtr_;
 
+      /**
+      * Manager for in-situ analyzers.
+      */
+      AnalyzerManager<D> analyzerManager_;
+
       /**
       * Chemical potential fields.
       */
@@ -863,6 +991,16 @@ namespace Pspc
       */
       mutable DArray< RFieldDft<D> > tmpFieldsKGrid_;
 
+      /**
+      * Upper triangle of chi, used by computeFreeEnergy (work space).
+      */
+      DMatrix<double> chiUpper_;
+
+      /**
+      * Pointers to basis coefficients of c fields (work space).
+      */
+      DArray<double const *> cPtr_;
+
       /**
       * Helmholtz free energy per monomer / kT.
       */
@@ -937,6 +1075,8 @@ namespace Pspc
 
       /**
       * Allocate memory for fields in basis format (private)
+      *
+      * Constructs the basis if not done previously.
       */
       void allocateFieldsBasis();
 
@@ -950,6 +1090,23 @@ namespace Pspc
       */
       void readFieldHeader(std::string filename);
 
+      /**
+      * Read fields in basis format from a string written before setMesh.
+      *
+      * Each element of fields is reallocated, if necessary, to the 
+      * number of basis functions of the new basis. Coefficients for
+      * wavevectors that do not exist on the new mesh are discarded,
+      * and those for new wavevectors are set to zero.
+      *
+      * \param buffer  contents of field file written with the old mesh
+      * \param nBasisIn  number of basis functions of the old basis
+      * \param unitCell  unit cell used to identify wavevectors
+      * \param fields  array of fields (outer array must be allocated)
+      */
+      void readRemeshBasis(std::string const & buffer, int nBasisIn,
+                           UnitCell<D> const & unitCell,
+                           DArray< DArray<double> >& fields);
+
       /**
       * Read a string and echo to log file.
       *
@@ -970,6 +1127,16 @@ namespace Pspc
       */
       void readEcho(std::istream& in, double& value) const;
 
+      /**
+      * Read an integer and echo to log file.
+      *
+      * Used to read integer parameters in readCommands.
+      *
+      * \param in  input stream (i.e., input file)
+      * \param value  number to read and echo
+      */
+      void readEcho(std::istream& in, int& value) const;
+
       /**
       * Initialize Homogeneous::Mixture object.
       */
@@ -1034,6 +1201,19 @@ namespace Pspc
    inline FileMaster const & System<D>::fileMaster() const
    {  return fileMaster_; }
 
+   // Set the log stream.
+   template <int D>
+   inline void System<D>::setLogFile(std::ostream& out)
+   {
+      logFilePtr_ = &out;
+      domain_.fieldIo().setLogFile(out);
+   }
+
+   // Get the log stream.
+   template <int D>
+   inline std::ostream& System<D>::logFile() const
+   {  return logFilePtr_ ? *logFilePtr_ : Log::file(); }
+
    // Get the Homogeneous::Mixture object.
    template <int D>
    inline Homogeneous::Mixture& System<D>::homogeneous()
@@ -1060,6 +1240,11 @@ namespace Pspc
       return *interactionPtr_;
    }
 
+   // Get the AnalyzerManager.
+   template <int D>
+   inline AnalyzerManager<D>& System<D>::analyzerManager()
+   {  return analyzerManager_; }
+
    // Get the Iterator.
    template <int D>
    inline Iterator<D>& System<D>::iterator()
@@ -12,24 +12,32 @@
 
 #include <pspc/sweep/Sweep.h>
 #include <pspc/sweep/SweepFactory.h>
+#include <pspc/sweep/SweepArchive.h>
 #include <pspc/iterator/Iterator.h>
 #include <pspc/iterator/IteratorFactory.h>
 #include <pspc/solvers/Polymer.h>
 #include <pspc/solvers/Solvent.h>
 #include <pspc/field/BFieldComparison.h>
 #include <pspc/field/RFieldComparison.h>
+#include <pspc/field/FieldConverter.h>
+#include <pspc/field/FieldExpr.h>
+#include <pspc/misc/ConvergenceStudy.h>
 
 #include <pscf/inter/Interaction.h>
 #include <pscf/math/IntVec.h>
+#include <pscf/math/MatrixProduct.h>
 #include <pscf/homogeneous/Clump.h>
 
 #include <util/param/BracketPolicy.h>
+#include <util/containers/DMatrix.h>
 #include <util/format/Str.h>
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 #include <util/misc/ioUtil.h>
+#include <util/misc/Timer.h>
 
 #include <string>
+#include <sstream>
 #include <unistd.h>
 
 namespace Pscf {
@@ -46,12 +54,14 @@ namespace Pspc
     : mixture_(),
       domain_(),
       fileMaster_(),
+      logFilePtr_(0),
       homogeneous_(),
       interactionPtr_(0),
       iteratorPtr_(0),
       iteratorFactoryPtr_(0),
       sweepPtr_(0),
       sweepFactoryPtr_(0),
+      analyzerManager_(*this),
       w_(),
       c_(),
       h_(),
@@ -72,7 +82,13 @@ namespace Pspc
       interactionPtr_ = new Interaction(); 
       iteratorFactoryPtr_ = new IteratorFactory<D>(*this); 
       sweepFactoryPtr_ = new SweepFactory<D>(*this);
-      BracketPolicy::set(BracketPolicy::Optional);
+
+      // Set the process-wide bracket policy once, in a thread-safe
+      // static initialization, so that systems constructed in 
+      // concurrent threads do not write it while others read it.
+      static const bool hasBracketPolicy 
+                 = (BracketPolicy::set(BracketPolicy::Optional), true);
+      (void) hasBracketPolicy;
    }
 
    /*
@@ -139,7 +155,7 @@ namespace Pspc
             oArg  = optarg;
             break;
          case '?':
-           Log::file() << "Unknown option -" << optopt << std::endl;
+           logFile() << "Unknown option -" << optopt << std::endl;
            UTIL_THROW("Invalid command line option");
          }
       }
@@ -199,9 +215,12 @@ namespace Pspc
       mixture_.setMesh(domain_.mesh());
       mixture_.setupUnitCell(unitCell());
 
+      // Associate basis, without constructing it (const accessor)
+      mixture_.setFieldIo(domain().basis(), domain().fieldIo());
+
       // Allocate field array members of System
       allocateFieldsGrid();
-      if (domain_.basis().isInitialized()) {
+      if (domain_.hasBasis()) {
          allocateFieldsBasis();
       }
 
@@ -212,7 +231,7 @@ namespace Pspc
          iteratorFactoryPtr_->readObjectOptional(in, *this, className, 
                                                  isEnd);
       if (!iteratorPtr_) {
-         Log::file() << "Notification: No iterator was constructed\n";
+         logFile() << "Notification: No iterator was constructed\n";
       }
 
       // Optionally instantiate a Sweep object
@@ -222,6 +241,9 @@ namespace Pspc
                                                  isEnd);
       }
 
+      // Optionally instantiate any number of Analyzer objects
+      analyzerManager_.readParameters(in, *this);
+
       // Initialize homogeneous object 
       // NOTE: THIS OBJECT IS NOT USED AT ALL.
       homogeneous_.setNMolecule(np+ns);
@@ -265,11 +287,11 @@ namespace Pspc
          if (in.eof()) {
             break;
          } else {
-            Log::file() << command << std::endl;
+            logFile() << command << std::endl;
          }
 
          if (command == "FINISH") {
-            Log::file() << std::endl;
+            logFile() << std::endl;
             readNext = false;
          } else
          if (command == "READ_W_BASIS") {
@@ -287,7 +309,7 @@ namespace Pspc
          if (command == "SET_UNIT_CELL") {
             UnitCell<D> unitCell;
             in >> unitCell;
-            Log::file() << "   " << unitCell << std::endl;
+            logFile() << "   " << unitCell << std::endl;
             setUnitCell(unitCell);
          } else
          if (command == "COMPUTE") {
@@ -300,6 +322,10 @@ namespace Pspc
             int fail = iterate(isContinuation);
             if (fail) {
                readNext = false;
+            } else
+            if (analyzerManager_.size() > 0) {
+               analyzerManager_.compute();
+               analyzerManager_.output(logFile());
             }
          } else
          if (command == "SWEEP") {
@@ -307,6 +333,49 @@ namespace Pspc
             // through parameter space
             sweep();
          } else
+         if (command == "CONVERGENCE_STUDY") {
+            // Re-solve over ladders of contour step sizes and meshes
+            double dsMax, fTolerance, stressTolerance;
+            int nLevel, nMeshLevel;
+            readEcho(in, filename);
+            readEcho(in, dsMax);
+            readEcho(in, nLevel);
+            readEcho(in, nMeshLevel);
+            readEcho(in, fTolerance);
+            readEcho(in, stressTolerance);
+            ConvergenceStudy<D> study(*this);
+            study.setLadder(dsMax, nLevel);
+            study.setMeshLadder(nMeshLevel);
+            study.setTolerances(fTolerance, stressTolerance);
+            study.compute();
+            std::ofstream file;
+            fileMaster().openOutputFile(filename, file);
+            study.output(file);
+            file.close();
+            study.output(logFile());
+         } else
+         if (command == "EXTRACT_SWEEP_STEP") {
+            // Write one step (or all, if stepId < 0) of a sweep archive
+            // to files in the format written by Sweep::outputSolution
+            int stepId;
+            readEcho(in, inFileName);
+            in >> stepId;
+            logFile() << Str("step ID  ", 21) << stepId << "\n";
+            readEcho(in, outFileName);
+            SweepArchive<D> archive(*this);
+            archive.openRead(inFileName);
+            if (stepId < 0) {
+               for (int i = 0; i < archive.nStep(); ++i) {
+                  archive.readStep(i);
+                  archive.extract(outFileName);
+               }
+            } else {
+               UTIL_CHECK(stepId < archive.nStep());
+               archive.readStep(stepId);
+               archive.extract(outFileName);
+            }
+            archive.close();
+         } else
          if (command == "WRITE_PARAM") {
             readEcho(in, filename);
             std::ofstream file;
@@ -349,10 +418,10 @@ namespace Pspc
             in >> blockId;
             in >> directionId;
             in >> segmentId;
-            Log::file() << Str("polymer ID  ", 21) << polymerId << "\n"
-                        << Str("block ID  ", 21) << blockId << "\n"
-                        << Str("direction ID  ", 21) << directionId << "\n"
-                        << Str("segment ID  ", 21) << segmentId << std::endl;
+            logFile() << Str("polymer ID  ", 21) << polymerId << "\n"
+                      << Str("block ID  ", 21) << blockId << "\n"
+                      << Str("direction ID  ", 21) << directionId << "\n"
+                      << Str("segment ID  ", 21) << segmentId << std::endl;
             writeQSlice(filename, polymerId, blockId, directionId, 
                                   segmentId);
          } else
@@ -362,9 +431,9 @@ namespace Pspc
             in >> polymerId;
             in >> blockId;
             in >> directionId;
-            Log::file() << Str("polymer ID  ", 21) << polymerId << "\n"
-                        << Str("block ID  ", 21) << blockId << "\n"
-                        << Str("direction ID  ", 21) << directionId << "\n";
+            logFile() << Str("polymer ID  ", 21) << polymerId << "\n"
+                      << Str("block ID  ", 21) << blockId << "\n"
+                      << Str("direction ID  ", 21) << directionId << "\n";
             writeQTail(filename, polymerId, blockId, directionId);
          } else
          if (command == "WRITE_Q") {
@@ -373,9 +442,9 @@ namespace Pspc
             in >> polymerId;
             in >> blockId;
             in >> directionId;
-            Log::file() << Str("polymer ID  ", 21) << polymerId << "\n"
-                        << Str("block ID  ", 21) << blockId << "\n"
-                        << Str("direction ID  ", 21) << directionId << "\n";
+            logFile() << Str("polymer ID  ", 21) << polymerId << "\n"
+                      << Str("block ID  ", 21) << blockId << "\n"
+                      << Str("direction ID  ", 21) << directionId << "\n";
             writeQ(filename, polymerId, blockId, directionId);
          } else
          if (command == "WRITE_Q_ALL") {
@@ -384,10 +453,12 @@ namespace Pspc
          } else
          if (command == "WRITE_STARS") {
             readEcho(in, filename);
+            makeBasis();
             writeStars(filename);
          } else
          if (command == "WRITE_WAVES") {
             readEcho(in, filename);
+            makeBasis();
             writeWaves(filename);
          } else 
          if (command == "WRITE_GROUP") {
@@ -419,6 +490,17 @@ namespace Pspc
             readEcho(in, outFileName);
             basisToKGrid(inFileName, outFileName);
          } else
+         if (command == "CONVERT_FIELDS") {
+            std::string conversion;
+            readEcho(in, conversion);
+            readEcho(in, filename);
+            convertFields(conversion, filename);
+         } else
+         if (command == "BATCH_COMPUTE") {
+            readEcho(in, inFileName);
+            readEcho(in, outFileName);
+            batchCompute(inFileName, outFileName);
+         } else
          if (command == "KGRID_TO_BASIS") {
             readEcho(in, inFileName);
             readEcho(in, outFileName);
@@ -431,11 +513,11 @@ namespace Pspc
             bool hasSymmetry;
             hasSymmetry = checkRGridFieldSymmetry(inFileName, epsilon);
             if (hasSymmetry) {
-               Log::file() << std::endl
+               logFile() << std::endl
                    << "Symmetry of r-grid file matches this space group." 
                    << std::endl << std::endl;
             } else {
-               Log::file() << std::endl
+               logFile() << std::endl
                    << "Symmetry of r-grid file does not match this space group" 
                    << std::endl
                    << "to within error threshold of "
@@ -480,6 +562,10 @@ namespace Pspc
          } else 
          if (command == "READ_H_BASIS") {
             readEcho(in, filename);
+            if (!isAllocatedBasis_) {
+               readFieldHeader(filename);
+               allocateFieldsBasis();
+            }
             if (!h_.isAllocatedBasis()) {
                h_.allocateBasis(basis().nBasis());
             }
@@ -507,19 +593,29 @@ namespace Pspc
             fieldIo().writeFieldsRGrid(filename, h_.rgrid(), unitCell());
          } else 
          if (command == "READ_MASK_BASIS") {
-            UTIL_CHECK(domain_.basis().isInitialized());
             readEcho(in, filename);
-            if (!mask_.isAllocated()) {
-               mask_.allocate(basis().nBasis(), mesh().dimensions());
+            if (!isAllocatedBasis_) {
+               readFieldHeader(filename);
+               allocateFieldsBasis();
             }
+            // Reallocate, in case mask was allocated without a basis
+            if (mask_.isAllocated()) {
+               mask_.deallocate();
+            }
+            mask_.allocate(basis().nBasis(), mesh().dimensions());
             mask_.readBasis(filename, domain_.unitCell());
          } else
          if (command == "READ_MASK_RGRID") {
+            // Does not construct a basis. The mask is taken to be 
+            // symmetric, and converted to basis format, only if a 
+            // basis already exists.
             readEcho(in, filename);
-            if (!mask_.isAllocated()) {
-               mask_.allocate(basis().nBasis(), mesh().dimensions());
+            if (mask_.isAllocated()) {
+               mask_.deallocate();
             }
-            mask_.readBasis(filename, domain_.unitCell());
+            mask_.allocate(basis().nBasis(), mesh().dimensions());
+            mask_.readRGrid(filename, domain_.unitCell(), 
+                            domain_.hasBasis());
          } else
          if (command == "WRITE_MASK_BASIS") {
             readEcho(in, filename);
@@ -532,8 +628,8 @@ namespace Pspc
             UTIL_CHECK(mask_.hasData());
             fieldIo().writeFieldRGrid(filename, mask_.rgrid(), unitCell());
          } else {
-            Log::file() << "Error: Unknown command  " 
-                        << command << std::endl;
+            logFile() << "Error: Unknown command  " 
+                      << command << std::endl;
             readNext = false;
          }
       }
@@ -579,15 +675,8 @@ namespace Pspc
    template <int D>
    void System<D>::readWRGrid(const std::string & filename)
    {
-
-      // If basis fields are not allocated, peek at field file header to 
-      // get unit cell parameters, initialize basis and allocate fields.
-      if (!isAllocatedBasis_) {
-         readFieldHeader(filename); 
-         allocateFieldsBasis();
-      }
-
-      // Read w fields
+      // Read w fields and unit cell. This does not construct a basis, 
+      // or allocate basis fields, since neither is needed. 
       w_.readRGrid(filename, domain_.unitCell());
       mixture_.setupUnitCell(domain_.unitCell());
       hasCFields_ = false;
@@ -600,8 +689,10 @@ namespace Pspc
    template <int D>
    void System<D>::setWBasis(DArray< DArray<double> > const & fields)
    {
-      UTIL_CHECK(domain_.basis().isInitialized());
-      UTIL_CHECK(isAllocatedBasis_);
+      UTIL_CHECK(domain_.unitCell().isInitialized());
+      if (!isAllocatedBasis_) {
+         allocateFieldsBasis();
+      }
       w_.setBasis(fields);
       hasCFields_ = false;
       hasFreeEnergy_ = false;
@@ -678,9 +769,6 @@ namespace Pspc
    {
       domain_.setUnitCell(unitCell);
       mixture_.setupUnitCell(domain_.unitCell());
-      if (!isAllocatedBasis_) {
-         allocateFieldsBasis();
-      }
    }
 
    /*
@@ -693,9 +781,6 @@ namespace Pspc
    {
       domain_.setUnitCell(lattice, parameters);
       mixture_.setupUnitCell(domain_.unitCell());
-      if (!isAllocatedBasis_) {
-         allocateFieldsBasis();
-      }
    }
 
    /*
@@ -706,6 +791,116 @@ namespace Pspc
    {
       domain_.setUnitCell(parameters);
       mixture_.setupUnitCell(domain_.unitCell());
+   }
+
+   // Mesh Modifier
+
+   /*
+   * Change mesh dimensions, transferring fields by basis coefficients.
+   */
+   template <int D>
+   void System<D>::setMesh(IntVec<D> const & dimensions)
+   {
+      // Preconditions
+      UTIL_CHECK(isAllocatedRGrid_);
+      UTIL_CHECK(isAllocatedBasis_);
+      UTIL_CHECK(w_.hasData());
+      UTIL_CHECK(w_.isSymmetric());
+      const int nm = mixture_.nMonomer();
+      const int nBasisOld = domain_.basis().nBasis();
+      FieldIo<D> const & fieldIo = domain_.fieldIo();
+
+      // Write fields in basis format, which identifies each coefficient
+      // by a wavevector and is thus independent of the mesh
+      std::ostringstream wOut, hOut, maskOut;
+      fieldIo.writeFieldsBasis(wOut, w_.basis(), unitCell());
+      bool hasH = h_.hasData() && h_.isSymmetric();
+      if (hasH) {
+         fieldIo.writeFieldsBasis(hOut, h_.basis(), unitCell());
+      }
+      bool hasMask = mask_.hasData() && mask_.isSymmetric();
+      if (hasMask) {
+         fieldIo.writeFieldBasis(maskOut, mask_.basis(), unitCell());
+      }
+      int nState = sweepPtr_ ? sweepPtr_->historySize() : 0;
+      DArray<std::string> stateOut;
+      int i;
+      if (nState > 0) {
+         stateOut.allocate(nState);
+         for (i = 0; i < nState; ++i) {
+            BasisFieldState<D>& state = sweepPtr_->state(i);
+            std::ostringstream out;
+            fieldIo.writeFieldsBasis(out, state.fields(), state.unitCell());
+            stateOut[i] = out.str();
+         }
+      }
+
+      // Change mesh, FFT and basis, reallocate mixture 
+      domain_.setMesh(dimensions);
+      domain_.makeBasis();
+      mixture_.setMesh(domain_.mesh());
+      mixture_.setupUnitCell(unitCell());
+
+      // Reallocate fields
+      IntVec<D> const & meshDimensions = domain_.mesh().dimensions();
+      const int nBasis = domain_.basis().nBasis();
+      UTIL_CHECK(nBasis > 0);
+      w_.allocateRGrid(meshDimensions);
+      w_.allocateBasis(nBasis);
+      c_.allocateRGrid(meshDimensions);
+      c_.allocateBasis(nBasis);
+      if (h_.isAllocatedRGrid()) {
+         h_.allocateRGrid(meshDimensions);
+      }
+      if (h_.isAllocatedBasis()) {
+         h_.allocateBasis(nBasis);
+      }
+      if (mask_.isAllocated()) {
+         mask_.deallocate();
+         mask_.allocate(nBasis, meshDimensions);
+      }
+      for (i = 0; i < nm; ++i) {
+         tmpFieldsRGrid_[i].deallocate();
+         tmpFieldsRGrid_[i].allocate(meshDimensions);
+         tmpFieldsKGrid_[i].deallocate();
+         tmpFieldsKGrid_[i].allocate(meshDimensions);
+      }
+
+      // Read fields in the new basis
+      readRemeshBasis(wOut.str(), nBasisOld, unitCell(), tmpFieldsBasis_);
+      w_.setBasis(tmpFieldsBasis_);
+      if (hasH) {
+         readRemeshBasis(hOut.str(), nBasisOld, unitCell(), 
+                         tmpFieldsBasis_);
+         h_.setBasis(tmpFieldsBasis_);
+      }
+      if (hasMask) {
+         DArray< DArray<double> > maskFields;
+         maskFields.allocate(1);
+         readRemeshBasis(maskOut.str(), nBasisOld, unitCell(), maskFields);
+         mask_.setBasis(maskFields[0]);
+      }
+      for (i = 0; i < nState; ++i) {
+         BasisFieldState<D>& state = sweepPtr_->state(i);
+         readRemeshBasis(stateOut[i], nBasisOld, state.unitCell(), 
+                         state.fields());
+      }
+
+      hasCFields_ = false;
+      hasFreeEnergy_ = false;
+
+      // Notify the iterator, which may hold arrays of nBasis elements
+      if (iteratorPtr_) {
+         iteratorPtr_->resetMesh();
+      }
+   }
+
+   /*
+   * Construct basis and allocate basis fields, if not done previously.
+   */
+   template <int D>
+   void System<D>::makeBasis()
+   {
       if (!isAllocatedBasis_) {
          allocateFieldsBasis();
       }
@@ -724,7 +919,8 @@ namespace Pspc
       UTIL_CHECK(w_.hasData());
 
       // Solve the modified diffusion equation (without iteration)
-      mixture_.compute(w_.rgrid(), c_.rgrid(), mask_.phiTot());
+      mixture_.compute(w_.rgrid(), c_.rgrid(), mask_.phiTot(), 
+                       w_.isSymmetric());
       hasCFields_ = true;
       hasFreeEnergy_ = false;
 
@@ -753,8 +949,8 @@ namespace Pspc
       hasCFields_ = false;
       hasFreeEnergy_ = false;
 
-      Log::file() << std::endl;
-      Log::file() << std::endl;
+      logFile() << std::endl;
+      logFile() << std::endl;
 
       // Call iterator (return 0 for convergence, 1 for failure)
       int error = iterator().solve(isContinuation);
@@ -765,7 +961,7 @@ namespace Pspc
          if (!iterator().isFlexible()) {
             mixture().computeStress();
          }
-         writeThermo(Log::file());
+         writeThermo(logFile());
       }
       return error;
    }
@@ -779,8 +975,8 @@ namespace Pspc
       UTIL_CHECK(w_.hasData());
       UTIL_CHECK(w_.isSymmetric());
       UTIL_CHECK(hasSweep());
-      Log::file() << std::endl;
-      Log::file() << std::endl;
+      logFile() << std::endl;
+      logFile() << std::endl;
 
       // Perform sweep
       sweepPtr_->sweep();
@@ -841,15 +1037,12 @@ namespace Pspc
       }
 
       int nm  = mixture_.nMonomer();
-      int nBasis = domain_.basis().nBasis();
 
       double temp(0.0);
       // Compute Legendre transform subtraction
       // Use expansion in symmetry-adapted orthonormal basis
       for (int i = 0; i < nm; ++i) {
-         for (int k = 0; k < nBasis; ++k) {
-            temp -= w_.basis(i)[k] * c_.basis(i)[k];
-         }
+         temp -= sum(w_.basis(i)*c_.basis(i));
       }
 
       // If the system has a mask, then the volume that should be used
@@ -869,24 +1062,23 @@ namespace Pspc
       if (hasExternalFields()) {
          fExt_ = 0.0;
          for (int i = 0; i < nm; ++i) {
-            for (int k = 0; k < nBasis; ++k) {
-               fExt_ += h_.basis(i)[k] * c_.basis(i)[k];
-            }
+            fExt_ += sum(h_.basis(i)*c_.basis(i));
          }
          fExt_ /= mask().phiTot();
          fHelmholtz_ += fExt_;
       }
 
       // Compute excess interaction free energy [ phi^{T}*chi*phi ]
-      double chi;
+      // as a bilinear form, using the upper triangle of chi
+      // (chi is copied on each call, since it may change in a sweep)
       for (int i = 0; i < nm; ++i) {
-         for (int j = i + 1; j < nm; ++j) {
-            chi = interaction().chi(i,j);
-            for (int k = 0; k < nBasis; ++k) {
-               fInter_ += chi * c_.basis(i)[k] * c_.basis(j)[k];
-            }
+         cPtr_[i] = c_.basis(i).cArray();
+         for (int j = 0; j < nm; ++j) {
+            chiUpper_(i, j) = (j > i) ? interaction().chi(i,j) : 0.0;
          }
       }
+      fInter_ += bilinearForm(chiUpper_, cPtr_, cPtr_, 
+                              domain_.basis().nBasis());
       fInter_ /= mask().phiTot();
       fHelmholtz_ += fInter_;
 
@@ -1097,11 +1289,16 @@ namespace Pspc
       Polymer<D> const& polymer = mixture_.polymer(polymerId);
       UTIL_CHECK(blockId >= 0);
       UTIL_CHECK(blockId < polymer.nBlock());
+      UTIL_CHECK(polymer.multiplicity(blockId) > 0);
       UTIL_CHECK(directionId >= 0);
       UTIL_CHECK(directionId <= 1);
       Propagator<D> const & 
            propagator = polymer.propagator(blockId, directionId);
-      RField<D> const& field = propagator.q(segmentId);
+      RField<D> work;
+      if (propagator.isCompressed()) {
+         work.allocate(domain_.mesh().dimensions());
+      }
+      RField<D> const& field = propagator.q(segmentId, work);
       domain_.fieldIo().writeFieldRGrid(filename, field, 
                                         domain_.unitCell());
    }
@@ -1119,6 +1316,7 @@ namespace Pspc
       Polymer<D> const& polymer = mixture_.polymer(polymerId);
       UTIL_CHECK(blockId >= 0);
       UTIL_CHECK(blockId < polymer.nBlock());
+      UTIL_CHECK(polymer.multiplicity(blockId) > 0);
       UTIL_CHECK(directionId >= 0);
       UTIL_CHECK(directionId <= 1);
       RField<D> const& 
@@ -1140,6 +1338,7 @@ namespace Pspc
       Polymer<D> const& polymer = mixture_.polymer(polymerId);
       UTIL_CHECK(blockId >= 0);
       UTIL_CHECK(blockId < polymer.nBlock());
+      UTIL_CHECK(polymer.multiplicity(blockId) > 0);
       UTIL_CHECK(directionId >= 0);
       UTIL_CHECK(directionId <= 1);
       Propagator<D> const& propagator 
@@ -1158,10 +1357,14 @@ namespace Pspc
            << "          " << ns << std::endl;
 
       // Write data
+      RField<D> work;
+      if (propagator.isCompressed()) {
+         work.allocate(domain_.mesh().dimensions());
+      }
       bool hasHeader = false;
       for (int i = 0; i < ns; ++i) {
           file << "slice " << i << std::endl;
-          fieldIo().writeFieldRGrid(file, propagator.q(i), 
+          fieldIo().writeFieldRGrid(file, propagator.q(i, work), 
                                     domain_.unitCell(), hasHeader);
       }
       file.close();
@@ -1179,6 +1382,7 @@ namespace Pspc
       for (ip = 0; ip < np; ++ip) {
          nb = mixture_.polymer(ip).nBlock();
          for (ib = 0; ib < nb; ++ib) {
+            if (mixture_.polymer(ip).multiplicity(ib) == 0) continue;
             for (id = 0; id < 2; ++id) {
                filename = basename;
                filename += "_";
@@ -1286,13 +1490,6 @@ namespace Pspc
    void System<D>::kGridToRGrid(const std::string & inFileName,
                                 const std::string& outFileName)
    {
-      // If basis fields are not allocated, peek at field file header to 
-      // get unit cell parameters, initialize basis and allocate fields.
-      if (!isAllocatedBasis_) {
-         readFieldHeader(inFileName); 
-         allocateFieldsBasis();
-      }
-
       // Read, convert and write fields
       UnitCell<D> tmpUnitCell;
       fieldIo().readFieldsKGrid(inFileName, tmpFieldsKGrid_, tmpUnitCell);
@@ -1311,13 +1508,6 @@ namespace Pspc
    void System<D>::rGridToKGrid(const std::string & inFileName,
                                 const std::string & outFileName)
    {
-      // If basis fields are not allocated, peek at field file header to 
-      // get unit cell parameters, initialize basis and allocate fields.
-      if (!isAllocatedBasis_) {
-         readFieldHeader(inFileName); 
-         allocateFieldsBasis();
-      }
-
       // Read, convert and write fields
       UnitCell<D> tmpUnitCell;
       fieldIo().readFieldsRGrid(inFileName, tmpFieldsRGrid_, 
@@ -1378,6 +1568,134 @@ namespace Pspc
                                          tmpFieldsKGrid_, tmpUnitCell);
    }
 
+   /*
+   * Convert a list of field files.
+   */
+   template <int D>
+   int System<D>::convertFields(const std::string & conversion,
+                                const std::string & listFileName)
+   {
+      typename FieldConverter<D>::Conversion type;
+      type = FieldConverter<D>::conversion(conversion);
+
+      // Read pairs of input and output file names
+      GArray<std::string> inFileNames;
+      GArray<std::string> outFileNames;
+      std::ifstream file;
+      fileMaster().openInputFile(listFileName, file);
+      std::string inFileName, outFileName;
+      while (file >> inFileName >> outFileName) {
+         inFileNames.append(inFileName);
+         outFileNames.append(outFileName);
+      }
+      file.close();
+      if (inFileNames.size() == 0) {
+         logFile() << "No files listed in " << listFileName << std::endl;
+         return 0;
+      }
+
+      // If basis fields are not allocated, peek at first field file 
+      // header to get unit cell parameters, initialize basis and 
+      // allocate fields.
+      if (!isAllocatedBasis_) {
+         readFieldHeader(inFileNames[0]); 
+         allocateFieldsBasis();
+      }
+
+      FieldConverter<D> converter;
+      converter.setup(domain_.fieldIo(), domain_.mesh(), 
+                      mixture_.nMonomer(), domain_.basis().nBasis());
+      return converter.convert(type, inFileNames, outFileNames);
+   }
+
+   /*
+   * Compute and tabulate free energies for a list of w field files.
+   */
+   template <int D>
+   int System<D>::batchCompute(const std::string & listFileName,
+                               const std::string & outFileName)
+   {
+      // Read list of w field file names
+      GArray<std::string> fileNames;
+      std::ifstream file;
+      fileMaster().openInputFile(listFileName, file);
+      std::string fileName;
+      while (file >> fileName) {
+         fileNames.append(fileName);
+      }
+      file.close();
+      int n = fileNames.size();
+      if (n == 0) {
+         logFile() << "No files listed in " << listFileName << std::endl;
+         return 0;
+      }
+
+      std::ofstream out;
+      fileMaster().openOutputFile(outFileName, out);
+      out << "#    id          fHelmholtz            pressure  file" 
+          << std::endl;
+
+      Timer timer;
+      timer.start();
+      UnitCell<D> tmpUnitCell;
+      int length, j;
+      bool isRGrid;
+      int nComputed = 0;
+      for (int i = 0; i < n; ++i) {
+         fileName = fileNames[i];
+         length = fileName.size();
+         isRGrid = (length > 3 && fileName.substr(length - 3) == ".rf");
+         try {
+            if (isRGrid) {
+               // Read r-grid fields and convert to basis format, since
+               // computeFreeEnergy requires symmetric w fields
+               if (!isAllocatedBasis_) {
+                  readFieldHeader(fileName); 
+                  allocateFieldsBasis();
+               }
+               domain_.fieldIo().readFieldsRGrid(fileName, tmpFieldsRGrid_,
+                                                 tmpUnitCell);
+               for (j = 0; j < mixture_.nMonomer(); ++j) {
+                  if (!domain_.fieldIo().hasSymmetry(tmpFieldsRGrid_[j],
+                                                     1.0E-8, false)) {
+                     UTIL_THROW("R-grid fields lack space group symmetry");
+                  }
+               }
+               domain_.fieldIo().convertRGridToBasis(tmpFieldsRGrid_, 
+                                                     tmpFieldsBasis_, 
+                                                     false);
+               setUnitCell(tmpUnitCell);
+               setWBasis(tmpFieldsBasis_);
+            } else {
+               readWBasis(fileName);
+            }
+            compute();
+            computeFreeEnergy();
+         } catch (Exception&) {
+            // Record the failure and continue with the next file
+            logFile() << "ERROR: could not evaluate w fields in file " 
+                      << fileName << std::endl;
+            out << Int(i, 7) 
+                << Str("ERROR", 20) 
+                << Str("ERROR", 20)
+                << "  " << fileName << std::endl;
+            continue;
+         }
+         out << Int(i, 7) 
+             << Dbl(fHelmholtz(), 20, 11) 
+             << Dbl(pressure(), 20, 11) 
+             << "  " << fileName << std::endl;
+         ++nComputed;
+      }
+      timer.stop();
+      out.close();
+
+      logFile() << "Computed " << nComputed << " of " << n 
+                << " sets of fields in " 
+                << Dbl(timer.time(), 12, 4) << " sec" << std::endl;
+      return nComputed;
+   }
+
    /*
    * Convert fields from real-space grid to symmetry-adapted basis format.
    */
@@ -1420,12 +1738,12 @@ namespace Pspc
       BFieldComparison comparison(1);
       comparison.compare(field1,field2);
 
-      Log::file() << "\n Basis expansion field comparison results" 
-                  << std::endl;
-      Log::file() << "     Maximum Absolute Difference:   " 
-                  << comparison.maxDiff() << std::endl;
-      Log::file() << "     Root-Mean-Square Difference:   " 
-                  << comparison.rmsDiff() << "\n" << std::endl;
+      logFile() << "\n Basis expansion field comparison results" 
+                << std::endl;
+      logFile() << "     Maximum Absolute Difference:   " 
+                << comparison.maxDiff() << std::endl;
+      logFile() << "     Root-Mean-Square Difference:   " 
+                << comparison.rmsDiff() << "\n" << std::endl;
    }
 
    /*
@@ -1438,12 +1756,12 @@ namespace Pspc
       RFieldComparison<D> comparison;
       comparison.compare(field1, field2);
 
-      Log::file() << "\n Real-space field comparison results" 
-                  << std::endl;
-      Log::file() << "     Maximum Absolute Difference:   " 
-                  << comparison.maxDiff() << std::endl;
-      Log::file() << "     Root-Mean-Square Difference:   " 
-                  << comparison.rmsDiff() << "\n" << std::endl;
+      logFile() << "\n Real-space field comparison results" 
+                << std::endl;
+      logFile() << "     Maximum Absolute Difference:   " 
+                << comparison.maxDiff() << std::endl;
+      logFile() << "     Root-Mean-Square Difference:   " 
+                << comparison.rmsDiff() << "\n" << std::endl;
    }
 
    // Private member functions
@@ -1481,6 +1799,11 @@ namespace Pspc
          tmpFieldsRGrid_[i].allocate(dimensions);
          tmpFieldsKGrid_[i].allocate(dimensions);
       }
+
+      // Allocate work space for computeFreeEnergy
+      chiUpper_.allocate(nMonomer, nMonomer);
+      cPtr_.allocate(nMonomer);
+
       isAllocatedRGrid_ = true;
    }
 
@@ -1496,7 +1819,10 @@ namespace Pspc
       UTIL_CHECK(nMonomer > 0);
       UTIL_CHECK(isAllocatedRGrid_);
       UTIL_CHECK(!isAllocatedBasis_);
-      UTIL_CHECK(domain_.basis().isInitialized());
+      UTIL_CHECK(domain_.unitCell().isInitialized());
+
+      // Construct the basis, if not done previously
+      domain_.makeBasis();
       const int nBasis = domain_.basis().nBasis();
       UTIL_CHECK(nBasis > 0);
 
@@ -1512,7 +1838,51 @@ namespace Pspc
    }
 
    /*
-   * Peek at field file header, initialize unit cell parameters and basis.
+   * Read fields in basis format written with a different mesh.
+   */
+   template <int D>
+   void System<D>::readRemeshBasis(std::string const & buffer, 
+                                   int nBasisIn,
+                                   UnitCell<D> const & unitCell,
+                                   DArray< DArray<double> >& fields)
+   {
+      UTIL_CHECK(fields.isAllocated());
+      const int nField = fields.capacity();
+      const int nBasis = domain_.basis().nBasis();
+
+      // FieldIo::readFieldsBasis reads no more lines than the capacity 
+      // of the fields, and sets the component with the index of each 
+      // star in the new basis. The capacity of the work array must thus
+      // be at least nBasisIn and at least nBasis.
+      int capacity = (nBasisIn > nBasis) ? nBasisIn : nBasis;
+      DArray< DArray<double> > temp;
+      temp.allocate(nField);
+      int i, j;
+      for (i = 0; i < nField; ++i) {
+         temp[i].allocate(capacity);
+      }
+
+      // Read from a copy of the unit cell, which is reset from the 
+      // header, so that parameters are not rounded to output precision
+      UnitCell<D> cell = unitCell;
+      std::istringstream in(buffer);
+      domain_.fieldIo().readFieldsBasis(in, temp, cell);
+
+      for (i = 0; i < nField; ++i) {
+         if (fields[i].isAllocated() && fields[i].capacity() != nBasis) {
+            fields[i].deallocate();
+         }
+         if (!fields[i].isAllocated()) {
+            fields[i].allocate(nBasis);
+         }
+         for (j = 0; j < nBasis; ++j) {
+            fields[i][j] = temp[i][j];
+         }
+      }
+   }
+
+   /*
+   * Peek at field file header, initialize unit cell parameters and group.
    */
    template <int D>
    void System<D>::readFieldHeader(std::string filename)
@@ -1524,11 +1894,10 @@ namespace Pspc
       std::ifstream file;
       fileMaster_.openInputFile(filename, file);
 
-      // Read field file header, and initialize basis if needed
+      // Read field file header (does not construct a basis)
       int nMonomer;
       domain_.fieldIo().readFieldHeader(file, nMonomer, 
                                         domain_.unitCell());
-      // FieldIo::readFieldHeader initializes a basis if needed
       file.close();
 
       // Postconditions
@@ -1536,8 +1905,6 @@ namespace Pspc
       UTIL_CHECK(domain_.unitCell().nParameter() > 0);
       UTIL_CHECK(domain_.unitCell().lattice() != UnitCell<D>::Null);
       UTIL_CHECK(domain_.unitCell().isInitialized());
-      UTIL_CHECK(domain_.basis().isInitialized());
-      UTIL_CHECK(domain_.basis().nBasis() > 0);
    }
 
    /*
@@ -1550,7 +1917,7 @@ namespace Pspc
       if (in.fail()) {
           UTIL_THROW("Unable to read string parameter.");
       }
-      Log::file() << " " << Str(string, 20) << std::endl;
+      logFile() << " " << Str(string, 20) << std::endl;
    }
 
    /*
@@ -1563,7 +1930,20 @@ namespace Pspc
       if (in.fail()) {
           UTIL_THROW("Unable to read floating point parameter.");
       }
-      Log::file() << " " << Dbl(value, 20) << std::endl;
+      logFile() << " " << Dbl(value, 20) << std::endl;
+   }
+
+   /*
+   * Read an integer, echo to log file (used in readCommands).
+   */
+   template <int D>
+   void System<D>::readEcho(std::istream& in, int& value) const
+   {
+      in >> value;
+      if (in.fail()) {
+          UTIL_THROW("Unable to read integer parameter.");
+      }
+      logFile() << " " << Int(value, 20) << std::endl;
    }
 
    /*
@@ -0,0 +1,136 @@
+#ifndef PSPC_ANALYZER_H
+#define PSPC_ANALYZER_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/param/ParamComposite.h>    // base class
+#include <pspc/field/RField.h>             // function parameter
+#include <util/containers/DArray.h>        // member template
+#include <util/global.h>
+
+#include <string>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template <int D>
+   class System;
+
+   using namespace Util;
+
+   /**
+   * Base class for in-situ analysis of converged solutions.
+   *
+   * An Analyzer computes a fixed number of scalar values from the
+   * current state of the parent System. Analyzers are invoked by the
+   * ITERATE command after convergence, and by Sweep<D>::outputSolution
+   * after each accepted step of a sweep, in which case the values are
+   * appended to the corresponding line of the sweep log file.
+   *
+   * Each subclass must allocate the values array by calling
+   * allocateValues within readParameters, and must implement compute
+   * and label. The number of values may not change after
+   * readParameters returns.
+   *
+   * \ingroup Pspc_Analyzer_Module
+   */
+   template <int D>
+   class Analyzer : public ParamComposite
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system parent System object
+      */
+      Analyzer(System<D>& system);
+
+      /**
+      * Destructor.
+      */
+      virtual ~Analyzer();
+
+      /**
+      * Compute all values for the current state of the parent System.
+      *
+      * Called only after the SCFT equations have been solved, when the
+      * concentration fields are up to date.
+      */
+      virtual void compute() = 0;
+
+      /**
+      * Get a label for value i, used in output headers.
+      *
+      * \param i  index of value, 0 <= i < nValue()
+      */
+      virtual std::string label(int i) const = 0;
+
+      /**
+      * Get the number of scalar values computed by this analyzer.
+      */
+      int nValue() const
+      {  return values_.capacity(); }
+
+      /**
+      * Get value i, as computed by the most recent call to compute.
+      *
+      * \param i  index of value, 0 <= i < nValue()
+      */
+      double value(int i) const
+      {  return values_[i]; }
+
+   protected:
+
+      /// Values computed by the most recent call to compute.
+      DArray<double> values_;
+
+      /**
+      * Allocate the array of values.
+      *
+      * \param n  number of values
+      */
+      void allocateValues(int n);
+
+      /**
+      * Compute local volume fraction of one monomer type.
+      *
+      * On return, psi(r) = c_m(r)/sum_i c_i(r), where m = monomerId,
+      * or zero at grid points at which the total concentration is
+      * negligible (e.g., outside the region defined by a mask).
+      *
+      * \param monomerId  index of monomer type
+      * \param psi  local volume fraction field (output)
+      */
+      void computeLocalFraction(int monomerId, RField<D>& psi) const;
+
+      /**
+      * Get parent system by const reference.
+      */
+      System<D> const & system() const
+      {  return *systemPtr_; }
+
+   private:
+
+      /// Pointer to the parent System object.
+      System<D>* systemPtr_;
+
+   };
+
+   #ifndef PSPC_ANALYZER_TPP
+   // Suppress implicit instantiation
+   extern template class Analyzer<1>;
+   extern template class Analyzer<2>;
+   extern template class Analyzer<3>;
+   #endif
+
+}
+}
+#endif
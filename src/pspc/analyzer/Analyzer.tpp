@@ -0,0 +1,86 @@
+#ifndef PSPC_ANALYZER_TPP
+#define PSPC_ANALYZER_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Analyzer.h"
+#include <pspc/System.h>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   template <int D>
+   Analyzer<D>::Analyzer(System<D>& system)
+    : systemPtr_(&system)
+   {  setClassName("Analyzer"); }
+
+   /*
+   * Destructor.
+   */
+   template <int D>
+   Analyzer<D>::~Analyzer()
+   {}
+
+   /*
+   * Allocate the array of values.
+   */
+   template <int D>
+   void Analyzer<D>::allocateValues(int n)
+   {
+      UTIL_CHECK(n > 0);
+      UTIL_CHECK(!values_.isAllocated());
+      values_.allocate(n);
+      for (int i = 0; i < n; ++i) {
+         values_[i] = 0.0;
+      }
+   }
+
+   /*
+   * Compute local volume fraction of one monomer type.
+   */
+   template <int D>
+   void Analyzer<D>::computeLocalFraction(int monomerId, 
+                                          RField<D>& psi) const
+   {
+      const int nMonomer = system().mixture().nMonomer();
+      const int nx = system().mesh().size();
+      UTIL_CHECK(monomerId >= 0 && monomerId < nMonomer);
+      if (psi.isAllocated() && 
+          psi.meshDimensions() != system().mesh().dimensions()) {
+         psi.deallocate();
+      }
+      if (!psi.isAllocated()) {
+         psi.allocate(system().mesh().dimensions());
+      }
+      UTIL_CHECK(psi.capacity() == nx);
+
+      RField<D> const & cm = system().c().rgrid(monomerId);
+      double total;
+      int i, j;
+      for (j = 0; j < nx; ++j) {
+         total = 0.0;
+         for (i = 0; i < nMonomer; ++i) {
+            total += system().c().rgrid(i)[j];
+         }
+         if (total > 1.0E-8) {
+            psi[j] = cm[j]/total;
+         } else {
+            psi[j] = 0.0;
+         }
+      }
+   }
+
+}
+}
+#endif
@@ -0,0 +1,66 @@
+#ifndef PSPC_ANALYZER_FACTORY_H
+#define PSPC_ANALYZER_FACTORY_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/param/Factory.h>  
+#include "Analyzer.h"
+
+#include <string>
+
+namespace Pscf {
+namespace Pspc {
+
+   using namespace Util;
+
+   template <int D> class System;
+
+   /**
+   * Default Factory for subclasses of Analyzer.
+   *
+   * \ingroup Pspc_Analyzer_Module
+   */
+   template <int D>
+   class AnalyzerFactory : public Factory< Analyzer<D> > 
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system parent System object
+      */
+      AnalyzerFactory(System<D>& system);
+
+      /**
+      * Method to create any Analyzer subclass.
+      *
+      * \param className name of the Analyzer subclass
+      * \return Analyzer<D>* pointer to new instance of className
+      */
+      Analyzer<D>* factory(std::string const & className) const;
+
+      using Factory< Analyzer<D> >::trySubfactories;
+
+   private:
+
+      System<D>* systemPtr_;
+
+   };
+
+   #ifndef PSPC_ANALYZER_FACTORY_TPP
+   // Suppress implicit instantiation
+   extern template class AnalyzerFactory<1>;
+   extern template class AnalyzerFactory<2>;
+   extern template class AnalyzerFactory<3>;
+   #endif
+
+}
+}
+#endif
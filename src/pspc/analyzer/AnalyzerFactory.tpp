@@ -0,0 +1,59 @@
+#ifndef PSPC_ANALYZER_FACTORY_TPP
+#define PSPC_ANALYZER_FACTORY_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "AnalyzerFactory.h"
+
+// Subclasses of Analyzer
+#include "StructureFactor.h"
+#include "InterfaceAnalyzer.h"
+#include "DomainAnalyzer.h"
+
+namespace Pscf {
+namespace Pspc {
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   template <int D>
+   AnalyzerFactory<D>::AnalyzerFactory(System<D>& system)
+    : systemPtr_(&system)
+   {}
+
+   /*
+   * Return a pointer to an instance of Analyzer subclass className.
+   */
+   template <int D>
+   Analyzer<D>* 
+   AnalyzerFactory<D>::factory(std::string const & className) const
+   {
+      Analyzer<D>* ptr = 0;
+
+      // Try subfactories first
+      ptr = trySubfactories(className);
+      if (ptr) return ptr;
+
+      if (className == "StructureFactor") {
+         ptr = new StructureFactor<D>(*systemPtr_);
+      } else 
+      if (className == "InterfaceAnalyzer") {
+         ptr = new InterfaceAnalyzer<D>(*systemPtr_);
+      } else 
+      if (className == "DomainAnalyzer") {
+         ptr = new DomainAnalyzer<D>(*systemPtr_);
+      }
+
+      return ptr;
+   }
+
+}
+}
+#endif
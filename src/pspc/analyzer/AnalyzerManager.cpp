@@ -0,0 +1,19 @@
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "AnalyzerManager.tpp"
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template class AnalyzerManager<1>;
+   template class AnalyzerManager<2>;
+   template class AnalyzerManager<3>;
+
+} // namespace Pspc
+} // namespace Pscf
@@ -0,0 +1,135 @@
+#ifndef PSPC_ANALYZER_MANAGER_H
+#define PSPC_ANALYZER_MANAGER_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/GArray.h>      // member template
+#include <util/global.h>
+
+#include <iostream>
+
+namespace Util {
+   class ParamComposite;
+}
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template <int D> class System;
+   template <int D> class Analyzer;
+   template <int D> class AnalyzerFactory;
+
+   using namespace Util;
+
+   /**
+   * Container and driver for a list of Analyzer objects.
+   *
+   * The parent System owns one AnalyzerManager. Analyzers are read from
+   * optional selectable blocks at the end of the System parameter block
+   * and are invoked after convergence by the ITERATE command and after 
+   * each accepted step of a sweep.
+   *
+   * \ingroup Pspc_Analyzer_Module
+   */
+   template <int D>
+   class AnalyzerManager
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system parent System
+      */
+      AnalyzerManager(System<D>& system);
+
+      /**
+      * Destructor, deletes all analyzers.
+      */
+      ~AnalyzerManager();
+
+      /**
+      * Read any number of optional Analyzer blocks.
+      *
+      * Reads selectable Analyzer blocks until a block label that is not
+      * recognized by the AnalyzerFactory (e.g., the closing bracket of
+      * the parent block) is encountered.
+      *
+      * \param in  input parameter stream
+      * \param parent  parent ParamComposite (the System)
+      */
+      void readParameters(std::istream& in, ParamComposite& parent);
+
+      /**
+      * Call compute for all analyzers.
+      */
+      void compute();
+
+      /**
+      * Write labels of all values on one line, without a line break.
+      *
+      * Each label is right justified in a field of 16 characters, for 
+      * use as column headers.
+      *
+      * \param out  output stream
+      */
+      void writeHeader(std::ostream& out) const;
+
+      /**
+      * Write all values on one line, without a line break.
+      *
+      * Values are written in the same order and field width as the
+      * labels written by writeHeader.
+      *
+      * \param out  output stream
+      */
+      void writeValues(std::ostream& out) const;
+
+      /**
+      * Write one line per value, with label, for the log file.
+      *
+      * \param out  output stream
+      */
+      void output(std::ostream& out) const;
+
+      /**
+      * Number of analyzers.
+      */
+      int size() const
+      {  return analyzers_.size(); }
+
+      /**
+      * Get analyzer i by reference.
+      *
+      * \param i  index of analyzer, 0 <= i < size()
+      */
+      Analyzer<D>& operator [] (int i)
+      {  return *analyzers_[i]; }
+
+   private:
+
+      /// Array of pointers to analyzers (owned).
+      GArray< Analyzer<D>* > analyzers_;
+
+      /// Pointer to factory (owned).
+      AnalyzerFactory<D>* factoryPtr_;
+
+   };
+
+   #ifndef PSPC_ANALYZER_MANAGER_TPP
+   // Suppress implicit instantiation
+   extern template class AnalyzerManager<1>;
+   extern template class AnalyzerManager<2>;
+   extern template class AnalyzerManager<3>;
+   #endif
+
+}
+}
+#endif
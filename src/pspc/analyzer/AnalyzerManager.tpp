@@ -0,0 +1,129 @@
+#ifndef PSPC_ANALYZER_MANAGER_TPP
+#define PSPC_ANALYZER_MANAGER_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "AnalyzerManager.h"
+#include "Analyzer.h"
+#include "AnalyzerFactory.h"
+#include <util/param/ParamComposite.h>
+#include <util/format/Dbl.h>
+
+#include <iomanip>
+#include <string>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   template <int D>
+   AnalyzerManager<D>::AnalyzerManager(System<D>& system)
+    : analyzers_(),
+      factoryPtr_(0)
+   {  factoryPtr_ = new AnalyzerFactory<D>(system); }
+
+   /*
+   * Destructor.
+   */
+   template <int D>
+   AnalyzerManager<D>::~AnalyzerManager()
+   {
+      for (int i = 0; i < analyzers_.size(); ++i) {
+         delete analyzers_[i];
+      }
+      if (factoryPtr_) {
+         delete factoryPtr_;
+      }
+   }
+
+   /*
+   * Read optional Analyzer blocks.
+   */
+   template <int D>
+   void 
+   AnalyzerManager<D>::readParameters(std::istream& in, 
+                                      ParamComposite& parent)
+   {
+      std::string className;
+      bool isEnd;
+      Analyzer<D>* ptr = 0;
+      do {
+         ptr = factoryPtr_->readObjectOptional(in, parent, className, 
+                                               isEnd);
+         if (ptr) {
+            analyzers_.append(ptr);
+         }
+      } while (ptr);
+   }
+
+   /*
+   * Call compute for all analyzers.
+   */
+   template <int D>
+   void AnalyzerManager<D>::compute()
+   {
+      for (int i = 0; i < analyzers_.size(); ++i) {
+         analyzers_[i]->compute();
+      }
+   }
+
+   /*
+   * Write labels of all values on one line.
+   */
+   template <int D>
+   void AnalyzerManager<D>::writeHeader(std::ostream& out) const
+   {
+      int i, j;
+      for (i = 0; i < analyzers_.size(); ++i) {
+         for (j = 0; j < analyzers_[i]->nValue(); ++j) {
+            out << std::right << std::setw(16) << analyzers_[i]->label(j);
+         }
+      }
+   }
+
+   /*
+   * Write all values on one line.
+   */
+   template <int D>
+   void AnalyzerManager<D>::writeValues(std::ostream& out) const
+   {
+      int i, j;
+      for (i = 0; i < analyzers_.size(); ++i) {
+         for (j = 0; j < analyzers_[i]->nValue(); ++j) {
+            out << Dbl(analyzers_[i]->value(j), 16);
+         }
+      }
+   }
+
+   /*
+   * Write one line per value, with labels.
+   */
+   template <int D>
+   void AnalyzerManager<D>::output(std::ostream& out) const
+   {
+      if (analyzers_.size() == 0) return;
+      out << "Analyzers:" << std::endl;
+      int i, j;
+      for (i = 0; i < analyzers_.size(); ++i) {
+         for (j = 0; j < analyzers_[i]->nValue(); ++j) {
+            out << std::left << std::setw(16) << analyzers_[i]->label(j)
+                << std::right << Dbl(analyzers_[i]->value(j), 18, 11)
+                << std::endl;
+         }
+      }
+      out << std::endl;
+   }
+
+}
+}
+#endif
@@ -0,0 +1,19 @@
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "DomainAnalyzer.tpp"
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template class DomainAnalyzer<1>;
+   template class DomainAnalyzer<2>;
+   template class DomainAnalyzer<3>;
+
+} // namespace Pspc
+} // namespace Pscf
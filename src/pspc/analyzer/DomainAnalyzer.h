@@ -0,0 +1,134 @@
+#ifndef PSPC_DOMAIN_ANALYZER_H
+#define PSPC_DOMAIN_ANALYZER_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Analyzer.h"                   // base class
+#include <pspc/field/RField.h>          // member
+#include <util/containers/DArray.h>     // member
+
+#include <vector>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template <int D>
+   class System;
+
+   using namespace Util;
+
+   /**
+   * Number and volume fractions of domains rich in one monomer type.
+   *
+   * A domain is a connected set of grid points at which the local volume
+   * fraction psi(r) of a chosen monomer type exceeds a threshold. Grid 
+   * points are connected if they are nearest neighbors along any mesh
+   * direction, with periodic boundary conditions. By default, the
+   * threshold is the midpoint between the minimum and maximum values of
+   * psi. 
+   *
+   * The analyzer reports the total volume fraction of the cell occupied
+   * by all such domains, the number of distinct domains within one unit
+   * cell, and the volume fractions of the maxDomain largest domains, in 
+   * order of decreasing size (padded with zeros if there are fewer 
+   * domains). A domain that percolates through periodic boundaries 
+   * (e.g., a lamella, cylinder or gyroid network) is counted once.
+   *
+   * Parameters: monomerId* (int, 0 by default), maxDomain* (int, 4 by
+   * default), threshold* (real, midpoint by default).
+   *
+   * \ingroup Pspc_Analyzer_Module
+   */
+   template <int D>
+   class DomainAnalyzer : public Analyzer<D>
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system parent System object
+      */
+      DomainAnalyzer(System<D>& system);
+
+      /**
+      * Destructor.
+      */
+      ~DomainAnalyzer();
+
+      /**
+      * Read parameters and allocate values.
+      *
+      * \param in input parameter stream
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Identify domains and compute their volume fractions.
+      */
+      void compute();
+
+      /**
+      * Get label for value i.
+      *
+      * \param i  index of value
+      */
+      std::string label(int i) const;
+
+      using Analyzer<D>::nValue;
+      using Analyzer<D>::value;
+
+   protected:
+
+      using Analyzer<D>::values_;
+      using Analyzer<D>::allocateValues;
+      using Analyzer<D>::computeLocalFraction;
+      using Analyzer<D>::system;
+      using ParamComposite::readOptional;
+      using ParamComposite::setClassName;
+
+   private:
+
+      /// Local volume fraction of the chosen monomer type.
+      RField<D> psi_;
+
+      /// Domain index of each grid point (-1 if below threshold).
+      DArray<int> domainId_;
+
+      /// Stack of grid point ranks used by flood fill.
+      std::vector<int> stack_;
+
+      /// Number of grid points in each domain.
+      std::vector<int> size_;
+
+      /// Threshold value of psi (if thresholdIsSet_).
+      double threshold_;
+
+      /// Index of monomer type used to define psi.
+      int monomerId_;
+
+      /// Number of domain volume fractions reported.
+      int maxDomain_;
+
+      /// Was a threshold given in the parameter file?
+      bool thresholdIsSet_;
+
+   };
+
+   #ifndef PSPC_DOMAIN_ANALYZER_TPP
+   // Suppress implicit instantiation
+   extern template class DomainAnalyzer<1>;
+   extern template class DomainAnalyzer<2>;
+   extern template class DomainAnalyzer<3>;
+   #endif
+
+}
+}
+#endif
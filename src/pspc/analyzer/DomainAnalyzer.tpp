@@ -0,0 +1,164 @@
+#ifndef PSPC_DOMAIN_ANALYZER_TPP
+#define PSPC_DOMAIN_ANALYZER_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "DomainAnalyzer.h"
+#include <pspc/System.h>
+#include <util/misc/ioUtil.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   template <int D>
+   DomainAnalyzer<D>::DomainAnalyzer(System<D>& system)
+    : Analyzer<D>(system),
+      threshold_(0.5),
+      monomerId_(0),
+      maxDomain_(4),
+      thresholdIsSet_(false)
+   {  setClassName("DomainAnalyzer"); }
+
+   /*
+   * Destructor.
+   */
+   template <int D>
+   DomainAnalyzer<D>::~DomainAnalyzer()
+   {}
+
+   /*
+   * Read parameters and allocate values.
+   */
+   template <int D>
+   void DomainAnalyzer<D>::readParameters(std::istream& in)
+   {
+      readOptional(in, "monomerId", monomerId_);
+      readOptional(in, "maxDomain", maxDomain_);
+      thresholdIsSet_ = readOptional(in, "threshold", threshold_).isActive();
+      UTIL_CHECK(monomerId_ >= 0);
+      UTIL_CHECK(monomerId_ < system().mixture().nMonomer());
+      UTIL_CHECK(maxDomain_ > 0);
+      allocateValues(2 + maxDomain_);
+   }
+
+   /*
+   * Identify domains by flood fill and compute volume fractions.
+   */
+   template <int D>
+   void DomainAnalyzer<D>::compute()
+   {
+      UTIL_CHECK(system().hasCFields());
+      Mesh<D> const & mesh = system().mesh();
+      const int nx = mesh.size();
+
+      // Allocate work arrays, or reallocate after a change of mesh
+      if (psi_.isAllocated() && psi_.meshDimensions() != mesh.dimensions()) {
+         psi_.deallocate();
+         domainId_.deallocate();
+      }
+      if (!psi_.isAllocated()) {
+         psi_.allocate(mesh.dimensions());
+         domainId_.allocate(nx);
+      }
+      computeLocalFraction(monomerId_, psi_);
+
+      // Choose threshold
+      double threshold = threshold_;
+      int i;
+      if (!thresholdIsSet_) {
+         double psiMin = psi_[0];
+         double psiMax = psi_[0];
+         for (i = 1; i < nx; ++i) {
+            if (psi_[i] < psiMin) psiMin = psi_[i];
+            if (psi_[i] > psiMax) psiMax = psi_[i];
+         }
+         threshold = 0.5*(psiMin + psiMax);
+      }
+
+      // Mark grid points above threshold as unassigned (-2)
+      int nInside = 0;
+      for (i = 0; i < nx; ++i) {
+         if (psi_[i] > threshold) {
+            domainId_[i] = -2;
+            ++nInside;
+         } else {
+            domainId_[i] = -1;
+         }
+      }
+
+      // Flood fill, with nearest neighbors in each mesh direction
+      size_.clear();
+      IntVec<D> position, neighbor;
+      int nDomain = 0;
+      int rank, next, j, k, count;
+      for (i = 0; i < nx; ++i) {
+         if (domainId_[i] != -2) continue;
+         domainId_[i] = nDomain;
+         count = 0;
+         stack_.clear();
+         stack_.push_back(i);
+         while (!stack_.empty()) {
+            rank = stack_.back();
+            stack_.pop_back();
+            ++count;
+            position = mesh.position(rank);
+            for (j = 0; j < D; ++j) {
+               for (k = -1; k <= 1; k += 2) {
+                  neighbor = position;
+                  neighbor[j] += k;
+                  mesh.shift(neighbor);
+                  next = mesh.rank(neighbor);
+                  if (domainId_[next] == -2) {
+                     domainId_[next] = nDomain;
+                     stack_.push_back(next);
+                  }
+               }
+            }
+         }
+         size_.push_back(count);
+         ++nDomain;
+      }
+
+      // Sort domain sizes in decreasing order
+      std::sort(size_.begin(), size_.end(), std::greater<int>());
+
+      values_[0] = double(nInside)/double(nx);
+      values_[1] = double(nDomain);
+      for (i = 0; i < maxDomain_; ++i) {
+         if (i < nDomain) {
+            values_[2 + i] = double(size_[i])/double(nx);
+         } else {
+            values_[2 + i] = 0.0;
+         }
+      }
+   }
+
+   /*
+   * Get label for value i.
+   */
+   template <int D>
+   std::string DomainAnalyzer<D>::label(int i) const
+   {
+      UTIL_CHECK(i >= 0 && i < nValue());
+      if (i == 0) return std::string("domainFraction");
+      if (i == 1) return std::string("nDomain");
+      return std::string("domain") + toString(i - 1);
+   }
+
+}
+}
+#endif
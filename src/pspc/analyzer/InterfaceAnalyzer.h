@@ -0,0 +1,129 @@
+#ifndef PSPC_INTERFACE_ANALYZER_H
+#define PSPC_INTERFACE_ANALYZER_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Analyzer.h"                // base class
+#include <pspc/field/RField.h>       // member
+#include <pspc/field/RFieldDft.h>    // member
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template <int D>
+   class System;
+
+   using namespace Util;
+
+   /**
+   * Interfacial width and area from a level set of a composition field.
+   *
+   * This analyzer computes the local volume fraction psi(r) of one 
+   * monomer type and its gradient, using spectral differentiation. The 
+   * interface is defined as the level set psi = psi_mid, where psi_mid 
+   * is the midpoint between the minimum and maximum values of psi. The 
+   * level set is sampled by a band of grid points within a distance 
+   * h = bandWidth*(psi_max - psi_min) of psi_mid. 
+   *
+   * The interfacial area per unit volume is estimated as the spatial 
+   * average of |grad psi| within the band divided by 2h, which is a 
+   * discrete version of the integral of |grad psi| delta(psi - psi_mid). 
+   * The interfacial width is defined as (psi_max - psi_min)/G, where G
+   * is the average of |grad psi| over the interface. Both values are
+   * given in the units of length used for the unit cell.
+   *
+   * Parameters: monomerId* (int, 0 by default), bandWidth* (real, 0.1
+   * by default).
+   *
+   * \ingroup Pspc_Analyzer_Module
+   */
+   template <int D>
+   class InterfaceAnalyzer : public Analyzer<D>
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system parent System object
+      */
+      InterfaceAnalyzer(System<D>& system);
+
+      /**
+      * Destructor.
+      */
+      ~InterfaceAnalyzer();
+
+      /**
+      * Read parameters and allocate values.
+      *
+      * \param in input parameter stream
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Compute interfacial width and area per unit volume.
+      */
+      void compute();
+
+      /**
+      * Get label for value i.
+      *
+      * \param i  index of value
+      */
+      std::string label(int i) const;
+
+      using Analyzer<D>::nValue;
+      using Analyzer<D>::value;
+
+   protected:
+
+      using Analyzer<D>::values_;
+      using Analyzer<D>::allocateValues;
+      using Analyzer<D>::computeLocalFraction;
+      using Analyzer<D>::system;
+      using ParamComposite::readOptional;
+      using ParamComposite::setClassName;
+
+   private:
+
+      /// Local volume fraction of the chosen monomer type.
+      RField<D> psi_;
+
+      /// One Cartesian component of the gradient of psi.
+      RField<D> grad_;
+
+      /// Square of the gradient of psi.
+      RField<D> gradSq_;
+
+      /// Fourier transform of psi.
+      RFieldDft<D> psiK_;
+
+      /// Fourier transform of one component of the gradient.
+      RFieldDft<D> gradK_;
+
+      /// Half width of band of sampled psi values, relative to range.
+      double bandWidth_;
+
+      /// Index of monomer type used to define psi.
+      int monomerId_;
+
+   };
+
+   #ifndef PSPC_INTERFACE_ANALYZER_TPP
+   // Suppress implicit instantiation
+   extern template class InterfaceAnalyzer<1>;
+   extern template class InterfaceAnalyzer<2>;
+   extern template class InterfaceAnalyzer<3>;
+   #endif
+
+}
+}
+#endif
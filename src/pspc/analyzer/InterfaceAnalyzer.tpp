@@ -0,0 +1,171 @@
+#ifndef PSPC_INTERFACE_ANALYZER_TPP
+#define PSPC_INTERFACE_ANALYZER_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "InterfaceAnalyzer.h"
+#include <pspc/System.h>
+#include <pscf/mesh/MeshIterator.h>
+#include <pscf/crystal/shiftToMinimum.h>
+
+#include <cmath>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   template <int D>
+   InterfaceAnalyzer<D>::InterfaceAnalyzer(System<D>& system)
+    : Analyzer<D>(system),
+      bandWidth_(0.1),
+      monomerId_(0)
+   {  setClassName("InterfaceAnalyzer"); }
+
+   /*
+   * Destructor.
+   */
+   template <int D>
+   InterfaceAnalyzer<D>::~InterfaceAnalyzer()
+   {}
+
+   /*
+   * Read parameters and allocate values.
+   */
+   template <int D>
+   void InterfaceAnalyzer<D>::readParameters(std::istream& in)
+   {
+      readOptional(in, "monomerId", monomerId_);
+      readOptional(in, "bandWidth", bandWidth_);
+      UTIL_CHECK(monomerId_ >= 0);
+      UTIL_CHECK(monomerId_ < system().mixture().nMonomer());
+      UTIL_CHECK(bandWidth_ > 0.0 && bandWidth_ < 0.5);
+      allocateValues(2);
+   }
+
+   /*
+   * Compute interfacial width and area per unit volume.
+   */
+   template <int D>
+   void InterfaceAnalyzer<D>::compute()
+   {
+      UTIL_CHECK(system().hasCFields());
+      Mesh<D> const & mesh = system().mesh();
+      UnitCell<D> const & unitCell = system().unitCell();
+      FFT<D> const & fft = system().fft();
+      IntVec<D> const & meshDimensions = mesh.dimensions();
+      const int nx = mesh.size();
+
+      // Allocate work arrays, or reallocate after a change of mesh
+      if (psi_.isAllocated() && psi_.meshDimensions() != meshDimensions) {
+         psi_.deallocate();
+         grad_.deallocate();
+         gradSq_.deallocate();
+         psiK_.deallocate();
+         gradK_.deallocate();
+      }
+      if (!psi_.isAllocated()) {
+         psi_.allocate(meshDimensions);
+         grad_.allocate(meshDimensions);
+         gradSq_.allocate(meshDimensions);
+         psiK_.allocate(meshDimensions);
+         gradK_.allocate(meshDimensions);
+      }
+
+      // Local volume fraction and its range
+      computeLocalFraction(monomerId_, psi_);
+      double psiMin = psi_[0];
+      double psiMax = psi_[0];
+      int i, j;
+      for (i = 1; i < nx; ++i) {
+         if (psi_[i] < psiMin) psiMin = psi_[i];
+         if (psi_[i] > psiMax) psiMax = psi_[i];
+      }
+      double range = psiMax - psiMin;
+      values_[0] = 0.0;
+      values_[1] = 0.0;
+      if (range < 1.0E-8) return;
+
+      // Compute |grad psi|^2 by spectral differentiation
+      for (i = 0; i < nx; ++i) {
+         gradSq_[i] = 0.0;
+      }
+      fft.forwardTransform(psi_, psiK_);
+      IntVec<D> kMeshDimensions = psiK_.dftDimensions();
+      MeshIterator<D> iter;
+      iter.setDimensions(kMeshDimensions);
+      IntVec<D> G, Gmin;
+      double k;
+      bool isNyquist;
+      int alpha;
+      for (alpha = 0; alpha < D; ++alpha) {
+         for (iter.begin(); !iter.atEnd(); ++iter) {
+            i = iter.rank();
+            G = iter.position();
+            Gmin = shiftToMinimum(G, meshDimensions, unitCell);
+
+            // Derivative of Nyquist component is set to zero
+            isNyquist = false;
+            for (j = 0; j < D; ++j) {
+               if (2*G[j] == meshDimensions[j]) isNyquist = true;
+            }
+            k = 0.0;
+            if (!isNyquist) {
+               for (j = 0; j < D; ++j) {
+                  k += Gmin[j]*unitCell.kBasis(j)[alpha];
+               }
+            }
+
+            // Multiply by i*k
+            gradK_[i][0] = -k*psiK_[i][1];
+            gradK_[i][1] =  k*psiK_[i][0];
+         }
+         fft.inverseTransformSafe(gradK_, grad_);
+         for (i = 0; i < nx; ++i) {
+            gradSq_[i] += grad_[i]*grad_[i];
+         }
+      }
+
+      // Sample band of grid points near level set psi = psiMid
+      double psiMid = 0.5*(psiMin + psiMax);
+      double h = bandWidth_*range;
+      double sum1 = 0.0;
+      double sum2 = 0.0;
+      for (i = 0; i < nx; ++i) {
+         if (std::abs(psi_[i] - psiMid) < h) {
+            sum1 += sqrt(gradSq_[i]);
+            sum2 += gradSq_[i];
+         }
+      }
+      if (sum1 > 0.0) {
+         values_[0] = range*sum1/sum2;
+         values_[1] = sum1/(2.0*h*double(nx));
+      }
+   }
+
+   /*
+   * Get label for value i.
+   */
+   template <int D>
+   std::string InterfaceAnalyzer<D>::label(int i) const
+   {
+      UTIL_CHECK(i >= 0 && i < nValue());
+      if (i == 0) {
+         return std::string("interfaceWidth");
+      } else {
+         return std::string("interfaceArea");
+      }
+   }
+
+}
+}
+#endif
@@ -0,0 +1,112 @@
+#ifndef PSPC_STRUCTURE_FACTOR_H
+#define PSPC_STRUCTURE_FACTOR_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Analyzer.h"              // base class
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template <int D>
+   class System;
+
+   using namespace Util;
+
+   /**
+   * Mean-field scattering intensities at the lowest nonzero stars.
+   *
+   * For each of the first nStar basis functions (stars) with nonzero
+   * wavevectors, this analyzer reports the wavenumber q = |G| and the
+   * intensity S, given by the square of the coefficient of the
+   * concentration field of one monomer type for that basis function.
+   * Because basis functions are normalized such that the spatial 
+   * average of the square of each is unity, S is the sum of |c(G)|^2 
+   * over all wavevectors G in the star, i.e., the integrated intensity
+   * of the corresponding powder diffraction peak. The analyzer also
+   * reports a characteristic domain spacing d = 2 pi/q_1 obtained from 
+   * the first nonzero star.
+   *
+   * The concentration basis coefficients are computed from the r-grid
+   * concentration fields by FFT in System<D>::compute, so no further
+   * transforms are required.
+   *
+   * Parameters: monomerId* (int, 0 by default), nStar* (int, 4 by 
+   * default).
+   *
+   * \ingroup Pspc_Analyzer_Module
+   */
+   template <int D>
+   class StructureFactor : public Analyzer<D>
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system parent System object
+      */
+      StructureFactor(System<D>& system);
+
+      /**
+      * Destructor.
+      */
+      ~StructureFactor();
+
+      /**
+      * Read parameters and allocate values.
+      *
+      * \param in input parameter stream
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Compute domain spacing, wavenumbers and intensities.
+      */
+      void compute();
+
+      /**
+      * Get label for value i.
+      *
+      * \param i  index of value
+      */
+      std::string label(int i) const;
+
+      using Analyzer<D>::nValue;
+      using Analyzer<D>::value;
+
+   protected:
+
+      using Analyzer<D>::values_;
+      using Analyzer<D>::allocateValues;
+      using Analyzer<D>::system;
+      using ParamComposite::readOptional;
+      using ParamComposite::setClassName;
+
+   private:
+
+      /// Index of monomer type for which intensities are computed.
+      int monomerId_;
+
+      /// Number of nonzero stars for which values are reported.
+      int nStar_;
+
+   };
+
+   #ifndef PSPC_STRUCTURE_FACTOR_TPP
+   // Suppress implicit instantiation
+   extern template class StructureFactor<1>;
+   extern template class StructureFactor<2>;
+   extern template class StructureFactor<3>;
+   #endif
+
+}
+}
+#endif
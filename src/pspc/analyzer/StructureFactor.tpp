@@ -0,0 +1,111 @@
+#ifndef PSPC_STRUCTURE_FACTOR_TPP
+#define PSPC_STRUCTURE_FACTOR_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "StructureFactor.h"
+#include <pspc/System.h>
+#include <util/math/Constants.h>
+#include <util/misc/ioUtil.h>
+
+#include <cmath>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   template <int D>
+   StructureFactor<D>::StructureFactor(System<D>& system)
+    : Analyzer<D>(system),
+      monomerId_(0),
+      nStar_(4)
+   {  setClassName("StructureFactor"); }
+
+   /*
+   * Destructor.
+   */
+   template <int D>
+   StructureFactor<D>::~StructureFactor()
+   {}
+
+   /*
+   * Read parameters and allocate values.
+   */
+   template <int D>
+   void StructureFactor<D>::readParameters(std::istream& in)
+   {
+      readOptional(in, "monomerId", monomerId_);
+      readOptional(in, "nStar", nStar_);
+      UTIL_CHECK(monomerId_ >= 0);
+      UTIL_CHECK(monomerId_ < system().mixture().nMonomer());
+      UTIL_CHECK(nStar_ > 0);
+      allocateValues(1 + 2*nStar_);
+   }
+
+   /*
+   * Compute domain spacing, wavenumbers and intensities.
+   */
+   template <int D>
+   void StructureFactor<D>::compute()
+   {
+      UTIL_CHECK(system().hasCFields());
+      UTIL_CHECK(system().w().isSymmetric());
+      Basis<D> const & basis = system().basis();
+      UnitCell<D> const & unitCell = system().unitCell();
+      DArray<double> const & c = system().c().basis(monomerId_);
+      const int nBasis = basis.nBasis();
+
+      // Basis functions are listed in order of increasing |G|, and
+      // basis function 0 is the homogeneous (G=0) function.
+      double q, coeff;
+      int j, k;
+      for (k = 0; k < nStar_; ++k) {
+         j = k + 1;
+         if (j < nBasis) {
+            q = sqrt(unitCell.ksq(basis.basisFunction(j).waveBz));
+            coeff = c[j];
+            values_[1 + 2*k] = q;
+            values_[2 + 2*k] = coeff*coeff;
+         } else {
+            values_[1 + 2*k] = 0.0;
+            values_[2 + 2*k] = 0.0;
+         }
+      }
+
+      // Domain spacing from the first nonzero star
+      if (nBasis > 1 && values_[1] > 0.0) {
+         values_[0] = 2.0*Constants::Pi/values_[1];
+      } else {
+         values_[0] = 0.0;
+      }
+   }
+
+   /*
+   * Get label for value i.
+   */
+   template <int D>
+   std::string StructureFactor<D>::label(int i) const
+   {
+      UTIL_CHECK(i >= 0 && i < nValue());
+      if (i == 0) return std::string("d_spacing");
+      int k = (i - 1)/2 + 1;
+      if ((i - 1) % 2 == 0) {
+         return std::string("q") + toString(k);
+      } else {
+         return std::string("S") + toString(k);
+      }
+   }
+
+}
+}
+#endif
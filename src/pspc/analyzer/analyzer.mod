@@ -0,0 +1,14 @@
+
+namespace Pscf{
+namespace Pspc{
+
+   /**
+   * \defgroup Pspc_Analyzer_Module Analyzers
+   *
+   * In-situ analysis of converged SCFT solutions.
+   *
+   * \ingroup Pscf_Pspc_Module
+   */
+
+}
+}
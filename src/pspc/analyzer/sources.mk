@@ -0,0 +1,13 @@
+pspc_analyzer_= \
+  pspc/analyzer/Analyzer.cpp \
+  pspc/analyzer/StructureFactor.cpp \
+  pspc/analyzer/InterfaceAnalyzer.cpp \
+  pspc/analyzer/DomainAnalyzer.cpp \
+  pspc/analyzer/AnalyzerFactory.cpp \
+  pspc/analyzer/AnalyzerManager.cpp 
+
+pspc_analyzer_SRCS=\
+     $(addprefix $(SRC_DIR)/, $(pspc_analyzer_))
+pspc_analyzer_OBJS=\
+     $(addprefix $(BLD_DIR)/, $(pspc_analyzer_:.cpp=.o))
+
@@ -40,6 +40,15 @@ namespace Pspc
    *    - a lattice system enum value
    *    - a groupName string
    *
+   * The Basis is constructed lazily: Neither reading the parameter
+   * file, reading an r-grid field header nor setting the unit cell
+   * constructs it. It is constructed only by an explicit call to 
+   * makeBasis (or by FieldIo when reading fields in basis format). 
+   * The basis() accessors never construct it. Calculations that use 
+   * only r-grid or k-grid fields thus never pay the cost of 
+   * constructing a basis, which can be large for big meshes and high
+   * symmetry groups.
+   *
    * \ingroup Pspc_Field_Module
    */
    template <int D>
@@ -88,7 +97,7 @@ namespace Pspc
       /**
       * Set unit cell. 
       *
-      * Initializes basis if not done previously.
+      * Does not construct the basis.
       *
       * \param unitCell new unit cell
       */
@@ -97,7 +106,7 @@ namespace Pspc
       /**
       * Set unit cell state.
       *
-      * Initializes basis if not done previously.
+      * Does not construct the basis.
       *
       * \param lattice  lattice system
       * \param parameters array of unit cell parameters
@@ -108,7 +117,7 @@ namespace Pspc
       /**
       * Set unit cell parameters.
       *
-      * Initializes basis if not done previously.
+      * Does not construct the basis.
       * Lattice system must already be set to non-null value on entry.
       *
       * \param parameters array of unit cell parameters
@@ -117,9 +126,22 @@ namespace Pspc
 
       /**
       * Construct basis if not done already.
+      *
+      * The unit cell must be initialized on entry.
       */
       void makeBasis();
 
+      /**
+      * Change the spatial mesh dimensions.
+      *
+      * Resets the FFT for the new mesh and destroys any existing basis,
+      * which must be reconstructed by calling makeBasis. The caller is 
+      * responsible for re-allocating any fields defined on the mesh.
+      *
+      * \param dimensions  new mesh dimensions
+      */
+      void setMesh(IntVec<D> const & dimensions);
+
       ///@}
       /// \name Accessors 
       ///@{
@@ -151,14 +173,25 @@ namespace Pspc
 
       /**
       * Get associated Basis object by reference.
+      *
+      * Does not construct the basis, and thus may return an 
+      * uninitialized Basis with nBasis() == 0. See makeBasis().
       */
       Basis<D>& basis();
 
       /**
       * Get associated Basis object by const reference.
+      *
+      * Does not construct the basis, and thus may return an 
+      * uninitialized Basis. See hasBasis().
       */
       Basis<D> const & basis() const ;
 
+      /**
+      * Has the basis been constructed?
+      */
+      bool hasBasis() const;
+
       /**
       * Get associated FFT object.
       */
@@ -288,6 +321,11 @@ namespace Pspc
    inline Basis<D> const & Domain<D>::basis() const
    {  return basis_; }
 
+   // Has the basis been constructed?
+   template <int D>
+   inline bool Domain<D>::hasBasis() const
+   {  return basis_.isInitialized(); }
+
    // Get the FFT<D> object.
    template <int D>
    inline FFT<D>& Domain<D>::fft()
@@ -82,9 +82,9 @@ namespace Pspc
       read(in, "groupName", groupName_);
       readGroup(groupName_, group_);
 
-      // Initialize unit cell if unit cell parameters are known
+      // Construct basis if unit cell parameters are known
       if (hasUnitCell) { 
-         basis().makeBasis(mesh(), unitCell(), group_);
+         makeBasis();
       }
       isInitialized_ = true;
    }
@@ -122,10 +122,9 @@ namespace Pspc
       mesh_.setDimensions(nGrid);
       fft_.setup(mesh_.dimensions());
 
-      // Initialize group and basis
+      // Initialize group (the basis is constructed by makeBasis)
       readGroup(groupName_, group_);
-      basis_.makeBasis(mesh_, unitCell_, group_);
-      
+
       isInitialized_ = true;
    }
 
@@ -138,9 +137,6 @@ namespace Pspc
          UTIL_CHECK(lattice_ == unitCell.lattice());
       }
       unitCell_ = unitCell;
-      if (!basis_.isInitialized()) {
-         makeBasis();
-      }
    }
 
    /*
@@ -156,9 +152,6 @@ namespace Pspc
          UTIL_CHECK(lattice_ == lattice);
       }
       unitCell_.set(lattice, parameters);
-      if (!basis_.isInitialized()) {
-         makeBasis();
-      }
    }
 
    /*
@@ -170,9 +163,6 @@ namespace Pspc
       UTIL_CHECK(unitCell_.lattice() != UnitCell<D>::Null);
       UTIL_CHECK(unitCell_.nParameter() == parameters.size());
       unitCell_.setParameters(parameters);
-      if (!basis_.isInitialized()) {
-         makeBasis();
-      }
    }
 
    template <int D>
@@ -180,6 +170,7 @@ namespace Pspc
    {
       UTIL_CHECK(mesh_.size() > 0);
       UTIL_CHECK(unitCell_.lattice() != UnitCell<D>::Null);
+      UTIL_CHECK(unitCell_.isInitialized());
 
       // Check group, read from file if necessary
       if (group_.size() == 1) {
@@ -190,10 +181,25 @@ namespace Pspc
       }
 
       // Check basis, construct if not initialized
-      if (!basis().isInitialized()) {
+      if (!basis_.isInitialized()) {
          basis_.makeBasis(mesh_, unitCell_, group_);
       }
-      UTIL_CHECK(basis().isInitialized());
+      UTIL_CHECK(basis_.isInitialized());
+   }
+
+   /*
+   * Change mesh dimensions, reset FFT and basis.
+   */
+   template <int D>
+   void Domain<D>::setMesh(IntVec<D> const & dimensions)
+   {
+      UTIL_CHECK(isInitialized_);
+      group_.checkMeshDimensions(dimensions);
+
+      mesh_.setDimensions(dimensions);
+      fft_.clear();
+      fft_.setup(mesh_.dimensions());
+      basis_.clear();
    }
 
 } // namespace Pspc
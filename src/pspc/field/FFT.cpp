@@ -18,12 +18,21 @@ namespace Pspc {
    template class FFT<2>;
    template class FFT<3>;
 
+   /*
+   * Get the FFTW planner mutex (constructed on first use).
+   */
+   std::mutex& fftwPlannerMutex()
+   {
+      static std::mutex mutex;
+      return mutex;
+   }
 
    // Planning functions, explicit specializations.
 
    template<>
    void FFT<1>::makePlans(RField<1>& rField, RFieldDft<1>& kField)
    {
+      std::lock_guard<std::mutex> lock(fftwPlannerMutex());
       unsigned int flags = FFTW_ESTIMATE;
       fPlan_ = fftw_plan_dft_r2c_1d(rSize_, &rField[0], &kField[0], flags);
       iPlan_ = fftw_plan_dft_c2r_1d(rSize_, &kField[0], &rField[0], flags);
@@ -32,6 +41,7 @@ namespace Pspc {
    template <>
    void FFT<2>::makePlans(RField<2>& rField, RFieldDft<2>& kField)
    {
+      std::lock_guard<std::mutex> lock(fftwPlannerMutex());
       unsigned int flags = FFTW_ESTIMATE;
       fPlan_ = fftw_plan_dft_r2c_2d(meshDimensions_[0], meshDimensions_[1],
       	                           &rField[0], &kField[0], flags);
@@ -42,6 +52,7 @@ namespace Pspc {
    template <>
    void FFT<3>::makePlans(RField<3>& rField, RFieldDft<3>& kField)
    {
+      std::lock_guard<std::mutex> lock(fftwPlannerMutex());
       unsigned int flags = FFTW_ESTIMATE;
       fPlan_ = fftw_plan_dft_r2c_3d(meshDimensions_[0], meshDimensions_[1],
       	                           meshDimensions_[2], &rField[0], &kField[0],
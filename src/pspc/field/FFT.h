@@ -14,6 +14,7 @@
 #include <util/global.h>
 
 #include <fftw3.h>
+#include <mutex>
 
 namespace Pscf {
 namespace Pspc {
@@ -21,6 +22,19 @@ namespace Pspc {
    using namespace Util;
    using namespace Pscf;
 
+   /**
+   * Get the mutex that serializes use of the FFTW planner.
+   *
+   * FFTW plan creation and destruction are not thread safe, though
+   * execution of existing plans is. Every FFT object holds this lock
+   * while creating or destroying its plans, so that FFT objects (and
+   * the systems that own them) can be set up in concurrent threads.
+   * Code that calls the FFTW planner directly should do the same.
+   *
+   * \ingroup Pspc_Field_Module
+   */
+   std::mutex& fftwPlannerMutex();
+
    /**
    * Fourier transform wrapper for real data.
    *
@@ -57,6 +71,14 @@ namespace Pspc {
       */
       void setup(RField<D>& rField, RFieldDft<D>& kField);
 
+      /**
+      * Destroy plans and return to the un-setup state.
+      *
+      * After this call, setup() may be called again with different
+      * mesh dimensions. Used when the spatial mesh is changed.
+      */
+      void clear();
+
       /**
       * Compute forward (real-to-complex) Fourier transform.
       *
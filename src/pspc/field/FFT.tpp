@@ -36,6 +36,7 @@ namespace Pspc
    template <int D>
    FFT<D>::~FFT()
    {
+      std::lock_guard<std::mutex> lock(fftwPlannerMutex());
       if (fPlan_) {
          fftw_destroy_plan(fPlan_);
       }
@@ -105,7 +106,7 @@ namespace Pspc
       if (!kFieldCopy_.isAllocated()) {
           kFieldCopy_.allocate(kDimensions);
       } else {
-          if (kFieldCopy_.capacity() != rSize_) {
+          if (kFieldCopy_.capacity() != kSize_) {
              kFieldCopy_.deallocate();
              kFieldCopy_.allocate(kDimensions);
           }
@@ -118,6 +119,24 @@ namespace Pspc
       isSetup_ = true;
    }
 
+   /*
+   * Destroy plans, allowing setup with new mesh dimensions.
+   */
+   template <int D>
+   void FFT<D>::clear()
+   {
+      std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+      if (fPlan_) {
+         fftw_destroy_plan(fPlan_);
+         fPlan_ = 0;
+      }
+      if (iPlan_) {
+         fftw_destroy_plan(iPlan_);
+         iPlan_ = 0;
+      }
+      isSetup_ = false;
+   }
+
    /*
    * Execute forward transform.
    */
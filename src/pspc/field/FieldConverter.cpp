@@ -0,0 +1,19 @@
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "FieldConverter.tpp"
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template class FieldConverter<1>;
+   template class FieldConverter<2>;
+   template class FieldConverter<3>;
+
+} // namespace Pspc
+} // namespace Pscf
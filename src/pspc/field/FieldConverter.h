@@ -0,0 +1,183 @@
+#ifndef PSPC_FIELD_CONVERTER_H
+#define PSPC_FIELD_CONVERTER_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <pspc/field/FFT.h>                // member template
+#include <pspc/field/FieldIo.h>            // member template
+#include <pspc/field/RField.h>             // member template argument
+#include <pspc/field/RFieldDft.h>          // member template argument
+#include <pscf/mesh/Mesh.h>                // function parameter
+#include <util/containers/DArray.h>        // member template
+#include <util/containers/GArray.h>        // function parameter
+
+#include <sstream>
+#include <string>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   using namespace Util;
+   using namespace Pscf;
+
+   /**
+   * Bulk conversion of field files among basis, r-grid and k-grid formats.
+   *
+   * A FieldConverter converts a list of field files using one shared
+   * Basis, Mesh and SpaceGroup (those of an associated FieldIo), so that
+   * the cost of constructing the basis is paid once for all files. Each
+   * thread uses a private FFT object, FieldIo object and set of field
+   * work arrays. FFT plans are created serially in setup(), since FFTW
+   * plan creation is not thread safe, while execution of separate plans
+   * is.
+   *
+   * If the code is compiled with OpenMP enabled (i.e., if the macro
+   * _OPENMP is defined), files are converted concurrently, with one file
+   * per thread at a time, using the number of threads given by
+   * omp_get_max_threads() (e.g., by the OMP_NUM_THREADS environment
+   * variable). Otherwise, files are converted serially.
+   *
+   * Threads never write to a shared stream: Messages written by the 
+   * FieldIo of each thread (e.g., warnings about inconsistent stars in
+   * an input file) are collected in a private buffer for that thread, 
+   * and are copied to the log stream of the FieldIo passed to setup 
+   * (see FieldIo::logFile) after all files have been converted, in 
+   * input order.
+   *
+   * \ingroup Pspc_Field_Module
+   */
+   template <int D>
+   class FieldConverter
+   {
+
+   public:
+
+      /**
+      * Type of format conversion.
+      */
+      enum Conversion {BasisToRGrid, RGridToBasis, KGridToRGrid,
+                       RGridToKGrid, BasisToKGrid, KGridToBasis};
+
+      /**
+      * Constructor.
+      */
+      FieldConverter();
+
+      /**
+      * Destructor.
+      */
+      ~FieldConverter();
+
+      /**
+      * Create thread work spaces.
+      *
+      * The basis associated with fieldIo must be initialized before this
+      * function is called, and the lattice system and space group of
+      * fieldIo must already be set.
+      *
+      * \param fieldIo  FieldIo object used as a template for each thread
+      * \param mesh  spatial discretization mesh
+      * \param nMonomer  number of monomer types (fields per file)
+      * \param nBasis  number of basis functions
+      */
+      void setup(FieldIo<D> const & fieldIo, Mesh<D> const & mesh,
+                 int nMonomer, int nBasis);
+
+      /**
+      * Convert a list of files.
+      *
+      * Element i of outFileNames is the name of the file created by
+      * converting input file inFileNames[i]. Failure to convert one file
+      * does not prevent conversion of the others. A summary of failures
+      * and of k-grid or r-grid inputs without the declared space group
+      * symmetry, preceded by any messages from reading each file, is 
+      * written to the log stream of the FieldIo passed to setup on 
+      * return.
+      *
+      * \param conversion  type of conversion
+      * \param inFileNames  names of input files
+      * \param outFileNames  names of output files
+      * \return number of files that could not be converted
+      */
+      int convert(Conversion conversion,
+                  GArray<std::string> const & inFileNames,
+                  GArray<std::string> const & outFileNames);
+
+      /**
+      * Number of threads (and work spaces).
+      */
+      int nThread() const
+      {  return nThread_; }
+
+      /**
+      * Get the conversion type from a command name.
+      *
+      * Accepts the names of the single-file conversion commands, e.g.,
+      * BASIS_TO_RGRID or KGRID_TO_BASIS. Throws an Exception for any
+      * other string.
+      *
+      * \param name  command name
+      */
+      static Conversion conversion(std::string const & name);
+
+   private:
+
+      /// One FFT per thread.
+      DArray< FFT<D> > fft_;
+
+      /// One FieldIo per thread, associated with the FFT for that thread.
+      DArray< FieldIo<D> > fieldIo_;
+
+      /// Work arrays for fields in basis format, indexed by thread.
+      DArray< DArray< DArray<double> > > basis_;
+
+      /// Work arrays for fields in r-grid format, indexed by thread.
+      DArray< DArray< RField<D> > > rGrid_;
+
+      /// Work arrays for fields in k-grid format, indexed by thread.
+      DArray< DArray< RFieldDft<D> > > kGrid_;
+
+      /// Message buffers, indexed by thread (log streams of fieldIo_).
+      DArray<std::ostringstream> messages_;
+
+      /// Pointer to log stream of the FieldIo passed to setup.
+      std::ostream* logFilePtr_;
+
+      /// Number of threads.
+      int nThread_;
+
+      /// Number of monomer types.
+      int nMonomer_;
+
+      /**
+      * Convert one file, using the work space of thread t.
+      *
+      * \param conversion  type of conversion
+      * \param inFileName  input file name
+      * \param outFileName  output file name
+      * \param t  thread index
+      * \return false if input fields lack the declared symmetry
+      */
+      bool convertFile(Conversion conversion,
+                       std::string const & inFileName,
+                       std::string const & outFileName,
+                       int t);
+
+   };
+
+   #ifndef PSPC_FIELD_CONVERTER_TPP
+   // Suppress implicit instantiation
+   extern template class FieldConverter<1>;
+   extern template class FieldConverter<2>;
+   extern template class FieldConverter<3>;
+   #endif
+
+} // namespace Pspc
+} // namespace Pscf
+#endif
@@ -0,0 +1,251 @@
+#ifndef PSPC_FIELD_CONVERTER_TPP
+#define PSPC_FIELD_CONVERTER_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "FieldConverter.h"
+#include <pscf/crystal/UnitCell.h>
+#include <util/global.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Pscf {
+namespace Pspc
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   template <int D>
+   FieldConverter<D>::FieldConverter()
+    : logFilePtr_(0),
+      nThread_(0),
+      nMonomer_(0)
+   {}
+
+   /*
+   * Destructor.
+   */
+   template <int D>
+   FieldConverter<D>::~FieldConverter()
+   {}
+
+   /*
+   * Create one work space per thread.
+   */
+   template <int D>
+   void FieldConverter<D>::setup(FieldIo<D> const & fieldIo,
+                                 Mesh<D> const & mesh,
+                                 int nMonomer, int nBasis)
+   {
+      UTIL_CHECK(nThread_ == 0);
+      UTIL_CHECK(nMonomer > 0);
+      UTIL_CHECK(nBasis > 0);
+
+      #ifdef _OPENMP
+      nThread_ = omp_get_max_threads();
+      #else
+      nThread_ = 1;
+      #endif
+      UTIL_CHECK(nThread_ > 0);
+      nMonomer_ = nMonomer;
+      logFilePtr_ = &fieldIo.logFile();
+
+      fft_.allocate(nThread_);
+      fieldIo_.allocate(nThread_);
+      basis_.allocate(nThread_);
+      rGrid_.allocate(nThread_);
+      kGrid_.allocate(nThread_);
+      messages_.allocate(nThread_);
+
+      // FFTW plans are created serially
+      int t, i;
+      for (t = 0; t < nThread_; ++t) {
+         fft_[t].setup(mesh.dimensions());
+         fieldIo_[t].associate(fieldIo, fft_[t]);
+         fieldIo_[t].setLogFile(messages_[t]);
+         basis_[t].allocate(nMonomer);
+         rGrid_[t].allocate(nMonomer);
+         kGrid_[t].allocate(nMonomer);
+         for (i = 0; i < nMonomer; ++i) {
+            basis_[t][i].allocate(nBasis);
+            rGrid_[t][i].allocate(mesh.dimensions());
+            kGrid_[t][i].allocate(mesh.dimensions());
+         }
+      }
+   }
+
+   /*
+   * Convert a list of files, concurrently if OpenMP is enabled.
+   */
+   template <int D>
+   int FieldConverter<D>::convert(Conversion conversion,
+                                  GArray<std::string> const & inFileNames,
+                                  GArray<std::string> const & outFileNames)
+   {
+      UTIL_CHECK(nThread_ > 0);
+      UTIL_CHECK(inFileNames.size() == outFileNames.size());
+      const int n = inFileNames.size();
+
+      // Status of each file: 0 = ok, 1 = not symmetric, 2 = failed
+      // Messages written while converting each file
+      DArray<int> status;
+      DArray<std::string> messages;
+      if (n > 0) {
+         status.allocate(n);
+         messages.allocate(n);
+      }
+
+      int j;
+      #ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic)
+      #endif
+      for (j = 0; j < n; ++j) {
+         int t = 0;
+         #ifdef _OPENMP
+         t = omp_get_thread_num();
+         #endif
+         messages_[t].str("");
+         try {
+            bool isSymmetric;
+            isSymmetric = convertFile(conversion, inFileNames[j],
+                                      outFileNames[j], t);
+            status[j] = isSymmetric ? 0 : 1;
+         } catch (...) {
+            status[j] = 2;
+         }
+         messages[j] = messages_[t].str();
+      }
+
+      // Report messages and problems serially, in input order
+      std::ostream& out = *logFilePtr_;
+      int nFail = 0;
+      for (j = 0; j < n; ++j) {
+         out << messages[j];
+         if (status[j] == 1) {
+            out << "WARNING: input fields in file "
+                << inFileNames[j]
+                << " do not have the declared space group symmetry"
+                << std::endl;
+         } else
+         if (status[j] == 2) {
+            out << "ERROR: failed to convert file "
+                << inFileNames[j] << std::endl;
+            ++nFail;
+         }
+      }
+      out << "Converted " << n - nFail << " of " << n
+          << " files using " << nThread_ << " thread(s)"
+          << std::endl;
+
+      return nFail;
+   }
+
+   /*
+   * Convert one file using the work space of thread t.
+   */
+   template <int D>
+   bool FieldConverter<D>::convertFile(Conversion conversion,
+                                       std::string const & inFileName,
+                                       std::string const & outFileName,
+                                       int t)
+   {
+      FieldIo<D> const & fieldIo = fieldIo_[t];
+      DArray< DArray<double> >& basis = basis_[t];
+      DArray< RField<D> >& rGrid = rGrid_[t];
+      DArray< RFieldDft<D> >& kGrid = kGrid_[t];
+      UnitCell<D> unitCell;
+      bool isSymmetric = true;
+      int i;
+
+      switch (conversion) {
+      case BasisToRGrid:
+         fieldIo.readFieldsBasis(inFileName, basis, unitCell);
+         fieldIo.convertBasisToRGrid(basis, rGrid);
+         fieldIo.writeFieldsRGrid(outFileName, rGrid, unitCell);
+         break;
+      case RGridToBasis:
+         fieldIo.readFieldsRGrid(inFileName, rGrid, unitCell);
+         fieldIo.convertRGridToKGrid(rGrid, kGrid);
+         for (i = 0; i < nMonomer_; ++i) {
+            if (!fieldIo.hasSymmetry(kGrid[i], 1.0E-8, false)) {
+               isSymmetric = false;
+            }
+            fieldIo.convertKGridToBasis(kGrid[i], basis[i], false);
+         }
+         fieldIo.writeFieldsBasis(outFileName, basis, unitCell);
+         break;
+      case KGridToRGrid:
+         fieldIo.readFieldsKGrid(inFileName, kGrid, unitCell);
+         fieldIo.convertKGridToRGrid(kGrid, rGrid);
+         fieldIo.writeFieldsRGrid(outFileName, rGrid, unitCell);
+         break;
+      case RGridToKGrid:
+         fieldIo.readFieldsRGrid(inFileName, rGrid, unitCell);
+         fieldIo.convertRGridToKGrid(rGrid, kGrid);
+         fieldIo.writeFieldsKGrid(outFileName, kGrid, unitCell);
+         break;
+      case BasisToKGrid:
+         fieldIo.readFieldsBasis(inFileName, basis, unitCell);
+         fieldIo.convertBasisToKGrid(basis, kGrid);
+         fieldIo.writeFieldsKGrid(outFileName, kGrid, unitCell);
+         break;
+      case KGridToBasis:
+         fieldIo.readFieldsKGrid(inFileName, kGrid, unitCell);
+         for (i = 0; i < nMonomer_; ++i) {
+            if (!fieldIo.hasSymmetry(kGrid[i], 1.0E-8, false)) {
+               isSymmetric = false;
+            }
+            fieldIo.convertKGridToBasis(kGrid[i], basis[i], false);
+         }
+         fieldIo.writeFieldsBasis(outFileName, basis, unitCell);
+         break;
+      }
+
+      return isSymmetric;
+   }
+
+   /*
+   * Get the conversion type from a command name.
+   */
+   template <int D>
+   typename FieldConverter<D>::Conversion
+   FieldConverter<D>::conversion(std::string const & name)
+   {
+      if (name == "BASIS_TO_RGRID") {
+         return BasisToRGrid;
+      } else
+      if (name == "RGRID_TO_BASIS") {
+         return RGridToBasis;
+      } else
+      if (name == "KGRID_TO_RGRID") {
+         return KGridToRGrid;
+      } else
+      if (name == "RGRID_TO_KGRID") {
+         return RGridToKGrid;
+      } else
+      if (name == "BASIS_TO_KGRID") {
+         return BasisToKGrid;
+      } else
+      if (name == "KGRID_TO_BASIS") {
+         return KGridToBasis;
+      } else {
+         std::string msg = "Unknown field conversion: ";
+         msg += name;
+         UTIL_THROW(msg.c_str());
+      }
+      return BasisToRGrid; // Never reached
+   }
+
+}
+}
+#endif
@@ -0,0 +1,574 @@
+#ifndef PSPC_FIELD_EXPR_H
+#define PSPC_FIELD_EXPR_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Field.h"                        // operand type
+#include <util/containers/DArray.h>       // operand type
+#include <util/global.h>
+
+#include <type_traits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Pscf {
+namespace Pspc {
+
+   using namespace Util;
+
+   /**
+   * \defgroup Pspc_FieldExpr_Module Field Expressions
+   *
+   * Expression templates for element-wise arithmetic on real fields.
+   *
+   * Arithmetic operators applied to Field<double> objects (including
+   * RField<D>), DArray<double> objects and real scalars do not compute
+   * anything, but instead return lightweight expression objects that
+   * record the operation. The functions assign, addTo and sum then
+   * evaluate a complete expression in a single loop over elements,
+   * with no temporary arrays. For example,
+   * \code
+   *    assign(c, a*b + 2.0*d - e);
+   *    addTo(c, lambda*r);
+   *    double f = sum(w*c);
+   * \endcode
+   * each make one pass through memory. If the code is compiled with
+   * OpenMP, loops over more than FieldExprMinThreaded elements are
+   * divided among threads.
+   *
+   * Only operations within a single expression are fused. A loop that
+   * calls addTo or sum once per term still makes one pass through
+   * memory per call. For example, the Legendre transform and external
+   * field terms in System::computeFreeEnergy each call sum once per
+   * monomer type, and AmIterator::addHistories calls addTo once per
+   * basis vector, so only the pairwise product within each call is
+   * fused.
+   *
+   * Expression objects contain pointers to the data of the operand
+   * arrays, and so should not outlive the full expression in which
+   * they are created. All arrays in one expression must have the same
+   * number of elements. The destination of assign or addTo may also
+   * appear in the expression, since each element of the destination
+   * depends only on the corresponding elements of the operands.
+   *
+   * \ingroup Pspc_Field_Module
+   */
+
+   /**
+   * Minimum number of elements for a threaded loop (with OpenMP).
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   const int FieldExprMinThreaded = 16384;
+
+   /**
+   * Empty base class for all field expression types.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   class FieldExprBase
+   {};
+
+   /**
+   * Leaf of an expression that refers to an array of real values.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   class FieldTerm : public FieldExprBase
+   {
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param data  pointer to first element
+      * \param size  number of elements
+      */
+      FieldTerm(double const * data, int size)
+       : data_(data),
+         size_(size)
+      {}
+
+      /**
+      * Get element i.
+      */
+      double operator [] (int i) const
+      {  return data_[i]; }
+
+      /**
+      * Number of elements.
+      */
+      int size() const
+      {  return size_; }
+
+      /**
+      * Do all arrays in this expression have n elements?
+      */
+      bool hasSize(int n) const
+      {  return (size_ == n); }
+
+   private:
+
+      double const * data_;
+      int size_;
+
+   };
+
+   /**
+   * Leaf of an expression that represents a scalar constant.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   class ScalarTerm : public FieldExprBase
+   {
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param value  value of constant
+      */
+      ScalarTerm(double value)
+       : value_(value)
+      {}
+
+      /**
+      * Get element i (the same for all i).
+      */
+      double operator [] (int i) const
+      {  return value_; }
+
+      /**
+      * Return -1, since a scalar has no intrinsic size.
+      */
+      int size() const
+      {  return -1; }
+
+      /**
+      * Return true, since a scalar is compatible with any array.
+      */
+      bool hasSize(int n) const
+      {  return true; }
+
+   private:
+
+      double value_;
+
+   };
+
+   /**
+   * Element-wise binary operation on two expressions.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class Op, class A, class B>
+   class BinaryFieldExpr : public FieldExprBase
+   {
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param a  left operand
+      * \param b  right operand
+      */
+      BinaryFieldExpr(A const & a, B const & b)
+       : a_(a),
+         b_(b)
+      {}
+
+      /**
+      * Compute element i.
+      */
+      double operator [] (int i) const
+      {  return Op::apply(a_[i], b_[i]); }
+
+      /**
+      * Number of elements of the first array operand.
+      */
+      int size() const
+      {  return (a_.size() >= 0) ? a_.size() : b_.size(); }
+
+      /**
+      * Do all arrays in this expression have n elements?
+      */
+      bool hasSize(int n) const
+      {  return (a_.hasSize(n) && b_.hasSize(n)); }
+
+   private:
+
+      A a_;
+      B b_;
+
+   };
+
+   /**
+   * Element-wise unary operation on an expression.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class Op, class A>
+   class UnaryFieldExpr : public FieldExprBase
+   {
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param a  operand
+      */
+      UnaryFieldExpr(A const & a)
+       : a_(a)
+      {}
+
+      /**
+      * Compute element i.
+      */
+      double operator [] (int i) const
+      {  return Op::apply(a_[i]); }
+
+      /**
+      * Number of elements.
+      */
+      int size() const
+      {  return a_.size(); }
+
+      /**
+      * Do all arrays in this expression have n elements?
+      */
+      bool hasSize(int n) const
+      {  return a_.hasSize(n); }
+
+   private:
+
+      A a_;
+
+   };
+
+   /**
+   * Element-wise operations used in field expressions.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   namespace FieldOp
+   {
+
+      struct Add
+      {
+         static double apply(double a, double b)
+         {  return a + b; }
+      };
+
+      struct Subtract
+      {
+         static double apply(double a, double b)
+         {  return a - b; }
+      };
+
+      struct Multiply
+      {
+         static double apply(double a, double b)
+         {  return a*b; }
+      };
+
+      struct Divide
+      {
+         static double apply(double a, double b)
+         {  return a/b; }
+      };
+
+      struct Negate
+      {
+         static double apply(double a)
+         {  return -a; }
+      };
+
+   }
+
+   /**
+   * Traits that convert an operand to an expression type.
+   *
+   * The generic template is used for types that are not valid operands,
+   * for which isOperand is false. Specializations are defined for
+   * expressions, for subclasses of Field<double>, for DArray<double>,
+   * and for arithmetic scalar types.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class T, class Enable = void>
+   struct FieldOperand
+   {
+      static const bool isOperand = false;
+      static const bool isScalar = false;
+      typedef FieldTerm Type;
+   };
+
+   // Expression (stored by value)
+   template <class T>
+   struct FieldOperand<T, typename std::enable_if<
+                          std::is_base_of<FieldExprBase, T>::value>::type>
+   {
+      static const bool isOperand = true;
+      static const bool isScalar = false;
+      typedef T Type;
+      static T const & make(T const & t)
+      {  return t; }
+   };
+
+   // Field<double> or a subclass, such as RField<D>
+   template <class T>
+   struct FieldOperand<T, typename std::enable_if<
+                          std::is_base_of<Field<double>, T>::value>::type>
+   {
+      static const bool isOperand = true;
+      static const bool isScalar = false;
+      typedef FieldTerm Type;
+      static FieldTerm make(T const & t)
+      {  return FieldTerm(t.cField(), t.capacity()); }
+   };
+
+   // DArray<double>
+   template <>
+   struct FieldOperand< DArray<double> >
+   {
+      static const bool isOperand = true;
+      static const bool isScalar = false;
+      typedef FieldTerm Type;
+      static FieldTerm make(DArray<double> const & t)
+      {  return FieldTerm(t.cArray(), t.capacity()); }
+   };
+
+   // Real or integer scalar
+   template <class T>
+   struct FieldOperand<T, typename std::enable_if<
+                          std::is_arithmetic<T>::value>::type>
+   {
+      static const bool isOperand = true;
+      static const bool isScalar = true;
+      typedef ScalarTerm Type;
+      static ScalarTerm make(T const & t)
+      {  return ScalarTerm((double) t); }
+   };
+
+   /**
+   * Type of a binary expression, defined only for valid operands.
+   *
+   * At least one operand must be an array or expression, so that the
+   * operators defined below never apply to two scalars.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class Op, class A, class B>
+   struct BinaryFieldResult
+    : public std::enable_if<
+               FieldOperand<A>::isOperand && FieldOperand<B>::isOperand
+               && !(FieldOperand<A>::isScalar && FieldOperand<B>::isScalar),
+               BinaryFieldExpr<Op, typename FieldOperand<A>::Type,
+                                   typename FieldOperand<B>::Type> >
+   {};
+
+   /**
+   * Element-wise sum of two operands.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class A, class B>
+   inline
+   typename BinaryFieldResult<FieldOp::Add, A, B>::type
+   operator + (A const & a, B const & b)
+   {
+      typedef typename BinaryFieldResult<FieldOp::Add, A, B>::type R;
+      return R(FieldOperand<A>::make(a), FieldOperand<B>::make(b));
+   }
+
+   /**
+   * Element-wise difference of two operands.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class A, class B>
+   inline
+   typename BinaryFieldResult<FieldOp::Subtract, A, B>::type
+   operator - (A const & a, B const & b)
+   {
+      typedef typename BinaryFieldResult<FieldOp::Subtract, A, B>::type R;
+      return R(FieldOperand<A>::make(a), FieldOperand<B>::make(b));
+   }
+
+   /**
+   * Element-wise product of two operands.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class A, class B>
+   inline
+   typename BinaryFieldResult<FieldOp::Multiply, A, B>::type
+   operator * (A const & a, B const & b)
+   {
+      typedef typename BinaryFieldResult<FieldOp::Multiply, A, B>::type R;
+      return R(FieldOperand<A>::make(a), FieldOperand<B>::make(b));
+   }
+
+   /**
+   * Element-wise quotient of two operands.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class A, class B>
+   inline
+   typename BinaryFieldResult<FieldOp::Divide, A, B>::type
+   operator / (A const & a, B const & b)
+   {
+      typedef typename BinaryFieldResult<FieldOp::Divide, A, B>::type R;
+      return R(FieldOperand<A>::make(a), FieldOperand<B>::make(b));
+   }
+
+   /**
+   * Element-wise negation of an array or expression.
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class A>
+   inline
+   typename std::enable_if<
+            FieldOperand<A>::isOperand && !FieldOperand<A>::isScalar,
+            UnaryFieldExpr<FieldOp::Negate,
+                           typename FieldOperand<A>::Type> >::type
+   operator - (A const & a)
+   {
+      typedef typename FieldOperand<A>::Type T;
+      return UnaryFieldExpr<FieldOp::Negate, T>(FieldOperand<A>::make(a));
+   }
+
+   /*
+   * Implementation of evaluation functions (not part of public interface).
+   */
+   namespace FieldExprImpl
+   {
+
+      template <class E>
+      inline void assign(double* a, int n, E const & e)
+      {
+         UTIL_CHECK(e.hasSize(n));
+         int i;
+         #ifdef _OPENMP
+         #pragma omp parallel for if (n > FieldExprMinThreaded)
+         #endif
+         for (i = 0; i < n; ++i) {
+            a[i] = e[i];
+         }
+      }
+
+      template <class E>
+      inline void addTo(double* a, int n, E const & e)
+      {
+         UTIL_CHECK(e.hasSize(n));
+         int i;
+         #ifdef _OPENMP
+         #pragma omp parallel for if (n > FieldExprMinThreaded)
+         #endif
+         for (i = 0; i < n; ++i) {
+            a[i] += e[i];
+         }
+      }
+
+   }
+
+   /**
+   * Evaluate an expression and assign it to a field, a = e.
+   *
+   * \param a  destination field (RField<D> or other Field<double>)
+   * \param e  expression, array or scalar
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class E>
+   inline void assign(Field<double>& a, E const & e)
+   {  FieldExprImpl::assign(a.cField(), a.capacity(),
+                            FieldOperand<E>::make(e)); }
+
+   /**
+   * Evaluate an expression and assign it to an array, a = e.
+   *
+   * \param a  destination array
+   * \param e  expression, array or scalar
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class E>
+   inline void assign(DArray<double>& a, E const & e)
+   {  FieldExprImpl::assign(a.cArray(), a.capacity(),
+                            FieldOperand<E>::make(e)); }
+
+   /**
+   * Evaluate an expression and add it to a field, a += e.
+   *
+   * \param a  destination field (RField<D> or other Field<double>)
+   * \param e  expression, array or scalar
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class E>
+   inline void addTo(Field<double>& a, E const & e)
+   {  FieldExprImpl::addTo(a.cField(), a.capacity(),
+                           FieldOperand<E>::make(e)); }
+
+   /**
+   * Evaluate an expression and add it to an array, a += e.
+   *
+   * \param a  destination array
+   * \param e  expression, array or scalar
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class E>
+   inline void addTo(DArray<double>& a, E const & e)
+   {  FieldExprImpl::addTo(a.cArray(), a.capacity(),
+                           FieldOperand<E>::make(e)); }
+
+   /**
+   * Return the sum of all elements of an expression or array.
+   *
+   * If the code is compiled with OpenMP and the expression has more
+   * than FieldExprMinThreaded elements, partial sums computed by each
+   * thread are combined by an OpenMP reduction. The order of floating
+   * point additions thus depends on the number of threads, and results
+   * (e.g., free energies computed by System::computeFreeEnergy) can
+   * differ in the last few digits for different numbers of threads.
+   *
+   * \param e  expression or array (not a scalar)
+   *
+   * \ingroup Pspc_FieldExpr_Module
+   */
+   template <class E>
+   inline
+   typename std::enable_if<
+            FieldOperand<E>::isOperand && !FieldOperand<E>::isScalar,
+            double>::type
+   sum(E const & e)
+   {
+      typename FieldOperand<E>::Type const & x = FieldOperand<E>::make(e);
+      int n = x.size();
+      UTIL_CHECK(n >= 0);
+      UTIL_CHECK(x.hasSize(n));
+      double s = 0.0;
+      int i;
+      #ifdef _OPENMP
+      #pragma omp parallel for reduction(+:s) if (n > FieldExprMinThreaded)
+      #endif
+      for (i = 0; i < n; ++i) {
+         s += x[i];
+      }
+      return s;
+   }
+
+}
+}
+#endif
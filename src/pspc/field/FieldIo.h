@@ -20,6 +20,7 @@
 #include <util/misc/FileMaster.h>          // member
 #include <util/containers/DArray.h>        // function parameter
 #include <util/containers/Array.h>         // function parameter
+#include <util/misc/Log.h>                 // default log stream
 
 namespace Pscf {
 namespace Pspc
@@ -73,6 +74,32 @@ namespace Pspc
                      Basis<D> & basis,
                      FileMaster const & fileMaster);
 
+      /**
+      * Copy associations of another FieldIo, but use a different FFT.
+      *
+      * This allows several FieldIo objects that share a Basis and other
+      * associated objects, but have separate FFT objects and work space,
+      * to be used concurrently (e.g., by different threads).
+      *
+      * \param other  FieldIo object from which associations are copied
+      * \param fft   associated FFT object for fast transforms
+      */
+      void associate(FieldIo<D> const & other, FFT<D> const & fft);
+
+      /**
+      * Set the stream used for warnings and error messages.
+      *
+      * By default, messages are written to the global Log::file().
+      *
+      * \param out  log output stream
+      */
+      void setLogFile(std::ostream& out);
+
+      /**
+      * Get the stream used for warnings and error messages.
+      */
+      std::ostream& logFile() const;
+
       /// \name Field File IO - Symmetry Adapted Basis Format
       ///@{
 
@@ -142,6 +169,10 @@ namespace Pspc
       * fields[i] is a DArray containing components of the field 
       * associated with monomer type i.
       *
+      * If the associated basis is not initialized, this function will
+      * construct it using the unit cell read from the file header and
+      * the associated group.
+      *
       * \param in  input stream (i.e., input file)
       * \param fields  array of fields (symmetry adapted basis components)
       * \param unitCell  associated crystallographic unit cell
@@ -389,9 +420,10 @@ namespace Pspc
       * group name and the the number of monomers. The unit cell data is
       * read into the associated UnitCell<D>, which is thus updated.
       *
-      * If the associated basis is not initialized, this function will
-      * attempt to initialize it using the unit cell read from file and
-      * the associated group (if available) or group name. 
+      * If the associated group is not initialized, this function will
+      * read it using the group name from the header. It does not 
+      * construct the associated basis, which is only constructed 
+      * when first needed (e.g., by readFieldsBasis). 
       * 
       * This function throws an exception if the values of "dim" read 
       * from file do not match the FieldIo template parameter D. 
@@ -460,7 +492,7 @@ namespace Pspc
       * If the checkSymmetry parameter is true, this function checks if 
       * the input field satisfies the space group symmetry to within a 
       * tolerance given by the epsilon parameter, and prints a warning to 
-      * Log::file() if it does not. 
+      * logFile() if it does not. 
       *
       * \param in  discrete Fourier transform (k-grid) of a field
       * \param out  components of field in asymmetry-adapted Fourier basis
@@ -481,7 +513,7 @@ namespace Pspc
       * If the checkSymmetry parameter is true, this function checks if 
       * the input fields all satisfies the space group symmetry to within
       * a tolerance given by the parameter epsilon, and prints a warning 
-      * to Log::file() if one or more fields do not. 
+      * to logFile() if one or more fields do not. 
       *
       * \param in  fields defined as discrete Fourier transforms (k-grid)
       * \param out  components of fields in symmetry adapted basis 
@@ -518,7 +550,7 @@ namespace Pspc
       * \param out  field in symmetry adapted basis form
       * \param checkSymmetry  boolean indicating whether to check that the 
       * symmetry of the input field matches the space group symmetry. If
-      * input does not have correct symmetry, prints warning to Log::file()
+      * input does not have correct symmetry, prints warning to logFile()
       * \param epsilon  if checkSymmetry = true, epsilon is the error 
       * threshold used when comparing the k-grid and symmetry-adapted formats 
       * to determine whether field has the declared space group symmetry
@@ -535,7 +567,7 @@ namespace Pspc
       * \param out  fields in symmetry adapted basis form
       * \param checkSymmetry  boolean indicating whether to check that the 
       * symmetry of the input field matches the space group symmetry. If
-      * input does not have correct symmetry, prints warning to Log::file()
+      * input does not have correct symmetry, prints warning to logFile()
       * \param epsilon  if checkSymmetry = true, epsilon is the error 
       * threshold used when comparing the k-grid and symmetry-adapted formats 
       * to determine whether field has the declared space group symmetry
@@ -601,7 +633,7 @@ namespace Pspc
       * symmetry-adapted formats to determine whether field has the declared
       * space group symmetry.
       * \param verbose if field does not have symmetry and verbose = true,
-      * function will write error values to Log::file().
+      * function will write error values to logFile().
       * \return true if the field is symmetric, false otherwise
       */
       bool hasSymmetry(RField<D> const & in, double epsilon = 1.0e-8,
@@ -615,7 +647,7 @@ namespace Pspc
       * symmetry-adapted formats to determine whether field has the declared
       * space group symmetry.
       * \param verbose if field does not have symmetry and verbose = true,
-      * function will write error values to Log::file().
+      * function will write error values to logFile().
       * \return true if the field is symmetric, false otherwise
       */
       bool hasSymmetry(RFieldDft<D> const & in, double epsilon = 1.0e-8,
@@ -651,6 +683,9 @@ namespace Pspc
       /// Pointer to Filemaster (holds paths to associated I/O files).
       FileMaster const * fileMasterPtr_;
 
+      /// Pointer to log stream (null if Log::file() is used).
+      std::ostream* logFilePtr_;
+
       // Private accessor functions:
 
       /// Get spatial discretization mesh by const reference.
@@ -709,6 +744,18 @@ namespace Pspc
 
    };
 
+   // Inline member functions
+
+   // Set the log stream.
+   template <int D>
+   inline void FieldIo<D>::setLogFile(std::ostream& out)
+   {  logFilePtr_ = &out; }
+
+   // Get the log stream.
+   template <int D>
+   inline std::ostream& FieldIo<D>::logFile() const
+   {  return logFilePtr_ ? *logFilePtr_ : Log::file(); }
+
    #ifndef PSPC_FIELD_IO_TPP
    extern template class FieldIo<1>;
    extern template class FieldIo<2>;
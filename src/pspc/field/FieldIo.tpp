@@ -38,7 +38,8 @@ namespace Pspc
       groupNamePtr_(0),
       groupPtr_(0),
       basisPtr_(0),
-      fileMasterPtr_()
+      fileMasterPtr_(),
+      logFilePtr_(0)
    {}
 
    /*
@@ -69,6 +70,22 @@ namespace Pspc
       basisPtr_ = &basis;
       fileMasterPtr_ = &fileMaster;
    }
+
+   /*
+   * Copy associations of another FieldIo, with a different FFT.
+   */
+   template <int D>
+   void FieldIo<D>::associate(FieldIo<D> const & other, FFT<D> const & fft)
+   {
+      meshPtr_ = other.meshPtr_;
+      fftPtr_ = &fft;
+      latticePtr_ = other.latticePtr_;
+      groupNamePtr_ = other.groupNamePtr_;
+      groupPtr_ = other.groupPtr_;
+      basisPtr_ = other.basisPtr_;
+      fileMasterPtr_ = other.fileMasterPtr_;
+      logFilePtr_ = other.logFilePtr_;
+   }
   
    template <int D>
    void FieldIo<D>::readFieldBasis(std::istream& in, DArray<double>& field,
@@ -136,6 +153,12 @@ namespace Pspc
    {
       int nMonomer;
       FieldIo<D>::readFieldHeader(in, nMonomer, unitCell);
+
+      // Construct basis if not initialized
+      UTIL_CHECK(basisPtr_);
+      if (!basis().isInitialized()) {
+         basisPtr_->makeBasis(mesh(), unitCell, group());
+      }
       UTIL_CHECK(basis().isInitialized());
 
       // Read the number of stars into nStarIn
@@ -245,7 +268,7 @@ namespace Pspc
             if (starPtr->size == sizeIn) {
                sizeMatches = true;
             } else {
-               Log::file() 
+               logFile() 
                   <<  "Warning: Inconsistent star size (line ignored)\n"
                   <<  "wave from file = " << waveIn << "\n"
                   <<  "size from file = " << sizeIn << "\n"
@@ -269,7 +292,7 @@ namespace Pspc
 
                } else {
 
-                  Log::file() 
+                  logFile() 
                      <<  "Inconsistent wave of closed star on input\n"
                      <<  "wave from file = " << waveIn  << "\n"
                      <<  "starId of wave = " << starId  << "\n"
@@ -405,8 +428,8 @@ namespace Pspc
       }   // end while (i < nStarIn)
 
       if (nReversedPair > 0) {
-         Log::file() << "\n";
-         Log::file() << nReversedPair << " reversed pairs of open stars"
+         logFile() << "\n";
+         logFile() << nReversedPair << " reversed pairs of open stars"
                    << " detected in FieldIo::readFieldsBasis\n";
       }
 
@@ -593,7 +616,7 @@ namespace Pspc
       } 
 
       else{
-         Log::file() << "Invalid Dimensions";
+         logFile() << "Invalid Dimensions";
       }
 
    }
@@ -685,7 +708,7 @@ namespace Pspc
             ++n1;
          }
       } else {
-         Log::file() << "Invalid Dimensions";
+         logFile() << "Invalid Dimensions";
       }
 
       // Write fields
@@ -812,7 +835,7 @@ namespace Pspc
       } 
 
       else{
-         Log::file() << "Invalid Dimensions";
+         logFile() << "Invalid Dimensions";
       }
    }
 
@@ -894,7 +917,7 @@ namespace Pspc
             ++n1;
          }
       } else {
-         Log::file() << "Invalid Dimensions";
+         logFile() << "Invalid Dimensions";
       }
 
       // Write field
@@ -1081,7 +1104,7 @@ namespace Pspc
          lattice() = unitCell.lattice();
       } else {
          if (lattice() != unitCell.lattice()) {
-            Log::file() << std::endl 
+            logFile() << std::endl 
                << "Error - "
                << "Mismatched lattice types, FieldIo::readFieldHeader:\n" 
                << "  FieldIo::lattice  :" << lattice() << "\n"
@@ -1096,7 +1119,7 @@ namespace Pspc
          groupName() = groupNameIn;
       } else {
          if (groupNameIn != groupName()) {
-            Log::file() << std::endl 
+            logFile() << std::endl 
                << "Error - "
                << "Mismatched group names in FieldIo::readFieldHeader:\n" 
                << "  FieldIo::groupName :" << groupName() << "\n"
@@ -1113,13 +1136,6 @@ namespace Pspc
          }
       }
 
-      // Check basis, construct if not initialized
-      UTIL_CHECK(basisPtr_);
-      if (!basis().isInitialized()) {
-         basisPtr_->makeBasis(mesh(), unitCell, group());
-      }
-      UTIL_CHECK(basis().isInitialized());
-      
    }
 
    template <int D>
@@ -1248,7 +1264,7 @@ namespace Pspc
          // Check if kgrid has symmetry
          bool symmetric = hasSymmetry(in, epsilon, true);
          if (!symmetric) {
-            Log::file() << std::endl
+            logFile() << std::endl
                << "WARNING: non-negligible error in conversion to "
                << "symmetry-adapted basis format." << std::endl
                << "   See error values printed above for each "
@@ -1387,7 +1403,7 @@ namespace Pspc
 
       // Print warning if any input field is assymmetric
       if (!symmetric) {
-         Log::file() << std::endl
+         logFile() << std::endl
             << "WARNING: non-negligible error in conversion to "
             << "symmetry-adapted basis format." << std::endl
             << "See error values printed above for each asymmetric field."
@@ -1460,7 +1476,7 @@ namespace Pspc
 
       // Print warning if any input fields is asymmetric
       if (!symmetric) {
-         Log::file() << std::endl
+         logFile() << std::endl
              << "WARNING: non-negligible error in conversion to "
              << "symmetry-adapted basis format." << std::endl
              << "   See error values printed above for each "
@@ -1621,11 +1637,11 @@ namespace Pspc
       if ((cancelledError < epsilon) && (uncancelledError < epsilon)) {
          return true;
       } else if (verbose) {
-         Log::file() << std::endl
-                     << "Maximum coefficient of a cancelled star: "
-                     << cancelledError << std::endl
-                     << "Maximum error of coefficient for uncancelled star: "
-                     << uncancelledError << std::endl;
+         logFile() << std::endl
+                   << "Maximum coefficient of a cancelled star: "
+                   << cancelledError << std::endl
+                   << "Maximum error of coefficient for uncancelled star: "
+                   << uncancelledError << std::endl;
       }
       return false;
    }
@@ -1635,8 +1651,11 @@ namespace Pspc
    {
       if (!workDft_.isAllocated()) {
          workDft_.allocate(mesh().dimensions());
-      } else {
-         UTIL_CHECK(workDft_.meshDimensions() == fft().meshDimensions());
+      } else 
+      if (workDft_.meshDimensions() != fft().meshDimensions()) {
+         // Mesh changed since last use (see Domain::setMesh)
+         workDft_.deallocate();
+         workDft_.allocate(mesh().dimensions());
       }
    }
 
@@ -75,14 +75,24 @@ namespace Pspc {
       /**
       * Allocate memory for the field.
       *
-      * A Mask<D> may only be allocated once. An Exception will
-      * be thrown if this function is called more than once.
+      * An Exception will be thrown if this function is called when
+      * the field is already allocated. See deallocate(). If nBasis is
+      * zero, only the r-grid array is allocated, and the field may 
+      * then only be set or read in r-grid format without symmetry.
       *
-      * \param nBasis  number of basis functions 
+      * \param nBasis  number of basis functions (may be 0)
       * \param dimensions  dimensions of spatial mesh
       */
       void allocate(int nBasis, IntVec<D> const & dimensions);
 
+      /**
+      * Release memory for the field, e.g., before a change of mesh.
+      *
+      * On return, isAllocated() and hasData() are false, and the 
+      * field may be allocated again with different dimensions.
+      */
+      void deallocate();
+
       /**
       * Set field component values, in symmetrized Fourier format.
       *
@@ -11,6 +11,7 @@
 #include "Mask.h"
 #include <pspc/field/FieldIo.h>
 #include <pspc/field/RFieldDft.h>
+#include <pspc/field/FieldExpr.h>
 
 namespace Pscf {
 namespace Pspc
@@ -66,11 +67,32 @@ namespace Pspc
       }
   
       // Allocate field arrays 
-      basis_.allocate(nBasis);
+      if (nBasis > 0) {
+         basis_.allocate(nBasis);
+      }
       rgrid_.allocate(meshDimensions);
       isAllocated_ = true;
    }
 
+   /*
+   * Release memory for field.
+   */
+   template <int D>
+   void Mask<D>::deallocate()
+   {
+      UTIL_CHECK(isAllocated_);
+      if (basis_.isAllocated()) {
+         basis_.deallocate();
+      }
+      rgrid_.deallocate();
+      nBasis_ = 0;
+      meshDimensions_ = 0;
+      meshSize_ = 0;
+      isAllocated_ = false;
+      hasData_ = false;
+      isSymmetric_ = false;
+   }
+
    /*
    * Set new w-field values.
    */
@@ -78,9 +100,7 @@ namespace Pspc
    void Mask<D>::setBasis(DArray<double> const & field)
    {
       UTIL_CHECK(field.capacity() == nBasis_);
-      for (int j = 0; j < nBasis_; ++j) {
-         basis_[j] = field[j];
-      }
+      assign(basis_, field);
       fieldIoPtr_->convertBasisToRGrid(basis_, rgrid_);
       hasData_ = true;
       isSymmetric_ = true;
@@ -93,9 +113,8 @@ namespace Pspc
    void Mask<D>::setRGrid(RField<D> const & field,
                           bool isSymmetric)
    {
-      for (int j = 0; j < meshSize_; ++j) {
-         rgrid_[j] = field[j];
-      }
+      UTIL_CHECK(field.capacity() == meshSize_);
+      assign(rgrid_, field);
       if (isSymmetric) {
          fieldIoPtr_->convertRGridToBasis(rgrid_, basis_);
       }
@@ -10,6 +10,7 @@
 
 #include "WFieldContainer.h"
 #include <pspc/field/FieldIo.h>
+#include <pspc/field/FieldExpr.h>
 
 namespace Pscf {
 namespace Pspc
@@ -175,9 +176,7 @@ namespace Pspc
          DArray<double> &  w = basis_[i];
          UTIL_CHECK(f.capacity() == nBasis_);
          UTIL_CHECK(w.capacity() == nBasis_);
-         for (int j = 0; j < nBasis_; ++j) {
-            w[j] = f[j];
-         }
+         assign(w, f);
       }
 
       // Update system wFieldsRGrid
@@ -202,9 +201,7 @@ namespace Pspc
          RField<D>& w = rgrid_[i];
          UTIL_CHECK(f.capacity() == meshSize_);
          UTIL_CHECK(w.capacity() == meshSize_);
-         for (int j = 0; j < meshSize_; ++j) {
-            w[j] = f[j];
-         }
+         assign(w, f);
       }
 
       if (isSymmetric) {
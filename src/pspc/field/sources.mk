@@ -4,6 +4,7 @@ pspc_field_= \
   pspc/field/RFieldDft.cpp \
   pspc/field/FFT.cpp \
   pspc/field/FieldIo.cpp \
+  pspc/field/FieldConverter.cpp \
   pspc/field/Domain.cpp \
   pspc/field/BFieldComparison.cpp \
   pspc/field/RFieldComparison.cpp \
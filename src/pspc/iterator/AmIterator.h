@@ -11,6 +11,8 @@
 #include "Iterator.h"                        // base class
 #include <pscf/iterator/AmIteratorTmpl.h>    // base class template                
 #include <pscf/iterator/AmbdInteraction.h>   // member variable
+#include <util/containers/DMatrix.h>         // member template
+#include <util/containers/DArray.h>          // member template
 
 namespace Pscf {
 namespace Pspc
@@ -24,6 +26,12 @@ namespace Pspc
    /**
    * Pspc implementation of the Anderson Mixing iterator.
    *
+   * If the optional parameter dsInitial is greater than the contour
+   * step ds given in the Mixture block, each solve begins with the 
+   * coarser step dsInitial. The step is halved, down to the Mixture 
+   * value, each time the error falls below dsRefineError (or epsilon, 
+   * if larger), so that early iterations require fewer MDE steps. 
+   *
    * \ingroup Pspc_Iterator_Module
    */
    template <int D>
@@ -51,8 +59,27 @@ namespace Pspc
       */
       void readParameters(std::istream& in);
 
+      /**
+      * Iterate to a solution.
+      *
+      * If contour step refinement is enabled, this sets the coarse 
+      * initial step before iterating, and ensures that the Mixture 
+      * step ds is restored on return.
+      *
+      * \param isContinuation true iff continuation within a sweep
+      * \return 0 for convergence, 1 for failure
+      */
+      int solve(bool isContinuation = false);
+
+      /**
+      * Reallocate memory after a change in mesh dimensions.
+      *
+      * Discards all Anderson mixing histories.
+      */
+      void resetMesh();
+
       // Inherited public member functions
-      using AmIteratorTmpl<Iterator<D>, DArray<double> >::solve;
+      using AmIteratorTmpl<Iterator<D>, DArray<double> >::epsilon;
       using Iterator<D>::isFlexible;
       using Iterator<D>::flexibleParams;
       using Iterator<D>::setFlexibleParams;
@@ -77,6 +104,35 @@ namespace Pspc
       */
       void setup(bool isContinuation);
 
+      /**
+      * Get the log stream of the parent system.
+      */
+      std::ostream& logFile() const;
+
+      /**
+      * Estimate the free energy error from a residual and a step.
+      *
+      * Uses the gradient of the free energy per monomer with respect 
+      * to the w field components, which is minus the product of the 
+      * inverse chi matrix and the SCF residual, and the gradient with
+      * respect to flexible unit cell parameters, which is the stress.
+      *
+      * \param resid  residual vector of current state
+      * \param field  field vector of current state
+      * \param fieldNew  field vector after Anderson mixing step
+      */
+      double estimateFError(DArray<double> const & resid, 
+                            DArray<double> const & field,
+                            DArray<double> const & fieldNew);
+
+      /**
+      * Halve the contour step if the error is small enough.
+      *
+      * \param error  scalar error for the current state
+      * \return true iff the contour step was changed
+      */
+      bool refine(double error);
+
    private:
       
       // Local copy of interaction, adapted for use AMBD residual definition
@@ -84,6 +140,27 @@ namespace Pspc
 
       /// How are stress residuals scaled in error calculation?
       double scaleStress_;
+
+      /// Initial contour step (refinement disabled if <= Mixture ds).
+      double dsInitial_;
+
+      /// Error below which the contour step is refined.
+      double dsRefineError_;
+
+      /// Final contour step, from the Mixture, during a solve.
+      double dsFinal_;
+
+      /// Coefficients of the residual, A = [chi, -p, p] (set in setup).
+      DMatrix<double> residA_;
+
+      /// Pointers to rows c_j, w_j and h_j of the residual product.
+      DArray<double const *> residX_;
+
+      /// Pointers to segments of the residual vector for each monomer.
+      DArray<double*> residR_;
+
+      /// W fields in basis format, set by update (allocated in setup).
+      DArray< DArray<double> > wField_;
       
       /**
       * Assign one field to another.
@@ -136,6 +213,11 @@ namespace Pspc
                              DArray<double> const & resTrial, 
                              double lambda);
 
+   protected:
+
+      // Functions that exchange data with the parent system are 
+      // protected, for use by subclasses that modify the algorithm.
+
       /**
       * Does the system has an initial guess for the field?
       */
@@ -12,6 +12,8 @@
 #include <pspc/System.h>
 #include <pscf/inter/Interaction.h>
 #include <pscf/iterator/NanException.h>
+#include <pscf/math/MatrixProduct.h>
+#include <pspc/field/FieldExpr.h>
 #include <util/global.h>
 #include <cmath>
 
@@ -23,7 +25,10 @@ namespace Pspc{
    // Constructor
    template <int D>
    AmIterator<D>::AmIterator(System<D>& system)
-    : Iterator<D>(system)
+    : Iterator<D>(system),
+      dsInitial_(0.0),
+      dsRefineError_(1.0E-4),
+      dsFinal_(0.0)
    {  setClassName("AmIterator"); }
 
    // Destructor
@@ -73,8 +78,51 @@ namespace Pspc{
 
       // Read optional scaleStress value
       readOptional(in, "scaleStress", scaleStress_);
+
+      // Read optional parameters for contour step refinement
+      readOptional(in, "dsInitial", dsInitial_);
+      if (dsInitial_ > 0.0) {
+         readOptional(in, "dsRefineError", dsRefineError_);
+      }
    }
 
+   // Iterate to a solution, with optional contour step refinement
+   template <int D>
+   int AmIterator<D>::solve(bool isContinuation)
+   {
+      Mixture<D>& mixture = system().mixture();
+      dsFinal_ = mixture.ds();
+      if (dsInitial_ <= dsFinal_) {
+         return AmIteratorTmpl<Iterator<D>, DArray<double> >
+                                           ::solve(isContinuation);
+      }
+
+      // Begin with coarse contour step, restore final step on return
+      mixture.setDs(dsInitial_);
+      int error;
+      try {
+         error = AmIteratorTmpl<Iterator<D>, DArray<double> >
+                                           ::solve(isContinuation);
+      } catch (...) {
+         mixture.setDs(dsFinal_);
+         throw;
+      }
+      // On failure before refinement to dsFinal_, the c fields were
+      // computed with a coarser step. Restore the step and re-evaluate,
+      // so that c fields and any stored propagators are consistent.
+      // (On an exception, System::iterate leaves hasCFields false.)
+      if (mixture.ds() != dsFinal_) {
+         mixture.setDs(dsFinal_);
+         system().compute();
+      }
+      return error;
+   }
+
+   // Reallocate after a change in mesh dimensions
+   template <int D>
+   void AmIterator<D>::resetMesh()
+   {  AmIteratorTmpl<Iterator<D>, DArray<double> >::reallocateAM(); }
+
    // Protected virtual function
 
    // Setup before entering iteration loop
@@ -83,6 +131,46 @@ namespace Pspc{
    {
       AmIteratorTmpl<Iterator<D>, DArray<double> >::setup(isContinuation);
       interaction_.update(system().interaction());
+
+      // Set coefficient matrix A = [chi, -p, p] used by getResidual. 
+      // The third block, for external fields, is present only if the
+      // system has external fields.
+      const int nMonomer = system().mixture().nMonomer();
+      const int nx = system().hasExternalFields() ? 3*nMonomer 
+                                                  : 2*nMonomer;
+      if (residA_.isAllocated() && residA_.capacity2() != nx) {
+         residA_.deallocate();
+         residX_.deallocate();
+      }
+      if (!residA_.isAllocated()) {
+         residA_.allocate(nMonomer, nx);
+         residX_.allocate(nx);
+      }
+      if (!residR_.isAllocated()) {
+         residR_.allocate(nMonomer);
+      }
+
+      // Allocate w fields used by update, or reallocate if the number
+      // of basis functions has changed (e.g., after a change of mesh)
+      const int nBasis = system().basis().nBasis();
+      if (wField_.isAllocated() && wField_[0].capacity() != nBasis) {
+         wField_.deallocate();
+      }
+      if (!wField_.isAllocated()) {
+         wField_.allocate(nMonomer);
+         for (int i = 0; i < nMonomer; ++i) {
+            wField_[i].allocate(nBasis);
+         }
+      }
+      for (int i = 0; i < nMonomer; ++i) {
+         for (int j = 0; j < nMonomer; ++j) {
+            residA_(i, j) = interaction_.chi(i,j);
+            residA_(i, nMonomer + j) = -1.0*interaction_.p(i,j);
+            if (nx > 2*nMonomer) {
+               residA_(i, 2*nMonomer + j) = interaction_.p(i,j);
+            }
+         }
+      }
    }
 
    // Private virtual functions used to implement AM algorithm
@@ -157,12 +245,9 @@ namespace Pspc{
                                DArray<double> coeffs,
                                int nHist)
    {
-      int n = trial.capacity();
       for (int i = 0; i < nHist; i++) {
-         for (int j = 0; j < n; j++) {
-            // Not clear on the origin of the -1 factor
-            trial[j] += coeffs[i] * -1 * basis[i][j];
-         }
+         // Not clear on the origin of the -1 factor
+         addTo(trial, (-coeffs[i])*basis[i]);
       }
    }
 
@@ -171,10 +256,7 @@ namespace Pspc{
                                          DArray<double> const & resTrial,
                                          double lambda)
    {
-      int n = fieldTrial.capacity();
-      for (int i = 0; i < n; i++) {
-         fieldTrial[i] += lambda * resTrial[i];
-      }
+      addTo(fieldTrial, lambda*resTrial);
    }
 
    // Private virtual functions to exchange data with parent system
@@ -256,19 +338,23 @@ namespace Pspc{
          resid[i] = 0.0;
       }
 
-      // Compute SCF residual vector elements
+      // Compute SCF residual vector elements, including contributions 
+      // of any external fields, as a matrix product R = A X, in which
+      // A = [chi, -p, p] is set in setup and X has rows c_j, w_j and 
+      // h_j. Row i of R is the segment of resid for monomer type i.
+      const bool hasExt = (residA_.capacity2() == 3*nMonomer);
+      UTIL_CHECK(hasExt == system().hasExternalFields());
       for (int i = 0; i < nMonomer; ++i) {
-         for (int j = 0; j < nMonomer; ++j) {
-            double chi = interaction_.chi(i,j);
-            double p = interaction_.p(i,j);
-            DArray<double> const & c = system().c().basis(j);
-            DArray<double> const & w = system().w().basis(j);
-            for (int k = 0; k < nBasis; ++k) {
-               int idx = i*nBasis + k;
-               resid[idx] += chi*c[k] - p*w[k];
-            }
+         residR_[i] = resid.cArray() + i*nBasis;
+      }
+      for (int j = 0; j < nMonomer; ++j) {
+         residX_[j] = system().c().basis(j).cArray();
+         residX_[nMonomer + j] = system().w().basis(j).cArray();
+         if (hasExt) {
+            residX_[2*nMonomer + j] = system().h().basis(j).cArray();
          }
       }
+      addMatrixProduct(residA_, residX_, residR_, nBasis);
 
       // If iterator has mask, account for it in residual values
       if (system().hasMask()) {
@@ -281,20 +367,6 @@ namespace Pspc{
          }
       }
 
-      // If iterator has external fields, account for them in the values 
-      // of the residuals
-      if (system().hasExternalFields()) {
-         for (int i = 0; i < nMonomer; ++i) {
-            for (int j = 0; j < nMonomer; ++j) {
-               for (int k = 0; k < nBasis; ++k) {
-                  int idx = i*nBasis + k;
-                  resid[idx] += interaction_.p(i,j) * 
-                                system().h().basis(j)[k];
-               }
-            }
-         }
-      }
-
       // If not canonical, account for incompressibility
       if (!system().mixture().isCanonical()) {
          if (!system().hasMask()) {
@@ -343,35 +415,33 @@ namespace Pspc{
       const int nMonomer = system().mixture().nMonomer();
       const int nBasis = system().basis().nBasis();
 
-      DArray< DArray<double> > wField;
-      wField.allocate(nMonomer);
-
       // Restructure in format of monomers, basis functions
+      UTIL_CHECK(wField_.isAllocated());
+      UTIL_CHECK(wField_[0].capacity() == nBasis);
       for (int i = 0; i < nMonomer; i++) {
-         wField[i].allocate(nBasis);
          for (int k = 0; k < nBasis; k++)
          {
-            wField[i][k] = newGuess[i*nBasis + k];
+            wField_[i][k] = newGuess[i*nBasis + k];
          }
       }
       // If canonical, explicitly set homogeneous field components
       if (system().mixture().isCanonical()) {
          double chi;
          for (int i = 0; i < nMonomer; ++i) {
-            wField[i][0] = 0.0; // initialize to 0
+            wField_[i][0] = 0.0; // initialize to 0
             for (int j = 0; j < nMonomer; ++j) {
                chi = interaction_.chi(i,j);
-               wField[i][0] += chi * system().c().basis(j)[0];
+               wField_[i][0] += chi * system().c().basis(j)[0];
             }
          }
          // If iterator has external fields, include them in homogeneous field
          if (system().hasExternalFields()) {
             for (int i = 0; i < nMonomer; ++i) {
-               wField[i][0] += system().h().basis(i)[0];
+               wField_[i][0] += system().h().basis(i)[0];
             }
          }
       }
-      system().setWBasis(wField);
+      system().setWBasis(wField_);
 
       if (isFlexible()) {
          const int nParam = system().unitCell().nParameter();
@@ -392,6 +462,76 @@ namespace Pspc{
 
    }
 
+   /*
+   * Get the log stream of the parent system.
+   */
+   template <int D>
+   std::ostream& AmIterator<D>::logFile() const
+   {  return system().logFile(); }
+
+   /*
+   * Estimate free energy error from residual and Anderson step.
+   */
+   template <int D>
+   double AmIterator<D>::estimateFError(DArray<double> const & resid, 
+                                        DArray<double> const & field,
+                                        DArray<double> const & fieldNew)
+   {
+      const int nMonomer = system().mixture().nMonomer();
+      const int nBasis = system().basis().nBasis();
+
+      // Field contribution: The gradient of fHelmholtz with respect to
+      // the basis components of w_i is -sum_j chiInverse(i,j) resid_j,
+      // because basis functions are orthonormal under spatial averages
+      double dot = 0.0;
+      double sum;
+      int i, j, k;
+      for (i = 0; i < nMonomer; ++i) {
+         for (j = 0; j < nMonomer; ++j) {
+            sum = 0.0;
+            for (k = 0; k < nBasis; ++k) {
+               sum += resid[j*nBasis + k]
+                      *(fieldNew[i*nBasis + k] - field[i*nBasis + k]);
+            }
+            dot -= interaction_.chiInverse(i, j)*sum;
+         }
+      }
+
+      // Unit cell contribution: Stress times change in parameter
+      if (isFlexible()) {
+         const int nParam = system().unitCell().nParameter();
+         int counter = 0;
+         for (i = 0; i < nParam; ++i) {
+            if (flexibleParams_[i]) {
+               k = nMonomer*nBasis + counter;
+               dot += system().mixture().stress(i)
+                      *(fieldNew[k] - field[k])/scaleStress_;
+               ++counter;
+            }
+         }
+      }
+
+      return 0.5*std::abs(dot);
+   }
+
+   // Halve the contour step if the error is small enough
+   template <int D>
+   bool AmIterator<D>::refine(double error)
+   {
+      Mixture<D>& mixture = system().mixture();
+      if (mixture.ds() <= dsFinal_) return false;
+
+      double threshold = dsRefineError_;
+      if (threshold < epsilon()) threshold = epsilon();
+      if (error >= threshold) return false;
+
+      double ds = 0.5*mixture.ds();
+      if (ds < dsFinal_) ds = dsFinal_;
+      mixture.setDs(ds);
+      logFile() << " Refining contour step, ds = " << Dbl(ds) << "\n";
+      return true;
+   }
+
    template<int D>
    void AmIterator<D>::outputToLog()
    {
@@ -399,7 +539,7 @@ namespace Pspc{
          const int nParam = system().unitCell().nParameter();
          for (int i = 0; i < nParam; i++) {
             if (flexibleParams_[i]) {
-               Log::file() 
+               logFile() 
                       << " Cell Param  " << i << " = "
                       << Dbl(system().unitCell().parameters()[i], 15)
                       << " , stress = " 
@@ -45,7 +45,7 @@ namespace Pspc
       params.append(false); // parameter is not flexible
 
       if (iterator().flexibleParams()[0]) {
-         Log::file() 
+         system().logFile() 
             << "Warning - The lattice parameter is not allowed "
             << "to be flexible for a 1D thin film system."
             << std::endl;
@@ -122,7 +122,7 @@ namespace Pspc
       // Before updating iterator_.flexibleParams_, check if the number
       // of flexible lattice parameters has changed during this function.
       if (nFlexibleParams() < iterator().nFlexibleParams()) {
-         Log::file() 
+         system().logFile() 
             << "***Notice - Some lattice parameters will be held constant\n"
             << "to comply with the thin film constraint.***"
             << std::endl;
@@ -196,9 +196,10 @@ namespace Pspc
       // parameters are flexible.
       if (lattice == UnitCell<3>::Rhombohedral) {
 
-         Log::file() << "Rhombohedral lattice systems are not compatible "
-                     << "with a thin film constraint.\n"
-                     << "See thin film documentation for more details.\n";
+         system().logFile() 
+            << "Rhombohedral lattice systems are not compatible "
+            << "with a thin film constraint.\n"
+            << "See thin film documentation for more details.\n";
          UTIL_THROW("Cannot use rhombohedral lattice in a thin film system.");
 
       } else if (lattice == UnitCell<3>::Hexagonal) {
@@ -247,7 +248,7 @@ namespace Pspc
       // Before updating iterator_.flexibleParams_, check if the number
       // of flexible lattice parameters has changed during this function.
       if (nFlexibleParams() < iterator().nFlexibleParams()) {
-         Log::file() 
+         system().logFile() 
             << "***Notice - Some lattice parameters will be held constant\n"
             << "to comply with the thin film constraint.***"
             << std::endl;
@@ -77,6 +77,34 @@ namespace Pspc
       */
       int solve(bool isContinuation = false);
 
+      /**
+      * Get the error tolerance of the real iterator.
+      */
+      double epsilon() const
+      {  return iterator_.epsilon(); }
+
+      /**
+      * Set the error tolerance of the real iterator.
+      *
+      * \param epsilon  new error tolerance
+      */
+      void setEpsilon(double epsilon)
+      {  iterator_.setEpsilon(epsilon); }
+
+      /**
+      * Estimated error in the free energy, from the real iterator.
+      */
+      double fError() const
+      {  return iterator_.fError(); }
+
+      /**
+      * Reallocate memory after a change in mesh dimensions.
+      *
+      * Resets the real iterator, and marks the wall fields for 
+      * regeneration on the next call to setup.
+      */
+      void resetMesh();
+
       /**
       * Return const reference to the real iterator within this FilmIterator
       */
@@ -183,6 +211,31 @@ namespace Pspc
       */
       double wallThickness() const;
 
+      /**
+      * Get target grid spacing along normalVecId (0 if not set).
+      */
+      double normalSpacing() const;
+
+      /**
+      * Has the grid spacing along normalVecId drifted past tolerance?
+      *
+      * Always false if normalSpacing was not set in the param file.
+      * Updated whenever the wall fields are regenerated, i.e., whenever
+      * the lattice parameters change. If true, the mesh is changed at
+      * the beginning of the next solve (see setup).
+      */
+      bool needsRemesh() const;
+
+      /**
+      * Get the recommended number of grid points along normalVecId.
+      *
+      * Returns the smallest even integer with no prime factors other
+      * than 2, 3 and 5 that gives a grid spacing no larger than 
+      * normalSpacing for the current film thickness. Requires that
+      * normalSpacing was set in the param file.
+      */
+      int recommendedNormalMesh() const;
+
       /**
       * Get const chiBottom matrix by reference
       */
@@ -217,7 +270,9 @@ namespace Pspc
       * Allocate required memory, perform necessary checks to ensure user 
       * input is compatible with a film constraint, and create the mask / 
       * external fields that will be used to represent the walls during 
-      * iteration.
+      * iteration. If normalSpacing was set and the grid spacing normal
+      * to the walls has drifted past remeshTolerance, the mesh is first
+      * changed by remesh().
       */
       void setup();
       
@@ -274,6 +329,31 @@ namespace Pspc
 
       /// Flag indicating whether the wall fields are currently ungenerated
       bool ungenerated_;
+
+      /// Target grid spacing along normalVecId_ (0 = no check)
+      double normalSpacing_;
+
+      /// Allowed fractional deviation of grid spacing from normalSpacing_
+      double remeshTolerance_;
+
+      /// Has the normal grid spacing drifted past remeshTolerance_?
+      bool needsRemesh_;
+
+      /**
+      * Get length of the lattice basis vector normal to the walls.
+      */
+      double normalLength() const;
+
+      /**
+      * Compare normal grid spacing to target, set needsRemesh_.
+      */
+      void checkNormalSpacing();
+
+      /**
+      * Change the mesh dimension along normalVecId_ to the value given
+      * by recommendedNormalMesh(), by calling System::setMesh.
+      */
+      void remesh();
    };
 
    // Inline member functions
@@ -312,6 +392,16 @@ namespace Pspc
    const
    {  return t_; }
 
+   // Get target grid spacing along normalVecId
+   template <int D, typename IteratorType>
+   inline double FilmIteratorBase<D, IteratorType>::normalSpacing() const
+   {  return normalSpacing_; }
+
+   // Has the normal grid spacing drifted past tolerance?
+   template <int D, typename IteratorType>
+   inline bool FilmIteratorBase<D, IteratorType>::needsRemesh() const
+   {  return needsRemesh_; }
+
    // Get value of wallThickness
    template <int D, typename IteratorType>
    inline double FilmIteratorBase<D, IteratorType>::wallThickness() const
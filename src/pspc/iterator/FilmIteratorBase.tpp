@@ -42,7 +42,10 @@ namespace Pspc
       chiTop_(),
       chiBottomCurrent_(),
       chiTopCurrent_(),
-      ungenerated_(true)
+      ungenerated_(true),
+      normalSpacing_(0.0),
+      remeshTolerance_(0.25),
+      needsRemesh_(false)
    {  
       setClassName(iterator_.className().append("FilmBase").c_str());
       system.mask().setFieldIo(system.fieldIo());
@@ -99,6 +102,16 @@ namespace Pspc
       readDArray(in, "chiBottom", chiBottom_, nm);
       readDArray(in, "chiTop", chiTop_, nm);
 
+      // Optional target grid spacing normal to the walls
+      readOptional(in, "normalSpacing", normalSpacing_);
+      readOptional(in, "remeshTolerance", remeshTolerance_);
+      if (normalSpacing_ < 0.0) {
+         UTIL_THROW("normalSpacing must be >= 0");
+      }
+      if (remeshTolerance_ <= 0.0) {
+         UTIL_THROW("remeshTolerance must be > 0");
+      }
+
       // If lattice parameters are flexible, determine which parameters
       // are allowed to vary, store them in this object, and pass them
       // into iterator_. The flexibleParams_ member of the iterator_
@@ -118,6 +131,15 @@ namespace Pspc
       UTIL_CHECK(system().basis().isInitialized());
       UTIL_CHECK(system().unitCell().isInitialized());
 
+      // Change the mesh along normalVecId_ if the grid spacing has 
+      // drifted from normalSpacing_ by more than remeshTolerance_
+      if (normalSpacing_ > 0.0) {
+         checkNormalSpacing();
+         if (needsRemesh_) {
+            remesh();
+         }
+      }
+
       // Allocate the mask and external field containers if needed
       if (!system().mask().isAllocated()) {
          system().mask().allocate(system().basis().nBasis(), 
@@ -182,13 +204,7 @@ namespace Pspc
       checkLatticeVectors();
 
       // Get the length L of the lattice basis vector normal to the walls
-      RealVec<D> a;
-      a = system().domain().unitCell().rBasis(normalVecId_);
-      double norm_sqd(0.0); // norm squared
-      for (int i = 0; i < D; i++) {
-         norm_sqd += a[i]*a[i];
-      }
-      double L(sqrt(norm_sqd));
+      double L = normalLength();
 
       // Create a 3 element vector 'dim' that contains the grid dimensions.
       // If system is 2D (1D), then the z (y & z) dimensions are set to 1.
@@ -233,6 +249,9 @@ namespace Pspc
       // Store lattice parameters associated with this maskBasis
       parameters_ = system().domain().unitCell().parameters();
 
+      // Check resolution of the mesh for the new film thickness
+      checkNormalSpacing();
+
       // Generate external fields if needed
       generateExternalFields();
    }
@@ -306,13 +325,7 @@ namespace Pspc
       int nm = system().mixture().nMonomer();
 
       // Get length L of the lattice basis vector normal to the walls
-      RealVec<D> a;
-      a = system().domain().unitCell().rBasis(normalVecId_);
-      double norm_sqd(0.0); // norm squared
-      for (int i = 0; i < D; i++) {
-         norm_sqd += a[i]*a[i];
-      }
-      double L(sqrt(norm_sqd));
+      double L = normalLength();
 
       // Create a 3 element vector 'dim' that contains the grid 
       // dimensions. If system is 2D (1D), then the z (y and z) 
@@ -368,6 +381,90 @@ namespace Pspc
       system().h().setRGrid(hRGrid,true);
    }
 
+   /*
+   * Get length of the lattice basis vector normal to the walls.
+   */
+   template <int D, typename IteratorType>
+   double FilmIteratorBase<D, IteratorType>::normalLength() const
+   {
+      RealVec<D> a;
+      a = system().domain().unitCell().rBasis(normalVecId_);
+      double norm_sqd(0.0); // norm squared
+      for (int i = 0; i < D; i++) {
+         norm_sqd += a[i]*a[i];
+      }
+      return sqrt(norm_sqd);
+   }
+
+   /*
+   * Compare the grid spacing normal to the walls to normalSpacing_.
+   */
+   template <int D, typename IteratorType>
+   void FilmIteratorBase<D, IteratorType>::checkNormalSpacing()
+   {
+      if (normalSpacing_ <= 0.0) return;
+
+      int n = system().domain().mesh().dimension(normalVecId_);
+      double h = normalLength()/double(n);
+      needsRemesh_ = (fabs(h/normalSpacing_ - 1.0) > remeshTolerance_);
+   }
+
+   /*
+   * Change the number of grid points normal to the walls.
+   *
+   * The w fields (and the states of any sweep) are transferred to the
+   * new mesh by System::setMesh, which calls resetMesh. The wall mask 
+   * and external fields are then regenerated on the new mesh by setup.
+   */
+   template <int D, typename IteratorType>
+   void FilmIteratorBase<D, IteratorType>::remesh()
+   {
+      IntVec<D> dimensions = system().domain().mesh().dimensions();
+      int nOld = dimensions[normalVecId_];
+      int nNew = recommendedNormalMesh();
+      needsRemesh_ = false;
+      if (nNew == nOld) return;
+
+      system().logFile() << "\nGrid spacing normal to walls deviates from "
+                         << "normalSpacing by more than remeshTolerance.\n"
+                         << "Changing mesh dimension " << normalVecId_ 
+                         << " from " << nOld << " to " << nNew << "\n";
+      dimensions[normalVecId_] = nNew;
+      system().setMesh(dimensions);
+   }
+
+   /*
+   * Reallocate memory after a change in mesh dimensions.
+   */
+   template <int D, typename IteratorType>
+   void FilmIteratorBase<D, IteratorType>::resetMesh()
+   {
+      iterator_.resetMesh();
+      ungenerated_ = true;
+   }
+
+   /*
+   * Get recommended number of grid points normal to the walls.
+   */
+   template <int D, typename IteratorType>
+   int FilmIteratorBase<D, IteratorType>::recommendedNormalMesh() const
+   {
+      UTIL_CHECK(normalSpacing_ > 0.0);
+      int n = (int) ceil(normalLength()/normalSpacing_);
+      if (n < 2) n = 2;
+      int m;
+      while (true) {
+         if (n % 2 == 0) {
+            m = n;
+            while (m % 2 == 0) m /= 2;
+            while (m % 3 == 0) m /= 3;
+            while (m % 5 == 0) m /= 5;
+            if (m == 1) return n;
+         }
+         ++n;
+      }
+   }
+
    /*
    * Check that user-defined space group is compatible 
    * with the thin film constraint
@@ -403,9 +500,9 @@ namespace Pspc
                in >> group;
                UTIL_CHECK(group.isValid());
             } else {
-               Log::file() << "\nFailed to open group file: " 
-                           << fileName << "\n";
-               Log::file() << "\n Error: Unknown space group\n";
+               system().logFile() << "\nFailed to open group file: " 
+                                  << fileName << "\n";
+               system().logFile() << "\n Error: Unknown space group\n";
                UTIL_THROW("Unknown space group");
             }
          } 
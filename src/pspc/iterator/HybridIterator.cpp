@@ -0,0 +1,18 @@
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "HybridIterator.tpp"
+
+namespace Pscf {
+namespace Pspc {
+
+   template class HybridIterator<1>;
+   template class HybridIterator<2>;
+   template class HybridIterator<3>;
+
+}
+}
@@ -0,0 +1,208 @@
+#ifndef PSPC_HYBRID_ITERATOR_H
+#define PSPC_HYBRID_ITERATOR_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "AmIterator.h"                   // base class
+#include <pscf/math/LuSolver.h>           // member
+#include <util/containers/DArray.h>       // member template
+#include <util/containers/DMatrix.h>      // member template
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template <int D>
+   class System;
+
+   using namespace Util;
+
+   /**
+   * Hybrid Newton / Anderson mixing iterator.
+   *
+   * This iterator treats the field components associated with the
+   * lowest-wavenumber basis functions (stars) by a Newton method and
+   * all other components by Anderson mixing. Slowly relaxing modes of
+   * the SCF problem are concentrated in a small number of low |G|
+   * stars, while high |G| components relax rapidly under simple mixing.
+   *
+   * A dense Jacobian of the residuals with respect to the w field
+   * components of the lowest stars is computed by finite differences,
+   * using one solution of the modified diffusion equation per column.
+   * In each iteration, the Anderson mixing step is performed as in the
+   * parent AmIterator for all other components. Within the low |G| 
+   * block, the Anderson trial is replaced by a Newton step taken from
+   * the current field, using the current residual and the LU 
+   * decomposition of the Jacobian, which is evaluated at a current 
+   * field. The Jacobian is recomputed at the start of each solve, 
+   * after any refinement of the contour step, and optionally at a
+   * fixed interval of iterations.
+   *
+   * By default, the number of stars in the Newton block is chosen
+   * automatically, by including all stars for which |G| Rg < kRgMax,
+   * where Rg is the largest unperturbed radius of gyration of any
+   * polymer species, up to a maximum of maxStar stars.
+   *
+   * \ingroup Pspc_Iterator_Module
+   */
+   template <int D>
+   class HybridIterator : public AmIterator<D>
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system System object associated with this iterator.
+      */
+      HybridIterator(System<D>& system);
+
+      /**
+      * Destructor.
+      */
+      ~HybridIterator();
+
+      /**
+      * Read all parameters and initialize.
+      *
+      * \param in input filestream
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Number of stars (basis functions) treated by Newton's method.
+      *
+      * Returns 0 before the first call to solve.
+      */
+      int nNewtonStar() const
+      {  return endStar_ - beginStar_; }
+
+      /**
+      * Reallocate memory after a change in mesh dimensions.
+      *
+      * Stars in the Newton block are selected again on the next solve.
+      */
+      void resetMesh();
+
+      // Inherited public member functions
+      using AmIterator<D>::solve;
+      using Iterator<D>::isFlexible;
+
+   protected:
+
+      // Inherited protected members
+      using ParamComposite::readOptional;
+      using ParamComposite::setClassName;
+      using AmIterator<D>::verbose;
+      using AmIterator<D>::system;
+      using AmIterator<D>::getCurrent;
+      using AmIterator<D>::getResidual;
+      using AmIterator<D>::update;
+      using AmIterator<D>::evaluate;
+      using AmIterator<D>::field;
+      using AmIterator<D>::residual;
+
+      /**
+      * Setup iterator just before entering iteration loop.
+      *
+      * \param isContinuation Is this a continuation within a sweep?
+      */
+      void setup(bool isContinuation);
+
+      /**
+      * Refine the contour step, and invalidate the Jacobian if refined.
+      *
+      * \param error  scalar error for the current state
+      * \return true iff the contour step was changed
+      */
+      bool refine(double error);
+
+   private:
+
+      /// Jacobian of low |G| residuals w.r.t. low |G| field components.
+      DMatrix<double> jacobian_;
+
+      /// LU solver for the Jacobian.
+      LuSolver solver_;
+
+      /// Current residual and Newton correction for the low |G| block.
+      DArray<double> rLow_, dLow_;
+
+      /// Full field and residual vectors used to compute the Jacobian.
+      DArray<double> fieldRef_, fieldPert_, residRef_, residPert_;
+
+      /// Maximum value of |G| Rg for automatically selected stars.
+      double kRgMax_;
+
+      /// Finite difference step used to compute the Jacobian.
+      double fdStep_;
+
+      /// Number of stars in Newton block, if set explicitly (0 = auto).
+      int nStar_;
+
+      /// Maximum number of automatically selected stars.
+      int maxStar_;
+
+      /// Recompute Jacobian every jacobianInterval_ iterations (0 = once per solve).
+      int jacobianInterval_;
+
+      /// First star in Newton block (1 in canonical ensemble, else 0).
+      int beginStar_;
+
+      /// One past the last star in Newton block.
+      int endStar_;
+
+      /// Number of elements in Newton block (nMonomer*nNewtonStar).
+      int nLow_;
+
+      /// Number of iterations since entry to current solve.
+      int counter_;
+
+      /// Is the current Jacobian valid?
+      bool hasJacobian_;
+
+      /// Have the stars in the Newton block been selected?
+      bool isSelected_;
+
+      /**
+      * Choose the stars included in the Newton block, allocate memory.
+      */
+      void selectStars();
+
+      /**
+      * Compute the Jacobian by finite differences and factorize it.
+      */
+      void computeJacobian();
+
+      /**
+      * Add simple mixing correction, replace low |G| block by Newton step.
+      *
+      * The Newton step is taken from the current field with the current
+      * residual, because the Jacobian is evaluated at a current field.
+      *
+      * \param fieldTrial trial field (in-out)
+      * \param resTrial predicted residual for current trial
+      * \param lambda simple mixing parameter for high |G| components
+      */
+      void addPredictedError(DArray<double>& fieldTrial,
+                             DArray<double> const & resTrial,
+                             double lambda);
+
+   };
+
+   #ifndef PSPC_HYBRID_ITERATOR_TPP
+   // Suppress implicit instantiation
+   extern template class HybridIterator<1>;
+   extern template class HybridIterator<2>;
+   extern template class HybridIterator<3>;
+   #endif
+
+} // namespace Pspc
+} // namespace Pscf
+#endif
@@ -0,0 +1,282 @@
+#ifndef PSPC_HYBRID_ITERATOR_TPP
+#define PSPC_HYBRID_ITERATOR_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "HybridIterator.h"
+#include <pspc/System.h>
+#include <util/global.h>
+#include <cmath>
+
+namespace Pscf{
+namespace Pspc{
+
+   using namespace Util;
+
+   // Constructor
+   template <int D>
+   HybridIterator<D>::HybridIterator(System<D>& system)
+    : AmIterator<D>(system),
+      kRgMax_(3.0),
+      fdStep_(1.0E-5),
+      nStar_(0),
+      maxStar_(40),
+      jacobianInterval_(0),
+      beginStar_(0),
+      endStar_(0),
+      nLow_(0),
+      counter_(0),
+      hasJacobian_(false),
+      isSelected_(false)
+   {  setClassName("HybridIterator"); }
+
+   // Destructor
+   template <int D>
+   HybridIterator<D>::~HybridIterator()
+   {}
+
+   // Read parameters from file
+   template <int D>
+   void HybridIterator<D>::readParameters(std::istream& in)
+   {
+      // Read all AmIterator parameters
+      AmIterator<D>::readParameters(in);
+
+      // Optional parameters for the Newton block
+      readOptional(in, "nStar", nStar_);
+      readOptional(in, "maxStar", maxStar_);
+      readOptional(in, "kRgMax", kRgMax_);
+      readOptional(in, "fdStep", fdStep_);
+      readOptional(in, "jacobianInterval", jacobianInterval_);
+      UTIL_CHECK(nStar_ >= 0);
+      UTIL_CHECK(maxStar_ > 0);
+      UTIL_CHECK(kRgMax_ > 0.0);
+      UTIL_CHECK(fdStep_ > 0.0);
+      UTIL_CHECK(jacobianInterval_ >= 0);
+   }
+
+   // Setup before entering iteration loop
+   template <int D>
+   void HybridIterator<D>::setup(bool isContinuation)
+   {
+      AmIterator<D>::setup(isContinuation);
+      if (!isSelected_) {
+         selectStars();
+      }
+      counter_ = 0;
+
+      // Recompute Jacobian at the start of every solve, because the 
+      // fields and parameters may have changed since the last one
+      hasJacobian_ = false;
+   }
+
+   /*
+   * Refine contour step. The Jacobian is invalid after a refinement.
+   */
+   template <int D>
+   bool HybridIterator<D>::refine(double error)
+   {
+      bool isRefined = AmIterator<D>::refine(error);
+      if (isRefined) {
+         hasJacobian_ = false;
+      }
+      return isRefined;
+   }
+
+   /*
+   * Release Newton block memory after a change in mesh dimensions.
+   */
+   template <int D>
+   void HybridIterator<D>::resetMesh()
+   {
+      AmIterator<D>::resetMesh();
+      if (isSelected_ && nLow_ > 0) {
+         jacobian_.deallocate();
+         solver_.deallocate();
+         rLow_.deallocate();
+         dLow_.deallocate();
+         fieldRef_.deallocate();
+         fieldPert_.deallocate();
+         residRef_.deallocate();
+         residPert_.deallocate();
+      }
+      isSelected_ = false;
+      hasJacobian_ = false;
+   }
+
+   /*
+   * Choose the stars treated by Newton's method.
+   */
+   template <int D>
+   void HybridIterator<D>::selectStars()
+   {
+      Mixture<D> const & mixture = system().mixture();
+      Basis<D> const & basis = system().basis();
+      const int nMonomer = mixture.nMonomer();
+      const int nBasis = basis.nBasis();
+
+      // The homogeneous component is fixed in the canonical ensemble
+      beginStar_ = mixture.isCanonical() ? 1 : 0;
+
+      if (nStar_ > 0) {
+         endStar_ = beginStar_ + nStar_;
+      } else {
+
+         // Largest unperturbed squared radius of gyration
+         double rgSq = 0.0;
+         double sum;
+         int i, j;
+         for (i = 0; i < mixture.nPolymer(); ++i) {
+            sum = 0.0;
+            for (j = 0; j < mixture.polymer(i).nBlock(); ++j) {
+               Block<D> const & block = mixture.polymer(i).block(j);
+               sum += block.length()*block.kuhn()*block.kuhn()/6.0;
+            }
+            if (sum > rgSq) rgSq = sum;
+         }
+
+         // Basis functions are listed in order of increasing |G|
+         double kSqMax = kRgMax_*kRgMax_;
+         double kSq;
+         endStar_ = beginStar_;
+         while (endStar_ < nBasis && endStar_ - beginStar_ < maxStar_) {
+            kSq = system().unitCell().ksq(
+                              basis.basisFunction(endStar_).waveBz);
+            if (kSq*rgSq > kSqMax) break;
+            ++endStar_;
+         }
+      }
+      if (endStar_ > nBasis) endStar_ = nBasis;
+      nLow_ = nMonomer*(endStar_ - beginStar_);
+      isSelected_ = true;
+
+      system().logFile() << "HybridIterator: Newton block contains "
+                         << endStar_ - beginStar_ << " stars ("
+                         << nLow_ << " field components)" << std::endl;
+      if (nLow_ == 0) return;
+
+      // Allocate memory
+      const int nEle = nMonomer*nBasis +
+                       (isFlexible() ? this->nFlexibleParams() : 0);
+      jacobian_.allocate(nLow_, nLow_);
+      solver_.allocate(nLow_);
+      rLow_.allocate(nLow_);
+      dLow_.allocate(nLow_);
+      fieldRef_.allocate(nEle);
+      fieldPert_.allocate(nEle);
+      residRef_.allocate(nEle);
+      residPert_.allocate(nEle);
+   }
+
+   /*
+   * Compute Jacobian of the low |G| block by finite differences.
+   *
+   * On entry, the system must have been evaluated for the current field.
+   * On exit, the w fields are restored, but the c fields correspond to
+   * the last perturbed state. This is harmless because the caller
+   * (AmIteratorTmpl::updateGuess) updates the fields and the system is
+   * then re-evaluated before the c fields are used again.
+   */
+   template <int D>
+   void HybridIterator<D>::computeJacobian()
+   {
+      const int nBasis = system().basis().nBasis();
+      const int nMonomer = system().mixture().nMonomer();
+      const int nStar = endStar_ - beginStar_;
+
+      if (verbose() > 0) {
+         system().logFile() << "\n Computing Jacobian of Newton block ("
+                            << nLow_ << " columns)";
+      }
+
+      getCurrent(fieldRef_);
+      getResidual(residRef_);
+
+      int i, k, a, m, col, row;
+      for (i = 0; i < nMonomer; ++i) {
+         for (k = beginStar_; k < endStar_; ++k) {
+            col = i*nStar + k - beginStar_;
+
+            // Evaluate residual for perturbed field
+            fieldPert_ = fieldRef_;
+            fieldPert_[i*nBasis + k] += fdStep_;
+            update(fieldPert_);
+            evaluate();
+            getResidual(residPert_);
+
+            for (a = 0; a < nMonomer; ++a) {
+               for (m = beginStar_; m < endStar_; ++m) {
+                  row = a*nStar + m - beginStar_;
+                  jacobian_(row, col) = (residPert_[a*nBasis + m]
+                                       - residRef_[a*nBasis + m])/fdStep_;
+               }
+            }
+         }
+      }
+
+      // Restore w fields and unit cell
+      update(fieldRef_);
+
+      solver_.computeLU(jacobian_);
+      hasJacobian_ = true;
+   }
+
+   /*
+   * Apply Newton step to low |G| block and simple mixing to the rest.
+   *
+   * The Jacobian is evaluated at a current (not trial) field, so the
+   * Newton step in the low |G| block is taken from the current field
+   * field() using the current residual residual(), and replaces the 
+   * Anderson trial in that block.
+   */
+   template <int D>
+   void
+   HybridIterator<D>::addPredictedError(DArray<double>& fieldTrial,
+                                        DArray<double> const & resTrial,
+                                        double lambda)
+   {
+      const int n = fieldTrial.capacity();
+
+      // Simple mixing for all components
+      for (int i = 0; i < n; i++) {
+         fieldTrial[i] += lambda * resTrial[i];
+      }
+      if (nLow_ == 0) return;
+
+      // Update Jacobian if needed
+      if (!hasJacobian_ || (jacobianInterval_ > 0 && counter_ > 0
+                            && counter_ % jacobianInterval_ == 0)) {
+         computeJacobian();
+      }
+      ++counter_;
+
+      // Newton step from current field replaces the low |G| block
+      DArray<double> const & current = field();
+      DArray<double> const & resid = residual();
+      const int nBasis = system().basis().nBasis();
+      const int nMonomer = system().mixture().nMonomer();
+      const int nStar = endStar_ - beginStar_;
+      int i, k, idx, row;
+      for (i = 0; i < nMonomer; ++i) {
+         for (k = beginStar_; k < endStar_; ++k) {
+            rLow_[i*nStar + k - beginStar_] = resid[i*nBasis + k];
+         }
+      }
+      solver_.solve(rLow_, dLow_);
+      for (i = 0; i < nMonomer; ++i) {
+         for (k = beginStar_; k < endStar_; ++k) {
+            idx = i*nBasis + k;
+            row = i*nStar + k - beginStar_;
+            fieldTrial[idx] = current[idx] - dLow_[row];
+         }
+      }
+   }
+
+}
+}
+#endif
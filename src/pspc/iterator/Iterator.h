@@ -57,6 +57,42 @@ namespace Pspc
       */
       virtual int solve(bool isContinuation) = 0;
 
+      /**
+      * Get the error tolerance used to test for convergence.
+      *
+      * The default implementation throws an Exception. Subclasses 
+      * that allow the tolerance to be modified must override this.
+      */
+      virtual double epsilon() const;
+
+      /**
+      * Set the error tolerance used to test for convergence.
+      *
+      * The default implementation throws an Exception.
+      *
+      * \param epsilon  new error tolerance
+      */
+      virtual void setEpsilon(double epsilon);
+
+      /**
+      * Estimated error in the free energy after the last solve.
+      *
+      * Returns a negative value if no estimate is available, which is
+      * the behavior of the default implementation.
+      */
+      virtual double fError() const
+      {  return -1.0; }
+
+      /**
+      * Reallocate any memory that depends on the mesh.
+      *
+      * Called by System::setMesh after a change in mesh dimensions, 
+      * which changes the number of basis functions. The default 
+      * implementation does nothing.
+      */
+      virtual void resetMesh()
+      {}
+
       /**
       * Return true iff unit cell has any flexible lattice parameters.
       */
@@ -131,6 +167,19 @@ namespace Pspc
    Iterator<D>::~Iterator()
    {}
 
+   // Get the error tolerance (default implementation)
+   template <int D>
+   double Iterator<D>::epsilon() const
+   {
+      UTIL_THROW("This iterator does not provide epsilon()");
+      return 0.0;
+   }
+
+   // Set the error tolerance (default implementation)
+   template <int D>
+   void Iterator<D>::setEpsilon(double epsilon)
+   {  UTIL_THROW("This iterator does not provide setEpsilon()"); }
+
    // Get the number of flexible lattice parameters
    template <int D>
    int Iterator<D>::nFlexibleParams() const
@@ -5,6 +5,7 @@
 
 // Subclasses of Iterator 
 #include "AmIterator.h"
+#include "HybridIterator.h"
 #include "FilmIterator.h"
 
 namespace Pscf {
@@ -35,6 +36,8 @@ namespace Pspc {
       // Try to match classname
       if (className == "Iterator" || className == "AmIterator") {
          ptr = new AmIterator<D>(*sysPtr_);
+      } else if (className == "HybridIterator") {
+         ptr = new HybridIterator<D>(*sysPtr_);
       } else if (className == "AmIteratorFilm") {
          ptr = new FilmIterator<D, AmIterator<D> >(*sysPtr_);
       }
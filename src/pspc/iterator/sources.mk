@@ -1,6 +1,7 @@
 pspc_iterator_= \
   pspc/iterator/IteratorFactory.cpp \
   pspc/iterator/AmIterator.cpp \
+  pspc/iterator/HybridIterator.cpp \
   pspc/iterator/FilmIterator.cpp \
 
 pspc_iterator_SRCS=\
@@ -0,0 +1,19 @@
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "ConvergenceStudy.tpp"
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template class ConvergenceStudy<1>;
+   template class ConvergenceStudy<2>;
+   template class ConvergenceStudy<3>;
+
+} // namespace Pspc
+} // namespace Pscf
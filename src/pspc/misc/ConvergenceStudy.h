@@ -0,0 +1,298 @@
+#ifndef PSPC_CONVERGENCE_STUDY_H
+#define PSPC_CONVERGENCE_STUDY_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <pscf/math/IntVec.h>              // member template
+#include <util/containers/DArray.h>        // member template
+#include <util/containers/DMatrix.h>       // member template
+#include <iostream>
+#include <string>
+
+namespace Pscf {
+namespace Pspc {
+
+   template <int D> class System;
+
+   using namespace Util;
+
+   /**
+   * Discretization convergence study for a converged solution.
+   *
+   * A ConvergenceStudy re-solves the SCFT problem for the current state
+   * of a parent System over two ladders of discretizations:
+   *
+   *   - A contour ladder, with target contour step sizes
+   *     ds_k = dsMax/2^k for k = 0, ..., nLevel - 1, solved on the
+   *     initial spatial mesh. The solution at each level is used as
+   *     the initial guess for the next.
+   *
+   *   - An optional mesh ladder with nMeshLevel levels, solved with
+   *     the initial contour step size. Level nMeshLevel - 1 is the
+   *     initial mesh, and each coarser level halves every mesh
+   *     dimension. Levels are solved from finest to coarsest, and
+   *     fields are carried between levels by spectral remeshing
+   *     (see System::setMesh).
+   *
+   * For each level, the Helmholtz free energy per monomer, the
+   * pressure, the chemical potential of every species and the stress
+   * (or the lattice parameters, if the iterator is flexible) are
+   * recorded, along with the wall clock time required to converge and
+   * the time per solution of the modified diffusion equation (i.e.,
+   * per iteration). The free energy, pressure and chemical potentials
+   * are the quantities that determine phase boundaries.
+   *
+   * For each ladder, the results for the three finest levels are used
+   * to fit a Richardson error model Q(h) = Q* + A h^p for each quantity
+   * Q, where h is ds for the contour ladder or the mesh spacing
+   * relative to the initial mesh for the mesh ladder. The fits give
+   * the error at each level and the largest h consistent with the
+   * tolerances. The cheapest level of each ladder for which the errors
+   * in the free energy and pressure are below fTolerance and the
+   * errors in all cell quantities are below stressTolerance is
+   * reported as the recommended discretization. Errors in chemical
+   * potentials are reported, but are not used to choose a level.
+   *
+   * Upon return from compute(), the System is restored to its initial
+   * mesh, w fields, unit cell and contour step size.
+   *
+   * \ingroup Pspc_Misc_Module
+   */
+   template <int D>
+   class ConvergenceStudy
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system  parent System
+      */
+      ConvergenceStudy(System<D>& system);
+
+      /**
+      * Destructor.
+      */
+      ~ConvergenceStudy();
+
+      /**
+      * Set the ladder of contour step sizes.
+      *
+      * \param dsMax  largest (coarsest) target step size
+      * \param nLevel  number of levels (nLevel >= 3)
+      */
+      void setLadder(double dsMax, int nLevel);
+
+      /**
+      * Set the number of levels in the ladder of spatial meshes.
+      *
+      * Every dimension of the current mesh must be divisible by
+      * 2^(nMeshLevel - 1). A value of zero disables the mesh ladder.
+      *
+      * \param nMeshLevel  number of mesh levels (0 or >= 3)
+      */
+      void setMeshLadder(int nMeshLevel);
+
+      /**
+      * Set error tolerances used to choose recommended levels.
+      *
+      * \param fTolerance  tolerance for fHelmholtz and pressure
+      * \param stressTolerance  tolerance for stress or lattice parameters
+      */
+      void setTolerances(double fTolerance, double stressTolerance);
+
+      /**
+      * Solve at every level, fit error models and choose levels.
+      *
+      * \pre The parent system must have converged w fields.
+      */
+      void compute();
+
+      /**
+      * Write a report of the results to an output stream.
+      *
+      * \param out  output stream
+      */
+      void output(std::ostream& out) const;
+
+      /**
+      * Recommended target step size (cheapest level meeting tolerances).
+      *
+      * Returns a negative value if no level meets the tolerances.
+      */
+      double recommendedDs() const;
+
+      /**
+      * Recommended mesh dimensions (cheapest level meeting tolerances).
+      *
+      * Returns a vector of zeros if no level meets the tolerances or
+      * if the mesh ladder is disabled.
+      */
+      IntVec<D> recommendedMesh() const;
+
+   private:
+
+      /**
+      * Results for one ladder of discretizations.
+      */
+      struct Ladder
+      {
+
+         /// Step size h of each level (ds or relative mesh spacing).
+         DArray<double> h;
+
+         /// Number of contour points or mesh points of each level.
+         DArray<int> nPoint;
+
+         /// Iterator error flag for each level (0 for success).
+         DArray<int> error;
+
+         /// Values of all quantities (rows = levels).
+         DMatrix<double> q;
+
+         /// Wall clock time for convergence at each level.
+         DArray<double> solveTime;
+
+         /// Wall clock time per MDE solution at each level.
+         DArray<double> mdeTime;
+
+         /// Fitted Richardson model parameters, for each quantity.
+         DArray<double> exact, amplitude, order;
+
+         /// Model estimate of largest h meeting all tolerances.
+         double modelH;
+
+         /// Index of recommended level (-1 if none).
+         int recommended;
+
+         /// Number of levels.
+         int nLevel;
+
+      };
+
+      /// Results of the contour step size ladder.
+      Ladder dsLadder_;
+
+      /// Results of the mesh ladder.
+      Ladder meshLadder_;
+
+      /// Mesh dimensions for each level of the mesh ladder.
+      DArray< IntVec<D> > meshes_;
+
+      /// Names of all recorded quantities.
+      DArray<std::string> names_;
+
+      /// Error tolerances.
+      double fTolerance_, stressTolerance_;
+
+      /// Relative magnitude of outer spectral coefficients.
+      double spectralTail_;
+
+      /// Pointer to parent System.
+      System<D>* systemPtr_;
+
+      /// Maximum contour step size (coarsest level).
+      double dsMax_;
+
+      /// Number of unit cell parameters.
+      int nParameter_;
+
+      /// Number of recorded quantities.
+      int nQuantity_;
+
+      /// Is the iterator flexible (cell data = lattice parameters)?
+      bool isFlexible_;
+
+      /// Has compute() been called successfully?
+      bool hasResults_;
+
+      /**
+      * Allocate all arrays of a Ladder, or reallocate if sizes differ.
+      *
+      * \param ladder  Ladder object
+      * \param nLevel  number of levels
+      */
+      void allocateLadder(Ladder& ladder, int nLevel);
+
+      /**
+      * Converge the system at one level and record results.
+      *
+      * \param ladder  Ladder object
+      * \param k  level index
+      */
+      void solveLevel(Ladder& ladder, int k);
+
+      /**
+      * Fit error models and choose the recommended level of a ladder.
+      *
+      * \param ladder  Ladder object
+      */
+      void analyze(Ladder& ladder);
+
+      /**
+      * Fit model Q(h) = exact + amplitude*h^order to finest levels.
+      *
+      * \param ladder  Ladder object with results for all levels
+      * \param j  index of quantity Q
+      */
+      void fitModel(Ladder& ladder, int j) const;
+
+      /**
+      * Write results of one ladder.
+      *
+      * \param out  output stream
+      * \param ladder  Ladder object
+      * \param isMesh  is this the mesh ladder?
+      */
+      void outputLadder(std::ostream& out, Ladder const & ladder,
+                        bool isMesh) const;
+
+      /**
+      * Compute the spectral tail of the current c fields.
+      */
+      double computeSpectralTail() const;
+
+      /// Get parent System by reference.
+      System<D>& system()
+      {  return *systemPtr_; }
+
+   };
+
+   // Inline functions
+
+   template <int D>
+   inline double ConvergenceStudy<D>::recommendedDs() const
+   {
+      if (dsLadder_.recommended < 0) return -1.0;
+      return dsLadder_.h[dsLadder_.recommended];
+   }
+
+   template <int D>
+   inline IntVec<D> ConvergenceStudy<D>::recommendedMesh() const
+   {
+      IntVec<D> dimensions;
+      for (int i = 0; i < D; ++i) {
+         dimensions[i] = 0;
+      }
+      if (meshLadder_.nLevel > 0 && meshLadder_.recommended >= 0) {
+         dimensions = meshes_[meshLadder_.recommended];
+      }
+      return dimensions;
+   }
+
+   #ifndef PSPC_CONVERGENCE_STUDY_TPP
+   // Suppress implicit instantiation
+   extern template class ConvergenceStudy<1>;
+   extern template class ConvergenceStudy<2>;
+   extern template class ConvergenceStudy<3>;
+   #endif
+
+} // namespace Pspc
+} // namespace Pscf
+#endif
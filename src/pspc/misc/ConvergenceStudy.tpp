@@ -0,0 +1,557 @@
+#ifndef PSPC_CONVERGENCE_STUDY_TPP
+#define PSPC_CONVERGENCE_STUDY_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "ConvergenceStudy.h"
+#include <pspc/System.h>
+#include <pspc/iterator/Iterator.h>
+#include <pspc/sweep/BasisFieldState.h>
+#include <util/misc/Timer.h>
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+#include <util/format/Str.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace Pscf {
+namespace Pspc
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   template <int D>
+   ConvergenceStudy<D>::ConvergenceStudy(System<D>& system)
+    : fTolerance_(1.0E-6),
+      stressTolerance_(1.0E-4),
+      spectralTail_(0.0),
+      systemPtr_(&system),
+      dsMax_(0.0),
+      nParameter_(0),
+      nQuantity_(0),
+      isFlexible_(false),
+      hasResults_(false)
+   {
+      dsLadder_.nLevel = 0;
+      dsLadder_.recommended = -1;
+      dsLadder_.modelH = -1.0;
+      meshLadder_.nLevel = 0;
+      meshLadder_.recommended = -1;
+      meshLadder_.modelH = -1.0;
+   }
+
+   /*
+   * Destructor.
+   */
+   template <int D>
+   ConvergenceStudy<D>::~ConvergenceStudy()
+   {}
+
+   /*
+   * Set ladder of target contour step sizes, ds_k = dsMax/2^k.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::setLadder(double dsMax, int nLevel)
+   {
+      UTIL_CHECK(dsMax > 0.0);
+      UTIL_CHECK(nLevel >= 3);
+      dsMax_ = dsMax;
+      dsLadder_.nLevel = nLevel;
+      hasResults_ = false;
+   }
+
+   /*
+   * Set ladder of meshes, halving each dimension at each coarser level.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::setMeshLadder(int nMeshLevel)
+   {
+      UTIL_CHECK(nMeshLevel == 0 || nMeshLevel >= 3);
+      meshLadder_.nLevel = nMeshLevel;
+      hasResults_ = false;
+      if (nMeshLevel == 0) return;
+
+      IntVec<D> dimensions = system().mesh().dimensions();
+      int factor = 1 << (nMeshLevel - 1);
+      int i, k;
+      for (i = 0; i < D; ++i) {
+         if (dimensions[i] % factor != 0) {
+            UTIL_THROW("Mesh dimensions not divisible by 2^(nMeshLevel-1)");
+         }
+      }
+      if (meshes_.isAllocated() && meshes_.capacity() != nMeshLevel) {
+         meshes_.deallocate();
+      }
+      if (!meshes_.isAllocated()) {
+         meshes_.allocate(nMeshLevel);
+      }
+      for (k = nMeshLevel - 1; k >= 0; --k) {
+         meshes_[k] = dimensions;
+         for (i = 0; i < D; ++i) {
+            dimensions[i] /= 2;
+         }
+      }
+   }
+
+   /*
+   * Set error tolerances.
+   */
+   template <int D>
+   void
+   ConvergenceStudy<D>::setTolerances(double fTolerance,
+                                      double stressTolerance)
+   {
+      UTIL_CHECK(fTolerance > 0.0);
+      UTIL_CHECK(stressTolerance > 0.0);
+      fTolerance_ = fTolerance;
+      stressTolerance_ = stressTolerance;
+   }
+
+   /*
+   * Solve at every level of both ladders and analyze results.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::compute()
+   {
+      UTIL_CHECK(dsLadder_.nLevel >= 3);
+      UTIL_CHECK(system().w().hasData());
+      UTIL_CHECK(system().w().isSymmetric());
+
+      Mixture<D>& mixture = system().mixture();
+      isFlexible_ = system().iterator().isFlexible();
+      nParameter_ = system().unitCell().nParameter();
+      int np = mixture.nPolymer();
+      int ns = mixture.nSolvent();
+      nQuantity_ = 2 + np + ns + nParameter_;
+
+      // Names of recorded quantities
+      if (names_.isAllocated() && names_.capacity() != nQuantity_) {
+         names_.deallocate();
+      }
+      if (!names_.isAllocated()) {
+         names_.allocate(nQuantity_);
+      }
+      std::string cellName = isFlexible_ ? "lattice" : "stress";
+      int i, j, k;
+      names_[0] = "fHelmholtz";
+      names_[1] = "pressure";
+      for (i = 0; i < np; ++i) {
+         names_[2 + i] = "mu_polymer[" + std::to_string(i) + "]";
+      }
+      for (i = 0; i < ns; ++i) {
+         names_[2 + np + i] = "mu_solvent[" + std::to_string(i) + "]";
+      }
+      for (i = 0; i < nParameter_; ++i) {
+         names_[2 + np + ns + i] = cellName + "[" + std::to_string(i) + "]";
+      }
+
+      // Allocate arrays for results and set step sizes
+      allocateLadder(dsLadder_, dsLadder_.nLevel);
+      double ds = dsMax_;
+      for (k = 0; k < dsLadder_.nLevel; ++k) {
+         dsLadder_.h[k] = ds;
+         ds *= 0.5;
+      }
+      const int nMesh = meshLadder_.nLevel;
+      if (nMesh > 0) {
+         UTIL_CHECK(meshes_.capacity() == nMesh);
+         allocateLadder(meshLadder_, nMesh);
+         double h = 1.0;
+         for (k = nMesh - 1; k >= 0; --k) {
+            meshLadder_.h[k] = h;
+            h *= 2.0;
+         }
+      }
+
+      // Save initial state, to be restored on return
+      double dsInitial = mixture.ds();
+      IntVec<D> meshInitial = system().mesh().dimensions();
+      BasisFieldState<D> initial(system());
+      initial.getSystemState();
+
+      // Contour ladder, on the initial mesh
+      for (k = 0; k < dsLadder_.nLevel; ++k) {
+         system().logFile() << std::endl;
+         system().logFile() << "Convergence study ds level " << k
+                            << ", ds = " << Dbl(dsLadder_.h[k])
+                            << std::endl;
+
+         mixture.setDs(dsLadder_.h[k]);
+         dsLadder_.nPoint[k] = 0;
+         for (i = 0; i < np; ++i) {
+            for (j = 0; j < mixture.polymer(i).nBlock(); ++j) {
+               if (mixture.polymer(i).multiplicity(j) == 0) continue;
+               dsLadder_.nPoint[k] += mixture.polymer(i).block(j).ns();
+            }
+         }
+
+         // Converge, starting from the solution at the previous level
+         solveLevel(dsLadder_, k);
+         if (dsLadder_.error[k]) {
+            initial.setSystemState(isFlexible_);
+         }
+      }
+
+      // Spectral resolution indicator, from finest level c fields
+      spectralTail_ = 0.0;
+      if (!dsLadder_.error[dsLadder_.nLevel - 1]) {
+         spectralTail_ = computeSpectralTail();
+      }
+
+      // Mesh ladder, with the initial ds, from finest to coarsest
+      if (nMesh > 0) {
+         mixture.setDs(dsInitial);
+         initial.setSystemState(isFlexible_);
+         int current = nMesh - 1; // Level of current mesh
+         for (k = nMesh - 1; k >= 0; --k) {
+            system().logFile() << std::endl;
+            system().logFile() << "Convergence study mesh level " << k
+                               << ", mesh = " << meshes_[k] << std::endl;
+
+            // Remesh, starting from the solution at the finer level
+            if (k != current) {
+               system().setMesh(meshes_[k]);
+               current = k;
+            }
+            meshLadder_.nPoint[k] = system().mesh().size();
+
+            solveLevel(meshLadder_, k);
+            if (meshLadder_.error[k]) {
+               if (current != nMesh - 1) {
+                  system().setMesh(meshInitial);
+                  current = nMesh - 1;
+               }
+               initial.setSystemState(isFlexible_);
+            }
+         }
+         if (current != nMesh - 1) {
+            system().setMesh(meshInitial);
+         }
+      }
+
+      // Restore initial state of the parent system
+      mixture.setDs(dsInitial);
+      initial.setSystemState(isFlexible_);
+      system().compute();
+
+      // The three finest levels are required for the error models
+      for (k = dsLadder_.nLevel - 3; k < dsLadder_.nLevel; ++k) {
+         if (dsLadder_.error[k]) {
+            UTIL_THROW("Convergence failure at one of 3 finest ds levels");
+         }
+      }
+      if (nMesh > 0) {
+         for (k = nMesh - 3; k < nMesh; ++k) {
+            if (meshLadder_.error[k]) {
+               UTIL_THROW("Convergence failure at one of 3 finest meshes");
+            }
+         }
+      }
+
+      analyze(dsLadder_);
+      if (nMesh > 0) {
+         analyze(meshLadder_);
+      }
+      hasResults_ = true;
+   }
+
+   /*
+   * Allocate arrays of one ladder, reallocating if sizes have changed.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::allocateLadder(Ladder& ladder, int nLevel)
+   {
+      UTIL_CHECK(nLevel >= 3);
+      UTIL_CHECK(nQuantity_ > 0);
+      if (ladder.h.isAllocated()) {
+         if (ladder.h.capacity() == nLevel
+             && ladder.exact.capacity() == nQuantity_) {
+            return;
+         }
+         ladder.h.deallocate();
+         ladder.nPoint.deallocate();
+         ladder.error.deallocate();
+         ladder.q.deallocate();
+         ladder.solveTime.deallocate();
+         ladder.mdeTime.deallocate();
+         ladder.exact.deallocate();
+         ladder.amplitude.deallocate();
+         ladder.order.deallocate();
+      }
+      ladder.h.allocate(nLevel);
+      ladder.nPoint.allocate(nLevel);
+      ladder.error.allocate(nLevel);
+      ladder.q.allocate(nLevel, nQuantity_);
+      ladder.solveTime.allocate(nLevel);
+      ladder.mdeTime.allocate(nLevel);
+      ladder.exact.allocate(nQuantity_);
+      ladder.amplitude.allocate(nQuantity_);
+      ladder.order.allocate(nQuantity_);
+   }
+
+   /*
+   * Converge the system at one level and record all quantities.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::solveLevel(Ladder& ladder, int k)
+   {
+      Mixture<D>& mixture = system().mixture();
+      Timer timer;
+
+      timer.start();
+      ladder.error[k] = system().iterate();
+      timer.stop();
+      ladder.solveTime[k] = timer.time();
+      if (ladder.error[k]) {
+         system().logFile() << "Iterator failed to converge at level "
+                            << k << std::endl;
+         return;
+      }
+
+      // Record thermodynamic and cell data
+      if (!system().hasFreeEnergy()) {
+         system().computeFreeEnergy();
+      }
+      int np = mixture.nPolymer();
+      int ns = mixture.nSolvent();
+      int i;
+      ladder.q(k, 0) = system().fHelmholtz();
+      ladder.q(k, 1) = system().pressure();
+      for (i = 0; i < np; ++i) {
+         ladder.q(k, 2 + i) = mixture.polymer(i).mu();
+      }
+      for (i = 0; i < ns; ++i) {
+         ladder.q(k, 2 + np + i) = mixture.solvent(i).mu();
+      }
+      for (i = 0; i < nParameter_; ++i) {
+         if (isFlexible_) {
+            ladder.q(k, 2 + np + ns + i) = system().unitCell().parameter(i);
+         } else {
+            ladder.q(k, 2 + np + ns + i) = mixture.stress(i);
+         }
+      }
+
+      // Time one MDE solution, i.e., the cost of one iteration
+      timer.clear();
+      timer.start();
+      system().compute();
+      timer.stop();
+      ladder.mdeTime[k] = timer.time();
+   }
+
+   /*
+   * Fit error models and choose the recommended level of one ladder.
+   *
+   * The free energy and pressure are compared to fTolerance, and cell
+   * quantities to stressTolerance. Chemical potentials are not used.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::analyze(Ladder& ladder)
+   {
+      const int nCellBegin = nQuantity_ - nParameter_;
+      int j, k;
+      double tolerance;
+
+      // Fit Richardson error models
+      for (j = 0; j < nQuantity_; ++j) {
+         fitModel(ladder, j);
+      }
+
+      // Model estimate of the largest h that meets all tolerances
+      ladder.modelH = ladder.h[0];
+      for (j = 0; j < nQuantity_; ++j) {
+         if (j >= 2 && j < nCellBegin) continue;
+         if (ladder.amplitude[j] == 0.0) continue;
+         tolerance = (j < 2) ? fTolerance_ : stressTolerance_;
+         double h = pow(tolerance/std::abs(ladder.amplitude[j]),
+                        1.0/ladder.order[j]);
+         if (h < ladder.modelH) ladder.modelH = h;
+      }
+
+      // Choose cheapest (coarsest) converged level meeting tolerances
+      ladder.recommended = -1;
+      bool isOk;
+      for (k = 0; k < ladder.nLevel; ++k) {
+         if (ladder.error[k]) continue;
+         isOk = true;
+         for (j = 0; j < nQuantity_; ++j) {
+            if (j >= 2 && j < nCellBegin) continue;
+            tolerance = (j < 2) ? fTolerance_ : stressTolerance_;
+            if (std::abs(ladder.q(k, j) - ladder.exact[j]) > tolerance) {
+               isOk = false;
+            }
+         }
+         if (isOk) {
+            ladder.recommended = k;
+            break;
+         }
+      }
+   }
+
+   /*
+   * Fit Q(h) = exact + amplitude*h^order to the three finest levels.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::fitModel(Ladder& ladder, int j) const
+   {
+      int n = ladder.nLevel;
+      double d1 = ladder.q(n-3, j) - ladder.q(n-2, j);
+      double d2 = ladder.q(n-2, j) - ladder.q(n-1, j);
+
+      // Estimate the order of convergence from successive differences.
+      // If differences do not decrease (e.g., at the round-off floor),
+      // use the nominal 4th order accuracy of the Richardson-extrapolated
+      // pseudo-spectral MDE algorithm. Spatial errors of a spectral
+      // method decrease faster than any power, so the fitted order of
+      // the mesh ladder is usually the upper bound of 8.
+      double order = 4.0;
+      if (d2 != 0.0 && d1/d2 > 1.0) {
+         order = log(d1/d2)/log(2.0);
+         if (order > 8.0) order = 8.0;
+         if (order < 1.0) order = 1.0;
+      }
+
+      double factor = pow(2.0, order) - 1.0;
+      ladder.order[j] = order;
+      ladder.exact[j] = ladder.q(n-1, j) - d2/factor;
+      ladder.amplitude[j] = d2/(pow(ladder.h[n-1], order)*factor);
+   }
+
+   /*
+   * Ratio of largest c-field coefficient in the outer third of the
+   * wavevector range to the largest nonzero-wavevector coefficient.
+   */
+   template <int D>
+   double ConvergenceStudy<D>::computeSpectralTail() const
+   {
+      System<D> const & sys = *systemPtr_;
+      Basis<D> const & basis = sys.basis();
+      UnitCell<D> const & cell = sys.unitCell();
+      int nBasis = basis.nBasis();
+      int nMonomer = sys.mixture().nMonomer();
+      if (nBasis < 2) return 0.0;
+
+      double kMax = cell.ksq(basis.basisFunction(nBasis-1).waveBz);
+      kMax = sqrt(kMax);
+      double cMax = 0.0;
+      double cTail = 0.0;
+      double k, c;
+      for (int j = 1; j < nBasis; ++j) {
+         k = sqrt(cell.ksq(basis.basisFunction(j).waveBz));
+         for (int i = 0; i < nMonomer; ++i) {
+            c = std::abs(sys.c().basis(i)[j]);
+            if (c > cMax) cMax = c;
+            if (k > 2.0*kMax/3.0 && c > cTail) cTail = c;
+         }
+      }
+      if (cMax == 0.0) return 0.0;
+      return cTail/cMax;
+   }
+
+   /*
+   * Write report to output stream.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::output(std::ostream& out) const
+   {
+      UTIL_CHECK(hasResults_);
+
+      out << "Discretization convergence study" << std::endl;
+      out << std::endl;
+      out << "Contour ladder:" << std::endl;
+      outputLadder(out, dsLadder_, false);
+      if (meshLadder_.nLevel > 0) {
+         out << "Mesh ladder (h = mesh spacing / initial spacing):"
+             << std::endl;
+         outputLadder(out, meshLadder_, true);
+      }
+
+      std::string cellName = isFlexible_ ? "lattice" : "stress";
+      out << "Tolerances:   fHelmholtz and pressure " << Dbl(fTolerance_)
+          << "   " << cellName << " " << Dbl(stressTolerance_) 
+          << std::endl;
+      out << "Model estimate of largest acceptable ds  "
+          << Dbl(dsLadder_.modelH) << std::endl;
+      if (dsLadder_.recommended >= 0) {
+         int k = dsLadder_.recommended;
+         out << "Recommended ds                           "
+             << Dbl(dsLadder_.h[k]) << "   (level " << k << ", "
+             << Dbl(dsLadder_.mdeTime[k], 10) << " s per iteration)"
+             << std::endl;
+      } else {
+         out << "No ds level meets the requested tolerances."
+             << std::endl;
+      }
+      if (meshLadder_.nLevel > 0) {
+         out << "Model estimate of largest acceptable h   "
+             << Dbl(meshLadder_.modelH) << std::endl;
+         if (meshLadder_.recommended >= 0) {
+            int k = meshLadder_.recommended;
+            out << "Recommended mesh                         "
+                << meshes_[k] << "   (level " << k << ", "
+                << Dbl(meshLadder_.mdeTime[k], 10) << " s per iteration)"
+                << std::endl;
+         } else {
+            out << "No mesh level meets the requested tolerances."
+                << std::endl;
+         }
+      }
+      out << "Spectral tail of c fields (mesh check)   "
+          << Dbl(spectralTail_) << std::endl;
+      out << std::endl;
+   }
+
+   /*
+   * Write table of errors and fitted models for one ladder.
+   */
+   template <int D>
+   void ConvergenceStudy<D>::outputLadder(std::ostream& out,
+                                          Ladder const & ladder,
+                                          bool isMesh) const
+   {
+      int j, k;
+      out << "level" << Str(isMesh ? "h" : "ds", 16) << Str("nPoint", 9)
+          << Str("fHelmholtz", 16);
+      for (j = 0; j < nQuantity_; ++j) {
+         out << Str(names_[j] + "Err", 20);
+      }
+      out << Str("solveTime", 16) << Str("timePerItr", 16) << std::endl;
+
+      for (k = 0; k < ladder.nLevel; ++k) {
+         out << Int(k, 5) << Dbl(ladder.h[k], 16)
+             << Int(ladder.nPoint[k], 9);
+         if (ladder.error[k]) {
+            out << "   (not converged)" << std::endl;
+            continue;
+         }
+         out << Dbl(ladder.q(k, 0), 16, 10);
+         for (j = 0; j < nQuantity_; ++j) {
+            out << Dbl(std::abs(ladder.q(k, j) - ladder.exact[j]), 20);
+         }
+         out << Dbl(ladder.solveTime[k], 16)
+             << Dbl(ladder.mdeTime[k], 16) << std::endl;
+      }
+      out << std::endl;
+
+      out << "Richardson models Q(h) = Q* + A h^p:" << std::endl;
+      for (j = 0; j < nQuantity_; ++j) {
+         out << Str(names_[j], 16)
+             << "   Q* = " << Dbl(ladder.exact[j], 18, 11)
+             << "   A = " << Dbl(ladder.amplitude[j])
+             << "   p = " << Dbl(ladder.order[j], 8, 3) << std::endl;
+      }
+      out << std::endl;
+   }
+
+} // namespace Pspc
+} // namespace Pscf
+#endif
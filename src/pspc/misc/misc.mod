@@ -0,0 +1,14 @@
+
+namespace Pscf{
+namespace Pspc{
+
+   /**
+   * \defgroup Pspc_Misc_Module Miscellaneous
+   *
+   * Commands and utilities that analyze or post-process SCFT solutions.
+   *
+   * \ingroup Pscf_Pspc_Module
+   */
+
+}
+}
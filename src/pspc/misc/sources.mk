@@ -0,0 +1,8 @@
+pspc_misc_= \
+  pspc/misc/ConvergenceStudy.cpp 
+
+pspc_misc_SRCS=\
+     $(addprefix $(SRC_DIR)/, $(pspc_misc_))
+pspc_misc_OBJS=\
+     $(addprefix $(BLD_DIR)/, $(pspc_misc_:.cpp=.o))
+
@@ -23,6 +23,9 @@ LIBS=$(PSPC_LIBS)
 INCLUDES+=$(GSL_INC)
 LIBS+=$(GSL_LIB) 
 
+# Add optional LAPACK library (empty unless PSCF_LAPACK is used)
+LIBS+=$(LAPACK_LIB)
+
 # Add paths to FFTW Fast Fourier transform library
 INCLUDES+=$(FFTW_INC)
 LIBS+=$(FFTW_LIB) 
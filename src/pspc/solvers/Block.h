@@ -17,6 +17,7 @@
 #include <pspc/field/FFT.h>               // member
 #include <util/containers/FArray.h>       // member template
 #include <util/containers/DMatrix.h>      // member template
+#include <util/containers/DArray.h>       // member template
 
 namespace Pscf { 
    template <int D> class Mesh; 
@@ -69,6 +70,18 @@ namespace Pspc {
       */
       void setDiscretization(double ds, const Mesh<D>& mesh);
 
+      /**
+      * Change the spatial mesh after a previous setDiscretization.
+      *
+      * Releases all memory that depends on the mesh, including any
+      * reduced mesh data, and reallocates it for the new mesh using 
+      * the current target contour step. Unit cell dependent data must
+      * then be recomputed by calling setupUnitCell.
+      *
+      * \param mesh  new spatial discretization mesh
+      */
+      void setMesh(const Mesh<D>& mesh);
+
       /**
       * Setup parameters that depend on the unit cell.
       *
@@ -92,6 +105,18 @@ namespace Pspc {
       */
       void setLength(double newLength);
 
+      /**
+      * Reset the target contour length step size.
+      *
+      * Recomputes the number ns of contour grid points from the new
+      * target step size, using the same rules as setDiscretization, 
+      * and reallocates propagator memory if ns changes. May only be 
+      * called after setDiscretization.
+      *
+      * \param ds  new desired (optimal) value for contour length step
+      */
+      void setDs(double ds);
+
       /**
       * Set or reset monomer statistical segment length.
       * 
@@ -111,6 +136,45 @@ namespace Pspc {
       */
       void setupSolver(RField<D> const & w);
 
+      /**
+      * Solve the MDE on a reduced mesh for invariant fields.
+      *
+      * If invariant[i] is nonzero for some axis i along which the mesh
+      * has more than one grid point, the w field passed to the next
+      * call of setupSolver is assumed to be independent of the index
+      * along every such axis. Each step of the MDE is then computed on 
+      * a reduced mesh in which each such axis is collapsed to a single 
+      * grid point, and the result is copied to all equivalent points 
+      * of the full mesh. Work arrays and the FFT plan for the reduced 
+      * mesh are allocated when first needed, and reallocated if the
+      * set of invariant axes changes. If invariant[i] is zero for all
+      * axes, the full mesh is used.
+      *
+      * This function is called by Mixture<D>::compute before each
+      * call to Polymer<D>::compute. May only be called after
+      * setDiscretization.
+      *
+      * \param invariant  nonzero elements mark invariant axes
+      */
+      void setInvariantAxes(IntVec<D> const & invariant);
+
+      /**
+      * Enable or disable symmetry-compressed storage of propagators.
+      *
+      * Calls Propagator<D>::setCompression for both propagators. May 
+      * only be called after setDiscretization.
+      *
+      * \param fieldIoPtr  pointer to FieldIo<D> for conversion, or null
+      * \param nBasis  number of basis functions (if fieldIoPtr != 0)
+      */
+      void setCompression(FieldIo<D> const * fieldIoPtr, int nBasis = 0);
+
+      /**
+      * Is the MDE currently solved on a reduced mesh?
+      */
+      bool isReduced() const
+      {  return isReduced_; }
+
       /**
       * Compute one step of solution of MDE, from step i to i+1.
       *
@@ -140,10 +204,44 @@ namespace Pspc {
       * the species partition function, i.e., the spatial average of q(r,L). 
       * This function is called by Polymer<D>::compute().
       *
+      * The prefactor is stored for later use by addConcentration. If
+      * storage of the block concentration field has been disabled by
+      * setStoreCField(false), cField() is not computed.
+      *
       * \param prefactor  constant multiplying integral over s
       */ 
       void computeConcentration(double prefactor);
 
+      /**
+      * Add concentration for this block to a monomer concentration field.
+      *
+      * Evaluates the same integral as computeConcentration, using the
+      * prefactor passed to the most recent call of computeConcentration,
+      * and adds the result to field c without use of cField(). This
+      * requires that both propagators still hold the solutions for which
+      * computeConcentration was called.
+      *
+      * \param c  field to which block concentration is added (in-out)
+      */
+      void addConcentration(RField<D>& c) const;
+
+      /**
+      * Enable or disable storage of the block concentration field.
+      *
+      * If storage is disabled, memory for cField() is not allocated and
+      * computeConcentration does not compute it. The default is true.
+      * May only be called before setDiscretization.
+      *
+      * \param storeCField  true to store cField(), false otherwise
+      */
+      void setStoreCField(bool storeCField);
+
+      /**
+      * Is the block concentration field cField() stored ?
+      */
+      bool storeCField() const
+      {  return storeCField_; }
+
       /** 
       * Compute stress contribution for this block.
       *
@@ -233,6 +331,30 @@ namespace Pspc {
       // Work array for wavevector space field (step size ds/2)
       RFieldDft<D> qk2_;
 
+      // Fourier transform plan for reduced mesh (if allocated)
+      FFT<D>* reducedFftPtr_;
+
+      // Dimensions of the reduced mesh
+      IntVec<D> reducedDimensions_;
+
+      // Work arrays for the reduced mesh, analogous to those above
+      RField<D> expKsqR_;
+      RField<D> expKsq2R_;
+      RField<D> expWR_;
+      RField<D> expW2R_;
+      RField<D> qR_;
+      RField<D> qNewR_;
+      RField<D> qrR_;
+      RField<D> qr2R_;
+      RFieldDft<D> qkR_;
+      RFieldDft<D> qk2R_;
+
+      // Rank in the reduced mesh of each point of the full mesh
+      DArray<int> reducedRank_;
+
+      // Rank in the full mesh of one point for each reduced mesh point
+      DArray<int> fullRank_;
+
       // Pointer to associated Mesh<D> object
       Mesh<D> const* meshPtr_;
 
@@ -248,6 +370,9 @@ namespace Pspc {
       // Contour length step size (value input in param file)
       double dsTarget_;
 
+      // Prefactor passed to most recent call of computeConcentration
+      double cPrefactor_;
+
       // Number of contour grid points = # of contour steps + 1
       int ns_;
 
@@ -257,6 +382,15 @@ namespace Pspc {
       // Are expKsq_ arrays up to date ? (initialize false)
       bool hasExpKsq_;
 
+      // Is block concentration field cField() stored ? (default true)
+      bool storeCField_;
+
+      // Has computeConcentration been called ?
+      bool hasCPrefactor_;
+
+      // Is the MDE solved on the reduced mesh ?
+      bool isReduced_;
+
       /** 
       * Access associated UnitCell<D> as reference.
       */  
@@ -269,10 +403,34 @@ namespace Pspc {
       void computedGsq();
 
       /**
-      * Compute expKSq_ arrays.
+      * Compute expKSq_ arrays (and reduced arrays, if allocated).
       */
       void computeExpKsq();
 
+      /**
+      * Allocate work arrays for a reduced mesh.
+      *
+      * \param dimensions  dimensions of the reduced mesh
+      */
+      void allocateReduced(IntVec<D> const & dimensions);
+
+      /**
+      * Release work arrays for a reduced mesh, if allocated.
+      */
+      void deallocateReduced();
+
+      /**
+      * Apply the pseudo-spectral step algorithm on one mesh.
+      *
+      * Used by step for both the full mesh and the reduced mesh.
+      */
+      void propagate(RField<D> const & q, RField<D>& qNew, 
+                     FFT<D> const & fft,
+                     RField<D> const & expW, RField<D> const & expW2,
+                     RField<D> const & expKsq, RField<D> const & expKsq2,
+                     RField<D>& qr, RField<D>& qr2, 
+                     RFieldDft<D>& qk, RFieldDft<D>& qk2);
+
    };
 
    // Inline member functions
@@ -11,6 +11,7 @@
 #include "Block.h"
 #include <pscf/mesh/Mesh.h>
 #include <pscf/mesh/MeshIterator.h>
+#include <pspc/field/FieldIo.h>
 #include <pscf/crystal/UnitCell.h>
 #include <pscf/crystal/shiftToMinimum.h>
 #include <pscf/math/IntVec.h>
@@ -29,13 +30,18 @@ namespace Pspc {
    */
    template <int D>
    Block<D>::Block()
-    : meshPtr_(0),
+    : reducedFftPtr_(0),
+      meshPtr_(0),
       kMeshDimensions_(0),
       ds_(0.0),
       dsTarget_(0.0),
+      cPrefactor_(0.0),
       ns_(0),
       isAllocated_(false),
-      hasExpKsq_(false)
+      hasExpKsq_(false),
+      storeCField_(true),
+      hasCPrefactor_(false),
+      isReduced_(false)
    {
       propagator(0).setBlock(*this);
       propagator(1).setBlock(*this);
@@ -46,7 +52,11 @@ namespace Pspc {
    */
    template <int D>
    Block<D>::~Block()
-   {}
+   {
+      if (reducedFftPtr_) {
+         delete reducedFftPtr_;
+      }
+   }
 
    template <int D>
    void Block<D>::setDiscretization(double ds, const Mesh<D>& mesh)
@@ -99,8 +109,10 @@ namespace Pspc {
       // Allocate work array for stress calculation
       dGsq_.allocate(kSize, 6);
 
-      // Allocate block concentration field
-      cField().allocate(mesh.dimensions());
+      // Allocate block concentration field, if stored
+      if (storeCField_) {
+         cField().allocate(mesh.dimensions());
+      }
 
       // Allocate memory for solutions to MDE (requires ns_)
       propagator(0).allocate(ns_, mesh);
@@ -110,6 +122,43 @@ namespace Pspc {
       hasExpKsq_ = false;
    }
 
+   /*
+   * Change the spatial mesh, reallocating all mesh-dependent memory.
+   */
+   template <int D>
+   void Block<D>::setMesh(const Mesh<D>& mesh)
+   {
+      UTIL_CHECK(isAllocated_);
+      UTIL_CHECK(dsTarget_ > 0.0);
+
+      // Release all memory allocated by setDiscretization
+      fft_.clear();
+      expKsq_.deallocate();
+      expKsq2_.deallocate();
+      expW_.deallocate();
+      expW2_.deallocate();
+      qr_.deallocate();
+      qk_.deallocate();
+      qr2_.deallocate();
+      qk2_.deallocate();
+      dGsq_.deallocate();
+      if (storeCField_) {
+         cField().deallocate();
+      }
+      propagator(0).deallocate();
+      propagator(1).deallocate();
+
+      // Release reduced mesh data, which refers to the old mesh
+      deallocateReduced();
+      if (reducedRank_.isAllocated()) {
+         reducedRank_.deallocate();
+      }
+      isReduced_ = false;
+      isAllocated_ = false;
+
+      setDiscretization(dsTarget_, mesh);
+   }
+
    /*
    * Set or reset the the block length.
    */
@@ -141,6 +190,33 @@ namespace Pspc {
       hasExpKsq_ = false;
    }
 
+   /*
+   * Reset the target contour length step size.
+   */
+   template <int D>
+   void Block<D>::setDs(double ds)
+   {
+      UTIL_CHECK(isAllocated_);
+      UTIL_CHECK(ds > 0.0);
+
+      dsTarget_ = ds;
+      int oldNs = ns_;
+      int tempNs;
+      tempNs = floor( length()/(2.0 *dsTarget_) + 0.5 );
+      if (tempNs == 0) {
+         tempNs = 1;
+      }
+      ns_ = 2*tempNs + 1;
+      ds_ = length()/double(ns_-1);
+
+      if (oldNs != ns_) {
+         propagator(0).reallocate(ns_);
+         propagator(1).reallocate(ns_);
+      }
+
+      hasExpKsq_ = false;
+   }
+
    /*
    * Set or reset the the block length.
    */
@@ -183,6 +259,19 @@ namespace Pspc {
          expKsq2_[i] = exp(Gsq*factor*0.5);
       }
 
+      // Reduced mesh (wavevectors with zero index along collapsed axes)
+      if (reducedFftPtr_) {
+         iter.setDimensions(expKsqR_.meshDimensions());
+         for (iter.begin(); !iter.atEnd(); ++iter) {
+            i = iter.rank();
+            G = iter.position();
+            Gmin = shiftToMinimum(G, reducedDimensions_, unitCell());
+            Gsq = unitCell().ksq(Gmin);
+            expKsqR_[i] = exp(Gsq*factor);
+            expKsq2R_[i] = exp(Gsq*factor*0.5);
+         }
+      }
+
       hasExpKsq_ = true;
    }
 
@@ -199,16 +288,31 @@ namespace Pspc {
       UTIL_CHECK(isAllocated_);
 
       // Compute expW arrays
-      for (int i = 0; i < nx; ++i) {
+      if (isReduced_) {
+
+         // Values on the reduced mesh
+         int nr = expWR_.capacity();
+         int i;
+         for (int r = 0; r < nr; ++r) {
+            i = fullRank_[r];
+            expWR_[r] = exp(-0.5*w[i]*ds_);
+            expW2R_[r] = exp(-0.5*0.5*w[i]*ds_);
+         }
+
+      } else {
+
+         for (int i = 0; i < nx; ++i) {
+
+            // First, check that w[i]*ds_ is not unreasonably large:
+            // (if this condition is not met, solution will have large
+            // error, and user should consider using a smaller ds_)
+            //UTIL_CHECK(std::abs(w[i]*ds_) < 1.0);
 
-         // First, check that w[i]*ds_ is not unreasonably large:
-         // (if this condition is not met, solution will have large
-         // error, and user should consider using a smaller ds_)
-         //UTIL_CHECK(std::abs(w[i]*ds_) < 1.0);
+            // Calculate values
+            expW_[i] = exp(-0.5*w[i]*ds_);
+            expW2_[i] = exp(-0.5*0.5*w[i]*ds_);
+         }
 
-         // Calculate values
-         expW_[i] = exp(-0.5*w[i]*ds_);
-         expW2_[i] = exp(-0.5*0.5*w[i]*ds_);
       }
 
       // Compute expKsq arrays if necessary
@@ -223,55 +327,91 @@ namespace Pspc {
    */
    template <int D>
    void Block<D>::computeConcentration(double prefactor)
+   {
+      UTIL_CHECK(isAllocated_);
+      cPrefactor_ = prefactor;
+      hasCPrefactor_ = true;
+      if (!storeCField_) return;
+
+      // Preconditions
+      int nx = mesh().size();
+      UTIL_CHECK(cField().capacity() == nx);
+
+      // Initialize cField to zero at all points
+      for (int i = 0; i < nx; ++i) {
+         cField()[i] = 0.0;
+      }
+
+      addConcentration(cField());
+   }
+
+   /*
+   * Integrate and add monomer concentration of this block to a field.
+   */
+   template <int D>
+   void Block<D>::addConcentration(RField<D>& c) const
    {
       // Preconditions
       UTIL_CHECK(isAllocated_);
+      UTIL_CHECK(hasCPrefactor_);
       int nx = mesh().size();
       UTIL_CHECK(nx > 0);
       UTIL_CHECK(ns_ > 0);
       UTIL_CHECK(ds_ > 0);
       UTIL_CHECK(propagator(0).isAllocated());
       UTIL_CHECK(propagator(1).isAllocated());
-      UTIL_CHECK(cField().capacity() == nx);
-
-      // Initialize cField to zero at all points
-      int i;
-      for (i = 0; i < nx; ++i) {
-         cField()[i] = 0.0;
-      }
+      UTIL_CHECK(c.capacity() == nx);
 
       Propagator<D> const & p0 = propagator(0);
       Propagator<D> const & p1 = propagator(1);
 
-      // Evaluate unnormalized integral
+      // Simpson's rule weights, including normalization
+      const double w1 = cPrefactor_*ds_/3.0;
+      const double w2 = 2.0*w1;
+      const double w4 = 4.0*w1;
 
       // Endpoint contributions
+      int i;
       for (i = 0; i < nx; ++i) {
-         cField()[i] += p0.q(0)[i]*p1.q(ns_ - 1)[i];
-         cField()[i] += p0.q(ns_ -1)[i]*p1.q(0)[i];
+         c[i] += w1*p0.q(0)[i]*p1.q(ns_ - 1)[i];
+         c[i] += w1*p0.q(ns_ -1)[i]*p1.q(0)[i];
+      }
+
+      // Work fields for reconstruction of compressed slices
+      RField<D> work0, work1;
+      if (p0.isCompressed()) {
+         work0.allocate(mesh().dimensions());
+         work1.allocate(mesh().dimensions());
       }
 
       // Odd indices
       int j;
       for (j = 1; j < (ns_ -1); j += 2) {
+         RField<D> const & q0 = p0.q(j, work0);
+         RField<D> const & q1 = p1.q(ns_ - 1 - j, work1);
          for (i = 0; i < nx; ++i) {
-            cField()[i] += p0.q(j)[i] * p1.q(ns_ - 1 - j)[i] * 4.0;
+            c[i] += w4 * q0[i] * q1[i];
          }
       }
 
       // Even indices
       for (j = 2; j < (ns_ -2); j += 2) {
+         RField<D> const & q0 = p0.q(j, work0);
+         RField<D> const & q1 = p1.q(ns_ - 1 - j, work1);
          for (i = 0; i < nx; ++i) {
-            cField()[i] += p0.q(j)[i] * p1.q(ns_ - 1 - j)[i] * 2.0;
+            c[i] += w2 * q0[i] * q1[i];
          }
       }
+   }
 
-      // Normalize the integral
-      prefactor *= ds_ / 3.0;
-      for (i = 0; i < nx; ++i) {
-         cField()[i] *= prefactor;
-      }
-
+   /*
+   * Enable or disable storage of the block concentration field.
+   */
+   template <int D>
+   void Block<D>::setStoreCField(bool storeCField)
+   {
+      UTIL_CHECK(!isAllocated_);
+      storeCField_ = storeCField;
    }
 
    /*
@@ -319,11 +459,14 @@ namespace Pspc {
       // Evaluate unnormalized integral
       for (int j = 0; j < ns_ ; ++j) {
 
-         qr_ = p0.q(j);
-         fft_.forwardTransform(qr_, qk_);
-
-         qr2_ = p1.q(ns_ - 1 - j);
-         fft_.forwardTransform(qr2_, qk2_);
+         // Compressed slices are converted directly to the k-grid
+         if (p0.isCompressed() && j != 0 && j != ns_ - 1) {
+            p0.fieldIo().convertBasisToKGrid(p0.qBasis(j), qk_);
+            p1.fieldIo().convertBasisToKGrid(p1.qBasis(ns_ - 1 - j), qk2_);
+         } else {
+            fft_.forwardTransform(p0.q(j), qk_);
+            fft_.forwardTransform(p1.q(ns_ - 1 - j), qk2_);
+         }
 
          dels = ds_;
 
@@ -387,6 +530,131 @@ namespace Pspc {
       }
    }
 
+   /*
+   * Enable or disable use of a reduced mesh.
+   */
+   template <int D>
+   void Block<D>::setInvariantAxes(IntVec<D> const & invariant)
+   {
+      UTIL_CHECK(isAllocated_);
+
+      IntVec<D> dimensions;
+      bool isReduced = false;
+      for (int i = 0; i < D; ++i) {
+         if (invariant[i] && mesh().dimensions()[i] > 1) {
+            dimensions[i] = 1;
+            isReduced = true;
+         } else {
+            dimensions[i] = mesh().dimensions()[i];
+         }
+      }
+      isReduced_ = isReduced;
+      if (!isReduced) return;
+
+      if (!reducedFftPtr_ || !(dimensions == reducedDimensions_)) {
+         allocateReduced(dimensions);
+      }
+   }
+
+   /*
+   * Enable or disable symmetry-compressed propagator storage.
+   */
+   template <int D>
+   void Block<D>::setCompression(FieldIo<D> const * fieldIoPtr, 
+                                 int nBasis)
+   {
+      UTIL_CHECK(isAllocated_);
+      propagator(0).setCompression(fieldIoPtr, nBasis);
+      propagator(1).setCompression(fieldIoPtr, nBasis);
+   }
+
+   /*
+   * Allocate work arrays and FFT plan for a reduced mesh.
+   */
+   template <int D>
+   void Block<D>::allocateReduced(IntVec<D> const & dimensions)
+   {
+      // Release any previous allocation
+      deallocateReduced();
+      reducedDimensions_ = dimensions;
+
+      reducedFftPtr_ = new FFT<D>;
+      reducedFftPtr_->setup(dimensions);
+
+      IntVec<D> kDimensions;
+      for (int i = 0; i < D; ++i) {
+         if (i < D - 1) {
+            kDimensions[i] = dimensions[i];
+         } else {
+            kDimensions[i] = dimensions[i]/2 + 1;
+         }
+      }
+      expKsqR_.allocate(kDimensions);
+      expKsq2R_.allocate(kDimensions);
+      expWR_.allocate(dimensions);
+      expW2R_.allocate(dimensions);
+      qR_.allocate(dimensions);
+      qNewR_.allocate(dimensions);
+      qrR_.allocate(dimensions);
+      qr2R_.allocate(dimensions);
+      qkR_.allocate(dimensions);
+      qk2R_.allocate(dimensions);
+
+      // Map between ranks of the full and reduced meshes
+      int nx = mesh().size();
+      int nr = qR_.capacity();
+      if (!reducedRank_.isAllocated()) {
+         reducedRank_.allocate(nx);
+      }
+      fullRank_.allocate(nr);
+      for (int r = 0; r < nr; ++r) {
+         fullRank_[r] = -1;
+      }
+      MeshIterator<D> iter;
+      iter.setDimensions(mesh().dimensions());
+      IntVec<D> position;
+      int i, j, r;
+      for (iter.begin(); !iter.atEnd(); ++iter) {
+         i = iter.rank();
+         position = iter.position();
+         r = 0;
+         for (j = 0; j < D; ++j) {
+            if (dimensions[j] == 1) {
+               position[j] = 0;
+            }
+            r = r*dimensions[j] + position[j];
+         }
+         reducedRank_[i] = r;
+         if (fullRank_[r] < 0) {
+            fullRank_[r] = i;
+         }
+      }
+
+      hasExpKsq_ = false;
+   }
+
+   /*
+   * Release work arrays and FFT plan for a reduced mesh, if any.
+   */
+   template <int D>
+   void Block<D>::deallocateReduced()
+   {
+      if (!reducedFftPtr_) return;
+      delete reducedFftPtr_;
+      reducedFftPtr_ = 0;
+      expKsqR_.deallocate();
+      expKsq2R_.deallocate();
+      expWR_.deallocate();
+      expW2R_.deallocate();
+      qR_.deallocate();
+      qNewR_.deallocate();
+      qrR_.deallocate();
+      qr2R_.deallocate();
+      qkR_.deallocate();
+      qk2R_.deallocate();
+      fullRank_.deallocate();
+   }
+
    /*
    * Propagate solution by one step.
    */
@@ -395,14 +663,8 @@ namespace Pspc {
    {
       // Internal prereconditions
       UTIL_CHECK(isAllocated_);
-      int nx = mesh().size();
-      int nk = qk_.capacity();
-      UTIL_CHECK(nx > 0);
-      UTIL_CHECK(nk > 0);
-      UTIL_CHECK(qr_.capacity() == nx);
-      UTIL_CHECK(expW_.capacity() == nx);
-      UTIL_CHECK(expKsq_.capacity() == nk);
       UTIL_CHECK(hasExpKsq_);
+      int nx = mesh().size();
 
       // Preconditions on parameters
       UTIL_CHECK(q.isAllocated());
@@ -410,43 +672,83 @@ namespace Pspc {
       UTIL_CHECK(qNew.isAllocated());
       UTIL_CHECK(qNew.capacity() == nx);
 
+      if (isReduced_) {
+         UTIL_CHECK(reducedFftPtr_);
+         int nr = qR_.capacity();
+         int r;
+         for (r = 0; r < nr; ++r) {
+            qR_[r] = q[fullRank_[r]];
+         }
+         propagate(qR_, qNewR_, *reducedFftPtr_, expWR_, expW2R_,
+                   expKsqR_, expKsq2R_, qrR_, qr2R_, qkR_, qk2R_);
+         for (int i = 0; i < nx; ++i) {
+            qNew[i] = qNewR_[reducedRank_[i]];
+         }
+      } else {
+         propagate(q, qNew, fft_, expW_, expW2_, 
+                   expKsq_, expKsq2_, qr_, qr2_, qk_, qk2_);
+      }
+   }
+
+   /*
+   * Pseudo-spectral step algorithm, on either the full or reduced mesh.
+   */
+   template <int D>
+   void Block<D>::propagate(RField<D> const & q, RField<D>& qNew, 
+                            FFT<D> const & fft,
+                            RField<D> const & expW, 
+                            RField<D> const & expW2,
+                            RField<D> const & expKsq, 
+                            RField<D> const & expKsq2,
+                            RField<D>& qr, RField<D>& qr2, 
+                            RFieldDft<D>& qk, RFieldDft<D>& qk2)
+   {
+      int nx = q.capacity();
+      int nk = qk.capacity();
+      UTIL_CHECK(nx > 0);
+      UTIL_CHECK(nk > 0);
+      UTIL_CHECK(qr.capacity() == nx);
+      UTIL_CHECK(expW.capacity() == nx);
+      UTIL_CHECK(expKsq.capacity() == nk);
+      UTIL_CHECK(qNew.capacity() == nx);
+
       // Apply pseudo-spectral algorithm
 
       // Full step for ds, half-step for ds/2
       int i;
       for (i = 0; i < nx; ++i) {
-         qr_[i] = q[i]*expW_[i];
-         qr2_[i] = q[i]*expW2_[i];
+         qr[i] = q[i]*expW[i];
+         qr2[i] = q[i]*expW2[i];
       }
-      fft_.forwardTransform(qr_, qk_);
-      fft_.forwardTransform(qr2_, qk2_);
+      fft.forwardTransform(qr, qk);
+      fft.forwardTransform(qr2, qk2);
       for (i = 0; i < nk; ++i) {
-         qk_[i][0] *= expKsq_[i];
-         qk_[i][1] *= expKsq_[i];
-         qk2_[i][0] *= expKsq2_[i];
-         qk2_[i][1] *= expKsq2_[i];
+         qk[i][0] *= expKsq[i];
+         qk[i][1] *= expKsq[i];
+         qk2[i][0] *= expKsq2[i];
+         qk2[i][1] *= expKsq2[i];
       }
-      fft_.inverseTransform(qk_, qr_);
-      fft_.inverseTransform(qk2_, qr2_);
+      fft.inverseTransform(qk, qr);
+      fft.inverseTransform(qk2, qr2);
       for (i = 0; i < nx; ++i) {
-         qr_[i] = qr_[i]*expW_[i];
-         qr2_[i] = qr2_[i]*expW_[i];
+         qr[i] = qr[i]*expW[i];
+         qr2[i] = qr2[i]*expW[i];
       }
 
       // Finish second half-step for ds/2
-      fft_.forwardTransform(qr2_, qk2_);
+      fft.forwardTransform(qr2, qk2);
       for (i = 0; i < nk; ++i) {
-         qk2_[i][0] *= expKsq2_[i];
-         qk2_[i][1] *= expKsq2_[i];
+         qk2[i][0] *= expKsq2[i];
+         qk2[i][1] *= expKsq2[i];
       }
-      fft_.inverseTransform(qk2_, qr2_);
+      fft.inverseTransform(qk2, qr2);
       for (i = 0; i < nx; ++i) {
-         qr2_[i] = qr2_[i]*expW2_[i];
+         qr2[i] = qr2[i]*expW2[i];
       }
 
       // Richardson extrapolation
       for (i = 0; i < nx; ++i) {
-         qNew[i] = (4.0*qr2_[i] - qr_[i])/3.0;
+         qNew[i] = (4.0*qr2[i] - qr[i])/3.0;
       }
    }
 
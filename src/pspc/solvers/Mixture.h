@@ -15,17 +15,21 @@
 #include <pscf/chem/Monomer.h>
 #include <util/containers/DArray.h>
 #include <util/containers/FArray.h>
+#include <pscf/math/IntVec.h>
 
 #include <iostream>
 
 namespace Pscf { 
    template <int D> class Mesh; 
+   template <int D> class Basis; 
 }
  
 namespace Pscf {
 namespace Pspc
 {
 
+   template <int D> class FieldIo;
+
    /**
    * Solver for a mixture of polymers and solvents.
    *
@@ -88,6 +92,10 @@ namespace Pspc
       * e.g., by reading its parameters from a file, so that the
       * mesh dimensions are known on entry.
       *
+      * If called again after a change in mesh dimensions, all memory 
+      * allocated for the previous mesh is released and reallocated.
+      * setupUnitCell must then be called before the next computation.
+      *
       * \param mesh associated Mesh<D> object (stores address).
       */
       void setMesh(Mesh<D> const & mesh);
@@ -103,6 +111,18 @@ namespace Pspc
       */
       void setupUnitCell(const UnitCell<D>& unitCell);
 
+      /**
+      * Create associations with the basis and FieldIo.
+      *
+      * These are used only for symmetry-compressed propagator storage
+      * (see parameter compressQ). The basis need not be initialized 
+      * when this function is called.
+      *
+      * \param basis  symmetry-adapted basis (stores address)
+      * \param fieldIo  associated FieldIo<D> (stores address)
+      */
+      void setFieldIo(Basis<D> const & basis, FieldIo<D> const & fieldIo);
+
       /**
       * Reset statistical segment length for one monomer type.
       * 
@@ -115,6 +135,17 @@ namespace Pspc
       */
       void setKuhn(int monomerId, double kuhn);
 
+      /**
+      * Reset the target contour length step size for all blocks.
+      *
+      * This function resets the value of ds used by every block of 
+      * every polymer species, and reallocates propagators as needed.
+      * It may only be called after setMesh.
+      *
+      * \param ds  new desired contour length step size
+      */
+      void setDs(double ds);
+
       /**
       * Compute partition functions and concentrations.
       *
@@ -124,7 +155,10 @@ namespace Pspc
       * concentration (or volume fraction) for each monomer type.
       * Upon return, values are set for volume fraction and chemical 
       * potential (mu) members of each species, and for the 
-      * concentration fields for each Block and Solvent. The total
+      * concentration fields for each Block and Solvent. If the optional
+      * parameter storeBlockC is false, block concentration fields are
+      * not stored, and the contribution of each block is instead added
+      * directly to the relevant monomer concentration field. The total
       * concentration for each monomer type is returned in the
       * cFields output parameter. Monomer "concentrations" are returned 
       * in units of inverse steric volume per monomer in an incompressible
@@ -133,18 +167,33 @@ namespace Pspc
       * The arrays wFields and cFields must each have capacity nMonomer(),
       * and contain fields that are indexed by monomer type index. 
       *
+      * Unless the optional parameter reduceMesh is false, this function
+      * first checks whether all w fields are invariant along one or more
+      * lattice axes. If so, the MDE is solved for every block on a 
+      * reduced mesh in which each such axis is collapsed to one point, 
+      * and the solution is copied to the full mesh. This gives the same 
+      * result at much lower cost, e.g., for a cylindrical phase in a 3D
+      * unit cell with cylinders parallel to a lattice vector.
+      *
       * The optional parameter phiTot is only relevant to problems such as 
       * thin films in which the material is excluded from part of the unit
       * cell by imposing an inhomogeneous constrain on the sum of mononer 
       * concentrations, (i.e., a "mask"). 
       *
+      * If the parameter compressQ is true, the optional parameter 
+      * isSymmetric is true, and setFieldIo has been called, interior 
+      * slices of all propagators are stored in the symmetry-adapted 
+      * basis. Otherwise, all slices are stored on the full r-grid.
+      *
       * \param wFields array of chemical potential fields (input)
       * \param cFields array of monomer concentration fields (output)
       * \param phiTot  volume fraction of unit cell occupied by material
+      * \param isSymmetric  do all w fields have the space group symmetry?
       */
       void compute(DArray< RField<D> > const & wFields, 
                    DArray< RField<D> >& cFields, 
-                   double phiTot = 1.0);
+                   double phiTot = 1.0,
+                   bool isSymmetric = false);
       
       /**
       * Compute derivatives of free energy w/ respect to cell parameters.
@@ -155,6 +204,14 @@ namespace Pspc
       * Combine cFields for each block/solvent into one DArray, which 
       * is used in System.tpp to print a more detailed r-grid file using
       * the command WRITE_C_BLOCK_RGRID.
+      *
+      * If block concentration fields are not stored (storeBlockC is 
+      * false), the field for each block is recomputed from the stored
+      * propagators, which must correspond to the last call to compute.
+      *
+      * If identical subtrees of a polymer are merged (mergeArms), each
+      * of the m equivalent blocks represented by one computed block is
+      * assigned 1/m times the concentration of that block.
       * 
       * \param blockCFields empty but allocated DArray to store fields
       */
@@ -182,6 +239,34 @@ namespace Pspc
       */
       bool isCanonical();
 
+      /**
+      * Get target contour length step size.
+      */
+      double ds() const;
+
+      /**
+      * Are concentration fields for individual blocks stored?
+      */
+      bool storeBlockC() const
+      {  return storeBlockC_; }
+
+      /**
+      * Are propagators stored in compressed form if possible?
+      */
+      bool compressQ() const
+      {  return compressQ_; }
+
+      /**
+      * Axes along which the w fields were invariant in the last compute.
+      *
+      * Element i is 1 if all w fields passed to the most recent call 
+      * of compute were independent of the grid index along lattice 
+      * axis i, and 0 otherwise. All elements are 0 if the reduceMesh
+      * parameter is false.
+      */
+      IntVec<D> const & invariantAxes() const
+      {  return invariantAxes_; }
+
       // Inherited public member functions with non-dependent names
       using MixtureTmpl< Polymer<D>, Solvent<D> >::nMonomer;
       using MixtureTmpl< Polymer<D>, Solvent<D> >::nPolymer;
@@ -212,12 +297,37 @@ namespace Pspc
       /// Pointer to associated UnitCell<D>
       UnitCell<D> const * unitCellPtr_;
 
+      /// Pointer to associated Basis<D> (for compressed storage)
+      Basis<D> const * basisPtr_;
+
+      /// Pointer to associated FieldIo<D> (for compressed storage)
+      FieldIo<D> const * fieldIoPtr_;
+
       /// Return associated domain by reference.
       Mesh<D> const & mesh() const;
 
+      /// Axes along which all w fields were invariant in last compute.
+      IntVec<D> invariantAxes_;
+
       /// Has stress been computed for current w fields?
       bool hasStress_;
 
+      /// Store concentration fields for each block? (optional, default true)
+      bool storeBlockC_;
+
+      /// Solve the MDE on a reduced mesh if possible? (default true)
+      bool reduceMesh_;
+
+      /// Store propagators in symmetry-adapted basis? (default false)
+      bool compressQ_;
+
+      /**
+      * Set invariantAxes_ by examining all w fields.
+      *
+      * \param wFields  array of chemical potential fields
+      */
+      void findInvariantAxes(DArray< RField<D> > const & wFields);
+
    };
 
    // Inline member function
@@ -230,6 +340,11 @@ namespace Pspc
       return stress_[n]; 
    }
 
+   // Get target contour length step size.
+   template <int D>
+   inline double Mixture<D>::ds() const
+   {  return ds_; }
+
    // Get Mesh<D> by constant reference (private).
    template <int D>
    inline Mesh<D> const & Mixture<D>::mesh() const
@@ -10,6 +10,9 @@
 
 #include "Mixture.h"
 #include <pscf/mesh/Mesh.h>
+#include <pscf/crystal/Basis.h>
+#include <pspc/field/FieldIo.h>
+#include <pspc/field/FieldExpr.h>
 
 #include <cmath>
 
@@ -22,7 +25,13 @@ namespace Pspc
     : ds_(-1.0),
       meshPtr_(0),
       unitCellPtr_(0),
-      hasStress_(false)
+      basisPtr_(0),
+      fieldIoPtr_(0),
+      invariantAxes_(0),
+      hasStress_(false),
+      storeBlockC_(true),
+      reduceMesh_(true),
+      compressQ_(false)
    {  setClassName("Mixture"); }
 
    template <int D>
@@ -34,10 +43,23 @@ namespace Pspc
    {
       MixtureTmpl< Polymer<D>, Solvent<D> >::readParameters(in);
       read(in, "ds", ds_);
+      readOptional(in, "storeBlockC", storeBlockC_);
+      readOptional(in, "reduceMesh", reduceMesh_);
+      readOptional(in, "compressQ", compressQ_);
 
       UTIL_CHECK(nMonomer() > 0);
       UTIL_CHECK(nPolymer()+ nSolvent() > 0);
       UTIL_CHECK(ds_ > 0);
+
+      // Disable storage of block concentrations if requested
+      if (!storeBlockC_) {
+         int i, j;
+         for (i = 0; i < nPolymer(); ++i) {
+            for (j = 0; j < polymer(i).nBlock(); ++j) {
+               polymer(i).block(j).setStoreCField(false);
+            }
+         }
+      }
    }
 
    template <int D>
@@ -47,6 +69,9 @@ namespace Pspc
       UTIL_CHECK(nPolymer()+ nSolvent() > 0);
       UTIL_CHECK(ds_ > 0);
 
+      // If called before, blocks are already allocated (remeshing)
+      bool isRemesh = (meshPtr_ != 0);
+
       // Save address of mesh
       meshPtr_ = &mesh;
 
@@ -55,7 +80,12 @@ namespace Pspc
          int i, j;
          for (i = 0; i < nPolymer(); ++i) {
             for (j = 0; j < polymer(i).nBlock(); ++j) {
-               polymer(i).block(j).setDiscretization(ds_, mesh);
+               if (polymer(i).multiplicity(j) == 0) continue;
+               if (isRemesh) {
+                  polymer(i).block(j).setMesh(mesh);
+               } else {
+                  polymer(i).block(j).setDiscretization(ds_, mesh);
+               }
             }
          }
       }
@@ -67,6 +97,7 @@ namespace Pspc
          }
       }
 
+      hasStress_ = false;
    }
 
    template <int D>
@@ -87,6 +118,17 @@ namespace Pspc
    }
 
 
+   /*
+   * Create associations with the basis and FieldIo.
+   */
+   template <int D>
+   void Mixture<D>::setFieldIo(Basis<D> const & basis, 
+                               FieldIo<D> const & fieldIo)
+   {
+      basisPtr_ = &basis;
+      fieldIoPtr_ = &fieldIo;
+   }
+
    /*
    * Reset statistical segment length for one monomer type.
    */
@@ -107,13 +149,78 @@ namespace Pspc
       hasStress_ = false;
    }
 
+   /*
+   * Reset target contour length step size for all blocks.
+   */
+   template <int D>
+   void Mixture<D>::setDs(double ds)
+   {
+      UTIL_CHECK(meshPtr_);
+      UTIL_CHECK(ds > 0);
+      ds_ = ds;
+      for (int i = 0; i < nPolymer(); ++i) {
+         for (int j =  0; j < polymer(i).nBlock(); ++j) {
+            if (polymer(i).multiplicity(j) == 0) continue;
+            polymer(i).block(j).setDs(ds);
+         }
+      }
+      hasStress_ = false;
+   }
+
+   /*
+   * Identify lattice axes along which all w fields are invariant.
+   */
+   template <int D>
+   void Mixture<D>::findInvariantAxes(DArray< RField<D> > const & wFields)
+   {
+      IntVec<D> const & dimensions = mesh().dimensions();
+      int nMesh = mesh().size();
+      int nm = nMonomer();
+
+      // Tolerance, relative to the largest magnitude of any w field
+      double wMax = 0.0;
+      int i, j, k;
+      for (i = 0; i < nm; ++i) {
+         for (k = 0; k < nMesh; ++k) {
+            if (std::abs(wFields[i][k]) > wMax) {
+               wMax = std::abs(wFields[i][k]);
+            }
+         }
+      }
+      double tolerance = 1.0E-10*(1.0 + wMax);
+
+      // A field is invariant along axis j if its value at every point 
+      // equals its value at the point with index 0 along axis j. This
+      // is equivalent to the vanishing of all Fourier coefficients for
+      // wavevectors with a nonzero index along axis j.
+      int stride = 1;
+      int n, base;
+      bool isInvariant;
+      for (j = D - 1; j >= 0; --j) {
+         n = dimensions[j];
+         isInvariant = (n > 1);
+         for (i = 0; i < nm && isInvariant; ++i) {
+            RField<D> const & w = wFields[i];
+            for (k = 0; k < nMesh; ++k) {
+               base = k - ((k/stride) % n)*stride;
+               if (std::abs(w[k] - w[base]) > tolerance) {
+                  isInvariant = false;
+                  break;
+               }
+            }
+         }
+         invariantAxes_[j] = isInvariant ? 1 : 0;
+         stride *= n;
+      }
+   }
+
    /*
    * Compute concentrations (but not total free energy).
    */
    template <int D>
    void Mixture<D>::compute(DArray< RField<D> > const & wFields,
                             DArray< RField<D> > & cFields,
-                            double phiTot)
+                            double phiTot, bool isSymmetric)
    {
       UTIL_CHECK(meshPtr_);
       UTIL_CHECK(mesh().size() > 0);
@@ -124,14 +231,40 @@ namespace Pspc
 
       int nMesh = mesh().size();
       int nm = nMonomer();
-      int i, j, k;
+      int i, j;
 
       // Clear all monomer concentration fields, check capacities
       for (i = 0; i < nm; ++i) {
          UTIL_CHECK(cFields[i].capacity() == nMesh);
          UTIL_CHECK(wFields[i].capacity() == nMesh);
-         for (j = 0; j < nMesh; ++j) {
-            cFields[i][j] = 0.0;
+         assign(cFields[i], 0.0);
+      }
+
+      // Identify axes along which all w fields are invariant, and
+      // solve the MDE on a reduced mesh if any are found
+      if (reduceMesh_) {
+         findInvariantAxes(wFields);
+         for (i = 0; i < nPolymer(); ++i) {
+            for (j = 0; j < polymer(i).nBlock(); ++j) {
+               if (polymer(i).multiplicity(j) == 0) continue;
+               polymer(i).block(j).setInvariantAxes(invariantAxes_);
+            }
+         }
+      }
+
+      // Choose storage format for propagators
+      if (compressQ_ && basisPtr_) {
+         FieldIo<D> const * fieldIoPtr = 0;
+         int nBasis = 0;
+         if (isSymmetric && basisPtr_->isInitialized()) {
+            fieldIoPtr = fieldIoPtr_;
+            nBasis = basisPtr_->nBasis();
+         }
+         for (i = 0; i < nPolymer(); ++i) {
+            for (j = 0; j < polymer(i).nBlock(); ++j) {
+               if (polymer(i).multiplicity(j) == 0) continue;
+               polymer(i).block(j).setCompression(fieldIoPtr, nBasis);
+            }
          }
       }
 
@@ -145,14 +278,18 @@ namespace Pspc
       int monomerId;
       for (i = 0; i < nPolymer(); ++i) {
          for (j = 0; j < polymer(i).nBlock(); ++j) {
+            if (polymer(i).multiplicity(j) == 0) continue;
             monomerId = polymer(i).block(j).monomerId();
             UTIL_CHECK(monomerId >= 0);
             UTIL_CHECK(monomerId < nm);
             RField<D>& monomerField = cFields[monomerId];
-            RField<D> const & blockField = polymer(i).block(j).cField();
-            UTIL_CHECK(blockField.capacity() == nMesh);
-            for (k = 0; k < nMesh; ++k) {
-               monomerField[k] += blockField[k];
+            if (storeBlockC_) {
+               RField<D> const & blockField = polymer(i).block(j).cField();
+               UTIL_CHECK(blockField.capacity() == nMesh);
+               addTo(monomerField, blockField);
+            } else {
+               // Integrate directly into the monomer field
+               polymer(i).block(j).addConcentration(monomerField);
             }
          }
       }
@@ -171,9 +308,7 @@ namespace Pspc
          RField<D>& monomerField = cFields[monomerId];
          RField<D> const & solventField = solvent(i).cField();
          UTIL_CHECK(solventField.capacity() == nMesh);
-         for (k = 0; k < nMesh; ++k) {
-            monomerField[k] += solventField[k];
-         }
+         addTo(monomerField, solventField);
 
       }
 
@@ -247,7 +382,7 @@ namespace Pspc
 
       int np = nSolvent() + nBlock();
       int nx = mesh().size();
-      int i, j;
+      int i, j, k, r, m;
 
       UTIL_CHECK(blockCFields.capacity() == nBlock() + nSolvent());
 
@@ -273,7 +408,24 @@ namespace Pspc
                UTIL_CHECK(sectionId < np);
                UTIL_CHECK(blockCFields[sectionId].capacity() == nx);
 
-               blockCFields[sectionId] = polymer(i).block(j).cField();
+               // Blocks of merged copies of a subtree each get an equal
+               // share of the concentration of the representative block
+               r = polymer(i).representative(j);
+               m = polymer(i).multiplicity(r);
+               UTIL_CHECK(m > 0);
+
+               Block<D> const & block = polymer(i).block(r);
+               if (block.storeCField()) {
+                  blockCFields[sectionId] = block.cField();
+               } else {
+                  // Recompute from stored propagators
+                  block.addConcentration(blockCFields[sectionId]);
+               }
+               if (m > 1) {
+                  for (k = 0; k < nx; ++k) {
+                     blockCFields[sectionId][k] /= double(m);
+                  }
+               }
             }
          }
       }
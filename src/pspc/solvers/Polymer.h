@@ -30,7 +30,8 @@ namespace Pspc {
    * The block concentrations stored in the constituent Block<D> objects
    * contain the block concentrations (i.e., volume fractions) computed 
    * in the most recent call of the compute function. These can be 
-   * accessed using the Block<D>::cField() function.
+   * accessed using the Block<D>::cField() function, unless storage of
+   * block concentrations has been disabled (see Block::setStoreCField).
    *
    * \ref user_param_polymer_sec "Parameter File Format"
    *
@@ -47,6 +47,7 @@ namespace Pspc {
       unitCellPtr_ = &unitCell;
 
       for (int j = 0; j < nBlock(); ++j) {
+         if (multiplicity(j) == 0) continue;
          block(j).setupUnitCell(unitCell);
       }
    }
@@ -58,9 +59,10 @@ namespace Pspc {
    void Polymer<D>::compute(DArray< RField<D> > const & wFields,
                             double phiTot)
    {
-      // Setup solvers for all blocks
+      // Setup solvers for all blocks (except merged duplicates)
       int monomerId;
       for (int j = 0; j < nBlock(); ++j) {
+         if (multiplicity(j) == 0) continue;
          monomerId = block(j).monomerId();
          block(j).setupSolver(wFields[monomerId]);
       }
@@ -84,7 +86,8 @@ namespace Pspc {
       // Compute and accumulate stress contributions from all blocks
       double prefactor = exp(mu_)/length();
       for (int i = 0; i < nBlock(); ++i) {
-         block(i).computeStress(prefactor);
+         if (multiplicity(i) == 0) continue;
+         block(i).computeStress(prefactor*multiplicity(i));
          for (int j = 0; j < unitCellPtr_->nParameter() ; ++j){
             stress_[j] += block(i).stress(j);
          }
@@ -20,6 +20,7 @@ namespace Pspc
 { 
 
    template <int D> class Block;
+   template <int D> class FieldIo;
    using namespace Util;
 
    /**
@@ -41,6 +42,15 @@ namespace Pspc
    * of the associated block, because that function has access to all 
    * the parameters used in the numerical solution.
    *
+   * By default, every slice q(r,s) is stored on the full spatial grid.
+   * If the w fields and the head of the propagator have the space group
+   * symmetry of the associated basis, every slice has this symmetry, and
+   * storage may be compressed by calling setCompression. Interior slices 
+   * (all but the head and tail) are then stored as components in the 
+   * symmetry-adapted basis, which reduces memory use by a factor close
+   * to the order of the space group. Compressed slices are reconstructed
+   * as needed by the q(int, QField&) function.
+   *
    * \ingroup Pspc_Solver_Module
    */
    template <int D>
@@ -111,8 +121,12 @@ namespace Pspc
       * 
       * This function is used when the value of ns is changed after initial
       * allocation. This occurs during parameter sweeps that change the
-      * block length. See the docs for the function ns() for the definition
-      * of ns.
+      * block length, or when the contour step is changed. See the docs 
+      * for the function ns() for the definition of ns.
+      *
+      * If ns does not exceed the largest value for which memory was
+      * previously allocated, the existing slice storage is reused 
+      * rather than freed and reallocated.
       *
       * The spatial mesh is set by derefencing a pointer to the associated
       * Mesh<D> object, which was set by a previous call to allocate.
@@ -124,6 +138,32 @@ namespace Pspc
       */ 
       void reallocate(int ns);
 
+      /**
+      * Release all memory used by this propagator.
+      *
+      * Also disables compressed storage. After this call, allocate may
+      * be called again, e.g., with a different mesh.
+      */ 
+      void deallocate();
+
+      /**
+      * Enable or disable symmetry-compressed storage of slices.
+      *
+      * If fieldIoPtr is nonzero, interior slices are stored as nBasis
+      * components in the symmetry-adapted basis of the associated 
+      * FieldIo<D>, and are converted using its basis conversion 
+      * functions. If fieldIoPtr is null, all slices are stored on the
+      * full r-grid. Memory is reallocated if the storage format is 
+      * changed, which marks the propagator as unsolved.
+      *
+      * Compressed storage may only be used if all subsequent solutions
+      * have the space group symmetry of the basis.
+      *
+      * \param fieldIoPtr  pointer to FieldIo<D> for conversion, or null
+      * \param nBasis  number of basis functions (if fieldIoPtr != 0)
+      */ 
+      void setCompression(FieldIo<D> const * fieldIoPtr, int nBasis = 0);
+
       /**
       * Solve the modified diffusion equation (MDE) for this block.
       *
@@ -164,10 +204,35 @@ namespace Pspc
       /**
       * Return q-field at specified step.
       *
+      * If storage is compressed, this may only be called for the head
+      * (i = 0) or tail (i = ns - 1). Use q(int, QField&) otherwise.
+      *
       * \param i step index, 0 <= i < ns
       */
       const QField& q(int i) const;
 
+      /**
+      * Return q-field at specified step, reconstructing it if needed.
+      *
+      * If slice i is stored on the r-grid, this returns a reference to
+      * the stored slice and work is not used. If slice i is stored in
+      * compressed form, it is converted into work, and a reference to
+      * work is returned.
+      *
+      * \param i step index, 0 <= i < ns
+      * \param work  allocated field used for reconstruction, if needed
+      */
+      const QField& q(int i, QField& work) const;
+
+      /**
+      * Return symmetry-adapted basis components of an interior slice.
+      *
+      * May only be called if storage is compressed, for 0 < i < ns - 1.
+      *
+      * \param i step index
+      */
+      DArray<double> const & qBasis(int i) const;
+
       /**
       * Return q-field at beginning of the block (initial condition).
       */
@@ -198,6 +263,16 @@ namespace Pspc
       */
       bool isAllocated() const;
 
+      /**
+      * Are interior slices stored in the symmetry-adapted basis?
+      */
+      bool isCompressed() const;
+
+      /**
+      * Get the FieldIo<D> used for compressed storage.
+      */
+      FieldIo<D> const & fieldIo() const;
+
       // Inherited public members with non-dependent names
 
       using PropagatorTmpl< Propagator<D> >::nSource;
@@ -216,24 +291,51 @@ namespace Pspc
 
    private:
      
-      /// Array of statistical weight fields 
+      /// Array of statistical weight fields (r-grid)
       DArray<QField> qFields_;
 
-      /// Workspace
+      /// Basis components of interior slices (if compressed)
+      DArray< DArray<double> > qBasis_;
+
+      /// Workspace for current slice (if compressed)
       QField work_;
 
+      /// Workspace for next slice (if compressed)
+      QField work2_;
+
       /// Pointer to associated Block.
       Block<D>* blockPtr_;
 
       /// Pointer to associated Mesh
       Mesh<D> const * meshPtr_;
 
+      /// Pointer to FieldIo used for basis conversion (if compressed)
+      FieldIo<D> const * fieldIoPtr_;
+
+      /// Number of basis functions (if compressed)
+      int nBasis_;
+
       /// Number of grid points = # of contour length steps + 1
       int ns_;
 
       /// Is this propagator allocated?
       bool isAllocated_;
 
+      /// Are interior slices stored in the symmetry-adapted basis?
+      bool isCompressed_;
+
+      /**
+      * Allocate storage for all slices in the current format.
+      *
+      * Storage for interior slices in the other format is released.
+      */
+      void allocateSlices();
+
+      /**
+      * Solve the MDE from the current head, storing every slice.
+      */
+      void propagate();
+
    };
 
    // Inline member functions
@@ -260,7 +362,22 @@ namespace Pspc
    template <int D>
    inline 
    typename Propagator<D>::QField const& Propagator<D>::q(int i) const
-   {  return qFields_[i]; }
+   {
+      UTIL_CHECK(!isCompressed_ || i == 0 || i == ns_ - 1);
+      return qFields_[i]; 
+   }
+
+   /*
+   * Return basis components of an interior slice.
+   */
+   template <int D>
+   inline 
+   DArray<double> const & Propagator<D>::qBasis(int i) const
+   {
+      UTIL_CHECK(isCompressed_);
+      UTIL_CHECK(i > 0 && i < ns_ - 1);
+      return qBasis_[i]; 
+   }
 
    /*
    * Get the associated Block object.
@@ -284,6 +401,17 @@ namespace Pspc
    inline bool Propagator<D>::isAllocated() const
    {  return isAllocated_; }
 
+   template <int D>
+   inline bool Propagator<D>::isCompressed() const
+   {  return isCompressed_; }
+
+   template <int D>
+   inline FieldIo<D> const & Propagator<D>::fieldIo() const
+   {
+      UTIL_ASSERT(fieldIoPtr_);
+      return *fieldIoPtr_;
+   }
+
    /*
    * Associate this propagator with a unique block.
    */
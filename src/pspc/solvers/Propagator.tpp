@@ -11,6 +11,7 @@
 #include "Propagator.h"
 #include "Block.h"
 
+#include <pspc/field/FieldIo.h>
 #include <pscf/mesh/Mesh.h>
 
 namespace Pscf {
@@ -25,8 +26,11 @@ namespace Pspc {
    Propagator<D>::Propagator()
     : blockPtr_(0),
       meshPtr_(0),
+      fieldIoPtr_(0),
+      nBasis_(0),
       ns_(0),
-      isAllocated_(false)
+      isAllocated_(false),
+      isCompressed_(false)
    {}
 
    /*
@@ -47,9 +51,7 @@ namespace Pspc {
       meshPtr_ = &mesh;
 
       qFields_.allocate(ns);
-      for (int i = 0; i < ns; ++i) {
-         qFields_[i].allocate(mesh.dimensions());
-      }
+      allocateSlices();
       isAllocated_ = true;
    }
 
@@ -63,8 +65,18 @@ namespace Pspc {
       UTIL_CHECK(ns_ != ns);
       ns_ = ns;
 
+      // If the new ns fits in existing storage, reuse it. Slices with
+      // indices >= ns are retained for later use with a larger ns.
+      if (ns <= qFields_.capacity()) {
+         allocateSlices();
+         return;
+      }
+
       // Deallocate all memory previously used by this propagator.
       qFields_.deallocate();
+      if (qBasis_.isAllocated()) {
+         qBasis_.deallocate();
+      }
 
       // NOTE: The qFields_ container is a DArray<QField>, where QField
       // is a typedef for DFields<D>. The DArray::deallocate() function
@@ -74,10 +86,111 @@ namespace Pspc {
       // The RField<D> destructor deletes the the double* array that 
       // stores the field associated with each slice of the propagator.
 
-      // Allocate new memory for qFields_ using new value of ns
+      // Allocate new memory for slices using new value of ns
       qFields_.allocate(ns);
-      for (int i = 0; i < ns; ++i) {
-         qFields_[i].allocate(meshPtr_->dimensions());
+      allocateSlices();
+   }
+
+   /*
+   * Release all memory used by this propagator.
+   */
+   template <int D>
+   void Propagator<D>::deallocate()
+   {
+      UTIL_CHECK(isAllocated_);
+      qFields_.deallocate();
+      if (qBasis_.isAllocated()) {
+         qBasis_.deallocate();
+      }
+      if (work_.isAllocated()) {
+         work_.deallocate();
+         work2_.deallocate();
+      }
+      fieldIoPtr_ = 0;
+      nBasis_ = 0;
+      ns_ = 0;
+      isCompressed_ = false;
+      isAllocated_ = false;
+      setIsSolved(false);
+   }
+
+   /*
+   * Enable or disable symmetry-compressed storage of slices.
+   */
+   template <int D>
+   void Propagator<D>::setCompression(FieldIo<D> const * fieldIoPtr, 
+                                      int nBasis)
+   {
+      UTIL_CHECK(isAllocated_);
+      bool isCompressed = (fieldIoPtr != 0);
+      if (isCompressed) {
+         UTIL_CHECK(nBasis > 0);
+      } else {
+         nBasis = 0;
+      }
+      fieldIoPtr_ = fieldIoPtr;
+      if (isCompressed == isCompressed_ && nBasis == nBasis_) return;
+
+      isCompressed_ = isCompressed;
+      nBasis_ = nBasis;
+      allocateSlices();
+      setIsSolved(false);
+   }
+
+   /*
+   * Allocate storage for all slices in the current format.
+   */
+   template <int D>
+   void Propagator<D>::allocateSlices()
+   {
+      UTIL_CHECK(qFields_.capacity() >= ns_);
+      IntVec<D> const & dimensions = meshPtr_->dimensions();
+
+      // Head and tail are always stored on the r-grid
+      if (!qFields_[0].isAllocated()) {
+         qFields_[0].allocate(dimensions);
+      }
+      if (!qFields_[ns_ - 1].isAllocated()) {
+         qFields_[ns_ - 1].allocate(dimensions);
+      }
+
+      int i;
+      if (isCompressed_) {
+         if (qBasis_.isAllocated() && qBasis_.capacity() < ns_) {
+            qBasis_.deallocate();
+         }
+         if (!qBasis_.isAllocated()) {
+            qBasis_.allocate(qFields_.capacity());
+         }
+         for (i = 1; i < ns_ - 1; ++i) {
+            if (qFields_[i].isAllocated()) {
+               qFields_[i].deallocate();
+            }
+            if (qBasis_[i].isAllocated() 
+                && qBasis_[i].capacity() != nBasis_) {
+               qBasis_[i].deallocate();
+            }
+            if (!qBasis_[i].isAllocated()) {
+               qBasis_[i].allocate(nBasis_);
+            }
+         }
+         if (!work_.isAllocated()) {
+            work_.allocate(dimensions);
+            work2_.allocate(dimensions);
+         }
+      } else {
+         if (qBasis_.isAllocated()) {
+            qBasis_.deallocate();
+         }
+         for (i = 1; i < ns_ - 1; ++i) {
+            if (!qFields_[i].isAllocated()) {
+               qFields_[i].allocate(dimensions);
+            }
+         }
+         if (work_.isAllocated()) {
+            work_.deallocate();
+            work2_.deallocate();
+         }
       }
    }
 
@@ -118,9 +231,7 @@ namespace Pspc {
    {
       UTIL_CHECK(isAllocated());
       computeHead();
-      for (int iStep = 0; iStep < ns_ - 1; ++iStep) {
-         block().step(qFields_[iStep], qFields_[iStep + 1]);
-      }
+      propagate();
       setIsSolved(true);
    }
 
@@ -140,12 +251,52 @@ namespace Pspc {
       }
 
       // Setup solver and solve
-      for (int iStep = 0; iStep < ns_ - 1; ++iStep) {
-         block().step(qFields_[iStep], qFields_[iStep + 1]);
-      }
+      propagate();
       setIsSolved(true);
    }
 
+   /*
+   * Solve the MDE from the head, storing every slice.
+   */
+   template <int D>
+   void Propagator<D>::propagate()
+   {
+      if (!isCompressed_) {
+         for (int iStep = 0; iStep < ns_ - 1; ++iStep) {
+            block().step(qFields_[iStep], qFields_[iStep + 1]);
+         }
+         return;
+      }
+
+      // Compressed storage: Alternate between two r-grid work fields,
+      // and store each interior slice in the symmetry-adapted basis
+      QField const * qPtr = &qFields_[0];
+      QField* qNewPtr;
+      for (int iStep = 0; iStep < ns_ - 2; ++iStep) {
+         qNewPtr = (iStep % 2 == 0) ? &work_ : &work2_;
+         block().step(*qPtr, *qNewPtr);
+         fieldIo().convertRGridToBasis(*qNewPtr, qBasis_[iStep + 1], 
+                                       false);
+         qPtr = qNewPtr;
+      }
+      block().step(*qPtr, qFields_[ns_ - 1]);
+   }
+
+   /*
+   * Return q-field at specified step, reconstructing it if needed.
+   */
+   template <int D>
+   typename Propagator<D>::QField const & 
+   Propagator<D>::q(int i, QField& work) const
+   {
+      UTIL_CHECK(i >= 0 && i < ns_);
+      if (!isCompressed_ || i == 0 || i == ns_ - 1) {
+         return qFields_[i];
+      }
+      fieldIo().convertBasisToRGrid(qBasis_[i], work);
+      return work;
+   }
+
    /*
    * Compute spatial average of product of head and tail of partner.
    */
@@ -45,6 +45,9 @@ namespace Pspc {
       /**
       * Set association with Mesh and allocate concentration field array.
       *
+      * May be called again after a change in mesh dimensions, in which 
+      * case the concentration field is reallocated.
+      *
       * \param mesh associated Mesh<D> object
       */
       void setDiscretization(Mesh<D> const & mesh);
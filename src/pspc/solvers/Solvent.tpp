@@ -36,6 +36,9 @@ namespace Pspc {
    void Solvent<D>::setDiscretization(Mesh<D> const & mesh)
    {
       meshPtr_ = &mesh;
+      if (cField_.isAllocated()) {
+         cField_.deallocate();
+      }
       cField_.allocate(mesh.dimensions());
    }
 
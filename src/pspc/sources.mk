@@ -2,12 +2,16 @@ include $(SRC_DIR)/pspc/field/sources.mk
 include $(SRC_DIR)/pspc/solvers/sources.mk
 include $(SRC_DIR)/pspc/iterator/sources.mk
 include $(SRC_DIR)/pspc/sweep/sources.mk
+include $(SRC_DIR)/pspc/misc/sources.mk
+include $(SRC_DIR)/pspc/analyzer/sources.mk
 
 pspc_= \
   $(pspc_field_) \
   $(pspc_solvers_) \
   $(pspc_iterator_) \
   $(pspc_sweep_) \
+  $(pspc_misc_) \
+  $(pspc_analyzer_) \
   pspc/System.cpp 
 
 pspc_SRCS=\
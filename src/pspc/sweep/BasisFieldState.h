@@ -45,7 +45,12 @@ namespace Pspc
       /**
       * Allocate all fields.
       *
-      * Precondition: hasSystem() == true
+      * Constructs the system basis if it has not been constructed.
+      * Fields already allocated with a number of basis functions that
+      * differs from that of the system basis are reallocated.
+      *
+      * Precondition: hasSystem() == true, and the system unit cell
+      * must be initialized if the basis has not been constructed.
       */
       void allocate();
 
@@ -58,12 +58,19 @@ namespace Pspc
          fields().allocate(nMonomer);
       }
 
+      // Construct basis if necessary (requires an initialized unit cell)
+      if (!system().basis().isInitialized()) {
+         system().makeBasis();
+      }
+
+      // Reallocate if nBasis has changed (see System::setMesh)
       int nBasis = system().basis().nBasis();
       UTIL_CHECK(nBasis > 0);
       for (int i = 0; i < nMonomer; ++i) {
-         if (field(i).isAllocated()) {
-            UTIL_CHECK(field(i).capacity() == nBasis);
-         } else {
+         if (field(i).isAllocated() && field(i).capacity() != nBasis) {
+            field(i).deallocate();
+         }
+         if (!field(i).isAllocated()) {
             field(i).allocate(nBasis);
          }
       }
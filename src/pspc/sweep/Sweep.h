@@ -10,6 +10,7 @@
 
 #include <pscf/sweep/SweepTmpl.h>          // base class template
 #include <pspc/sweep/BasisFieldState.h>    // base class template parameter
+#include <pspc/sweep/SweepArchive.h>       // member
 #include "SweepParameter.h" // parameter class
 #include <util/global.h>
 
@@ -119,6 +120,28 @@ namespace Pspc {
       */
       virtual void cleanup();
 
+      /**
+      * Get the log stream of the parent system.
+      */
+      virtual std::ostream& logFile() const;
+
+      /**
+      * Get the error tolerance of the current iterator.
+      */
+      virtual double iteratorEpsilon() const;
+
+      /**
+      * Set the error tolerance of the current iterator.
+      *
+      * \param epsilon  new error tolerance
+      */
+      virtual void setIteratorEpsilon(double epsilon);
+
+      /**
+      * Get the estimated free energy error from the current iterator.
+      */
+      virtual double iteratorFError() const;
+
       /**
       * Has an association with the parent System been set?
       */
@@ -140,11 +163,16 @@ namespace Pspc {
       /// Whether to write real space potential field files. 
       bool writeWRGrid_;
 
+      /// Whether to write all solutions to a single archive file.
+      bool writeArchive_;
+
       // Protected members inherited from base classes
       using SweepTmpl< BasisFieldState<D> >::ns_;
       using SweepTmpl< BasisFieldState<D> >::baseFileName_;
       using SweepTmpl< BasisFieldState<D> >::initialize;
       using SweepTmpl< BasisFieldState<D> >::setCoefficients;
+      using SweepTmpl< BasisFieldState<D> >::looseEpsilon_;
+      using SweepTmpl< BasisFieldState<D> >::isLoose;
       using ParamComposite::readOptional;
 
    private:
@@ -155,8 +183,11 @@ namespace Pspc {
       /// Unit cell parameters for trial state 
       FSArray<double, 6> unitCellParameters_;
 
-      /// Log file for summary output
-      std::ofstream logFile_;
+      /// Sweep summary file (sweep.log), distinct from logFile()
+      std::ofstream sweepLog_;
+
+      /// Archive file for solutions (used iff writeArchive_ is true)
+      SweepArchive<D> archive_;
 
       /// Pointer to parent system.
       System<D>* systemPtr_;
@@ -167,6 +198,9 @@ namespace Pspc {
       /// Output brief summary of thermodynamic properties
       void outputSummary(std::ostream&);
 
+      /// Output tolerance and free energy error (if looseEpsilon > 0)
+      void outputConvergence(std::ostream&);
+
    };
 
 } // namespace Pspc
@@ -13,6 +13,8 @@
 #include <util/misc/FileMaster.h>
 #include <util/misc/ioUtil.h>
 
+#include <sstream>
+
 namespace Pscf {
 namespace Pspc {
 
@@ -30,6 +32,8 @@ namespace Pspc {
       writeCRGrid_(false),
       writeCBasis_(false),
       writeWRGrid_(false),
+      writeArchive_(false),
+      archive_(),
       systemPtr_(0)
    {}
 
@@ -42,6 +46,8 @@ namespace Pspc {
       writeCRGrid_(false),
       writeCBasis_(false),
       writeWRGrid_(false),
+      writeArchive_(false),
+      archive_(system),
       systemPtr_(&system)
    {}
 
@@ -57,7 +63,10 @@ namespace Pspc {
    */
    template <int D>
    void Sweep<D>::setSystem(System<D>& system) 
-   {  systemPtr_ = &system; }
+   {  
+      systemPtr_ = &system; 
+      archive_.setSystem(system);
+   }
 
    /*
    * Read parameters
@@ -72,6 +81,7 @@ namespace Pspc {
       readOptional(in, "writeCRGrid", writeCRGrid_);
       readOptional(in, "writeCBasis", writeCBasis_);
       readOptional(in, "writeWRGrid", writeWRGrid_);
+      readOptional(in, "writeArchive", writeArchive_);
    }
 
    /*
@@ -98,9 +108,18 @@ namespace Pspc {
       // Open log summary file
       std::string fileName = baseFileName_;
       fileName += "sweep.log";
-      system().fileMaster().openOutputFile(fileName, logFile_);
-      logFile_ << " step             ds     free_energy        pressure"
-               << std::endl;
+      system().fileMaster().openOutputFile(fileName, sweepLog_);
+      sweepLog_ << " step             ds     free_energy        pressure";
+      system().analyzerManager().writeHeader(sweepLog_);
+      sweepLog_ << std::endl;
+
+      // Open single-file archive of solutions, if requested
+      if (writeArchive_) {
+         fileName = baseFileName_;
+         fileName += "sweep.arc";
+         archive_.openWrite(fileName, writeCBasis_, writeCRGrid_, 
+                            writeWRGrid_);
+      }
    };
 
    /*
@@ -135,6 +154,9 @@ namespace Pspc {
          // Compute coefficients of polynomial extrapolation to sNew
          setCoefficients(sNew);
 
+         // Resize trial_ if the mesh has changed since setup
+         trial_.allocate();
+
          // Set extrapolated trial w fields 
          double coeff;
          int nMonomer = system().mixture().nMonomer();
@@ -248,17 +270,36 @@ namespace Pspc {
       state(0).setSystem(system());
       state(0).getSystemState(); 
 
+      // Evaluate any in-situ analyzers for the converged solution
+      system().analyzerManager().compute();
+
       // Output converged solution to several files
       outputSolution();
 
       // Output summary to log file
-      outputSummary(logFile_);
+      outputSummary(sweepLog_);
 
    };
 
+   /*
+   * Output data for the current solution.
+   *
+   * States accepted at the loose tolerance (see isLoose()) are not
+   * accurate enough to be used as fields, so only the .dat file is 
+   * written for them, and no archive record is appended.
+   */
    template <int D>
    void Sweep<D>::outputSolution()
    {
+      // If archiving, write one record rather than separate files
+      if (writeArchive_) {
+         if (isLoose()) return;
+         std::ostringstream convergence;
+         outputConvergence(convergence);
+         archive_.append(nAccept() - 1, s(0), convergence.str());
+         return;
+      }
+
       std::ofstream out;
       std::string outFileName;
       std::string indexString = toString(nAccept() - 1);
@@ -273,8 +314,12 @@ namespace Pspc {
       system().writeParamNoSweep(out);
       out << std::endl;
       system().writeThermo(out);
+      outputConvergence(out);
       out.close();
 
+      // Do not write fields of a loosely converged state
+      if (isLoose()) return;
+
       // Write w fields
       outFileName = baseFileName_;
       outFileName += indexString;
@@ -330,12 +375,62 @@ namespace Pspc {
       out << Int(i,5) << Dbl(sNew)
           << Dbl(system().fHelmholtz(),16)
           << Dbl(system().pressure(),16);
+      system().analyzerManager().writeValues(out);
+      out << std::endl;
+   }
+
+   /*
+   * Output the tolerance to which the current solution was converged.
+   *
+   * Written only if looseEpsilon is positive, so that output of sweeps 
+   * that always use the full tolerance is unchanged.
+   */
+   template <int D>
+   void Sweep<D>::outputConvergence(std::ostream& out)
+   {
+      if (looseEpsilon_ <= 0.0) return;
+      double epsilon = isLoose() ? looseEpsilon_ : iteratorEpsilon();
+      out << "Convergence:" << std::endl;
+      out << "epsilon       " << Dbl(epsilon, 18, 11) << std::endl;
+      out << "fError        " << Dbl(iteratorFError(), 18, 11) 
+          << std::endl;
       out << std::endl;
    }
 
    template <int D>
    void Sweep<D>::cleanup() 
-   {  logFile_.close(); }
+   {  
+      sweepLog_.close(); 
+      archive_.close();
+   }
+
+   /*
+   * Get the log stream of the parent system.
+   */
+   template <int D>
+   std::ostream& Sweep<D>::logFile() const
+   {  return systemPtr_->logFile(); }
+
+   /*
+   * Get the error tolerance of the current iterator.
+   */
+   template <int D>
+   double Sweep<D>::iteratorEpsilon() const
+   {  return systemPtr_->iterator().epsilon(); }
+
+   /*
+   * Set the error tolerance of the current iterator.
+   */
+   template <int D>
+   void Sweep<D>::setIteratorEpsilon(double epsilon)
+   {  systemPtr_->iterator().setEpsilon(epsilon); }
+
+   /*
+   * Get the estimated free energy error from the current iterator.
+   */
+   template <int D>
+   double Sweep<D>::iteratorFError() const
+   {  return systemPtr_->iterator().fError(); }
 
 } // namespace Pspc
 } // namespace Pscf
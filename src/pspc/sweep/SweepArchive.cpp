@@ -0,0 +1,19 @@
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "SweepArchive.tpp"
+
+namespace Pscf {
+namespace Pspc
+{
+
+   template class SweepArchive<1>;
+   template class SweepArchive<2>;
+   template class SweepArchive<3>;
+
+} // namespace Pspc
+} // namespace Pscf
@@ -0,0 +1,280 @@
+#ifndef PSPC_SWEEP_ARCHIVE_H
+#define PSPC_SWEEP_ARCHIVE_H
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <pspc/field/RField.h>             // member template argument
+#include <pscf/crystal/UnitCell.h>         // member
+#include <util/containers/DArray.h>        // member template
+#include <util/containers/GArray.h>        // member template
+
+#include <fstream>
+#include <string>
+
+namespace Pscf {
+namespace Pspc {
+
+   template <int D> class System;
+
+   using namespace Util;
+
+   /**
+   * Single-file binary archive of the solutions along a sweep.
+   *
+   * A SweepArchive stores all of the data that Sweep<D>::outputSolution
+   * otherwise writes to several files per accepted step in a single
+   * append-only binary file. The file contains a header, one record per
+   * accepted step and a trailing index of record offsets, which allows
+   * random access to any step.
+   *
+   * File layout (native byte order):
+   *
+   *    - header: magic "PSCFSWP1", then int32 values for the version,
+   *      D, nMonomer, nBasis, the D mesh dimensions and a flag word
+   *      that records which optional field types are stored, then the
+   *      space group name and the unit cell (lattice system and
+   *      parameters, in text form) at the time the file was created.
+   *
+   *    - record: magic "STEP", int64 number of bytes that follow,
+   *      int32 step index, double sweep variable s, the parameter file
+   *      text (as for writeParamNoSweep), the thermodynamic text (as for
+   *      writeThermo, followed by any convergence data that the sweep
+   *      writes to the .dat file), int32 nParameter followed by the 
+   *      unit cell parameters, then the w fields in basis format and, 
+   *      if enabled, c fields in basis format, c fields in r-grid format
+   *      and w fields in r-grid format, all as arrays of double. Strings
+   *      are stored as an int64 length followed by characters.
+   *
+   *    - index: magic "INDX", int32 number of steps and one int64 file
+   *      offset per record, followed by a fixed-size footer containing
+   *      the int64 offset of the index and the magic "PSCFEND1".
+   *
+   * Each new record overwrites the previous index, and a new index and
+   * footer are written after it, so the file is valid after each step.
+   * If the footer is missing (e.g., after a crash), openRead recovers
+   * the index by scanning records from the start of the file.
+   *
+   * \ingroup Pspc_Sweep_Module
+   */
+   template <int D>
+   class SweepArchive
+   {
+
+   public:
+
+      /**
+      * Default constructor.
+      */
+      SweepArchive();
+
+      /**
+      * Constructor, creates association with parent system.
+      *
+      * \param system  parent System
+      */
+      SweepArchive(System<D>& system);
+
+      /**
+      * Destructor.
+      */
+      ~SweepArchive();
+
+      /**
+      * Set association with parent System.
+      *
+      * \param system  parent System
+      */
+      void setSystem(System<D>& system);
+
+      /// \name Writing
+      //@{
+
+      /**
+      * Create a new archive file and write the header.
+      *
+      * \param filename  name of archive file (opened via FileMaster)
+      * \param hasCBasis  store c fields in basis format?
+      * \param hasCRGrid  store c fields in r-grid format?
+      * \param hasWRGrid  store w fields in r-grid format?
+      */
+      void openWrite(std::string const & filename, bool hasCBasis,
+                     bool hasCRGrid, bool hasWRGrid);
+
+      /**
+      * Append a record for the current state of the parent System.
+      *
+      * \param step  index of accepted sweep step
+      * \param s  sweep contour variable for this step
+      * \param thermoSuffix  text appended to the thermodynamic text
+      */
+      void append(int step, double s, 
+                  std::string const & thermoSuffix = "");
+
+      //@}
+      /// \name Reading
+      //@{
+
+      /**
+      * Open an existing archive file and read its index.
+      *
+      * The mesh, number of monomers and space group must match those 
+      * of the parent System. If the system unit cell is not yet 
+      * initialized, it is set from the archive header. The basis is
+      * then constructed if necessary (see System::makeBasis), and the
+      * number of basis functions must match that of the archive.
+      *
+      * \param filename  name of archive file (opened via FileMaster)
+      */
+      void openRead(std::string const & filename);
+
+      /**
+      * Number of steps stored in an archive opened for reading.
+      */
+      int nStep() const;
+
+      /**
+      * Read the record with index i (0 <= i < nStep()).
+      *
+      * The contents of the record are available through the accessors
+      * below until the next call to readStep.
+      *
+      * \param i  record index
+      */
+      void readStep(int i);
+
+      /**
+      * Write the current record to files in the legacy sweep format.
+      *
+      * Writes the files <base><step>.dat and <base><step>_w.bf, as
+      * well as _c.bf, _c.rf and _w.rf files for field types that are
+      * stored in the archive.
+      *
+      * \param baseFileName  prefix for output file names
+      */
+      void extract(std::string const & baseFileName);
+
+      /// Step index of current record.
+      int step() const
+      {  return step_; }
+
+      /// Sweep variable s of current record.
+      double s() const
+      {  return s_; }
+
+      /// Parameter file text of current record.
+      std::string const & paramText() const
+      {  return paramText_; }
+
+      /// Thermodynamic output text of current record.
+      std::string const & thermoText() const
+      {  return thermoText_; }
+
+      /// Unit cell of current record.
+      UnitCell<D> const & unitCell() const
+      {  return unitCell_; }
+
+      /// W fields of current record in basis format.
+      DArray< DArray<double> > const & wBasis() const
+      {  return wBasis_; }
+
+      /// C fields of current record in basis format (if stored).
+      DArray< DArray<double> > const & cBasis() const
+      {  return cBasis_; }
+
+      /// C fields of current record in r-grid format (if stored).
+      DArray< RField<D> > const & cRGrid() const
+      {  return cRGrid_; }
+
+      /// W fields of current record in r-grid format (if stored).
+      DArray< RField<D> > const & wRGrid() const
+      {  return wRGrid_; }
+
+      /// Does the archive store c fields in basis format?
+      bool hasCBasis() const
+      {  return hasCBasis_; }
+
+      /// Does the archive store c fields in r-grid format?
+      bool hasCRGrid() const
+      {  return hasCRGrid_; }
+
+      /// Does the archive store w fields in r-grid format?
+      bool hasWRGrid() const
+      {  return hasWRGrid_; }
+
+      //@}
+
+      /**
+      * Close the archive file (writes nothing further).
+      */
+      void close();
+
+   private:
+
+      /// Output stream (write mode).
+      std::ofstream out_;
+
+      /// Input stream (read mode).
+      std::ifstream in_;
+
+      /// File offsets of all records.
+      GArray<long long> offsets_;
+
+      /// Buffers for current record (read mode).
+      std::string paramText_;
+      std::string thermoText_;
+      UnitCell<D> unitCell_;
+      DArray< DArray<double> > wBasis_;
+      DArray< DArray<double> > cBasis_;
+      DArray< RField<D> > cRGrid_;
+      DArray< RField<D> > wRGrid_;
+      double s_;
+
+      /// End of file (write mode).
+      long long fileEnd_;
+
+      int step_;
+
+      /// Pointer to parent System.
+      System<D>* systemPtr_;
+
+      /// Optional field types.
+      bool hasCBasis_;
+      bool hasCRGrid_;
+      bool hasWRGrid_;
+
+      /// Is the archive open for writing?
+      bool isWriting_;
+
+      /// Is the archive open for reading?
+      bool isReading_;
+
+      /// Write index and footer at the current output position.
+      void writeIndex();
+
+      /// Recover record offsets by scanning from the header.
+      void scanRecords(long long headerEnd);
+
+      /// Allocate read buffers, if necessary.
+      void allocate();
+
+      /// Return parent System by reference.
+      System<D>& system()
+      {  return *systemPtr_; }
+
+   };
+
+   #ifndef PSPC_SWEEP_ARCHIVE_TPP
+   // Suppress implicit instantiation
+   extern template class SweepArchive<1>;
+   extern template class SweepArchive<2>;
+   extern template class SweepArchive<3>;
+   #endif
+
+} // namespace Pspc
+} // namespace Pscf
+#endif
@@ -0,0 +1,548 @@
+#ifndef PSPC_SWEEP_ARCHIVE_TPP
+#define PSPC_SWEEP_ARCHIVE_TPP
+
+/*
+* PSCF - Polymer Self-Consistent Field Theory
+*
+* Copyright 2016 - 2022, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "SweepArchive.h"
+#include <pspc/System.h>
+#include <util/misc/FileMaster.h>
+#include <util/misc/ioUtil.h>
+#include <util/containers/FSArray.h>
+#include <util/global.h>
+
+#include <sstream>
+#include <cstring>
+
+namespace Pscf {
+namespace Pspc {
+
+   using namespace Util;
+
+   namespace {
+
+      // Flag bits for optional field types in the header
+      const int SWEEP_ARCHIVE_C_BASIS = 1;
+      const int SWEEP_ARCHIVE_C_RGRID = 2;
+      const int SWEEP_ARCHIVE_W_RGRID = 4;
+
+      const int SWEEP_ARCHIVE_VERSION = 2;
+
+      template <typename T>
+      void writeBinary(std::ostream& out, T value)
+      {  out.write(reinterpret_cast<char const *>(&value), sizeof(T)); }
+
+      template <typename T>
+      void readBinary(std::istream& in, T& value)
+      {  in.read(reinterpret_cast<char*>(&value), sizeof(T)); }
+
+      void writeBinary(std::ostream& out, std::string const & string)
+      {
+         long long n = string.size();
+         writeBinary(out, n);
+         out.write(string.c_str(), n);
+      }
+
+      void readBinary(std::istream& in, std::string& string)
+      {
+         long long n;
+         readBinary(in, n);
+         UTIL_CHECK(n >= 0);
+         string.resize(n);
+         if (n > 0) {
+            in.read(&string[0], n);
+         }
+      }
+
+      void writeMagic(std::ostream& out, char const * magic)
+      {  out.write(magic, strlen(magic)); }
+
+      bool checkMagic(std::istream& in, char const * magic)
+      {
+         int n = strlen(magic);
+         char buffer[16];
+         UTIL_CHECK(n < 16);
+         in.read(buffer, n);
+         if (!in.good()) return false;
+         return (strncmp(buffer, magic, n) == 0);
+      }
+
+   }
+
+   /*
+   * Default constructor.
+   */
+   template <int D>
+   SweepArchive<D>::SweepArchive()
+    : s_(0.0),
+      fileEnd_(0),
+      step_(-1),
+      systemPtr_(0),
+      hasCBasis_(false),
+      hasCRGrid_(false),
+      hasWRGrid_(false),
+      isWriting_(false),
+      isReading_(false)
+   {}
+
+   /*
+   * Constructor, creates association with parent system.
+   */
+   template <int D>
+   SweepArchive<D>::SweepArchive(System<D>& system)
+    : s_(0.0),
+      fileEnd_(0),
+      step_(-1),
+      systemPtr_(&system),
+      hasCBasis_(false),
+      hasCRGrid_(false),
+      hasWRGrid_(false),
+      isWriting_(false),
+      isReading_(false)
+   {}
+
+   /*
+   * Destructor.
+   */
+   template <int D>
+   SweepArchive<D>::~SweepArchive()
+   {  close(); }
+
+   /*
+   * Set association with parent system.
+   */
+   template <int D>
+   void SweepArchive<D>::setSystem(System<D>& system)
+   {  systemPtr_ = &system; }
+
+   /*
+   * Create archive file and write header.
+   */
+   template <int D>
+   void SweepArchive<D>::openWrite(std::string const & filename,
+                                   bool hasCBasis, bool hasCRGrid,
+                                   bool hasWRGrid)
+   {
+      UTIL_CHECK(systemPtr_);
+      UTIL_CHECK(!isWriting_);
+      UTIL_CHECK(!isReading_);
+
+      hasCBasis_ = hasCBasis;
+      hasCRGrid_ = hasCRGrid;
+      hasWRGrid_ = hasWRGrid;
+
+      system().fileMaster().openOutputFile(filename, out_,
+                                 std::ios_base::out | std::ios_base::binary);
+
+      // Header
+      int flags = 0;
+      if (hasCBasis_) flags |= SWEEP_ARCHIVE_C_BASIS;
+      if (hasCRGrid_) flags |= SWEEP_ARCHIVE_C_RGRID;
+      if (hasWRGrid_) flags |= SWEEP_ARCHIVE_W_RGRID;
+      writeMagic(out_, "PSCFSWP1");
+      writeBinary<int>(out_, SWEEP_ARCHIVE_VERSION);
+      writeBinary<int>(out_, D);
+      writeBinary<int>(out_, system().mixture().nMonomer());
+      writeBinary<int>(out_, system().basis().nBasis());
+      for (int i = 0; i < D; ++i) {
+         writeBinary<int>(out_, system().mesh().dimension(i));
+      }
+      writeBinary<int>(out_, flags);
+      std::ostringstream cellStream;
+      cellStream << system().unitCell();
+      writeBinary(out_, system().groupName());
+      writeBinary(out_, cellStream.str());
+
+      offsets_.clear();
+      fileEnd_ = 0;
+      isWriting_ = true;
+      writeIndex();
+   }
+
+   /*
+   * Append a record for the current system state.
+   */
+   template <int D>
+   void SweepArchive<D>::append(int step, double s, 
+                                std::string const & thermoSuffix)
+   {
+      UTIL_CHECK(isWriting_);
+      UTIL_CHECK(system().w().hasData());
+      UTIL_CHECK(system().w().isSymmetric());
+
+      int nMonomer = system().mixture().nMonomer();
+      int nBasis = system().basis().nBasis();
+      int nMesh = system().mesh().size();
+
+      // Text sections, as written to the legacy .dat file
+      std::ostringstream paramStream;
+      system().writeParamNoSweep(paramStream);
+      std::ostringstream thermoStream;
+      system().writeThermo(thermoStream);
+      thermoStream << thermoSuffix;
+
+      // New record overwrites the previous index
+      long long offset;
+      offset = out_.tellp();
+      offsets_.append(offset);
+
+      writeMagic(out_, "STEP");
+      long long sizePos = out_.tellp();
+      writeBinary<long long>(out_, 0);
+
+      writeBinary<int>(out_, step);
+      writeBinary<double>(out_, s);
+      writeBinary(out_, paramStream.str());
+      writeBinary(out_, thermoStream.str());
+
+      UnitCell<D> const & cell = system().unitCell();
+      int nParameter = cell.nParameter();
+      writeBinary<int>(out_, nParameter);
+      for (int i = 0; i < nParameter; ++i) {
+         writeBinary<double>(out_, cell.parameter(i));
+      }
+
+      int i;
+      for (i = 0; i < nMonomer; ++i) {
+         out_.write(reinterpret_cast<char const *>(
+                    system().w().basis(i).cArray()),
+                    nBasis*sizeof(double));
+      }
+      if (hasCBasis_) {
+         UTIL_CHECK(system().hasCFields());
+         for (i = 0; i < nMonomer; ++i) {
+            out_.write(reinterpret_cast<char const *>(
+                       system().c().basis(i).cArray()),
+                       nBasis*sizeof(double));
+         }
+      }
+      if (hasCRGrid_) {
+         for (i = 0; i < nMonomer; ++i) {
+            out_.write(reinterpret_cast<char const *>(
+                       system().c().rgrid(i).cField()),
+                       nMesh*sizeof(double));
+         }
+      }
+      if (hasWRGrid_) {
+         for (i = 0; i < nMonomer; ++i) {
+            out_.write(reinterpret_cast<char const *>(
+                       system().w().rgrid(i).cField()),
+                       nMesh*sizeof(double));
+         }
+      }
+
+      // Fill in record size
+      long long endPos = out_.tellp();
+      out_.seekp(sizePos);
+      writeBinary<long long>(out_, endPos - sizePos - sizeof(long long));
+      out_.seekp(endPos);
+
+      writeIndex();
+      out_.flush();
+      if (!out_.good()) {
+         UTIL_THROW("Error writing sweep archive");
+      }
+   }
+
+   /*
+   * Write index and footer at the current output position, then return
+   * to the start of the index, where the next record will begin.
+   */
+   template <int D>
+   void SweepArchive<D>::writeIndex()
+   {
+      long long indexPos = out_.tellp();
+      writeMagic(out_, "INDX");
+      writeBinary<int>(out_, offsets_.size());
+      for (int i = 0; i < offsets_.size(); ++i) {
+         writeBinary<long long>(out_, offsets_[i]);
+      }
+
+      // The file is never truncated, so pad if necessary to keep the 
+      // footer at the end of any stale data from a previous index.
+      long long footerSize = sizeof(long long) + 8;
+      long long pos = out_.tellp();
+      while (pos + footerSize < fileEnd_) {
+         out_.put('\0');
+         ++pos;
+      }
+      writeBinary<long long>(out_, indexPos);
+      writeMagic(out_, "PSCFEND1");
+      fileEnd_ = out_.tellp();
+      out_.seekp(indexPos);
+   }
+
+   /*
+   * Open an existing archive and read its index.
+   */
+   template <int D>
+   void SweepArchive<D>::openRead(std::string const & filename)
+   {
+      UTIL_CHECK(systemPtr_);
+      UTIL_CHECK(!isWriting_);
+      UTIL_CHECK(!isReading_);
+
+      system().fileMaster().openInputFile(filename, in_,
+                                 std::ios_base::in | std::ios_base::binary);
+
+      // Header
+      if (!checkMagic(in_, "PSCFSWP1")) {
+         UTIL_THROW("File is not a PSCF sweep archive");
+      }
+      int version, dim, nMonomer, nBasis, flags, n;
+      readBinary(in_, version);
+      readBinary(in_, dim);
+      readBinary(in_, nMonomer);
+      readBinary(in_, nBasis);
+      if (version != SWEEP_ARCHIVE_VERSION) {
+         UTIL_THROW("Unsupported sweep archive version");
+      }
+      UTIL_CHECK(dim == D);
+      UTIL_CHECK(nMonomer == system().mixture().nMonomer());
+      for (int i = 0; i < D; ++i) {
+         readBinary(in_, n);
+         UTIL_CHECK(n == system().mesh().dimension(i));
+      }
+      readBinary(in_, flags);
+      hasCBasis_ = (flags & SWEEP_ARCHIVE_C_BASIS);
+      hasCRGrid_ = (flags & SWEEP_ARCHIVE_C_RGRID);
+      hasWRGrid_ = (flags & SWEEP_ARCHIVE_W_RGRID);
+      std::string groupName, cellText;
+      readBinary(in_, groupName);
+      readBinary(in_, cellText);
+      if (!in_.good()) {
+         UTIL_THROW("Error reading sweep archive header");
+      }
+      long long headerEnd = in_.tellg();
+
+      // Check space group, set unit cell if necessary, construct basis
+      if (groupName != system().groupName()) {
+         system().logFile() << "Archive group: " << groupName 
+                            << "  System group: " << system().groupName() 
+                            << std::endl;
+         UTIL_THROW("Space group of sweep archive does not match system");
+      }
+      std::istringstream cellStream(cellText);
+      UnitCell<D> cell;
+      cellStream >> cell;
+      if (system().unitCell().isInitialized()) {
+         UTIL_CHECK(system().unitCell().lattice() == cell.lattice());
+      } else {
+         system().setUnitCell(cell);
+      }
+      system().makeBasis();
+      UTIL_CHECK(nBasis == system().basis().nBasis());
+
+      // Footer and index
+      offsets_.clear();
+      bool hasIndex = false;
+      long long footerSize = sizeof(long long) + 8;
+      in_.seekg(0, std::ios_base::end);
+      long long fileEnd = in_.tellg();
+      if (fileEnd - headerEnd >= footerSize) {
+         long long indexPos;
+         in_.seekg(fileEnd - footerSize);
+         readBinary(in_, indexPos);
+         if (checkMagic(in_, "PSCFEND1") && indexPos >= headerEnd) {
+            in_.seekg(indexPos);
+            if (checkMagic(in_, "INDX")) {
+               readBinary(in_, n);
+               long long offset;
+               for (int i = 0; i < n; ++i) {
+                  readBinary(in_, offset);
+                  offsets_.append(offset);
+               }
+               hasIndex = in_.good();
+            }
+         }
+      }
+      if (!hasIndex) {
+         in_.clear();
+         scanRecords(headerEnd);
+      }
+
+      allocate();
+      isReading_ = true;
+   }
+
+   /*
+   * Recover record offsets by scanning, for a file without an index.
+   */
+   template <int D>
+   void SweepArchive<D>::scanRecords(long long headerEnd)
+   {
+      offsets_.clear();
+      long long offset = headerEnd;
+      long long size;
+      in_.seekg(offset);
+      while (checkMagic(in_, "STEP")) {
+         readBinary(in_, size);
+         if (!in_.good() || size <= 0) break;
+         in_.seekg(size, std::ios_base::cur);
+         if (!in_.good()) break;
+         offsets_.append(offset);
+         offset = in_.tellg();
+      }
+      in_.clear();
+   }
+
+   /*
+   * Allocate buffers for one record.
+   */
+   template <int D>
+   void SweepArchive<D>::allocate()
+   {
+      int nMonomer = system().mixture().nMonomer();
+      int nBasis = system().basis().nBasis();
+      IntVec<D> const & dimensions = system().mesh().dimensions();
+      if (wBasis_.isAllocated()) return;
+
+      wBasis_.allocate(nMonomer);
+      for (int i = 0; i < nMonomer; ++i) {
+         wBasis_[i].allocate(nBasis);
+      }
+      if (hasCBasis_) {
+         cBasis_.allocate(nMonomer);
+         for (int i = 0; i < nMonomer; ++i) {
+            cBasis_[i].allocate(nBasis);
+         }
+      }
+      if (hasCRGrid_) {
+         cRGrid_.allocate(nMonomer);
+         for (int i = 0; i < nMonomer; ++i) {
+            cRGrid_[i].allocate(dimensions);
+         }
+      }
+      if (hasWRGrid_) {
+         wRGrid_.allocate(nMonomer);
+         for (int i = 0; i < nMonomer; ++i) {
+            wRGrid_[i].allocate(dimensions);
+         }
+      }
+   }
+
+   /*
+   * Get number of stored steps.
+   */
+   template <int D>
+   int SweepArchive<D>::nStep() const
+   {  return offsets_.size(); }
+
+   /*
+   * Read one record.
+   */
+   template <int D>
+   void SweepArchive<D>::readStep(int id)
+   {
+      UTIL_CHECK(isReading_);
+      UTIL_CHECK(id >= 0);
+      UTIL_CHECK(id < offsets_.size());
+
+      int nMonomer = system().mixture().nMonomer();
+      int nBasis = system().basis().nBasis();
+      int nMesh = system().mesh().size();
+
+      in_.clear();
+      in_.seekg(offsets_[id]);
+      if (!checkMagic(in_, "STEP")) {
+         UTIL_THROW("Corrupt record in sweep archive");
+      }
+      long long size;
+      readBinary(in_, size);
+      readBinary(in_, step_);
+      readBinary(in_, s_);
+      readBinary(in_, paramText_);
+      readBinary(in_, thermoText_);
+
+      int nParameter;
+      readBinary(in_, nParameter);
+      FSArray<double, 6> parameters;
+      double parameter;
+      for (int i = 0; i < nParameter; ++i) {
+         readBinary(in_, parameter);
+         parameters.append(parameter);
+      }
+      unitCell_ = system().unitCell();
+      UTIL_CHECK(nParameter == unitCell_.nParameter());
+      unitCell_.setParameters(parameters);
+
+      int i;
+      for (i = 0; i < nMonomer; ++i) {
+         in_.read(reinterpret_cast<char*>(wBasis_[i].cArray()),
+                  nBasis*sizeof(double));
+      }
+      if (hasCBasis_) {
+         for (i = 0; i < nMonomer; ++i) {
+            in_.read(reinterpret_cast<char*>(cBasis_[i].cArray()),
+                     nBasis*sizeof(double));
+         }
+      }
+      if (hasCRGrid_) {
+         for (i = 0; i < nMonomer; ++i) {
+            in_.read(reinterpret_cast<char*>(cRGrid_[i].cField()),
+                     nMesh*sizeof(double));
+         }
+      }
+      if (hasWRGrid_) {
+         for (i = 0; i < nMonomer; ++i) {
+            in_.read(reinterpret_cast<char*>(wRGrid_[i].cField()),
+                     nMesh*sizeof(double));
+         }
+      }
+      if (!in_.good()) {
+         UTIL_THROW("Error reading record from sweep archive");
+      }
+   }
+
+   /*
+   * Write current record in legacy sweep output format.
+   */
+   template <int D>
+   void SweepArchive<D>::extract(std::string const & baseFileName)
+   {
+      UTIL_CHECK(isReading_);
+      UTIL_CHECK(step_ >= 0);
+
+      FieldIo<D> const & fieldIo = system().fieldIo();
+      std::string base = baseFileName + toString(step_);
+      std::ofstream out;
+
+      system().fileMaster().openOutputFile(base + ".dat", out);
+      out << paramText_ << std::endl << thermoText_;
+      out.close();
+
+      fieldIo.writeFieldsBasis(base + "_w.bf", wBasis_, unitCell_);
+      if (hasCRGrid_) {
+         fieldIo.writeFieldsRGrid(base + "_c.rf", cRGrid_, unitCell_);
+      }
+      if (hasCBasis_) {
+         fieldIo.writeFieldsBasis(base + "_c.bf", cBasis_, unitCell_);
+      }
+      if (hasWRGrid_) {
+         fieldIo.writeFieldsRGrid(base + "_w.rf", wRGrid_, unitCell_);
+      }
+   }
+
+   /*
+   * Close file.
+   */
+   template <int D>
+   void SweepArchive<D>::close()
+   {
+      if (isWriting_) {
+         out_.close();
+         isWriting_ = false;
+      }
+      if (isReading_) {
+         in_.close();
+         isReading_ = false;
+      }
+   }
+
+} // namespace Pspc
+} // namespace Pscf
+#endif
@@ -2,6 +2,7 @@
 pspc_sweep_= \
   pspc/sweep/FieldState.cpp \
   pspc/sweep/BasisFieldState.cpp \
+  pspc/sweep/SweepArchive.cpp \
   pspc/sweep/Sweep.cpp \
   pspc/sweep/LinearSweep.cpp \
   pspc/sweep/SweepFactory.cpp
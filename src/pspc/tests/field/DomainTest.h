@@ -91,8 +91,9 @@ public:
       TEST_ASSERT(domain.unitCell().lattice() == domain.lattice());
       TEST_ASSERT(domain.group().size() == 96);
       TEST_ASSERT(domain.basis().nBasis() == 0);
+      TEST_ASSERT(!domain.hasBasis());
 
-      // Read header and construct basis
+      // Read header, which does not construct basis
       openInputFile("in/w_bcc.rf", in);
       domain.fieldIo().readFieldHeader(in, nMonomer_, domain.unitCell());
       in.close();
@@ -100,7 +101,16 @@ public:
       TEST_ASSERT(domain.unitCell().lattice() == UnitCell<3>::Cubic);
       TEST_ASSERT(domain.lattice() == UnitCell<3>::Cubic);
       TEST_ASSERT(domain.group().size() > 1);
+      TEST_ASSERT(!domain.hasBasis());
+
+      // Access does not construct basis
+      TEST_ASSERT(domain.basis().nBasis() == 0);
+      TEST_ASSERT(!domain.hasBasis());
+
+      // Construct basis explicitly
+      domain.makeBasis();
       TEST_ASSERT(domain.basis().nBasis() == 489);
+      TEST_ASSERT(domain.hasBasis());
    }
 
    void testReadHeader() 
@@ -115,7 +125,10 @@ public:
       TEST_ASSERT(domain.mesh().dimension(1) == 32);
       TEST_ASSERT(domain.mesh().dimension(2) == 32);
       TEST_ASSERT(domain.unitCell().lattice() == UnitCell<3>::Cubic);
+      TEST_ASSERT(!domain.hasBasis());
+      domain.makeBasis();
       TEST_ASSERT(domain.basis().nBasis() == 489);
+      TEST_ASSERT(domain.hasBasis());
       TEST_ASSERT(nMonomer_ == 2);
 
       if (verbose() > 0) {
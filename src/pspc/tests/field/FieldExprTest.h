@@ -0,0 +1,124 @@
+#ifndef PSPC_FIELD_EXPR_TEST_H
+#define PSPC_FIELD_EXPR_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <pspc/field/FieldExpr.h>
+#include <pspc/field/RField.h>
+#include <util/containers/DArray.h>
+
+#include <cmath>
+
+using namespace Util;
+using namespace Pscf::Pspc;
+
+class FieldExprTest : public UnitTest 
+{
+private:
+
+   const static int capacity = 7;
+
+   RField<1> a_, b_, c_;
+   DArray<double> d_;
+
+public:
+
+   void setUp() 
+   {
+      a_.allocate(capacity);
+      b_.allocate(capacity);
+      c_.allocate(capacity);
+      d_.allocate(capacity);
+      for (int i = 0; i < capacity; ++i) {
+         a_[i] = 0.5*i - 1.0;
+         b_[i] = 2.0 + i*i;
+         c_[i] = 3.0*i;
+         d_[i] = 1.0/(i + 1.0);
+      }
+   }
+
+   void tearDown() {}
+
+   void testAssign()
+   {
+      printMethod(TEST_FUNC);
+
+      RField<1> e;
+      e.allocate(capacity);
+      assign(e, a_*b_ + 2.0*d_ - c_/b_);
+      for (int i = 0; i < capacity; ++i) {
+         double x = a_[i]*b_[i] + 2.0*d_[i] - c_[i]/b_[i];
+         TEST_ASSERT(std::abs(e[i] - x) < 1.0E-12);
+      }
+
+      DArray<double> f;
+      f.allocate(capacity);
+      assign(f, -a_ + 1);
+      for (int i = 0; i < capacity; ++i) {
+         TEST_ASSERT(std::abs(f[i] - (1.0 - a_[i])) < 1.0E-12);
+      }
+
+      assign(f, 3.0);
+      for (int i = 0; i < capacity; ++i) {
+         TEST_ASSERT(f[i] == 3.0);
+      }
+   }
+
+   void testAddTo()
+   {
+      printMethod(TEST_FUNC);
+
+      RField<1> e;
+      e.allocate(capacity);
+      for (int i = 0; i < capacity; ++i) {
+         e[i] = c_[i];
+      }
+
+      // Destination appears in the expression
+      addTo(e, 0.5*e*d_ - a_);
+      for (int i = 0; i < capacity; ++i) {
+         double x = c_[i] + 0.5*c_[i]*d_[i] - a_[i];
+         TEST_ASSERT(std::abs(e[i] - x) < 1.0E-12);
+      }
+   }
+
+   void testSum()
+   {
+      printMethod(TEST_FUNC);
+
+      double x = 0.0;
+      for (int i = 0; i < capacity; ++i) {
+         x += a_[i]*d_[i];
+      }
+      TEST_ASSERT(std::abs(sum(a_*d_) - x) < 1.0E-12);
+   }
+
+   void testSizeCheck()
+   {
+      printMethod(TEST_FUNC);
+
+      DArray<double> g;
+      g.allocate(capacity + 1);
+      RField<1> e;
+      e.allocate(capacity);
+
+      bool thrown = false;
+      try {
+         assign(e, a_ + g);
+      } catch (Exception& ex) {
+         thrown = true;
+      }
+      TEST_ASSERT(thrown);
+   }
+
+};
+
+TEST_BEGIN(FieldExprTest)
+TEST_ADD(FieldExprTest, testAssign)
+TEST_ADD(FieldExprTest, testAddTo)
+TEST_ADD(FieldExprTest, testSum)
+TEST_ADD(FieldExprTest, testSizeCheck)
+TEST_END(FieldExprTest)
+
+#endif
@@ -80,6 +80,7 @@ public:
       openInputFile(filename, in);
       domain.readRGridFieldHeader(in, nMonomer_);
       in.close();
+      domain.makeBasis();
    }
 
    // Allocate an array of fields in symmetry adapated format
@@ -13,6 +13,7 @@
 #include "WFieldContainerTest.h"
 #include "CFieldContainerTest.h"
 #include "MaskTest.h"
+#include "FieldExprTest.h"
 
 TEST_COMPOSITE_BEGIN(FieldTestComposite)
 TEST_COMPOSITE_ADD_UNIT(FieldTest);
@@ -25,6 +26,7 @@ TEST_COMPOSITE_ADD_UNIT(FieldIoTest);
 TEST_COMPOSITE_ADD_UNIT(WFieldContainerTest);
 TEST_COMPOSITE_ADD_UNIT(CFieldContainerTest);
 TEST_COMPOSITE_ADD_UNIT(MaskTest);
+TEST_COMPOSITE_ADD_UNIT(FieldExprTest);
 TEST_COMPOSITE_END
 
 #endif
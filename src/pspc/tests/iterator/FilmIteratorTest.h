@@ -16,6 +16,7 @@
 #include <util/misc/Exception.h>
 
 #include <fstream>
+#include <cmath>
 
 using namespace Util;
 using namespace Pscf;
@@ -494,6 +495,54 @@ public:
       TEST_ASSERT(diff < epsilon);
    }
 
+   void testRemesh1D() // test remeshing to maintain normalSpacing
+   {
+      printMethod(TEST_FUNC);
+      
+      openLogFile("out/filmTestRemesh1D.log");
+      
+      // Set up system, with normalSpacing = 0.015. The initial mesh 
+      // of 96 points for L = 2.1 gives a spacing of 0.021875.
+      System<1> system;
+      FilmIteratorTest::setUpSystem(system, "in/film/system1D_remesh");
+      system.readWBasis("in/film/w_1D_in.bf");
+      TEST_ASSERT(system.mesh().dimension(0) == 96);
+
+      // Solve: The mesh is changed to 144 points before iterating
+      int error = system.iterate();
+      TEST_ASSERT(!error);
+      TEST_ASSERT(system.mesh().dimension(0) == 144);
+      int nBasis = system.basis().nBasis();
+      TEST_ASSERT(nBasis == 144);
+      TEST_ASSERT(system.w().basis(0).capacity() == nBasis);
+      TEST_ASSERT(system.mask().basis().capacity() == nBasis);
+      TEST_ASSERT(std::abs(system.mask().phiTot() - 8.0951532073e-01) 
+                  < 1.0E-7);
+
+      // Compare low wavevector components to solution on 96 points
+      UnitCell<1> unitCell; 
+      DArray< DArray<double> > wFieldsCheck; 
+      system.fieldIo().readFieldsBasis("in/film/w_1D_ref.bf", 
+                                       wFieldsCheck, unitCell);
+      double diff = 0.0;
+      for (int i = 0; i < 2; ++i) {
+         for (int j = 0; j < 41; ++j) {
+            double d = std::abs(system.w().basis(i)[j] 
+                                - wFieldsCheck[i][j]);
+            if (d > diff) diff = d;
+         }
+      }
+      if (verbose() > 0) {
+         std::cout << "\nMax low-wavevector difference = " << diff << "\n";
+      }
+      TEST_ASSERT(diff < 1.0E-4);
+
+      // A second solve for the same thickness does not change the mesh
+      error = system.iterate();
+      TEST_ASSERT(!error);
+      TEST_ASSERT(system.mesh().dimension(0) == 144);
+   }
+
    void testFreeEnergy() // test System::computeFreeEnergy with mask/h fields
    {
       printMethod(TEST_FUNC);
@@ -645,6 +694,7 @@ TEST_ADD(FilmIteratorTest, testCheckLatticeVectors)
 TEST_ADD(FilmIteratorTest, testSolve1D)
 TEST_ADD(FilmIteratorTest, testSolve2D)
 TEST_ADD(FilmIteratorTest, testSweep)
+TEST_ADD(FilmIteratorTest, testRemesh1D)
 TEST_ADD(FilmIteratorTest, testFreeEnergy)
 TEST_ADD(FilmIteratorTest, testMaskAndH)
 TEST_END(FilmIteratorTest)
@@ -14,6 +14,7 @@
 #include <util/math/Constants.h>
 
 #include <fstream>
+#include <cmath>
 
 using namespace Util;
 using namespace Pscf;
@@ -122,6 +123,173 @@ public:
       
    }
 
+   void testSolver1D_noBlockC()
+   {
+      printMethod(TEST_FUNC);
+
+      // Mixture with stored block concentrations (default)
+      Mixture<1> mixture;
+      std::ifstream in;
+      openInputFile("in/Mixture", in);
+      mixture.readParam(in);
+      UnitCell<1> unitCell;
+      in >> unitCell;
+      IntVec<1> d;
+      in >> d;
+      in.close();
+
+      // Mixture with direct accumulation into monomer fields
+      Mixture<1> direct;
+      openInputFile("in/Mixture_noBlockC", in);
+      direct.readParam(in);
+      in.close();
+      TEST_ASSERT(mixture.storeBlockC());
+      TEST_ASSERT(!direct.storeBlockC());
+
+      Mesh<1> mesh;
+      mesh.setDimensions(d);
+      mixture.setMesh(mesh);
+      mixture.setupUnitCell(unitCell);
+      direct.setMesh(mesh);
+      direct.setupUnitCell(unitCell);
+      TEST_ASSERT(!direct.polymer(0).block(0).cField().isAllocated());
+
+      int nMonomer = mixture.nMonomer();
+      int nx = mesh.size();
+      DArray< RField<1> > wFields;
+      DArray< RField<1> > cFields;
+      DArray< RField<1> > cFieldsDirect;
+      wFields.allocate(nMonomer);
+      cFields.allocate(nMonomer);
+      cFieldsDirect.allocate(nMonomer);
+      for (int i = 0; i < nMonomer; ++i) {
+         wFields[i].allocate(nx);
+         cFields[i].allocate(nx);
+         cFieldsDirect[i].allocate(nx);
+      }
+
+      double cs;
+      for (int i = 0; i < nx; ++i) {
+         cs = cos(2.0*Constants::Pi*double(i)/double(nx));
+         wFields[0][i] = 0.5 + cs;
+         wFields[1][i] = 0.5 - cs;
+      }
+
+      mixture.compute(wFields, cFields);
+      direct.compute(wFields, cFieldsDirect);
+
+      // Compare monomer concentrations
+      int i, j;
+      for (i = 0; i < nMonomer; ++i) {
+         for (j = 0; j < nx; ++j) {
+            TEST_ASSERT(std::abs(cFields[i][j] - cFieldsDirect[i][j])
+                        < 1.0E-10);
+         }
+      }
+
+      // Compare block concentrations recomputed on demand
+      int nBlock = mixture.nBlock();
+      DArray< RField<1> > blockC;
+      DArray< RField<1> > blockCDirect;
+      blockC.allocate(nBlock);
+      blockCDirect.allocate(nBlock);
+      for (i = 0; i < nBlock; ++i) {
+         blockC[i].allocate(nx);
+         blockCDirect[i].allocate(nx);
+      }
+      mixture.createBlockCRGrid(blockC);
+      direct.createBlockCRGrid(blockCDirect);
+      for (i = 0; i < nBlock; ++i) {
+         for (j = 0; j < nx; ++j) {
+            TEST_ASSERT(std::abs(blockC[i][j] - blockCDirect[i][j])
+                        < 1.0E-10);
+         }
+      }
+   }
+
+   void testSolver1D_mergedArms()
+   {
+      printMethod(TEST_FUNC);
+
+      // Star polymer with three identical arms, computed explicitly
+      Mixture<1> mixture;
+      std::ifstream in;
+      openInputFile("in/Mixture_star", in);
+      mixture.readParam(in);
+      UnitCell<1> unitCell;
+      in >> unitCell;
+      IntVec<1> d;
+      in >> d;
+      in.close();
+
+      // Same polymer with identical arms merged
+      Mixture<1> merged;
+      openInputFile("in/Mixture_starMerged", in);
+      merged.readParam(in);
+      in.close();
+      TEST_ASSERT(!mixture.polymer(0).hasMergedArms());
+      TEST_ASSERT(merged.polymer(0).hasMergedArms());
+
+      Mesh<1> mesh;
+      mesh.setDimensions(d);
+      mixture.setMesh(mesh);
+      mixture.setupUnitCell(unitCell);
+      merged.setMesh(mesh);
+      merged.setupUnitCell(unitCell);
+
+      int nMonomer = mixture.nMonomer();
+      int nx = mesh.size();
+      DArray< RField<1> > wFields;
+      DArray< RField<1> > cFields;
+      DArray< RField<1> > cFieldsMerged;
+      wFields.allocate(nMonomer);
+      cFields.allocate(nMonomer);
+      cFieldsMerged.allocate(nMonomer);
+      for (int i = 0; i < nMonomer; ++i) {
+         wFields[i].allocate(nx);
+         cFields[i].allocate(nx);
+         cFieldsMerged[i].allocate(nx);
+      }
+
+      double cs;
+      for (int i = 0; i < nx; ++i) {
+         cs = cos(2.0*Constants::Pi*double(i)/double(nx));
+         wFields[0][i] = 0.5 + cs;
+         wFields[1][i] = 0.5 - cs;
+      }
+
+      mixture.compute(wFields, cFields);
+      merged.compute(wFields, cFieldsMerged);
+
+      // Compare monomer concentrations
+      int i, j;
+      for (i = 0; i < nMonomer; ++i) {
+         for (j = 0; j < nx; ++j) {
+            TEST_ASSERT(std::abs(cFields[i][j] - cFieldsMerged[i][j])
+                        < 1.0E-10);
+         }
+      }
+
+      // Each merged arm gets an equal share of the arm concentration
+      int nBlock = mixture.nBlock();
+      DArray< RField<1> > blockC;
+      DArray< RField<1> > blockCMerged;
+      blockC.allocate(nBlock);
+      blockCMerged.allocate(nBlock);
+      for (i = 0; i < nBlock; ++i) {
+         blockC[i].allocate(nx);
+         blockCMerged[i].allocate(nx);
+      }
+      mixture.createBlockCRGrid(blockC);
+      merged.createBlockCRGrid(blockCMerged);
+      for (i = 0; i < nBlock; ++i) {
+         for (j = 0; j < nx; ++j) {
+            TEST_ASSERT(std::abs(blockC[i][j] - blockCMerged[i][j])
+                        < 1.0E-10);
+         }
+      }
+   }
+
    void testSolver2D()
    {
       printMethod(TEST_FUNC);
@@ -217,6 +385,95 @@ public:
       
    }
 
+   void testSolver2D_reduced()
+   {
+      printMethod(TEST_FUNC);
+
+      // Mixture that detects invariant axes, and one that does not
+      Mixture<2> mixture;
+      Mixture<2> fullMixture;
+
+      std::ifstream in;
+      openInputFile("in/Mixture2d", in);
+      mixture.readParam(in);
+      UnitCell<2> unitCell;
+      in >> unitCell;
+      IntVec<2> d;
+      in >> d;
+      in.close();
+
+      openInputFile("in/Mixture2d_noReduce", in);
+      fullMixture.readParam(in);
+      in.close();
+
+      Mesh<2> mesh;
+      mesh.setDimensions(d);
+      mixture.setMesh(mesh);
+      mixture.setupUnitCell(unitCell);
+      fullMixture.setMesh(mesh);
+      fullMixture.setupUnitCell(unitCell);
+
+      int nMonomer = mixture.nMonomer();
+      DArray< RField<2> > wFields;
+      DArray< RField<2> > cFields;
+      DArray< RField<2> > cFieldsFull;
+      wFields.allocate(nMonomer);
+      cFields.allocate(nMonomer);
+      cFieldsFull.allocate(nMonomer);
+      int nx = mesh.size();
+      for (int i = 0; i < nMonomer; ++i) {
+         wFields[i].allocate(nx);
+         cFields[i].allocate(nx);
+         cFieldsFull[i].allocate(nx);
+      }
+
+      // Generate wField that depends only on index along axis 0
+      int dx = mesh.dimension(0);
+      int dy = mesh.dimension(1);
+      double fx = 2.0*Constants::Pi/double(dx);
+      double cx;
+      int k = 0;
+      for (int i = 0; i < dx; ++i) {
+         cx = cos(fx*double(i));
+         for (int j = 0; j < dy; ++j) {
+            wFields[0][k] = 0.5 + cx;
+            wFields[1][k] = 0.5 - cx;
+            ++k;
+         }
+      }
+
+      mixture.compute(wFields, cFields);
+      fullMixture.compute(wFields, cFieldsFull);
+
+      TEST_ASSERT(mixture.invariantAxes()[0] == 0);
+      TEST_ASSERT(mixture.invariantAxes()[1] == 1);
+      TEST_ASSERT(mixture.polymer(0).block(0).isReduced());
+      TEST_ASSERT(!fullMixture.polymer(0).block(0).isReduced());
+
+      // Compare partition functions and concentrations
+      double Q = mixture.polymer(0).propagator(1, 0).computeQ();
+      double QFull = fullMixture.polymer(0).propagator(1, 0).computeQ();
+      TEST_ASSERT(std::abs(Q - QFull) < 1.0E-10*QFull);
+      for (int i = 0; i < nMonomer; ++i) {
+         for (k = 0; k < nx; ++k) {
+            TEST_ASSERT(std::abs(cFields[i][k] - cFieldsFull[i][k]) 
+                        < 1.0E-10);
+         }
+      }
+
+      // A field that varies along both axes disables the reduction
+      k = 0;
+      for (int i = 0; i < dx; ++i) {
+         for (int j = 0; j < dy; ++j) {
+            wFields[0][k] += 0.1*cos(2.0*Constants::Pi*double(j)/dy);
+            ++k;
+         }
+      }
+      mixture.compute(wFields, cFields);
+      TEST_ASSERT(mixture.invariantAxes()[1] == 0);
+      TEST_ASSERT(!mixture.polymer(0).block(0).isReduced());
+   }
+
    void testSolver2D_hex()
    {
       printMethod(TEST_FUNC);
@@ -382,7 +639,10 @@ TEST_BEGIN(MixtureTest)
 TEST_ADD(MixtureTest, testConstructor1D)
 TEST_ADD(MixtureTest, testReadParameters1D)
 TEST_ADD(MixtureTest, testSolver1D)
+TEST_ADD(MixtureTest, testSolver1D_noBlockC)
+TEST_ADD(MixtureTest, testSolver1D_mergedArms)
 TEST_ADD(MixtureTest, testSolver2D)
+TEST_ADD(MixtureTest, testSolver2D_reduced)
 TEST_ADD(MixtureTest, testSolver2D_hex)
 TEST_ADD(MixtureTest, testSolver3D)
 TEST_END(MixtureTest)
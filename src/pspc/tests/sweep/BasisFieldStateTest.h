@@ -42,10 +42,11 @@ public:
    
       // Setup system
       BasisFieldStateTest::SetUpSystem(system);
-      TEST_ASSERT(system.domain().basis().isInitialized());
+      TEST_ASSERT(!system.domain().hasBasis());
 
       // Read in file one way
       system.readWBasis("in/bcc/omega.ref");
+      TEST_ASSERT(system.domain().basis().isInitialized());
       // Read in file another way
       bfs.read("in/bcc/omega.ref");
       // Compare
@@ -7,12 +7,14 @@
 #include <pspc/System.h>
 #include <pspc/sweep/SweepFactory.h>
 #include <pspc/sweep/LinearSweep.h>
+#include <pspc/sweep/SweepArchive.h>
 #include <pscf/crystal/BFieldComparison.h>
 #include <util/tests/LogFileUnitTest.h>
 #include <util/format/Dbl.h>
 
 #include <fstream>
 #include <sstream>
+#include <cmath>
 
 using namespace Util;
 using namespace Pscf;
@@ -199,6 +201,110 @@ public:
       TEST_ASSERT(maxDiff < 5.0e-7);
    }
 
+   void testLinearSweepChiRetain()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testLinearSweepChiRetain");
+
+      // Sweep with the default continuation, which keeps the full 
+      // field and residual histories
+      double maxDiff = testLinearSweepParam("chi");
+      TEST_ASSERT(maxDiff < 5.0e-7);
+
+      // Same sweep with retainBasis true, which retains only the
+      // basis of differences from the previous state
+      System<1> system;
+      SweepTest::SetUpSystem(system, "in/chi/param.retain");
+      system.readWBasis("in/chi/w.bf");
+      system.sweep();
+
+      // Check that neither sweep backtracked
+      std::ifstream f(std::string(filePrefix() 
+                                  + "out/chiRetain_5_w.bf").c_str());
+      TEST_ASSERT(!f.good());
+
+      // Compare states of the two sweeps, and to reference states
+      BasisFieldState<1> fieldsRef, fieldsRetain, fieldsDefault;
+      fieldsRef.setSystem(system);
+      fieldsRetain.setSystem(system);
+      fieldsDefault.setSystem(system);
+      BFieldComparison comparison(1);
+      for (int i = 0; i < 5; ++i) {
+         fieldsRef.read("in/sweepref/chi/" + std::to_string(i) + "_w.bf");
+         fieldsRetain.read("out/chiRetain_" + std::to_string(i) + "_w.bf");
+         fieldsDefault.read("out/chi/" + std::to_string(i) + "_w.bf");
+         comparison.compare(fieldsRetain.fields(), fieldsDefault.fields());
+         TEST_ASSERT(comparison.maxDiff() < 5.0e-7);
+         comparison.compare(fieldsRef.fields(), fieldsRetain.fields());
+         TEST_ASSERT(comparison.maxDiff() < 5.0e-7);
+      }
+   }
+
+   void testLinearSweepChiLoose()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testLinearSweepChiLoose");
+
+      // Sweep with the full tolerance at every state
+      double maxDiff = testLinearSweepParam("chi");
+      TEST_ASSERT(maxDiff < 5.0e-7);
+
+      // Same sweep with looseEpsilon 1.0e-8 and fTolerance 1.0e-10
+      System<1> system;
+      SweepTest::SetUpSystem(system, "in/chi/param.loose");
+      system.readWBasis("in/chi/w.bf");
+      system.sweep();
+
+      std::ifstream f(std::string(filePrefix() 
+                                  + "out/chiLoose_5_w.bf").c_str());
+      TEST_ASSERT(!f.good());
+
+      BasisFieldState<1> fieldsRef, fieldsOut;
+      fieldsRef.setSystem(system);
+      fieldsOut.setSystem(system);
+      BFieldComparison comparison(1);
+      double fFull, fLoose, epsilon, fError;
+      int nLoose = 0;
+      for (int i = 0; i < 5; ++i) {
+         std::string index = std::to_string(i);
+
+         // Full tolerance output has no convergence section
+         readDat("out/chi/" + index + ".dat", fFull, epsilon, fError);
+         TEST_ASSERT(epsilon < 0.0);
+
+         // Each loose sweep state records its actual tolerance 
+         readDat("out/chiLoose_" + index + ".dat", fLoose, 
+                 epsilon, fError);
+         if (i == 0 || i == 4) {
+            TEST_ASSERT(std::abs(epsilon - 1.0e-12) < 1.0e-20);
+         } else {
+            TEST_ASSERT(std::abs(epsilon - 1.0e-8) < 1.0e-16 ||
+                        std::abs(epsilon - 1.0e-12) < 1.0e-20);
+         }
+         if (std::abs(epsilon - 1.0e-8) < 1.0e-16) {
+            TEST_ASSERT(fError >= 0.0);
+            TEST_ASSERT(fError <= 1.0e-10);
+            ++nLoose;
+         }
+         TEST_ASSERT(std::abs(fLoose - fFull) < 1.0e-8);
+
+         // Field files are written only for fully converged states
+         std::ifstream w(std::string(filePrefix() + "out/chiLoose_" 
+                                     + index + "_w.bf").c_str());
+         if (std::abs(epsilon - 1.0e-8) < 1.0e-16) {
+            TEST_ASSERT(!w.good());
+            continue;
+         }
+         TEST_ASSERT(w.good());
+         w.close();
+         fieldsRef.read("in/sweepref/chi/" + index + "_w.bf");
+         fieldsOut.read("out/chiLoose_" + index + "_w.bf");
+         comparison.compare(fieldsRef.fields(), fieldsOut.fields());
+         TEST_ASSERT(comparison.maxDiff() < 1.0e-5);
+      }
+      TEST_ASSERT(nLoose > 0);
+   }
+
    void testLinearSweepKuhn()
    {
       printMethod(TEST_FUNC);
@@ -229,6 +335,47 @@ public:
       TEST_ASSERT(maxDiff < 5.0e-7);
    }
 
+   void testSweepArchive()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testSweepArchive");
+
+      System<1> system;
+      SweepTest::SetUpSystem(system, "in/archive/param");
+      system.readWBasis("in/archive/w.bf");
+      system.sweep();
+
+      // Read archive and compare w fields to reference sweep
+      SweepArchive<1> archive(system);
+      archive.openRead("out/archive_sweep.arc");
+      TEST_ASSERT(archive.nStep() == 5);
+
+      BasisFieldState<1> fieldsRef;
+      fieldsRef.setSystem(system);
+      BFieldComparison comparison(1);
+      double maxDiff = 0.0;
+      for (int i = 0; i < 5; ++i) {
+         archive.readStep(i);
+         TEST_ASSERT(archive.step() == i);
+         fieldsRef.read("in/sweepref/chi/" + std::to_string(i) + "_w.bf");
+         comparison.compare(fieldsRef.fields(), archive.wBasis());
+         if (comparison.maxDiff() > maxDiff) {
+            maxDiff = comparison.maxDiff();
+         }
+      }
+      TEST_ASSERT(maxDiff < 5.0e-7);
+
+      // Extract one step in legacy format and read it back
+      archive.readStep(2);
+      archive.extract("out/archive_");
+      archive.close();
+      BasisFieldState<1> fieldsOut;
+      fieldsOut.setSystem(system);
+      fieldsOut.read("out/archive_2_w.bf");
+      comparison.compare(fieldsOut.fields(), archive.wBasis());
+      TEST_ASSERT(comparison.maxDiff() < 1.0e-10);
+   }
+
    void SetUpSystem(System<1>& system, std::string fname)
    {
       system.fileMaster().setInputPrefix(filePrefix());
@@ -243,6 +390,43 @@ public:
       system.setUnitCell(parameters);
    }
 
+   /*
+   * Read fHelmholtz and any convergence section from a sweep .dat file.
+   *
+   * Sets epsilon and fError to -1.0 if there is no convergence section.
+   */
+   void readDat(std::string fname, double& fHelmholtz, 
+                double& epsilon, double& fError)
+   {
+      std::ifstream in;
+      openInputFile(fname, in);
+      fHelmholtz = 0.0;
+      epsilon = -1.0;
+      fError = -1.0;
+      // The echoed parameter file also contains an epsilon, so only
+      // read epsilon and fError after the "Convergence:" label
+      std::string line, label;
+      bool isConvergence = false;
+      while (std::getline(in, line)) {
+         std::istringstream words(line);
+         words >> label;
+         if (label == "fHelmholtz") {
+            words >> fHelmholtz;
+         } else
+         if (label == "Convergence:") {
+            isConvergence = true;
+         } else
+         if (isConvergence && label == "epsilon") {
+            words >> epsilon;
+         } else
+         if (isConvergence && label == "fError") {
+            words >> fError;
+         }
+         label.clear();
+      }
+      in.close();
+   }
+
    double testLinearSweepParam(std::string paramname)
    {
       // Set up system with a LinearSweep object
@@ -306,9 +490,12 @@ TEST_ADD(SweepTest, testParameterSet)
 TEST_ADD(SweepTest, testLinearSweepRead)
 TEST_ADD(SweepTest, testLinearSweepBlock)
 TEST_ADD(SweepTest, testLinearSweepChi)
+TEST_ADD(SweepTest, testLinearSweepChiRetain)
+TEST_ADD(SweepTest, testLinearSweepChiLoose)
 TEST_ADD(SweepTest, testLinearSweepKuhn)
 TEST_ADD(SweepTest, testLinearSweepPhi)
 TEST_ADD(SweepTest, testLinearSweepSolvent)
+TEST_ADD(SweepTest, testSweepArchive)
 TEST_END(SweepTest)
 
 #endif
@@ -0,0 +1,36 @@
+ format  1  0
+dim                 
+                   1
+crystal_system      
+          lamellar
+N_cell_param        
+                   1
+cell_param          
+    1.3835952906E+00
+group_name          
+                P_-1
+N_monomer           
+                   2
+N_star              
+                  21
+  5.280000000000E+00  6.720000000000E+00       0     1
+ -2.280215677638E+00  2.951146584480E+00       1     2
+  5.369021849839E-01  1.711495620115E-01       2     2
+ -3.614970217345E-02 -1.699554850743E-01       3     2
+ -4.790621691298E-02 -2.130292494921E-02       4     2
+  1.040140885208E-02  1.389448772414E-02       5     2
+  1.689998188821E-03  1.974429533752E-04       6     2
+ -8.546878789372E-04 -8.740315738248E-04       7     2
+ -1.260809812364E-06  6.658077525854E-05       8     2
+  4.850642531237E-05  4.324025338889E-05       9     2
+ -5.060188249176E-06 -7.606023764237E-06      10     2
+ -2.024621066269E-06 -1.557487715696E-06      11     2
+  4.546950410452E-07  5.269533930802E-07      12     2
+  5.522772695402E-08  2.734278073154E-08      13     2
+ -2.674445376213E-08 -2.749754245071E-08      14     2
+ -1.046122525153E-10  1.259918313136E-09      15     2
+  1.245911021518E-09  1.154298048798E-09      16     2
+ -1.093885878172E-10 -1.654172658180E-10      17     2
+ -4.789137419372E-11 -3.829015557787E-11      18     2
+  8.664481504317E-12  1.117375516891E-11      19     2
+  6.111399251379E-11  6.022121221915E-11      20     1
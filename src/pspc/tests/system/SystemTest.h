@@ -5,11 +5,16 @@
 #include <test/UnitTestRunner.h>
 
 #include <pspc/System.h>
+#include <pspc/analyzer/Analyzer.h>
+#include <pspc/iterator/AmIterator.h>
+#include <pspc/iterator/HybridIterator.h>
 #include <pspc/field/RFieldComparison.h>
 #include <pscf/crystal/BFieldComparison.h>
 #include <util/tests/LogFileUnitTest.h>
 
 #include <fstream>
+#include <sstream>
+#include <thread>
 
 using namespace Util;
 using namespace Pscf;
@@ -199,6 +204,46 @@ public:
 
    }
 
+   void testConvertFields2D_hex()
+   {
+      printMethod(TEST_FUNC);
+      System<2> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      openLogFile("out/testConvertFields2D_hex.log");
+
+      std::ifstream in;
+      openInputFile("in/diblock/hex/param.flex", in);
+      system.readParam(in);
+      in.close();
+
+      // Bulk round trip basis -> rgrid -> basis for two files
+      int nFail;
+      nFail = system.convertFields("BASIS_TO_RGRID",
+                                   "in/diblock/hex/convert_b2r");
+      TEST_ASSERT(nFail == 0);
+      nFail = system.convertFields("RGRID_TO_BASIS",
+                                   "in/diblock/hex/convert_r2b");
+      TEST_ASSERT(nFail == 0);
+
+      // Compare results to originals
+      DArray< DArray<double> > wFields_check;
+      system.readWBasis("in/diblock/hex/omega.in");
+      wFields_check = system.w().basis();
+      system.readWBasis("out/testConvertFields2D_hex_w1.bf");
+      BFieldComparison comparison1;
+      comparison1.compare(wFields_check, system.w().basis());
+      TEST_ASSERT(comparison1.maxDiff() < 1.0E-10);
+
+      system.readWBasis("in/diblock/hex/omega.ref");
+      wFields_check = system.w().basis();
+      system.readWBasis("out/testConvertFields2D_hex_w2.bf");
+      BFieldComparison comparison2;
+      comparison2.compare(wFields_check, system.w().basis());
+      TEST_ASSERT(comparison2.maxDiff() < 1.0E-10);
+   }
+
    void testConversion3D_bcc()
    {
       printMethod(TEST_FUNC);
@@ -315,6 +360,115 @@ public:
 
    }
 
+   void testBatchCompute1D_lam()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testBatchCompute1D_lam.log");
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.rigid", in);
+      system.readParam(in);
+      in.close();
+
+      int n = system.batchCompute("in/diblock/lam/batch",
+                                  "out/testBatchCompute1D_lam.dat");
+      TEST_ASSERT(n == 2);
+
+      // Recompute the last entry directly
+      system.readWBasis("in/diblock/lam/omega.ref");
+      system.compute();
+      system.computeFreeEnergy();
+      double fHelmholtz = system.fHelmholtz();
+      double pressure = system.pressure();
+
+      // Read the last line of the table
+      openInputFile("out/testBatchCompute1D_lam.dat", in);
+      std::string line, fileName;
+      int id = -1;
+      double f = 0.0;
+      double p = 0.0;
+      std::getline(in, line);
+      TEST_ASSERT(line[0] == '#');
+      while (in >> id >> f >> p >> fileName) {}
+      in.close();
+      TEST_ASSERT(id == 1);
+      TEST_ASSERT(fileName == "in/diblock/lam/omega.ref");
+      TEST_ASSERT(std::abs(f - fHelmholtz) < 1.0E-8);
+      TEST_ASSERT(std::abs(p - pressure) < 1.0E-8);
+   }
+
+   void testBatchCompute1D_lam_rgrid()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testBatchCompute1D_lam_rgrid.log");
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.rigid", in);
+      system.readParam(in);
+      in.close();
+
+      // Reference values for the symmetric w fields
+      system.readWBasis("in/diblock/lam/omega.ref");
+      system.compute();
+      system.computeFreeEnergy();
+      double fHelmholtz = system.fHelmholtz();
+      double pressure = system.pressure();
+
+      // Write the same fields in r-grid format
+      system.writeWRGrid("out/testBatchCompute1D_lam.rf");
+
+      // Write r-grid fields without inversion symmetry
+      DArray< RField<1> > wAsym;
+      wAsym = system.w().rgrid();
+      wAsym[0][1] += 0.1;
+      system.fieldIo().writeFieldsRGrid("out/testBatchCompute1D_asym.rf",
+                                        wAsym, system.unitCell());
+
+      // List r-grid, asymmetric r-grid, missing and basis files
+      std::ofstream list;
+      openOutputFile("out/testBatchCompute1D_lam_rgrid.list", list);
+      list << "out/testBatchCompute1D_lam.rf" << std::endl;
+      list << "out/testBatchCompute1D_asym.rf" << std::endl;
+      list << "in/diblock/lam/missing" << std::endl;
+      list << "in/diblock/lam/omega.ref" << std::endl;
+      list.close();
+
+      int n = system.batchCompute("out/testBatchCompute1D_lam_rgrid.list",
+                                  "out/testBatchCompute1D_lam_rgrid.dat");
+      TEST_ASSERT(n == 2);
+
+      // Check each row of the table
+      openInputFile("out/testBatchCompute1D_lam_rgrid.dat", in);
+      std::string line, fileName, fString, pString;
+      int id;
+      std::getline(in, line);
+      TEST_ASSERT(line[0] == '#');
+      for (int i = 0; i < 4; ++i) {
+         TEST_ASSERT(std::getline(in, line));
+         std::istringstream row(line);
+         row >> id >> fString >> pString >> fileName;
+         TEST_ASSERT(id == i);
+         if (i == 1 || i == 2) {
+            TEST_ASSERT(fString == "ERROR");
+            TEST_ASSERT(pString == "ERROR");
+         } else {
+            TEST_ASSERT(std::abs(std::stod(fString) - fHelmholtz) 
+                        < 1.0E-8);
+            TEST_ASSERT(std::abs(std::stod(pString) - pressure) 
+                        < 1.0E-8);
+         }
+      }
+      in.close();
+   }
+
    void testIterate1D_lam_rigid()
    {
       printMethod(TEST_FUNC);
@@ -368,6 +522,49 @@ public:
 
    }
 
+   void testIterate1D_lam_analyzer()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testIterate1D_lam_analyzer.log");
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.analyzer", in);
+      system.readParam(in);
+      in.close();
+      TEST_ASSERT(system.analyzerManager().size() == 3);
+
+      system.readWBasis("in/diblock/lam/omega.ref");
+      int error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+      system.analyzerManager().compute();
+      system.analyzerManager().output(Log::file());
+
+      // Primary peak of lamellae is at the period of the unit cell
+      double a = system.unitCell().parameter(0);
+      Analyzer<1>& sf = system.analyzerManager()[0];
+      TEST_ASSERT(sf.nValue() == 7);
+      TEST_ASSERT(std::abs(sf.value(0) - a) < 1.0E-8*a);
+
+      // Two flat interfaces per period
+      Analyzer<1>& interface = system.analyzerManager()[1];
+      TEST_ASSERT(interface.nValue() == 2);
+      TEST_ASSERT(interface.value(0) > 0.0);
+      TEST_ASSERT(std::abs(interface.value(1)*a - 2.0) < 0.2);
+
+      // One A domain per period, containing about half the volume
+      Analyzer<1>& domain = system.analyzerManager()[2];
+      TEST_ASSERT(domain.nValue() == 4);
+      TEST_ASSERT(std::abs(domain.value(1) - 1.0) < 1.0E-8);
+      TEST_ASSERT(std::abs(domain.value(0) - 0.5) < 0.1);
+      TEST_ASSERT(std::abs(domain.value(3)) < 1.0E-8);
+   }
+
    void testIterate1D_lam_flex()
    {
       printMethod(TEST_FUNC);
@@ -410,6 +607,232 @@ public:
       TEST_ASSERT(comparison.maxDiff() < 1.0E-7);
    }
 
+   void testIterate1D_lam_adaptive()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testIterate1D_lam_adaptive.log");
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.adaptive", in);
+      system.readParam(in);
+      in.close();
+
+      // Read input w-fields, iterate and compare to reference solution
+      system.readWBasis("in/diblock/lam/omega.in");
+      int error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+
+      DArray< DArray<double> > wFields_check;
+      wFields_check = system.w().basis();
+
+      system.readWBasis("in/diblock/lam/omega.ref");
+
+      BFieldComparison comparison(1);
+      comparison.compare(wFields_check, system.w().basis());
+      if (verbose() > 0) {
+         std::cout << "\n";
+         std::cout << "Max error = " << comparison.maxDiff() << "\n";
+      }
+      TEST_ASSERT(comparison.maxDiff() < 1.0E-7);
+   }
+
+   void testIterate1D_lam_adaptiveCond()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testIterate1D_lam_adaptiveCond.log");
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      // Small maxCond, which forces truncation of the basis
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.adaptiveCond", in);
+      system.readParam(in);
+      in.close();
+
+      system.readWBasis("in/diblock/lam/omega.in");
+      int error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+      AmIterator<1>& iterator 
+                  = dynamic_cast< AmIterator<1>& >(system.iterator());
+      TEST_ASSERT(iterator.nTruncate() > 0);
+      if (verbose() > 0) {
+         std::cout << "\n";
+         std::cout << "nItr      = " << iterator.nItr() << "\n";
+         std::cout << "nTruncate = " << iterator.nTruncate() << "\n";
+      }
+
+      DArray< DArray<double> > wFields_check;
+      wFields_check = system.w().basis();
+      system.readWBasis("in/diblock/lam/omega.ref");
+      BFieldComparison comparison(1);
+      comparison.compare(wFields_check, system.w().basis());
+      TEST_ASSERT(comparison.maxDiff() < 1.0E-7);
+   }
+
+   void testIterate1D_lam_adaptiveStagnant()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testIterate1D_lam_adaptiveStagnant.log");
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      // Unreachable epsilon and small nStagnant, so that the error 
+      // stagnates at roundoff level 
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.adaptiveStagnant", in);
+      system.readParam(in);
+      in.close();
+
+      // Expect a restart, a second restart in safe mode, and failure
+      // well before maxItr
+      system.readWBasis("in/diblock/lam/omega.in");
+      int error = system.iterate();
+      TEST_ASSERT(error != 0);
+      AmIterator<1>& iterator 
+                  = dynamic_cast< AmIterator<1>& >(system.iterator());
+      if (verbose() > 0) {
+         std::cout << "\n";
+         std::cout << "nItr     = " << iterator.nItr() << "\n";
+         std::cout << "nRestart = " << iterator.nRestart() << "\n";
+      }
+      TEST_ASSERT(iterator.nRestart() == 2);
+      TEST_ASSERT(iterator.isSafeMode());
+      TEST_ASSERT(iterator.nItr() < 1000);
+
+      // Fields after giving up are still those of the converged state
+      DArray< DArray<double> > wFields_check;
+      wFields_check = system.w().basis();
+      system.readWBasis("in/diblock/lam/omega.ref");
+      BFieldComparison comparison(1);
+      comparison.compare(wFields_check, system.w().basis());
+      TEST_ASSERT(comparison.maxDiff() < 1.0E-7);
+   }
+
+   void testIterate1D_lam_fError()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testIterate1D_lam_fError.log");
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.flex", in);
+      system.readParam(in);
+      in.close();
+      double epsilon = system.iterator().epsilon();
+
+      // Converge to a loose tolerance
+      system.readWBasis("in/diblock/lam/omega.in");
+      system.iterator().setEpsilon(1.0E-5);
+      int error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+      double fLoose = system.fHelmholtz();
+      double fErrorLoose = system.iterator().fError();
+      TEST_ASSERT(fErrorLoose >= 0.0);
+
+      // Continue to the full tolerance
+      system.iterator().setEpsilon(epsilon);
+      TEST_ASSERT(system.iterator().epsilon() == epsilon);
+      error = system.iterate(true);
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+      double fFull = system.fHelmholtz();
+      double fErrorFull = system.iterator().fError();
+      TEST_ASSERT(fErrorFull >= 0.0);
+      TEST_ASSERT(fErrorFull < fErrorLoose);
+      if (verbose() > 0) {
+         std::cout << "\n";
+         std::cout << "fError (loose) = " << fErrorLoose << "\n";
+         std::cout << "fError (full)  = " << fErrorFull << "\n";
+         std::cout << "|df| (loose)   = " 
+                   << std::abs(fLoose - fFull) << "\n";
+      }
+
+      // The estimate should bound the actual error of the loose state 
+      // to within a modest factor
+      TEST_ASSERT(std::abs(fLoose - fFull) < 1.0E2*fErrorLoose + 1.0E-10);
+   }
+
+   void testIterate1D_lam_hybrid()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testIterate1D_lam_hybrid.log");
+
+      // Iteration count of the AmIterator from the same initial guess
+      int nItrAm;
+      {
+         System<1> amSystem;
+         amSystem.fileMaster().setInputPrefix(filePrefix());
+         amSystem.fileMaster().setOutputPrefix(filePrefix());
+         std::ifstream in;
+         openInputFile("in/diblock/lam/param.flex", in);
+         amSystem.readParam(in);
+         in.close();
+         amSystem.readWBasis("in/diblock/lam/omega.in");
+         if (amSystem.iterate()) {
+            TEST_THROW("AmIterator failed to converge.");
+         }
+         nItrAm = dynamic_cast< AmIterator<1>& >(amSystem.iterator()).nItr();
+      }
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.hybrid", in);
+      system.readParam(in);
+      in.close();
+
+      // Read input w-fields, iterate and output solution
+      system.readWBasis("in/diblock/lam/omega.in");
+      int error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+
+      // The Newton block must be active, and must not slow convergence
+      HybridIterator<1>& iterator 
+                  = dynamic_cast< HybridIterator<1>& >(system.iterator());
+      if (verbose() > 0) {
+         std::cout << "\n";
+         std::cout << "nItr (AM)     = " << nItrAm << "\n";
+         std::cout << "nItr (hybrid) = " << iterator.nItr() << "\n";
+      }
+      TEST_ASSERT(iterator.nNewtonStar() == 4);
+      TEST_ASSERT(iterator.nItr() <= nItrAm);
+
+      DArray< DArray<double> > wFields_check;
+      wFields_check = system.w().basis();
+
+      system.readWBasis("in/diblock/lam/omega.ref");
+
+      BFieldComparison comparison(1);
+      comparison.compare(wFields_check, system.w().basis());
+      if (verbose() > 0) {
+         std::cout << "\n";
+         std::cout << "Max error = " << comparison.maxDiff() << "\n";
+      }
+      TEST_ASSERT(comparison.maxDiff() < 1.0E-7);
+   }
+
    void testIterate1D_lam_soln()
    {
       printMethod(TEST_FUNC);
@@ -606,6 +1029,83 @@ public:
 
    }
 
+   void testSetMesh1D_lam()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testSetMesh1D_lam.log");
+
+      System<1> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      openInputFile("in/diblock/lam/param.rigid", in);
+      system.readParam(in);
+      in.close();
+
+      // Converge on the original mesh of 32 points
+      system.readWBasis("in/diblock/lam/omega.ref");
+      int error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+      double fHelmholtz = system.fHelmholtz();
+      DArray< DArray<double> > wFields_check;
+      wFields_check = system.w().basis();
+      int nBasisOld = system.basis().nBasis();
+      TEST_ASSERT(nBasisOld == 17);
+
+      // Refine the mesh. Coefficients of all stars other than the last
+      // (k = 16, which is a star of size 1 only for 32 points) are kept,
+      // and coefficients of new stars are zero.
+      IntVec<1> dimensions;
+      dimensions[0] = 64;
+      system.setMesh(dimensions);
+      TEST_ASSERT(system.mesh().dimension(0) == 64);
+      int nBasis = system.basis().nBasis();
+      TEST_ASSERT(nBasis == 33);
+      int i, j;
+      double diff = 0.0;
+      double d;
+      for (i = 0; i < 2; ++i) {
+         TEST_ASSERT(system.w().basis(i).capacity() == nBasis);
+         for (j = 0; j < nBasisOld - 1; ++j) {
+            d = std::abs(system.w().basis(i)[j] - wFields_check[i][j]);
+            if (d > diff) diff = d;
+         }
+         for (j = nBasisOld; j < nBasis; ++j) {
+            TEST_ASSERT(system.w().basis(i)[j] == 0.0);
+         }
+      }
+      TEST_ASSERT(diff < 1.0E-8);
+
+      // Iterate on the finer mesh, compare free energy
+      error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge after setMesh.");
+      }
+      if (verbose() > 0) {
+         std::cout << "\nfHelmholtz (32)  = " << fHelmholtz;
+         std::cout << "\nfHelmholtz (64)  = " << system.fHelmholtz();
+      }
+      TEST_ASSERT(std::abs(system.fHelmholtz() - fHelmholtz) < 1.0E-6);
+
+      // Return to the original mesh, recover the original solution
+      dimensions[0] = 32;
+      system.setMesh(dimensions);
+      TEST_ASSERT(system.basis().nBasis() == nBasisOld);
+      error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge after setMesh.");
+      }
+      BFieldComparison comparison(1);
+      comparison.compare(wFields_check, system.w().basis());
+      if (verbose() > 0) {
+         std::cout << "\nMax error = " << comparison.maxDiff() << "\n";
+      }
+      TEST_ASSERT(comparison.maxDiff() < 1.0E-7);
+   }
+
    void testIterate2D_hex_rigid()
    {
       printMethod(TEST_FUNC);
@@ -906,6 +1406,193 @@ public:
 
    }
 
+   void testCompressQ2D_hex()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testCompressQ2D_hex.log");
+
+      // System with propagators stored on the r-grid
+      System<2> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+      std::ifstream in;
+      openInputFile("in/diblock/hex/param.rigid", in);
+      system.readParam(in);
+      in.close();
+
+      // System with symmetry-compressed propagators
+      System<2> systemQ;
+      systemQ.fileMaster().setInputPrefix(filePrefix());
+      systemQ.fileMaster().setOutputPrefix(filePrefix());
+      openInputFile("in/diblock/hex/param.compress", in);
+      systemQ.readParam(in);
+      in.close();
+      TEST_ASSERT(systemQ.mixture().compressQ());
+
+      // Solve MDE for the same symmetric w fields
+      system.readWBasis("in/diblock/hex/omega.in");
+      systemQ.readWBasis("in/diblock/hex/omega.in");
+      system.compute(true);
+      systemQ.compute(true);
+      Propagator<2> const & propagator 
+                           = systemQ.mixture().polymer(0).propagator(0, 0);
+      TEST_ASSERT(propagator.isCompressed());
+      TEST_ASSERT(!system.mixture().polymer(0).propagator(0, 0)
+                                               .isCompressed());
+
+      // Compare concentrations and stress
+      RFieldComparison<2> rComparison;
+      rComparison.compare(system.c().rgrid(), systemQ.c().rgrid());
+      if (verbose() > 0) {
+         std::cout << "\n";
+         std::cout << "Max c error = " << rComparison.maxDiff() << "\n";
+      }
+      TEST_ASSERT(rComparison.maxDiff() < 1.0E-10);
+      double stressDiff = system.mixture().stress(0) 
+                        - systemQ.mixture().stress(0);
+      TEST_ASSERT(std::abs(stressDiff) < 1.0E-10);
+
+      // Compare a reconstructed interior slice
+      Propagator<2> const & propagatorR 
+                           = system.mixture().polymer(0).propagator(0, 0);
+      int i = propagator.ns()/2;
+      RField<2> work;
+      work.allocate(systemQ.mesh().dimensions());
+      rComparison.compare(propagatorR.q(i), propagator.q(i, work));
+      TEST_ASSERT(rComparison.maxDiff() < 1.0E-10);
+
+      // Iterate to convergence with compressed propagators
+      int error = systemQ.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+      system.readWBasis("in/diblock/hex/omega.ref");
+      BFieldComparison comparison(1);
+      comparison.compare(system.w().basis(), systemQ.w().basis());
+      TEST_ASSERT(comparison.maxDiff() < 5.0E-7);
+   }
+
+   void testIterateDsRefine2D_hex()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testIterateDsRefine2D_hex.log");
+
+      System<2> system;
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      openInputFile("in/diblock/hex/param.dsRefine", in);
+      system.readParam(in);
+      in.close();
+      int ns = system.mixture().polymer(0).block(1).ns();
+
+      // Read reference solution
+      system.readWBasis("in/diblock/hex/omega.ref");
+      DArray< DArray<double> > wFields_check;
+      wFields_check = system.w().basis();
+
+      // Iterate from initial guess, starting with a coarse contour step
+      system.readWBasis("in/diblock/hex/omega.in");
+      int error = system.iterate();
+      if (error) {
+         TEST_THROW("Iterator failed to converge.");
+      }
+
+      // Check that the final contour discretization was restored
+      TEST_ASSERT(std::abs(system.mixture().ds() - 0.01) < 1.0E-12);
+      TEST_ASSERT(system.mixture().polymer(0).block(1).ns() == ns);
+
+      // Compare current solution to reference solution
+      BFieldComparison comparison(1);
+      comparison.compare(wFields_check, system.w().basis());
+      if (verbose() > 0) {
+         std::cout << "\n";
+         std::cout << "Max error = " << comparison.maxDiff() << "\n";
+      }
+      TEST_ASSERT(comparison.maxDiff() < 5.0E-7);
+   }
+
+   void testConcurrentIterate2D_hex()
+   {
+      printMethod(TEST_FUNC);
+      openLogFile("out/testConcurrentIterate2D_hex.log");
+
+      // Serial reference calculation
+      double fSerial;
+      DArray< DArray<double> > wSerial;
+      std::ostringstream serialLog;
+      TEST_ASSERT(iterateHex(serialLog, fSerial, wSerial) == 0);
+
+      // Independent systems, solved concurrently in separate threads
+      const int nSystem = 4;
+      DArray<int> error;
+      DArray<double> f;
+      DArray< DArray< DArray<double> > > w;
+      DArray<std::ostringstream> logs;
+      error.allocate(nSystem);
+      f.allocate(nSystem);
+      w.allocate(nSystem);
+      logs.allocate(nSystem);
+      DArray<std::thread> threads;
+      threads.allocate(nSystem);
+      int i;
+      for (i = 0; i < nSystem; ++i) {
+         threads[i] = std::thread([this, i, &error, &f, &w, &logs]() {
+            try {
+               error[i] = iterateHex(logs[i], f[i], w[i]);
+            } catch (...) {
+               error[i] = -1;
+            }
+         });
+      }
+      for (i = 0; i < nSystem; ++i) {
+         threads[i].join();
+      }
+
+      // Compare each result to the serial reference
+      BFieldComparison comparison(1);
+      for (i = 0; i < nSystem; ++i) {
+         TEST_ASSERT(error[i] == 0);
+         TEST_ASSERT(std::abs(f[i] - fSerial) < 1.0E-10);
+         comparison.compare(wSerial, w[i]);
+         TEST_ASSERT(comparison.maxDiff() < 1.0E-10);
+         TEST_ASSERT(!logs[i].str().empty());
+      }
+   }
+
+private:
+
+   /*
+   * Solve the rigid hexagonal phase in a new System<2>.
+   *
+   * All output of the system is written to stream log, so that
+   * several calls may run concurrently. Returns the iterator error
+   * code, and sets the free energy and converged w fields.
+   */
+   int iterateHex(std::ostream& log, double& f,
+                  DArray< DArray<double> >& w)
+   {
+      System<2> system;
+      system.setLogFile(log);
+      system.fileMaster().setInputPrefix(filePrefix());
+      system.fileMaster().setOutputPrefix(filePrefix());
+
+      std::ifstream in;
+      system.fileMaster().openInputFile("in/diblock/hex/param.rigid", in);
+      system.readParam(in);
+      in.close();
+
+      system.readWBasis("in/diblock/hex/omega.in");
+      int error = system.iterate();
+      if (!error) {
+         system.computeFreeEnergy();
+         f = system.fHelmholtz();
+         w = system.w().basis();
+      }
+      return error;
+   }
+
 };
 
 TEST_BEGIN(SystemTest)
@@ -913,20 +1600,33 @@ TEST_ADD(SystemTest, testConstructor1D)
 TEST_ADD(SystemTest, testReadParameters1D)
 TEST_ADD(SystemTest, testConversion1D_lam)
 TEST_ADD(SystemTest, testConversion2D_hex)
+TEST_ADD(SystemTest, testConvertFields2D_hex)
 TEST_ADD(SystemTest, testConversion3D_bcc)
 TEST_ADD(SystemTest, testCheckSymmetry3D_bcc)
+TEST_ADD(SystemTest, testBatchCompute1D_lam)
+TEST_ADD(SystemTest, testBatchCompute1D_lam_rgrid)
 TEST_ADD(SystemTest, testIterate1D_lam_rigid)
+TEST_ADD(SystemTest, testIterate1D_lam_analyzer)
 TEST_ADD(SystemTest, testIterate1D_lam_flex)
+TEST_ADD(SystemTest, testIterate1D_lam_adaptive)
+TEST_ADD(SystemTest, testIterate1D_lam_adaptiveCond)
+TEST_ADD(SystemTest, testIterate1D_lam_adaptiveStagnant)
+TEST_ADD(SystemTest, testIterate1D_lam_fError)
+TEST_ADD(SystemTest, testIterate1D_lam_hybrid)
 TEST_ADD(SystemTest, testIterate1D_lam_soln)
 TEST_ADD(SystemTest, testIterate1D_lam_open_soln)
 TEST_ADD(SystemTest, testIterate1D_lam_open_blend)
 TEST_ADD(SystemTest, testIterate1D_lam_open_shift)
+TEST_ADD(SystemTest, testSetMesh1D_lam)
 TEST_ADD(SystemTest, testIterate2D_hex_rigid)
 TEST_ADD(SystemTest, testIterate2D_hex_flex)
 TEST_ADD(SystemTest, testIterate3D_bcc_rigid)
 TEST_ADD(SystemTest, testIterate3D_bcc_flex)
 TEST_ADD(SystemTest, testIterate3D_altGyr_flex)
 TEST_ADD(SystemTest, testIterate3D_c15_1_flex)
+TEST_ADD(SystemTest, testCompressQ2D_hex)
+TEST_ADD(SystemTest, testIterateDsRefine2D_hex)
+TEST_ADD(SystemTest, testConcurrentIterate2D_hex)
 TEST_END(SystemTest)
 
 #endif
@@ -22,6 +22,9 @@ LIBS=$(PSPG_LIBS)
 INCLUDES+=$(GSL_INC)
 LIBS+=$(GSL_LIB) 
 
+# Add optional LAPACK library (empty unless PSCF_LAPACK is used)
+LIBS+=$(LAPACK_LIB)
+
 # Add paths to CUDA FFT library
 PSPG_DEFS+=-DPSPG_FFTW -DGPU_OUTER
 INCLUDES+=$(CUFFT_INC)
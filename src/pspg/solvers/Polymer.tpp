@@ -56,6 +56,10 @@ namespace Pspg {
    template <int D>
    void Polymer<D>::compute(DArray< RDField<D> > const & wFields)
    {
+      if (hasMergedArms()) {
+         UTIL_THROW("Option mergeArms is not supported by this program");
+      }
+
       // Setup solvers for all blocks
       int monomerId;
       for (int j = 0; j < nBlock(); ++j) {
@@ -148,6 +148,7 @@ namespace Pspg {
       using SweepTmpl< BasisFieldState<D> >::baseFileName_;
       using SweepTmpl< BasisFieldState<D> >::initialize;
       using SweepTmpl< BasisFieldState<D> >::setCoefficients;
+      using SweepTmpl< BasisFieldState<D> >::looseEpsilon_;
       using ParamComposite::readOptional;
 
    private:
@@ -158,8 +159,8 @@ namespace Pspg {
       /// Unit cell parameters for trial state 
       FSArray<double, 6> unitCellParameters_;
 
-      /// Log file for summary output
-      std::ofstream logFile_;
+      /// Sweep summary file (sweep.log), distinct from logFile()
+      std::ofstream sweepLog_;
 
       /// Pointer to parent system.
       System<D>* systemPtr_;
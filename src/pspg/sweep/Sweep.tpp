@@ -69,6 +69,9 @@ namespace Pspg {
    {
       // Call the base class's readParameters function.
       SweepTmpl< BasisFieldState<D> >::readParameters(in);
+      if (looseEpsilon_ > 0.0) {
+         UTIL_THROW("Parameter looseEpsilon is not supported by this sweep");
+      }
       
       // Read optional flags indicating which field types to output
       readOptional(in, "writeCRGrid", writeCRGrid_);
@@ -100,7 +103,7 @@ namespace Pspg {
       // Open log summary file
       std::string fileName = baseFileName_;
       fileName += "sweep.log";
-      system().fileMaster().openOutputFile(fileName, logFile_);
+      system().fileMaster().openOutputFile(fileName, sweepLog_);
    };
 
    /*
@@ -263,7 +266,7 @@ namespace Pspg {
       outputSolution();
 
       // Output summary to log file
-      outputSummary(logFile_);
+      outputSummary(sweepLog_);
 
    };
 
@@ -338,7 +341,7 @@ namespace Pspg {
 
    template <int D>
    void Sweep<D>::cleanup() 
-   {  logFile_.close(); }
+   {  sweepLog_.close(); }
 
 } // namespace Pspg
 } // namespace Pscf